@@ -33,6 +33,9 @@ namespace clients::dns {
 /// cache-size-per-way | size of each way of network cache | 256
 /// cache-max-reply-ttl | TTL limit for network replies caching | 5m
 /// cache-failure-ttl | TTL for network failures caching | 5s
+/// cache-hot-size | max number of hot names served lock-free, 0 to disable | 256
+/// cache-hot-threshold | network cache hits that make a name hot | 8
+/// cache-prefetch-interval | interval of hot names refresh and idle names eviction | 1s
 ///
 /// ## Static configuration example:
 ///
@@ -39,6 +39,13 @@ struct ResolverConfig {
 
   /// Network cache failure TTL
   std::chrono::milliseconds cache_failure_ttl{std::chrono::seconds{5}};
+  /// Maximum number of hot names served from the lock-free cache tier
+  /// (tier is disabled if zero)
+  size_t cache_hot_size{256};
+  /// Network cache hits that make a name hot
+  size_t cache_hot_threshold{8};
+  /// Hot names prefetch and eviction interval
+  std::chrono::milliseconds cache_prefetch_interval{std::chrono::seconds{1}};
 };
 
 }  // namespace clients::dns
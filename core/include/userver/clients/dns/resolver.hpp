@@ -30,6 +30,19 @@ class Resolver {
     utils::statistics::RelaxedCounter<size_t> network_failure{0};
   };
 
+  struct NetCacheCounters {
+    /// Replies served from the lock-free hot names tier
+    utils::statistics::RelaxedCounter<size_t> hot_hits{0};
+    /// Lookups that missed the network cache and waited for name servers
+    utils::statistics::RelaxedCounter<size_t> misses{0};
+    /// Background queries started ahead of hot names expiration
+    utils::statistics::RelaxedCounter<size_t> prefetches{0};
+    /// Names moved to the hot tier
+    utils::statistics::RelaxedCounter<size_t> hot_promotions{0};
+    /// Names evicted from the hot tier for being idle
+    utils::statistics::RelaxedCounter<size_t> hot_evictions{0};
+  };
+
   Resolver(engine::TaskProcessor& fs_task_processor,
            const ResolverConfig& config);
   Resolver(const Resolver&) = delete;
@@ -40,6 +53,8 @@ class Resolver {
   ///
   /// Sources are tried in the following order:
   ///  - Cached file lookup table
+  ///  - Hot names tier of the network cache, lock-free and never waiting
+  ///    for name servers, possibly stale while a refresh is pending
   ///  - Cached network resolution results
   ///  - Network name servers
   ///
@@ -50,9 +65,16 @@ class Resolver {
   /// Returns lookup source counters.
   const LookupSourceCounters& GetLookupSourceCounters() const;
 
+  /// Returns network cache counters.
+  const NetCacheCounters& GetNetCacheCounters() const;
+
   /// Forces the reload of lookup table file. Waits until the reload is done.
   void ReloadHosts();
 
+  /// Forces a pass of the hot names prefetch and eviction. Waits until the
+  /// pass is done.
+  void PrefetchHotNames();
+
   /// Resets the network results cache.
   void FlushNetworkCache();
 
@@ -61,7 +83,7 @@ class Resolver {
 
  private:
   class Impl;
-  constexpr static size_t kSize = 1584;
+  constexpr static size_t kSize = 2272;
   constexpr static size_t kAlignment = 16;
   utils::FastPimpl<Impl, kSize, kAlignment> impl_;
 };
@@ -16,6 +16,7 @@
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/rcu/rcu.hpp>
 #include <userver/utils/fast_pimpl.hpp>
+#include <userver/utils/fixed_array.hpp>
 #include <userver/utils/periodic_task.hpp>
 #include <userver/utils/swappingsmart.hpp>
 #include <userver/yaml_config/fwd.hpp>
@@ -25,6 +26,7 @@ USERVER_NAMESPACE_BEGIN
 namespace curl {
 class easy;
 class multi;
+class share;
 class ConnectRateLimiter;
 }  // namespace curl
 
@@ -49,6 +51,15 @@ struct ClientSettings final {
   std::string thread_name_prefix;
   size_t io_threads = 8;
   bool defer_events = false;
+
+  /// Perform requests to the same host:port on the same IO thread, so that
+  /// they reuse its keepalive connections. A thread that is loaded much more
+  /// than the other one assigned to the destination is bypassed.
+  bool destination_affinity = false;
+
+  /// Share TLS session cache between all the IO threads, so that a TLS
+  /// session established by one of them is resumed by the others.
+  bool share_tls_sessions = false;
 };
 
 ClientSettings Parse(const yaml_config::YamlConfig& value,
@@ -130,6 +141,17 @@ class Client final {
 
   size_t FindMultiIndex(const curl::multi*) const;
 
+  // Returns the multi to perform a request to `url` with, or nullptr to keep
+  // the multi the request was created with
+  curl::multi* FindMultiForUrl(std::string_view url) const noexcept;
+
+  void UpdateMultiLoads();
+
+  // Clones the easy configured for a request onto the multi that follows its
+  // own one, for a hedged attempt of the request. The easy may be performed
+  // meanwhile, so it is cloned in the ev thread of its multi.
+  std::shared_ptr<curl::easy> CloneEasyToAnotherMulti(curl::easy& easy);
+
   // Functions for EasyWrapper that must be noexcept, as they are called from
   // the EasyWrapper destructor.
   friend class impl::EasyWrapper;
@@ -147,6 +169,14 @@ class Client final {
   std::vector<Statistics> statistics_;
   std::vector<std::unique_ptr<curl::multi>> multis_;
 
+  const bool destination_affinity_;
+  // Cached curl::MultiStatistics busy storage loads of multis_, as computing
+  // them is too costly to do on each request
+  utils::FixedArray<std::atomic<double>> multi_loads_;
+  utils::PeriodicTask multi_load_update_task_;
+  std::shared_ptr<curl::share> tls_session_share_;
+  std::shared_ptr<impl::SingleFlight> single_flight_;
+
   static constexpr size_t kIdleQueueSize = 616;
   static constexpr size_t kIdleQueueAlignment = 8;
   using IdleQueueTraits = moodycamel::ConcurrentQueueDefaultTraits;
@@ -39,6 +39,8 @@ namespace components {
 /// thread-name-prefix | set OS thread name to this value | ''
 /// threads | number of threads to process low level HTTP related IO system calls | 8
 /// defer-events | whether to defer events execution to a periodic timer; might affect timings a bit, might boost performance, use with care | false
+/// destination-affinity | perform requests to the same host:port on the same IO thread to reuse its keepalive connections, spill over to another thread if that one is overloaded | false
+/// share-tls-sessions | share TLS session cache between the IO threads to resume TLS sessions instead of full handshakes | false
 /// fs-task-processor | task processor to run blocking HTTP related calls, like DNS resolving or hosts reading | -
 /// destination-metrics-auto-max-size | set max number of automatically created destination metrics | 100
 /// user-agent | User-Agent HTTP header to show on all requests, result of utils::GetUserverIdentifier() if empty | empty
@@ -3,7 +3,10 @@
 /// @file userver/clients/http/request.hpp
 /// @brief @copybrief clients::http::Request
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
@@ -24,6 +27,7 @@ class StreamedResponse;
 
 namespace impl {
 class EasyWrapper;
+class SingleFlight;
 }  // namespace impl
 
 /// HTTP request method
@@ -59,6 +63,34 @@ class DestinationStatistics;
 struct TestsuiteConfig;
 struct EnforceTaskDeadlineConfig;
 
+/// Settings of the coalescing of identical requests, see
+/// Request::EnableCoalescing()
+struct CoalescingSettings final {
+  /// Names of the request headers that distinguish the requests in addition
+  /// to the method and the URL, e.g. "Authorization" or "Accept-Language"
+  std::vector<std::string> key_headers;
+
+  /// For how long a successful response may be served to the identical
+  /// requests after it is received. The response `Cache-Control: max-age`
+  /// shortens that time and `no-store` or `no-cache` disable the caching.
+  /// Zero disables the caching, only the in-flight requests are shared.
+  std::chrono::milliseconds max_cache_age{0};
+};
+
+/// Settings of the hedging of a request, see Request::EnableHedging()
+struct HedgingSettings final {
+  /// Time to wait for a response before sending a hedged attempt
+  std::chrono::milliseconds delay{0};
+
+  /// If set, the time to wait is this percentile of the recent response
+  /// timings of the request destination, but not less than `delay`
+  std::optional<double> delay_percentile;
+
+  /// Maximum ratio of the hedged attempts to the hedged requests to a
+  /// destination, in percent
+  double max_hedges_percent{10};
+};
+
 /// Class for creating and performing new http requests
 class Request final : public std::enable_shared_from_this<Request> {
  public:
@@ -192,6 +224,10 @@ class Request final : public std::enable_shared_from_this<Request> {
   // Set deadline propagation settings. For internal use only.
   std::shared_ptr<Request> SetEnforceTaskDeadline(
       EnforceTaskDeadlineConfig enforce_task_deadline);
+
+  // Set the registry of the coalesced requests. For internal use only.
+  std::shared_ptr<Request> SetSingleFlight(
+      std::shared_ptr<impl::SingleFlight> single_flight);
   /// @endcond
 
   /// Disable auto-decoding of received replies.
@@ -204,6 +240,28 @@ class Request final : public std::enable_shared_from_this<Request> {
   /// Disable auto add header with client timeout.
   std::shared_ptr<Request> DisableAddClientTimeoutHeader();
 
+  /// @brief Coalesce the request with the identical requests of the same
+  /// client that use coalescing too.
+  ///
+  /// The requests are identical if they have the same method, URL and values
+  /// of the CoalescingSettings::key_headers. Only one of the identical
+  /// requests that are performed concurrently is sent, the others receive a
+  /// copy of its response or its error, including the cancellation of the
+  /// sending request. Only GET and HEAD requests without a body are coalesced,
+  /// the coalescing is ignored for the other requests and for
+  /// async_perform_stream_body().
+  std::shared_ptr<Request> EnableCoalescing(CoalescingSettings settings = {});
+
+  /// @brief Send a hedged attempt of the request if there is no response for
+  /// too long.
+  ///
+  /// The hedged attempt goes to another IO thread of the client over its own
+  /// connection, the first successful response of the attempts is returned
+  /// and the other attempt is cancelled. The hedged attempt is not retried.
+  /// Only GET and HEAD requests without a body are hedged, the hedging is
+  /// ignored for the other requests and for async_perform_stream_body().
+  std::shared_ptr<Request> EnableHedging(HedgingSettings settings = {});
+
   /// Perform request asynchronously.
   ///
   /// Works well with engine::WaitAny, engine::WaitAnyFor, and
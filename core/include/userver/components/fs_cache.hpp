@@ -24,6 +24,7 @@ namespace components {
 /// dir               | directory to cache files from                        | /var/www
 /// update-period     | Update period (0 - fill the cache only at startup)   | 0
 /// fs-task-processor | task processor to do filesystem operations           | fs-task-processor
+/// max-file-size     | larger files are read from disk on each request      | unlimited
 
 // clang-format on
 
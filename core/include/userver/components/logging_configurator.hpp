@@ -4,6 +4,7 @@
 #include <userver/components/impl/component_base.hpp>
 #include <userver/concurrent/async_event_source.hpp>
 #include <userver/dynamic_config/source.hpp>
+#include <userver/utils/statistics/storage.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -17,6 +18,8 @@ namespace components {
 ///
 /// The functionality is not in Trace or Logger components because that
 /// introduces circular dependency between Logger and DynamicConfig.
+/// For the same reason it reports the statistics of the components::Logging
+/// loggers under the `logger` path.
 ///
 /// ## Dynamic config
 /// * @ref USERVER_NO_LOG_SPANS
@@ -47,6 +50,7 @@ class LoggingConfigurator final : public impl::ComponentBase {
   void OnConfigUpdate(const dynamic_config::Snapshot& config);
 
   concurrent::AsyncEventSubscriberScope config_subscription_;
+  utils::statistics::Entry statistics_holder_;
 };
 
 /// }@
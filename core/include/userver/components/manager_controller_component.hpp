@@ -33,7 +33,13 @@ class Manager;
 /// coro_pool.initial_size | amount of coroutines to preallocate on startup | -
 /// coro_pool.max_size | max amount of coroutines to keep preallocated | -
 /// coro_pool.stack_size | size of a single coroutine | 256 * 1024
+/// coro_pool.stack_release_watermark | amount of idle coroutines in the pool starting from which the stack memory of the returned coroutines is given back to the OS (except for the top 16KB of the stack) | coro_pool.max_size
+/// coro_pool.stack_release_method | how to give the stack memory back to the OS: 'dontneed' (MADV_DONTNEED, memory is freed immediately) or 'free' (MADV_FREE, memory is freed lazily under memory pressure) | dontneed
+/// coro_pool.stack_usage_monitor_enabled | measure the stack usage of the coroutines returned to the pool and report it in the coro-pool.stack-usage metrics; costs a mincore() syscall per coroutine | false
 /// event_thread_pool.threads | number of threads to process low level IO system calls (number of ev loops to start in libev) | -
+/// event_thread_pool.cpu-affinity.cpus | CPUs to run the ev threads on, in the Linux CPU list format, e.g. '0-15,32-47' | -
+/// event_thread_pool.cpu-affinity.numa-nodes | NUMA nodes to spread the ev threads over; sockets and timers prefer the ev thread on the NUMA node of the calling worker | -
+/// event_thread_pool.io_backend | socket I/O backend: 'epoll' or 'io_uring' (Linux 5.6+, falls back to 'epoll' if not supported by the kernel); with 'io_uring' the RecvSome, SendAll, Accept and Connect operations that would block are submitted to the io_uring of the ev thread in batches, once per ev-loop iteration | epoll
 /// components | dictionary of "component name": "options" | -
 /// default_task_processor | name of the default task processor to use in components | -
 /// task_processors.*NAME*.*OPTIONS* | dictionary of task processors to create and their options. See description below | -
@@ -45,6 +51,9 @@ class Manager;
 /// thread_name | set OS thread name to this value | -
 /// worker_threads | threads count for the task processor | -
 /// os-scheduling | OS scheduling mode for the task processor threads. 'idle' sets the lowest pririty. 'low-priority' sets the priority below 'normal' but higher than 'idle'. | normal
+/// task-processor-queue | Task queue implementation. 'global-task-queue' shares a single queue between all the workers. 'work-stealing-task-queue' uses per-worker queues with a LIFO slot for the just woken up task and randomized stealing, which reduces contention on task processors with many workers | global-task-queue
+/// cpu-affinity.cpus | CPUs to run the worker threads on, in the Linux CPU list format, e.g. '0-15,32-47' | -
+/// cpu-affinity.numa-nodes | NUMA nodes to spread the worker threads over, worker `i` is pinned to the CPUs of `numa-nodes[i % size]` | -
 /// task-trace | optional dictionary of tracing options | empty (disabled)
 /// task-trace.every | set N to trace each Nth task | 1000
 /// task-trace.max-context-switch-count | set upper limit of context switches to trace for a single task | 1000
@@ -50,6 +50,9 @@ class AsyncEventChannel : public AsyncEventSource<Args...> {
  public:
   using Function = typename AsyncEventSource<Args...>::Function;
 
+  /// Decides whether an event should be delivered to a listener
+  using Filter = std::function<bool(Args...)>;
+
   /// @brief The primary constructor
   /// @param name used for diagnostic purposes and is also accessible with Name
   explicit AsyncEventChannel(std::string name) : name_(std::move(name)) {}
@@ -70,6 +73,22 @@ class AsyncEventChannel : public AsyncEventSource<Args...> {
     return DoAddListener(id, name, std::move(func));
   }
 
+  /// @brief Same as above, but the listener is only woken up for the events
+  /// that pass the `filter`
+  ///
+  /// `filter` is called for each event under the channel lock, so it should be
+  /// cheap and must not block.
+  template <typename UpdaterFunc>
+  AsyncEventSubscriberScope DoUpdateAndListen(FunctionId id,
+                                              std::string_view name,
+                                              Function&& func,
+                                              UpdaterFunc&& updater,
+                                              Filter&& filter) {
+    std::lock_guard lock(event_mutex_);
+    std::forward<UpdaterFunc>(updater)();
+    return AddFilteredListener(id, name, std::move(func), std::move(filter));
+  }
+
   /// @overload
   template <typename Class, typename UpdaterFunc>
   AsyncEventSubscriberScope DoUpdateAndListen(Class* obj, std::string_view name,
@@ -86,18 +105,22 @@ class AsyncEventChannel : public AsyncEventSource<Args...> {
     std::lock_guard lock(event_mutex_);
     auto listeners = listeners_.Lock();
 
-    std::vector<engine::TaskWithResult<void>> tasks;
+    std::vector<std::pair<const Listener*, engine::TaskWithResult<void>>>
+        tasks;
     tasks.reserve(listeners->size());
 
     for (const auto& [_, listener] : *listeners) {
-      tasks.push_back(utils::Async(
-          listener.task_name,
-          [&, &callback = listener.callback] { callback(args...); }));
+      if (listener.filter && !listener.filter(args...)) continue;
+
+      tasks.emplace_back(
+          &listener,
+          utils::Async(listener.task_name, [&, &callback = listener.callback] {
+            callback(args...);
+          }));
     }
 
-    std::size_t i = 0;
-    for (const auto& [_, listener] : *listeners) {
-      impl::WaitForTask(listener.name, tasks[i++]);
+    for (auto& [listener, task] : tasks) {
+      impl::WaitForTask(listener->name, task);
     }
   }
 
@@ -109,6 +132,7 @@ class AsyncEventChannel : public AsyncEventSource<Args...> {
     std::string name;
     Function callback;
     std::string task_name;
+    Filter filter;
   };
 
   void RemoveListener(FunctionId id, UnsubscribingKind kind) noexcept final {
@@ -129,10 +153,18 @@ class AsyncEventChannel : public AsyncEventSource<Args...> {
 
   AsyncEventSubscriberScope DoAddListener(FunctionId id, std::string_view name,
                                           Function&& func) final {
+    return AddFilteredListener(id, name, std::move(func), {});
+  }
+
+  AsyncEventSubscriberScope AddFilteredListener(FunctionId id,
+                                                std::string_view name,
+                                                Function&& func,
+                                                Filter&& filter) {
     auto listeners = listeners_.Lock();
     auto task_name = impl::MakeAsyncChannelName(name_, name);
     const auto [iterator, success] = listeners->emplace(
-        id, Listener{std::string{name}, std::move(func), std::move(task_name)});
+        id, Listener{std::string{name}, std::move(func), std::move(task_name),
+                     std::move(filter)});
     if (!success) impl::ReportAlreadySubscribed(Name(), name);
     return AsyncEventSubscriberScope(*this, id);
   }
@@ -3,9 +3,12 @@
 #include <any>
 #include <cstddef>
 #include <exception>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <typeindex>
 #include <typeinfo>
+#include <unordered_set>
 #include <vector>
 
 #include <userver/dynamic_config/fwd.hpp>
@@ -37,6 +40,10 @@ ConfigId Register(Factory factory);
 template <typename Key>
 inline const ConfigId kConfigId = Register(&FactoryFor<Key>);
 
+// Names of the DocsMap items that each config was parsed from, indexed by
+// ConfigId
+using ConfigDependencies = std::vector<std::vector<std::string>>;
+
 class SnapshotData final {
  public:
   SnapshotData(const std::vector<KeyValue>& config_variables);
@@ -46,9 +53,28 @@ class SnapshotData final {
   SnapshotData(const SnapshotData& defaults,
                const std::vector<KeyValue>& overrides);
 
+  // Parses all the configs and records the items each of them depends on
+  SnapshotData(const DocsMap& docs, ConfigDependencies& dependencies);
+
+  // Reparses only the configs that depend on the `changed_names` items of
+  // `docs`, the rest of the configs are shared with `previous`
+  SnapshotData(const SnapshotData& previous, const DocsMap& docs,
+               const std::unordered_set<std::string>& changed_names,
+               ConfigDependencies& dependencies);
+
+  // Same, for the given factories rather than the registered ones, configs
+  // are indexed by the positions of their factories. For tests.
+  SnapshotData(const SnapshotData& previous, const DocsMap& docs,
+               const std::unordered_set<std::string>& changed_names,
+               ConfigDependencies& dependencies,
+               const std::vector<Factory>& factories);
+
   SnapshotData(SnapshotData&&) noexcept = default;
   SnapshotData& operator=(SnapshotData&&) noexcept = default;
 
+  // Returns true if the config is shared with `other` or is missing in both
+  bool IsSame(ConfigId id, const SnapshotData& other) const;
+
   template <typename Key>
   const auto& operator[](Key) const {
     using VariableType = decltype(Key::Parse(std::declval<const DocsMap&>()));
@@ -62,7 +88,8 @@ class SnapshotData final {
  private:
   const std::any& Get(impl::ConfigId id) const;
 
-  std::vector<std::any> user_configs_;
+  // Unchanged configs are shared between the consecutive snapshots
+  std::vector<std::shared_ptr<const std::any>> user_configs_;
 };
 
 struct StorageData;
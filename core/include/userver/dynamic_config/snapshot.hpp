@@ -28,8 +28,9 @@ using VariableOfKey = decltype(Key::Parse(std::declval<const DocsMap&>()));
 /// @brief The storage for a snapshot of configs
 ///
 /// When a config update comes in via new `DocsMap`, configs of all
-/// the registered types are constructed and stored in `Config`. After that
-/// the `DocsMap` is dropped.
+/// the registered types are constructed and stored in `Config`. Subsequent
+/// updates only reconstruct the configs that read the changed `DocsMap` items,
+/// the rest are shared with the previous snapshot.
 ///
 /// Config types are automatically registered if they are accessed with `Get`
 /// somewhere in the program.
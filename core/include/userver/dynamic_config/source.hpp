@@ -5,6 +5,7 @@
 
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <userver/concurrent/async_event_source.hpp>
 #include <userver/dynamic_config/snapshot.hpp>
@@ -100,6 +101,23 @@ class Source final {
         });
   }
 
+  /// Same as above, but the function is only invoked on updates that change
+  /// at least one of the `keys` configs. Updates of the other configs do not
+  /// wake the subscriber up.
+  template <typename Class, typename... Keys>
+  concurrent::AsyncEventSubscriberScope UpdateAndListen(
+      Class* obj, std::string_view name,
+      void (Class::*func)(const dynamic_config::Snapshot& config),
+      Keys... keys) {
+    static_assert(sizeof...(Keys) > 0);
+    return DoUpdateAndListen(
+        concurrent::FunctionId(obj), name,
+        [obj, func](const dynamic_config::Snapshot& config) {
+          (obj->*func)(config);
+        },
+        {impl::kConfigId<Keys>...});
+  }
+
   EventSource& GetEventChannel();
 
  private:
@@ -107,6 +125,10 @@ class Source final {
       concurrent::FunctionId id, std::string_view name,
       EventSource::Function&& func);
 
+  concurrent::AsyncEventSubscriberScope DoUpdateAndListen(
+      concurrent::FunctionId id, std::string_view name,
+      EventSource::Function&& func, std::vector<impl::ConfigId>&& keys);
+
   impl::StorageData* storage_;
 };
 
@@ -4,6 +4,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <userver/formats/json/serialize_container.hpp>
 #include <userver/formats/json/value.hpp>
@@ -30,9 +31,22 @@ class DocsMap final {
 
   bool AreContentsEqual(const DocsMap& other) const;
 
+  /* Returns names of the items that were added, removed or modified since
+   * the `previous` map */
+  std::unordered_set<std::string> GetChangedNames(
+      const DocsMap& previous) const;
+
+  /* For internal use: appends the names passed to Get() to `names` until
+   * called with nullptr */
+  void RecordRequestedNames(std::vector<std::string>* names) const;
+
+  /* For internal use: marks the names as requested without reading them */
+  void MarkRequestedNames(const std::vector<std::string>& names) const;
+
  private:
   std::unordered_map<std::string, formats::json::Value> docs_;
   mutable std::unordered_set<std::string> requested_names_;
+  mutable std::vector<std::string>* requested_names_recorder_{nullptr};
 };
 
 template <typename T>
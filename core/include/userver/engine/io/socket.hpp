@@ -103,6 +103,16 @@ class USERVER_NODISCARD Socket final : public RwBase {
   /// @note Can return less than len if socket is closed by peer.
   [[nodiscard]] size_t SendAll(const void* buf, size_t len, Deadline deadline);
 
+  /// @brief Sends exactly len bytes of the file starting from offset to the
+  /// socket, without copying the data through userspace buffers where the
+  /// platform allows it.
+  /// @note Can return less than len if socket is closed by peer or the file
+  /// is shorter than expected.
+  /// @warning Blocks the thread on disk reads if the data is not in the page
+  /// cache, prefetch it on a blocking task processor beforehand.
+  [[nodiscard]] size_t SendFile(int file_fd, std::size_t offset,
+                                std::size_t len, Deadline deadline);
+
   /// @brief Accepts a connection from a listening socket.
   /// @see engine::io::Listen
   [[nodiscard]] Socket Accept(Deadline);
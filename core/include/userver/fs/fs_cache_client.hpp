@@ -3,6 +3,9 @@
 /// @file userver/fs/fs_cache_client.hpp
 /// @brief @copybref fs::FsCacheClient
 
+#include <limits>
+
+#include <userver/fs/blocking/file_descriptor.hpp>
 #include <userver/fs/read.hpp>
 #include <userver/rcu/rcu_map.hpp>
 #include <userver/utils/periodic_task.hpp>
@@ -21,8 +24,11 @@ class FsCacheClient final {
   /// @param dir directory to cache files from
   /// @param update_period time (0 - fill the cache only at startup)
   /// @param tp task processor to do filesystem operations
+  /// @param max_file_size larger files are not kept in memory, see OpenFile
   FsCacheClient(std::string_view dir, std::chrono::milliseconds update_period,
-                engine::TaskProcessor& tp);
+                engine::TaskProcessor& tp,
+                std::size_t max_file_size =
+                    std::numeric_limits<std::size_t>::max());
 
   /// @brief get file from memory
   /// @param path to file
@@ -30,6 +36,15 @@ class FsCacheClient final {
   /// on FS
   FileInfoWithDataConstPtr TryGetFile(std::string_view path) const;
 
+  /// @brief open the file for reading on the filesystem task processor, e.g.
+  /// if its data is not kept in memory
+  /// @throws std::runtime_error if the file could not be opened
+  fs::blocking::FileDescriptor OpenFile(const FileInfoWithData& file) const;
+
+  /// @brief task processor for the filesystem operations, e.g. to read the
+  /// files returned by OpenFile
+  engine::TaskProcessor& GetTaskProcessor() const noexcept { return tp_; }
+
   /// @brief Concurrency-safe cache update
   void UpdateCache();
 
@@ -37,6 +52,7 @@ class FsCacheClient final {
   const std::string dir_;
   const std::chrono::milliseconds update_period_;
   engine::TaskProcessor& tp_;
+  const std::size_t max_file_size_;
   utils::PeriodicTask cache_updater_;
   rcu::RcuMap<std::string, const fs::FileInfoWithData> data_;
 };
@@ -3,6 +3,8 @@
 /// @file userver/fs/read.hpp
 /// @brief functions for asyncronous file read operations
 
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -20,6 +22,11 @@ struct FileInfoWithData {
   std::string data;
   std::string extension;
   size_t size;
+  /// Path of the file on FS, to read it if the data is not loaded
+  std::string path;
+  std::chrono::system_clock::time_point last_modified;
+  /// `false` if the file is too large to keep its data in memory
+  bool has_data{true};
 };
 
 using FileInfoWithDataConstPtr = std::shared_ptr<const FileInfoWithData>;
@@ -36,12 +43,14 @@ enum class SettingsReadFile {
 /// @param async_tp TaskProcessor for synchronous waiting
 /// @param path to directory to traverse recursively
 /// @param flags settings read files
+/// @param max_data_size data of the larger files is not read, only their info
 /// @returns map with relative to `path` filepaths and file info
 /// @throws std::runtime_error if read fails for any reason (e.g. no such file,
 /// read error, etc.),
 FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
     engine::TaskProcessor& async_tp, const std::string& path,
-    utils::Flags<SettingsReadFile> flags = {SettingsReadFile::kSkipHidden});
+    utils::Flags<SettingsReadFile> flags = {SettingsReadFile::kSkipHidden},
+    std::size_t max_data_size = std::numeric_limits<std::size_t>::max());
 
 /// @brief Reads file contents asynchronously
 /// @param async_tp TaskProcessor for synchronous waiting
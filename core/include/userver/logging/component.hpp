@@ -9,6 +9,7 @@
 #include <userver/components/component_fwd.hpp>
 #include <userver/components/impl/component_base.hpp>
 #include <userver/concurrent/async_event_source.hpp>
+#include <userver/formats/json/value.hpp>
 #include <userver/os_signals/component.hpp>
 
 #include <userver/utils/periodic_task.hpp>
@@ -37,10 +38,11 @@ namespace components {
 /// ---- | ----------- | -------------
 /// file_path | path to the log file | -
 /// level | log verbosity | info
-/// format | log output format, either `tskv` or `ltsv` | tskv
+/// format | log output format, either `tskv`, `ltsv` or `binary` | tskv
 /// flush_level | messages of this and higher levels get flushed to the file immediately | warning
-/// message_queue_size | the size of internal message queue, must be a power of 2 | 65536
-/// overflow_behavior | message handling policy while the queue is full: `discard` drops messages, `block` waits until message gets into the queue | discard
+/// message_queue_size | the size of internal message queue, must be a power of 2; every thread that logs gets a buffer that starts at 4 KiB and grows while full up to `message_queue_size * 16` bytes | 65536
+/// overflow_behavior | message handling policy while the buffer of the thread is full: `discard` drops the new messages (the oldest ones are kept), `block` waits until message gets into the buffer | discard
+/// thread_pool_size | deprecated and ignored, the loggers no longer use a thread pool; kept so that the existing configs stay valid | 1
 /// testsuite-capture | if exists, setups additional TCP log sink for testing purposes | {}
 ///
 /// ### Logs output
@@ -51,6 +53,11 @@ namespace components {
 /// - Use `%file_name%` to write your logs in file. Use USR1 signal or `OnLogRotate` handler to reopen files after log rotation;
 /// - Use `unix://%socket_name%` to write your logs to unix socket. Socket must be created before the service starts and closed by listener afert service is shuted down.
 ///
+/// ### Binary format
+/// `format: binary` writes length-prefixed key-value records without escaping
+/// the values, which is much cheaper than `tskv` for chatty services. Use the
+/// `binary_log_decoder` tool to convert such logs back to TSKV.
+///
 /// ### testsuite-capture options:
 /// Name | Description | Default value
 /// ---- | ----------- | -------------
@@ -92,6 +99,12 @@ class Logging final : public impl::ComponentBase {
   void OnLogRotate();
   void TryReopenFiles();
 
+  /// @brief Returns the counts of messages dropped by the file loggers on
+  /// buffer overflow, by logger name
+  /// @note Reported by components::LoggingConfigurator, as the statistics
+  /// storage depends on this component
+  formats::json::Value ExtendStatistics() const;
+
   class TestsuiteCaptureSink;
 
   static yaml_config::Schema GetStaticConfigSchema();
@@ -10,7 +10,14 @@ USERVER_NAMESPACE_BEGIN
 namespace logging {
 
 /// Log formats
-enum class Format { kTskv, kLtsv, kRaw };
+enum class Format {
+  kTskv,
+  kLtsv,
+  kRaw,
+  /// Length-prefixed key-value records without escaping, convert them to
+  /// TSKV with the `binary_log_decoder` tool
+  kBinary,
+};
 
 /// Parse Format enum from string
 Format FormatFromString(std::string_view format_str);
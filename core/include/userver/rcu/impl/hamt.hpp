@@ -0,0 +1,402 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace rcu::impl {
+
+inline std::uint64_t NextHamtEditToken() noexcept {
+  static std::atomic<std::uint64_t> last_token{0};
+  return ++last_token;
+}
+
+/// @brief Persistent hash array mapped trie with structural sharing
+///
+/// Copying is O(1): the copy shares all the nodes with the original. A
+/// modification copies only the nodes on the path from the root to the
+/// modified entry, so it costs O(log32(n)) allocations and never touches
+/// nodes reachable from other copies.
+///
+/// Nodes use the CHAMP layout: entries and subtrees are kept in separate
+/// arrays addressed by two bitmaps, and a subtree holding a single entry is
+/// always inlined into its parent, so the shape of the trie depends only on
+/// its keyset.
+///
+/// Between BeginEdit() and EndEdit() the trie works in "transient" mode:
+/// nodes created by the current edit session are modified in place, so a
+/// batch of modifications copies every shared node at most once.
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename Equal = std::equal_to<Key>>
+class Hamt final {
+ public:
+  struct Entry {
+    std::size_t hash;
+    Key key;
+    Value value;
+  };
+
+  class ConstIterator;
+
+  Hamt() = default;
+
+  Hamt(const Hamt& other) : root_(other.root_), size_(other.size_) {
+    // Nodes of an unfinished edit session are now shared with the copy and
+    // must not be modified in place anymore.
+    if (other.edit_) other.edit_ = NextHamtEditToken();
+  }
+
+  Hamt(Hamt&& other) noexcept
+      : root_(std::move(other.root_)),
+        size_(std::exchange(other.size_, 0)),
+        edit_(std::exchange(other.edit_, 0)) {}
+
+  Hamt& operator=(const Hamt& other) {
+    if (this != &other) *this = Hamt(other);
+    return *this;
+  }
+
+  Hamt& operator=(Hamt&& other) noexcept {
+    root_ = std::move(other.root_);
+    size_ = std::exchange(other.size_, 0);
+    edit_ = std::exchange(other.edit_, 0);
+    return *this;
+  }
+
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  ConstIterator begin() const { return ConstIterator(root_.get()); }
+  ConstIterator end() const { return {}; }
+
+  /// Returns a pointer to the value stored for `key` or nullptr
+  const Value* Find(const Key& key) const;
+
+  /// Inserts `value` if there is no `key` in the trie
+  /// @returns whether the insertion took place
+  bool Insert(const Key& key, Value value);
+
+  /// Inserts `value` or replaces the existing one
+  /// @returns whether a new entry was created
+  bool InsertOrAssign(const Key& key, Value value);
+
+  /// Removes `key` from the trie
+  /// @returns the removed value if the key was present
+  std::optional<Value> Erase(const Key& key);
+
+  void Clear() noexcept {
+    root_.reset();
+    size_ = 0;
+  }
+
+  /// Starts a transient edit session, see the class description
+  void BeginEdit() noexcept { edit_ = NextHamtEditToken(); }
+
+  /// Finishes the edit session; must be called before the trie is published
+  void EndEdit() noexcept { edit_ = 0; }
+
+ private:
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+
+  struct Node {
+    std::uint32_t datamap{0};
+    std::uint32_t nodemap{0};
+    std::uint64_t edit{0};
+    std::vector<Entry> entries;
+    std::vector<NodePtr> children;
+  };
+
+  static constexpr unsigned kBits = 5;
+  static constexpr unsigned kHashBits = sizeof(std::size_t) * CHAR_BIT;
+
+  static bool IsCollisionLevel(unsigned shift) noexcept {
+    return shift >= kHashBits;
+  }
+
+  static std::uint32_t Bit(std::size_t hash, unsigned shift) noexcept {
+    return std::uint32_t{1} << ((hash >> shift) & ((1u << kBits) - 1));
+  }
+
+  static std::size_t Index(std::uint32_t bitmap, std::uint32_t bit) noexcept {
+    return __builtin_popcount(bitmap & (bit - 1));
+  }
+
+  static bool Matches(const Entry& entry, std::size_t hash, const Key& key) {
+    return entry.hash == hash && Equal{}(entry.key, key);
+  }
+
+  NodePtr MakeNode() const {
+    auto node = std::make_shared<Node>();
+    node->edit = edit_;
+    return node;
+  }
+
+  Node& MakeEditable(NodePtr& node) const {
+    if (!node) {
+      node = MakeNode();
+    } else if (!edit_ || node->edit != edit_) {
+      auto copy = std::make_shared<Node>(*node);
+      copy->edit = edit_;
+      node = std::move(copy);
+    }
+    return *node;
+  }
+
+  NodePtr MergeEntries(Entry lhs, Entry rhs, unsigned shift) const;
+  bool DoInsert(NodePtr& node, unsigned shift, Entry&& entry) const;
+  Value DoErase(NodePtr& node, std::size_t hash, unsigned shift,
+                const Key& key) const;
+
+  NodePtr root_;
+  std::size_t size_{0};
+  mutable std::uint64_t edit_{0};
+};
+
+/// Forward iterator over entries of a Hamt, the trie must outlive it
+template <typename Key, typename Value, typename Hash, typename Equal>
+class Hamt<Key, Value, Hash, Equal>::ConstIterator final {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = Entry;
+  using reference = const Entry&;
+  using pointer = const Entry*;
+
+  ConstIterator() = default;
+
+  reference operator*() const { return *current_; }
+  pointer operator->() const { return current_; }
+
+  ConstIterator& operator++() {
+    Advance();
+    return *this;
+  }
+
+  ConstIterator operator++(int) {
+    auto tmp = *this;
+    Advance();
+    return tmp;
+  }
+
+  bool operator==(const ConstIterator& other) const {
+    return current_ == other.current_;
+  }
+  bool operator!=(const ConstIterator& other) const {
+    return current_ != other.current_;
+  }
+
+ private:
+  friend class Hamt;
+
+  explicit ConstIterator(const Node* root) {
+    if (!root) return;
+    // kHashBits / kBits levels plus a collision level
+    stack_.reserve(kHashBits / kBits + 2);
+    stack_.emplace_back(root, 0);
+    Advance();
+  }
+
+  void Advance() {
+    while (!stack_.empty()) {
+      auto& [node, pos] = stack_.back();
+      if (pos < node->entries.size()) {
+        current_ = &node->entries[pos++];
+        return;
+      }
+      const auto child_pos = pos - node->entries.size();
+      if (child_pos < node->children.size()) {
+        ++pos;
+        const Node* child = node->children[child_pos].get();
+        stack_.emplace_back(child, 0);
+        continue;
+      }
+      stack_.pop_back();
+    }
+    current_ = nullptr;
+  }
+
+  // node and the position of the next entry or child to visit
+  std::vector<std::pair<const Node*, std::size_t>> stack_;
+  const Entry* current_{nullptr};
+};
+
+template <typename K, typename V, typename H, typename E>
+const V* Hamt<K, V, H, E>::Find(const K& key) const {
+  const auto hash = H{}(key);
+  const Node* node = root_.get();
+  unsigned shift = 0;
+
+  while (node) {
+    if (IsCollisionLevel(shift)) {
+      for (const auto& entry : node->entries) {
+        if (Matches(entry, hash, key)) return &entry.value;
+      }
+      return nullptr;
+    }
+
+    const auto bit = Bit(hash, shift);
+    if (node->datamap & bit) {
+      const auto& entry = node->entries[Index(node->datamap, bit)];
+      return Matches(entry, hash, key) ? &entry.value : nullptr;
+    }
+    if (!(node->nodemap & bit)) return nullptr;
+
+    node = node->children[Index(node->nodemap, bit)].get();
+    shift += kBits;
+  }
+  return nullptr;
+}
+
+template <typename K, typename V, typename H, typename E>
+bool Hamt<K, V, H, E>::Insert(const K& key, V value) {
+  if (Find(key)) return false;
+  return InsertOrAssign(key, std::move(value));
+}
+
+template <typename K, typename V, typename H, typename E>
+bool Hamt<K, V, H, E>::InsertOrAssign(const K& key, V value) {
+  const bool inserted =
+      DoInsert(root_, 0, Entry{H{}(key), key, std::move(value)});
+  if (inserted) ++size_;
+  return inserted;
+}
+
+template <typename K, typename V, typename H, typename E>
+std::optional<V> Hamt<K, V, H, E>::Erase(const K& key) {
+  if (!Find(key)) return std::nullopt;
+
+  auto value = DoErase(root_, H{}(key), 0, key);
+  if (--size_ == 0) root_.reset();
+  return value;
+}
+
+template <typename K, typename V, typename H, typename E>
+auto Hamt<K, V, H, E>::MergeEntries(Entry lhs, Entry rhs, unsigned shift) const
+    -> NodePtr {
+  auto node = MakeNode();
+  if (IsCollisionLevel(shift)) {
+    node->entries.reserve(2);
+    node->entries.push_back(std::move(lhs));
+    node->entries.push_back(std::move(rhs));
+    return node;
+  }
+
+  const auto lhs_bit = Bit(lhs.hash, shift);
+  const auto rhs_bit = Bit(rhs.hash, shift);
+  if (lhs_bit == rhs_bit) {
+    node->nodemap = lhs_bit;
+    node->children.push_back(
+        MergeEntries(std::move(lhs), std::move(rhs), shift + kBits));
+    return node;
+  }
+
+  node->datamap = lhs_bit | rhs_bit;
+  node->entries.reserve(2);
+  if (lhs_bit > rhs_bit) std::swap(lhs, rhs);
+  node->entries.push_back(std::move(lhs));
+  node->entries.push_back(std::move(rhs));
+  return node;
+}
+
+template <typename K, typename V, typename H, typename E>
+bool Hamt<K, V, H, E>::DoInsert(NodePtr& node_ptr, unsigned shift,
+                                Entry&& entry) const {
+  auto& node = MakeEditable(node_ptr);
+
+  if (IsCollisionLevel(shift)) {
+    for (auto& old : node.entries) {
+      if (Matches(old, entry.hash, entry.key)) {
+        old.value = std::move(entry.value);
+        return false;
+      }
+    }
+    node.entries.push_back(std::move(entry));
+    return true;
+  }
+
+  const auto bit = Bit(entry.hash, shift);
+  if (node.datamap & bit) {
+    const auto index = Index(node.datamap, bit);
+    auto& old = node.entries[index];
+    if (Matches(old, entry.hash, entry.key)) {
+      old.value = std::move(entry.value);
+      return false;
+    }
+
+    auto child = MergeEntries(std::move(old), std::move(entry), shift + kBits);
+    node.entries.erase(node.entries.begin() + index);
+    node.datamap ^= bit;
+    node.children.insert(node.children.begin() + Index(node.nodemap, bit),
+                         std::move(child));
+    node.nodemap |= bit;
+    return true;
+  }
+
+  if (node.nodemap & bit) {
+    return DoInsert(node.children[Index(node.nodemap, bit)], shift + kBits,
+                    std::move(entry));
+  }
+
+  node.entries.insert(node.entries.begin() + Index(node.datamap, bit),
+                      std::move(entry));
+  node.datamap |= bit;
+  return true;
+}
+
+// The key must be present in the subtree
+template <typename K, typename V, typename H, typename E>
+V Hamt<K, V, H, E>::DoErase(NodePtr& node_ptr, std::size_t hash,
+                            unsigned shift, const K& key) const {
+  auto& node = MakeEditable(node_ptr);
+
+  if (IsCollisionLevel(shift)) {
+    auto it = node.entries.begin();
+    while (!Matches(*it, hash, key)) {
+      ++it;
+      UASSERT(it != node.entries.end());
+    }
+    auto value = std::move(it->value);
+    node.entries.erase(it);
+    return value;
+  }
+
+  const auto bit = Bit(hash, shift);
+  if (node.datamap & bit) {
+    const auto it = node.entries.begin() + Index(node.datamap, bit);
+    auto value = std::move(it->value);
+    node.entries.erase(it);
+    node.datamap ^= bit;
+    return value;
+  }
+
+  const auto child_it = node.children.begin() + Index(node.nodemap, bit);
+  auto value = DoErase(*child_it, hash, shift + kBits, key);
+
+  auto& child = **child_it;
+  if (child.children.empty() && child.entries.size() == 1) {
+    // Keep the trie canonical: a single entry is stored in the parent
+    auto entry = std::move(child.entries.front());
+    node.children.erase(child_it);
+    node.nodemap ^= bit;
+    node.entries.insert(node.entries.begin() + Index(node.datamap, bit),
+                        std::move(entry));
+    node.datamap |= bit;
+  }
+  return value;
+}
+
+}  // namespace rcu::impl
+
+USERVER_NAMESPACE_END
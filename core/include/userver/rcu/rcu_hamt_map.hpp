@@ -0,0 +1,495 @@
+#pragma once
+
+/// @file userver/rcu/rcu_hamt_map.hpp
+/// @brief @copybrief rcu::RcuHamtMap
+
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <userver/rcu/impl/hamt.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/rcu/rcu_map.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace rcu {
+
+/// @brief Forward iterator for the rcu::RcuHamtMap
+///
+/// Use member functions of rcu::RcuHamtMap to retrieve the iterator.
+template <typename Key, typename Value, typename IterValue>
+class RcuHamtMapIterator final {
+  using MapType = impl::Hamt<Key, std::shared_ptr<Value>>;
+  using BaseIterator = typename MapType::ConstIterator;
+
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type = ptrdiff_t;
+  using value_type = std::pair<Key, std::shared_ptr<IterValue>>;
+  using reference = const value_type&;
+  using pointer = const value_type*;
+
+  RcuHamtMapIterator() = default;
+
+  RcuHamtMapIterator operator++(int);
+  RcuHamtMapIterator& operator++();
+  reference operator*() const;
+  pointer operator->() const;
+
+  bool operator==(const RcuHamtMapIterator&) const;
+  bool operator!=(const RcuHamtMapIterator&) const;
+
+  /// @cond
+  /// For internal use only
+  explicit RcuHamtMapIterator(ReadablePtr<MapType>&& ptr);
+  /// @endcond
+
+ private:
+  void UpdateCurrent();
+
+  std::optional<ReadablePtr<MapType>> ptr_;
+  BaseIterator it_;
+  value_type current_;
+};
+
+/// @ingroup userver_concurrency userver_containers
+///
+/// @brief Map-like structure allowing RCU keyset updates without copying the
+/// whole map.
+///
+/// Has the same interface and guarantees as rcu::RcuMap, but the keyset is
+/// stored in a persistent hash array mapped trie. A new keyset version shares
+/// all the unchanged parts with the previous one, so a keyset change costs
+/// O(log n) instead of O(n) and does not cause allocation spikes for large
+/// maps. Lookups are a bit slower than in rcu::RcuMap, prefer rcu::RcuMap for
+/// small or rarely modified maps.
+///
+/// Multiple changes may be published to readers at once via StartBatch().
+/// @note No synchronization is provided for value access, it must be
+/// implemented by Value when necessary.
+///
+/// ## Example usage:
+///
+/// @snippet rcu/rcu_hamt_map_test.cpp  Sample rcu::RcuHamtMap usage
+///
+/// @see @ref md_en_userver_synchronization
+template <typename Key, typename Value>
+class RcuHamtMap final {
+  static_assert(!std::is_reference_v<Key>);
+  static_assert(!std::is_reference_v<Value>);
+  static_assert(!std::is_const_v<Key>);
+
+ public:
+  template <typename ValuePtrType>
+  struct InsertReturnTypeImpl;
+  class Batch;
+
+  using ValuePtr = std::shared_ptr<Value>;
+  using Iterator = RcuHamtMapIterator<Key, Value, Value>;
+  using ConstValuePtr = std::shared_ptr<const Value>;
+  using ConstIterator = RcuHamtMapIterator<Key, Value, const Value>;
+  using Snapshot = std::unordered_map<Key, ConstValuePtr>;
+  using InsertReturnType = InsertReturnTypeImpl<ValuePtr>;
+
+  RcuHamtMap() = default;
+
+  RcuHamtMap(const RcuHamtMap&) = delete;
+  RcuHamtMap(RcuHamtMap&&) = delete;
+  RcuHamtMap& operator=(const RcuHamtMap&) = delete;
+  RcuHamtMap& operator=(RcuHamtMap&&) = delete;
+
+  /// Returns an estimated size of the map at some point in time
+  size_t SizeApprox() const;
+
+  /// @name Iteration support
+  /// @details Keyset is fixed at the start of the iteration and is not affected
+  /// by concurrent changes.
+  /// @{
+  ConstIterator begin() const;
+  ConstIterator end() const;
+  Iterator begin();
+  Iterator end();
+  /// @}
+
+  /// @brief Returns a readonly value pointer by its key if exists
+  /// @throws MissingKeyException if the key is not present
+  const ConstValuePtr operator[](const Key&) const;
+
+  /// @brief Returns a modifiable value pointer by key if exists or
+  /// default-creates one
+  const ValuePtr operator[](const Key&);
+
+  /// @brief Inserts a new element into the container if there is no element
+  /// with the key in the container.
+  /// Returns a pair consisting of a pointer to the inserted element, or the
+  /// already-existing element if no insertion happened, and a bool denoting
+  /// whether the insertion took place.
+  InsertReturnType Insert(const Key& key, ValuePtr value);
+
+  /// @brief Inserts a new element into the container constructed in-place with
+  /// the given args if there is no element with the key in the container.
+  /// Returns a pair consisting of a pointer to the inserted element, or the
+  /// already-existing element if no insertion happened, and a bool denoting
+  /// whether the insertion took place.
+  template <typename... Args>
+  InsertReturnType Emplace(const Key& key, Args&&... args);
+
+  /// @brief If a key equivalent to `key` already exists in the container, does
+  /// nothing.
+  /// Otherwise, behaves like `Emplace` except that the value is constructed
+  /// only if the insertion takes place.
+  /// Returns a pair consisting of a pointer to the inserted element, or the
+  /// already-existing element if no insertion happened, and a bool denoting
+  /// whether the insertion took place.
+  template <typename... Args>
+  InsertReturnType TryEmplace(const Key& key, Args&&... args);
+
+  /// @brief If a key equivalent to `key` already exists in the container,
+  /// replaces the associated value. Otherwise, inserts a new pair into the map.
+  void InsertOrAssign(const Key& key, ValuePtr value);
+
+  /// @brief Returns a readonly value pointer by its key or an empty pointer
+  const ConstValuePtr Get(const Key&) const;
+
+  /// @brief Returns a modifiable value pointer by key or an empty pointer
+  const ValuePtr Get(const Key&);
+
+  /// @brief Removes a key from the map
+  /// @returns whether the key was present
+  bool Erase(const Key&);
+
+  /// @brief Removes a key from the map returning its value
+  /// @returns a value if the key was present, empty pointer otherwise
+  ValuePtr Pop(const Key&);
+
+  /// Resets the map to an empty state
+  void Clear();
+
+  /// Replace current data by data from `new_map`.
+  void Assign(const std::unordered_map<Key, ValuePtr>& new_map);
+
+  /// @brief Starts a batch of keyset changes that become visible to readers
+  /// all at once on Batch::Commit()
+  /// @note Like rcu::WritablePtr, the batch blocks other writers until it is
+  /// committed or destroyed and may not be passed between coroutines.
+  Batch StartBatch();
+
+  /// @brief Returns a readonly copy of the map
+  /// @note Equivalent to `{begin(), end()}` construct, preferable
+  /// for long-running operations.
+  Snapshot GetSnapshot() const;
+
+ private:
+  using MapType = impl::Hamt<Key, ValuePtr>;
+
+  rcu::Variable<MapType> rcu_;
+};
+
+template <typename K, typename V>
+template <typename ValuePtrType>
+struct RcuHamtMap<K, V>::InsertReturnTypeImpl {
+  ValuePtrType value;
+  bool inserted;
+};
+
+/// @brief A set of keyset changes of rcu::RcuHamtMap published in a single
+/// snapshot
+///
+/// Changes are not visible to readers of the map until Commit() and are
+/// discarded if the batch is destroyed without Commit().
+template <typename K, typename V>
+class RcuHamtMap<K, V>::Batch final {
+ public:
+  Batch(Batch&&) noexcept = default;
+  Batch& operator=(Batch&&) = delete;
+
+  /// @brief Returns a value pointer by its key or an empty pointer, taking
+  /// uncommitted changes of the batch into account
+  ValuePtr Get(const K& key);
+
+  /// @brief Inserts a new element if there is no element with the key
+  /// @returns whether the insertion took place
+  bool Insert(const K& key, ValuePtr value);
+
+  /// @brief Inserts a new element or replaces the associated value
+  void InsertOrAssign(const K& key, ValuePtr value);
+
+  /// @brief Removes a key
+  /// @returns whether the key was present
+  bool Erase(const K& key);
+
+  /// @brief Removes all the keys
+  void Clear();
+
+  /// @brief Publishes all the changes of the batch to readers
+  void Commit();
+
+ private:
+  friend class RcuHamtMap;
+
+  explicit Batch(WritablePtr<MapType>&& txn) : txn_(std::move(txn)) {
+    txn_->BeginEdit();
+  }
+
+  WritablePtr<MapType> txn_;
+};
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::ConstIterator RcuHamtMap<K, V>::begin() const {
+  return ConstIterator{rcu_.Read()};
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::ConstIterator RcuHamtMap<K, V>::end() const {
+  // End iterator must be empty, because otherwise begin and end calls will
+  // return iterators that point into different map snapshots.
+  return {};
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::Iterator RcuHamtMap<K, V>::begin() {
+  return Iterator{rcu_.Read()};
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::Iterator RcuHamtMap<K, V>::end() {
+  // End iterator must be empty, because otherwise begin and end calls will
+  // return iterators that point into different map snapshots.
+  return {};
+}
+
+template <typename K, typename V>
+size_t RcuHamtMap<K, V>::SizeApprox() const {
+  auto ptr = rcu_.Read();
+  return ptr->size();
+}
+
+template <typename K, typename V>
+// Protects from assignment to map[key]
+// NOLINTNEXTLINE(readability-const-return-type)
+const typename RcuHamtMap<K, V>::ConstValuePtr RcuHamtMap<K, V>::operator[](
+    const K& key) const {
+  if (auto value = Get(key)) {
+    return value;
+  }
+  throw MissingKeyException("Key ") << key << " is missing";
+}
+
+template <typename K, typename V>
+// Protects from assignment to map[key]
+// NOLINTNEXTLINE(readability-const-return-type)
+const typename RcuHamtMap<K, V>::ConstValuePtr RcuHamtMap<K, V>::Get(
+    const K& key) const {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  return const_cast<RcuHamtMap<K, V>*>(this)->Get(key);
+}
+
+template <typename K, typename V>
+// Protects from assignment to map[key]
+// NOLINTNEXTLINE(readability-const-return-type)
+const typename RcuHamtMap<K, V>::ValuePtr RcuHamtMap<K, V>::operator[](
+    const K& key) {
+  return TryEmplace(key).value;
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::InsertReturnType RcuHamtMap<K, V>::Insert(
+    const K& key, typename RcuHamtMap<K, V>::ValuePtr value) {
+  InsertReturnType result{Get(key), false};
+  if (result.value) return result;
+
+  auto txn = rcu_.StartWrite();
+  if (const auto* existing = txn->Find(key)) {
+    result.value = *existing;
+    return result;
+  }
+  result.value = value;
+  result.inserted = txn->Insert(key, std::move(value));
+  txn.Commit();
+  return result;
+}
+
+template <typename K, typename V>
+template <typename... Args>
+typename RcuHamtMap<K, V>::InsertReturnType RcuHamtMap<K, V>::Emplace(
+    const K& key, Args&&... args) {
+  InsertReturnType result{Get(key), false};
+  if (result.value) return result;
+
+  return Insert(key, std::make_shared<V>(std::forward<Args>(args)...));
+}
+
+template <typename K, typename V>
+template <typename... Args>
+typename RcuHamtMap<K, V>::InsertReturnType RcuHamtMap<K, V>::TryEmplace(
+    const K& key, Args&&... args) {
+  InsertReturnType result{Get(key), false};
+  if (result.value) return result;
+
+  auto txn = rcu_.StartWrite();
+  if (const auto* existing = txn->Find(key)) {
+    result.value = *existing;
+    return result;
+  }
+  result.value = std::make_shared<V>(std::forward<Args>(args)...);
+  result.inserted = txn->Insert(key, result.value);
+  txn.Commit();
+  return result;
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::InsertOrAssign(
+    const K& key, typename RcuHamtMap<K, V>::ValuePtr value) {
+  auto txn = rcu_.StartWrite();
+  txn->InsertOrAssign(key, std::move(value));
+  txn.Commit();
+}
+
+template <typename K, typename V>
+// Protects from assignment to map[key]
+// NOLINTNEXTLINE(readability-const-return-type)
+const typename RcuHamtMap<K, V>::ValuePtr RcuHamtMap<K, V>::Get(const K& key) {
+  auto snapshot = rcu_.Read();
+  const auto* value = snapshot->Find(key);
+  if (!value) return {};
+  return *value;
+}
+
+template <typename K, typename V>
+bool RcuHamtMap<K, V>::Erase(const K& key) {
+  return !!Pop(key);
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::ValuePtr RcuHamtMap<K, V>::Pop(const K& key) {
+  if (!Get(key)) return {};
+
+  auto txn = rcu_.StartWrite();
+  auto value = txn->Erase(key);
+  if (!value) return {};
+  txn.Commit();
+  return std::move(*value);
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::Clear() {
+  rcu_.Assign({});
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::Assign(
+    const std::unordered_map<K, typename RcuHamtMap<K, V>::ValuePtr>& new_map) {
+  MapType map;
+  map.BeginEdit();
+  for (const auto& [key, value] : new_map) {
+    map.Insert(key, value);
+  }
+  map.EndEdit();
+  rcu_.Assign(std::move(map));
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::Batch RcuHamtMap<K, V>::StartBatch() {
+  return Batch{rcu_.StartWrite()};
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::Snapshot RcuHamtMap<K, V>::GetSnapshot() const {
+  return {begin(), end()};
+}
+
+template <typename K, typename V>
+typename RcuHamtMap<K, V>::ValuePtr RcuHamtMap<K, V>::Batch::Get(
+    const K& key) {
+  const auto* value = txn_->Find(key);
+  if (!value) return {};
+  return *value;
+}
+
+template <typename K, typename V>
+bool RcuHamtMap<K, V>::Batch::Insert(const K& key, ValuePtr value) {
+  return txn_->Insert(key, std::move(value));
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::Batch::InsertOrAssign(const K& key, ValuePtr value) {
+  txn_->InsertOrAssign(key, std::move(value));
+}
+
+template <typename K, typename V>
+bool RcuHamtMap<K, V>::Batch::Erase(const K& key) {
+  return txn_->Erase(key).has_value();
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::Batch::Clear() {
+  txn_->Clear();
+}
+
+template <typename K, typename V>
+void RcuHamtMap<K, V>::Batch::Commit() {
+  txn_->EndEdit();
+  txn_.Commit();
+}
+
+template <typename Key, typename Value, typename IterValue>
+RcuHamtMapIterator<Key, Value, IterValue>::RcuHamtMapIterator(
+    ReadablePtr<MapType>&& ptr)
+    : ptr_(std::move(ptr)), it_((*ptr_)->begin()) {
+  UpdateCurrent();
+}
+
+template <typename Key, typename Value, typename IterValue>
+auto RcuHamtMapIterator<Key, Value, IterValue>::operator++(int)
+    -> RcuHamtMapIterator {
+  RcuHamtMapIterator tmp(*this);
+  ++*this;
+  return tmp;
+}
+
+template <typename Key, typename Value, typename IterValue>
+auto RcuHamtMapIterator<Key, Value, IterValue>::operator++()
+    -> RcuHamtMapIterator& {
+  ++it_;
+  UpdateCurrent();
+  return *this;
+}
+
+template <typename Key, typename Value, typename IterValue>
+auto RcuHamtMapIterator<Key, Value, IterValue>::operator*() const
+    -> reference {
+  return current_;
+}
+
+template <typename Key, typename Value, typename IterValue>
+auto RcuHamtMapIterator<Key, Value, IterValue>::operator->() const -> pointer {
+  return &current_;
+}
+
+template <typename Key, typename Value, typename IterValue>
+bool RcuHamtMapIterator<Key, Value, IterValue>::operator==(
+    const RcuHamtMapIterator& rhs) const {
+  // Iterators of different snapshots never point to the same entry
+  return it_ == rhs.it_;
+}
+
+template <typename Key, typename Value, typename IterValue>
+bool RcuHamtMapIterator<Key, Value, IterValue>::operator!=(
+    const RcuHamtMapIterator& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename Key, typename Value, typename IterValue>
+void RcuHamtMapIterator<Key, Value, IterValue>::UpdateCurrent() {
+  if (it_ != BaseIterator{}) {
+    current_ = {it_->key, it_->value};
+  }
+}
+
+}  // namespace rcu
+
+USERVER_NAMESPACE_END
@@ -68,6 +68,9 @@ namespace components {
 /// connection.in_buffer_size | size of the buffer to preallocate for request receive: bigger values use more RAM and less CPU | 32 * 1024
 /// connection.requests_queue_size_threshold | drop requests from handlers that allow trottling if there's more pending requests than allowed by this value | 100
 /// connection.keepalive_timeout | timeout in seconds to drop connection if there's not data received from it | 600
+/// connection.http2_enabled | serve HTTP/2 (h2c with prior knowledge) on connections that start with the HTTP/2 connection preface | false
+/// connection.http2_max_concurrent_streams | max count of concurrently processed requests of an HTTP/2 connection | 100
+/// connection.http2_initial_window_size | initial HTTP/2 flow control window of a stream in bytes | 65535
 /// shards | how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing | -
 
 // clang-format on
@@ -39,6 +39,11 @@ namespace server::handlers {
 /// decompress_request | allow decompression of the requests | false
 /// throttling_enabled | allow throttling of the requests by components::Server , for more info see its `max_response_size_in_flight` and `requests_queue_size_threshold` options | true
 /// set-response-server-hostname | set to true to add the `X-YaTaxi-Server-Hostname` header with instance name, set to false to not add the header | <takes the value from components::Server config>
+/// response-compression | compress the responses with gzip or brotli according to the Accept-Encoding of the requests, see the options below | <not compressed>
+/// response-compression.min-size | smaller responses are sent as is, the streamed responses and the files set by server::http::HttpResponse::SetBodyFile() are never compressed | 1024
+/// response-compression.gzip-level | zlib compression level from 0 to 9 | 6
+/// response-compression.brotli-quality | brotli compression quality from 0 to 11 | 4
+/// response-compression.task-processor | task processor to compress the responses on | <task processor of the handler>
 /// monitor-handler | Overrides the in-code `is_monitor` flag that makes the handler run either on `server.listener` or on `server.listener-monitor` | --
 
 // clang-format on
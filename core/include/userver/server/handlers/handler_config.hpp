@@ -24,6 +24,19 @@ enum class UrlTrailingSlashOption {
   kDefault = kBoth,
 };
 
+/// Response compression settings of a handler, see the
+/// `response-compression` option of server::handlers::HandlerBase
+struct ResponseCompressionConfig {
+  /// Smaller responses are sent as is
+  size_t min_size{1024};
+  /// zlib compression level from 0 to 9
+  int gzip_level{6};
+  /// brotli compression quality from 0 to 11
+  int brotli_quality{4};
+  /// Compress on this task processor instead of the one of the handler
+  std::optional<std::string> task_processor;
+};
+
 struct HandlerConfig {
   std::variant<std::string, FallbackHandler> path;
   std::string task_processor;
@@ -39,8 +52,12 @@ struct HandlerConfig {
   bool throttling_enabled{true};
   bool response_body_stream{false};
   std::optional<bool> set_response_server_hostname;
+  std::optional<ResponseCompressionConfig> response_compression;
 };
 
+ResponseCompressionConfig Parse(const yaml_config::YamlConfig& value,
+                                formats::parse::To<ResponseCompressionConfig>);
+
 HandlerConfig ParseHandlerConfigsWithDefaults(
     const yaml_config::YamlConfig& value,
     const server::ServerConfig& server_config, bool is_monitor = false);
@@ -148,6 +148,10 @@ class HttpHandlerBase : public HandlerBase {
   void FormatStatistics(utils::statistics::Writer result,
                         const HttpStatistics& stats);
 
+  void CompressResponse(const http::HttpRequest& http_request,
+                        http::HttpResponse& response) const;
+  void SetResponseStreamCompressor(const http::HttpRequest& http_request,
+                                   http::HttpResponse& response) const;
   void SetResponseAcceptEncoding(http::HttpResponse& response) const;
   void SetResponseServerHostname(http::HttpResponse& response) const;
 
@@ -164,6 +168,7 @@ class HttpHandlerBase : public HandlerBase {
   bool set_response_server_hostname_;
   mutable utils::TokenBucket rate_limit_;
   bool is_body_streamed_;
+  engine::TaskProcessor* compression_task_processor_{nullptr};
 };
 
 }  // namespace server::handlers
@@ -16,6 +16,14 @@ namespace server::handlers {
 /// @brief Convenient base for handlers that accept requests with body in
 /// JSON format and respond with body in JSON format.
 ///
+/// ## Static options:
+/// Inherits all the options from server::handlers::HttpHandlerBase and adds
+/// the following ones:
+///
+/// Name | Description | Default value
+/// ---- | ----------- | -------------
+/// request-json-arena | parse request bodies with formats::json::FromStringWithArena | false
+///
 /// ## Example usage:
 ///
 /// @snippet samples/config_service/config_service.cpp Config service sample - component
@@ -55,6 +63,8 @@ class HttpHandlerJsonBase : public HttpHandlerBase {
  private:
   FormattedErrorData GetFormattedExternalErrorBody(
       const CustomHandlerException& exc) const final;
+
+  const bool request_json_arena_;
 };
 
 }  // namespace server::handlers
@@ -19,6 +19,14 @@ namespace server::handlers {
 /// @brief Handler that returns HTTP 200 if file exist
 /// and returns file data with mapped content/type
 ///
+/// Supports conditional requests with ETag/If-None-Match and
+/// Last-Modified/If-Modified-Since, and single range `Range` requests. The
+/// file data is not copied to the response: files kept in memory by the
+/// FsCache are referenced, larger ones are sent from disk with sendfile(2).
+///
+/// Precompressed variants of the files, e.g. `app.js.br` and `app.js.gz` for
+/// `app.js`, are sent instead of the file if the client accepts them.
+///
 /// ## Dynamic config
 /// * @ref USERVER_FILES_CONTENT_TYPE_MAP
 ///
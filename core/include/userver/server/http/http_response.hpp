@@ -4,11 +4,15 @@
 /// @brief @copybrief server::http::HttpResponse
 
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include <userver/concurrent/queue.hpp>
 #include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/http/content_type.hpp>
 #include <userver/server/http/http_response_cookie.hpp>
 #include <userver/server/request/response_base.hpp>
@@ -19,6 +23,18 @@
 
 USERVER_NAMESPACE_BEGIN
 
+namespace compression {
+class StreamCompressor;
+}  // namespace compression
+
+namespace fs::blocking {
+class FileDescriptor;
+}  // namespace fs::blocking
+
+namespace server::net {
+class Http2Stream;
+}  // namespace server::net
+
 namespace server::http {
 
 namespace impl {
@@ -73,6 +89,33 @@ class HttpResponse final : public request::ResponseBase {
   /// @brief Remove all cookies from response.
   void ClearCookies();
 
+  /// @brief Sets the body to `size` bytes of the `file` starting from
+  /// `offset`, overriding the data set by SetData().
+  ///
+  /// Over plain HTTP/1.x connections the body is sent with sendfile(2)
+  /// without copying it through userspace buffers, HTTP/2 streams read the
+  /// file in chunks. Disk reads are done on the `fs_task_processor`, so that
+  /// the file could be sent by a coroutine. The file is never compressed
+  /// by the `response-compression` option of the handlers.
+  void SetBodyFile(std::shared_ptr<const fs::blocking::FileDescriptor> file,
+                   std::size_t offset, std::size_t size,
+                   engine::TaskProcessor& fs_task_processor);
+
+  /// @brief Sets the body to the `data` that is kept alive by the `owner`,
+  /// overriding the data set by SetData(). The data is not copied, so
+  /// e.g. files from fs::FsCacheClient could be sent as is.
+  void SetBodyShared(std::shared_ptr<const void> owner, std::string_view data);
+
+  /// @brief Remove the body, including the one set by SetBodyFile() or
+  /// SetBodyShared().
+  void ClearBody();
+
+  /// @return the body set by SetData() or SetBodyShared()
+  std::string_view GetBodyView() const;
+
+  /// @return true if the body is set by SetBodyFile()
+  bool HasBodyFile() const { return body_file_.has_value(); }
+
   /// @return HTTP response status
   HttpStatus GetStatus() const { return status_; }
 
@@ -97,6 +140,7 @@ class HttpResponse final : public request::ResponseBase {
   /// @cond
   // TODO: server internals. remove from public interface
   void SendResponse(engine::io::Socket& socket) override;
+  void SendResponse(net::Http2Stream& stream);
   /// @endcond
 
   void SetStatusServiceUnavailable() override {
@@ -115,9 +159,30 @@ class HttpResponse final : public request::ResponseBase {
   // Can be called only once
   Queue::Producer GetBodyProducer();
 
+  /// @cond
+  // Compresses the streamed body unless the handler sets Content-Encoding,
+  // see the `response-compression` option of the handlers
+  void SetStreamCompressor(
+      std::string encoding,
+      std::unique_ptr<compression::StreamCompressor> compressor,
+      engine::TaskProcessor* task_processor);
+  /// @endcond
+
  private:
   void SetBodyStreamed(engine::io::Socket& socket, std::string& header);
   void SetBodyNotstreamed(engine::io::Socket& socket, std::string& header);
+  std::size_t SendBodyFile(engine::io::Socket& socket);
+  void SendBodyFile(net::Http2Stream& stream);
+  std::size_t GetBodySize() const;
+  void StartStreamCompression();
+  std::string CompressChunk(std::string_view chunk, bool finish);
+
+  struct FileBody {
+    std::shared_ptr<const fs::blocking::FileDescriptor> file;
+    std::size_t offset{0};
+    std::size_t size{0};
+    engine::TaskProcessor* fs_task_processor{nullptr};
+  };
 
   const HttpRequestImpl& request_;
   HttpStatus status_ = HttpStatus::kOk;
@@ -127,6 +192,14 @@ class HttpResponse final : public request::ResponseBase {
   engine::SingleConsumerEvent headers_end_;
   std::optional<Queue::Consumer> body_stream_;
   std::optional<Queue::Producer> body_stream_producer_;
+
+  std::optional<FileBody> body_file_;
+  std::shared_ptr<const void> body_owner_;
+  std::string_view body_shared_;
+
+  std::string stream_encoding_;
+  std::unique_ptr<compression::StreamCompressor> stream_compressor_;
+  engine::TaskProcessor* compression_task_processor_{nullptr};
 };
 
 void SetThrottleReason(http::HttpResponse& http_response,
@@ -0,0 +1,242 @@
+#pragma once
+
+/// @file userver/utils/statistics/hdr_histogram.hpp
+/// @brief @copybrief utils::statistics::HdrHistogram
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <userver/utils/statistics/histogram_view.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+/** @brief Log-linear (HDR-style) histogram with a bounded relative error
+ *
+ * Values below `2^PrecisionBits` are counted precisely. Larger values are
+ * counted in buckets whose width doubles with each power of two, with
+ * `2^(PrecisionBits - 1)` buckets per power of two. Thus the relative error of
+ * GetPercentile() results does not exceed kMaxRelativeError for any value up
+ * to kMaxValue, while the histogram takes only
+ * `(MaxValueBits - PrecisionBits + 2) * 2^(PrecisionBits - 1)` counters.
+ *
+ * The defaults take 3.5KB and track values up to 2^32 with at most 3.2%
+ * error, e.g. microsecond timings from 1us up to an hour.
+ *
+ * Like utils::statistics::Percentile, the histogram may be used as a Counter
+ * and a Result of utils::statistics::RecentPeriod and
+ * utils::statistics::ShardedRecentPeriod. Histograms are merged via Add().
+ *
+ * Writing the histogram to utils::statistics::Writer produces a native
+ * histogram metric, see utils::statistics::HistogramView.
+ *
+ * @tparam PrecisionBits defines the relative error of 2^-(PrecisionBits - 1)
+ * @tparam MaxValueBits values up to 2^MaxValueBits - 1 are tracked, larger
+ * ones are only counted as overflow
+ * @tparam Counter bucket type
+ *
+ * Example:
+ *
+ * @snippet utils/statistics/hdr_histogram_test.cpp  HdrHistogram usage
+ */
+template <std::size_t PrecisionBits = 6, std::size_t MaxValueBits = 32,
+          typename Counter = std::uint32_t>
+class HdrHistogram final {
+  static_assert(PrecisionBits >= 2 && PrecisionBits < MaxValueBits);
+  static_assert(MaxValueBits < 64);
+
+ public:
+  using ValueType = std::uint64_t;
+
+  /// Max value that is tracked precisely
+  static constexpr ValueType kMaxValue = (ValueType{1} << MaxValueBits) - 1;
+
+  /// Max relative error of GetPercentile() results
+  static constexpr double kMaxRelativeError =
+      1.0 / (std::size_t{1} << (PrecisionBits - 1));
+
+  HdrHistogram() noexcept { Reset(); }
+
+  HdrHistogram(const HdrHistogram& other) noexcept { *this = other; }
+
+  HdrHistogram& operator=(const HdrHistogram& rhs) noexcept {
+    if (this == &rhs) return *this;
+
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      buckets_[i].store(rhs.buckets_[i].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    }
+    overflow_.store(rhs.overflow_.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    return *this;
+  }
+
+  /// Account for another value
+  void Account(ValueType value, Counter count = 1) noexcept {
+    if (value > kMaxValue) {
+      overflow_.fetch_add(count, std::memory_order_relaxed);
+    } else {
+      buckets_[ValueToIndex(value)].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+
+  /** @brief Get X percentile - min value P so that total number of elements
+   * that are not greater than P is more than X percent.
+   *
+   * Same as utils::statistics::Percentile::GetPercentile(), but returns the
+   * greatest value of the bucket, so the result is not less than the precise
+   * percentile and exceeds it by at most kMaxRelativeError.
+   * Returns kMaxValue + 1 if the percentile falls into the overflow.
+   * @param percent - value in [0..100] - requested percentile
+   */
+  ValueType GetPercentile(double percent) const noexcept {
+    const auto count = Count();
+    if (count == 0) return 0;
+
+    const double want_sum = count * percent;
+    std::uint64_t sum = 0;
+    ValueType max_value = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      const auto value = buckets_[i].load(std::memory_order_relaxed);
+      if (!value) continue;
+
+      sum += value;
+      max_value = IndexToMaxValue(i);
+      if (sum * 100 > want_sum) return max_value;
+    }
+
+    return CountOverflow() ? kMaxValue + 1 : max_value;
+  }
+
+  /// Total number of elements, including the overflow
+  std::uint64_t Count() const noexcept {
+    std::uint64_t result = overflow_.load(std::memory_order_relaxed);
+    for (const auto& bucket : buckets_) {
+      result += bucket.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// Number of elements greater than kMaxValue
+  std::uint64_t CountOverflow() const noexcept {
+    return overflow_.load(std::memory_order_relaxed);
+  }
+
+  template <class Duration = std::chrono::seconds>
+  void Add(const HdrHistogram& other,
+           [[maybe_unused]] Duration this_epoch_duration = Duration(),
+           [[maybe_unused]] Duration before_this_epoch_duration = Duration()) {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      const auto value = other.buckets_[i].load(std::memory_order_relaxed);
+      if (value) buckets_[i].fetch_add(value, std::memory_order_relaxed);
+    }
+    overflow_.fetch_add(other.overflow_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+  }
+
+  void Reset() noexcept {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    overflow_.store(0, std::memory_order_relaxed);
+  }
+
+  /// @cond
+  // For DumpMetric
+  static constexpr std::size_t kExportBucketCount = 2 * MaxValueBits;
+
+  // Inclusive upper bounds 0, 1, 2, 3, 5, 7, 11, 15, ..., kMaxValue, i.e. the
+  // values right below 1, 2, 3, 4, 6, 8, 12, 16, ..., 2^MaxValueBits. Those
+  // are edges of the buckets for any PrecisionBits, so no bucket straddles an
+  // upper bound and the export is exact.
+  static constexpr std::array<double, kExportBucketCount> kExportUpperBounds =
+      [] {
+        std::array<double, kExportBucketCount> result{};
+        result[0] = 0;
+        for (std::size_t i = 1; i <= MaxValueBits; ++i) {
+          result[2 * i - 1] = (ValueType{1} << i) - 1;
+          if (i < MaxValueBits) result[2 * i] = (ValueType{3} << (i - 1)) - 1;
+        }
+        return result;
+      }();
+
+  // Merges the buckets into the export buckets. Each bucket goes to the first
+  // export bucket whose upper bound is not less than the bucket max value.
+  // As the bounds are the bucket edges, the bucket min value is greater than
+  // the previous bound.
+  std::array<std::uint64_t, kExportBucketCount> GetExportValues() const {
+    std::array<std::uint64_t, kExportBucketCount> result{};
+    std::size_t export_index = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      const auto value = buckets_[i].load(std::memory_order_relaxed);
+      if (!value) continue;
+
+      const auto max_value = static_cast<double>(IndexToMaxValue(i));
+      while (kExportUpperBounds[export_index] < max_value) ++export_index;
+      result[export_index] += value;
+    }
+    return result;
+  }
+
+  // Sum estimation by the middles of the buckets
+  double GetApproximateSum() const noexcept {
+    double result = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      const auto value = buckets_[i].load(std::memory_order_relaxed);
+      if (value) {
+        result += value * (IndexToMinValue(i) + IndexToMaxValue(i)) / 2.0;
+      }
+    }
+    return result + CountOverflow() * static_cast<double>(kMaxValue + 1);
+  }
+  /// @endcond
+
+ private:
+  static constexpr std::size_t kSubBucketCount = std::size_t{1}
+                                                 << PrecisionBits;
+  static constexpr std::size_t kSubBucketHalf = kSubBucketCount / 2;
+  static constexpr std::size_t kBucketCount =
+      (MaxValueBits - PrecisionBits + 2) * kSubBucketHalf;
+
+  static std::size_t ValueToIndex(ValueType value) noexcept {
+    if (value < kSubBucketCount) return value;
+
+    const auto highest_bit = 63 - __builtin_clzll(value);
+    const auto shift = highest_bit - (PrecisionBits - 1);
+    return shift * kSubBucketHalf + (value >> shift);
+  }
+
+  static ValueType IndexToMinValue(std::size_t index) noexcept {
+    if (index < kSubBucketCount) return index;
+
+    const auto shift = index / kSubBucketHalf - 1;
+    return ValueType{index - shift * kSubBucketHalf} << shift;
+  }
+
+  static ValueType IndexToMaxValue(std::size_t index) noexcept {
+    if (index < kSubBucketCount) return index;
+
+    const auto shift = index / kSubBucketHalf - 1;
+    return IndexToMinValue(index) + (ValueType{1} << shift) - 1;
+  }
+
+  std::array<std::atomic<Counter>, kBucketCount> buckets_;
+  std::atomic<Counter> overflow_;
+};
+
+template <std::size_t PrecisionBits, std::size_t MaxValueBits, typename Counter>
+void DumpMetric(
+    Writer& writer,
+    const HdrHistogram<PrecisionBits, MaxValueBits, Counter>& hist) {
+  using Histogram = HdrHistogram<PrecisionBits, MaxValueBits, Counter>;
+  const auto values = hist.GetExportValues();
+  writer = HistogramView{Histogram::kExportUpperBounds, values,
+                         hist.CountOverflow(), hist.GetApproximateSum()};
+}
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,68 @@
+#pragma once
+
+/// @file userver/utils/statistics/histogram_view.hpp
+/// @brief @copybrief utils::statistics::HistogramView
+
+#include <cstddef>
+#include <cstdint>
+
+#include <userver/utils/assert.hpp>
+#include <userver/utils/impl/span.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+/// @brief Non-owning read-only view of histogram buckets, the way histogram
+/// metrics are passed to the metric formats
+///
+/// Bucket `i` counts values in `(GetUpperBoundAt(i - 1), GetUpperBoundAt(i)]`,
+/// values greater than the last upper bound are counted by GetValueAtInf().
+/// The formats that support histograms (e.g. Prometheus and Solomon) export
+/// them natively.
+///
+/// Write it via utils::statistics::Writer from a `DumpMetric` function of
+/// a histogram type, e.g. utils::statistics::HdrHistogram.
+class HistogramView final {
+ public:
+  HistogramView(utils::impl::Span<const double> upper_bounds,
+                utils::impl::Span<const std::uint64_t> values,
+                std::uint64_t value_at_inf, double sum) noexcept
+      : upper_bounds_(upper_bounds),
+        values_(values),
+        value_at_inf_(value_at_inf),
+        sum_(sum) {
+    UASSERT(upper_bounds_.size() == values_.size());
+  }
+
+  std::size_t GetBucketCount() const noexcept { return values_.size(); }
+
+  /// Upper bounds are strictly increasing
+  double GetUpperBoundAt(std::size_t index) const {
+    return upper_bounds_[index];
+  }
+
+  /// Count of values in the bucket, not cumulative
+  std::uint64_t GetValueAt(std::size_t index) const { return values_[index]; }
+
+  std::uint64_t GetValueAtInf() const noexcept { return value_at_inf_; }
+
+  std::uint64_t GetTotalCount() const noexcept {
+    std::uint64_t result = value_at_inf_;
+    for (const auto value : values_) result += value;
+    return result;
+  }
+
+  /// Sum of all the accounted values, may be approximate
+  double GetSum() const noexcept { return sum_; }
+
+ private:
+  utils::impl::Span<const double> upper_bounds_;
+  utils::impl::Span<const std::uint64_t> values_;
+  std::uint64_t value_at_inf_;
+  double sum_;
+};
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -103,6 +103,15 @@ class RecentPeriod {
 
   void UpdateEpochIfOld() { std::ignore = get_current_index(); }
 
+  /// Returns the counter of the epoch starting at `epoch` (the time since the
+  /// Timer epoch) if the counter is still stored, nullptr otherwise.
+  Counter* FindCounterForEpoch(Duration epoch) {
+    for (auto& item : items_) {
+      if (item.epoch.load() == epoch) return &item.counter;
+    }
+    return nullptr;
+  }
+
  private:
   size_t get_current_index() const {
     while (true) {
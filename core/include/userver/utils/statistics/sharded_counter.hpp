@@ -0,0 +1,88 @@
+#pragma once
+
+/// @file userver/utils/statistics/sharded_counter.hpp
+/// @brief @copybrief utils::statistics::ShardedCounter
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include <userver/utils/fixed_array.hpp>
+#include <userver/utils/impl/interference_size.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+namespace impl {
+
+// Number of shards of the sharded statistics, a power of two
+std::size_t GetShardCount() noexcept;
+
+// Shard of the current thread, in [0, GetShardCount())
+std::size_t GetCurrentShardIndex() noexcept;
+
+}  // namespace impl
+
+/// @brief Atomic counter of integral type T split into per-thread shards
+///
+/// Each shard occupies its own cache line, so concurrent updates from
+/// different threads (e.g. task processor workers) do not contend, unlike
+/// the updates of utils::statistics::RelaxedCounter. The shards are summed
+/// on Load(), so it is much slower than the updates.
+///
+/// Use it for counters that are updated on every request and read only by
+/// the statistics collection.
+template <class T>
+class ShardedCounter final {
+  static_assert(std::is_integral_v<T>);
+
+ public:
+  using ValueType = T;
+
+  ShardedCounter() : shards_(impl::GetShardCount()) {}
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  T Load() const noexcept {
+    T result{};
+    for (const auto& shard : shards_) {
+      result += shard.value.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  operator T() const noexcept { return Load(); }
+
+  ShardedCounter& operator++() noexcept { return *this += 1; }
+
+  ShardedCounter& operator--() noexcept { return *this -= 1; }
+
+  ShardedCounter& operator+=(T arg) noexcept {
+    GetShard().fetch_add(arg, std::memory_order_relaxed);
+    return *this;
+  }
+
+  ShardedCounter& operator-=(T arg) noexcept {
+    GetShard().fetch_sub(arg, std::memory_order_relaxed);
+    return *this;
+  }
+
+ private:
+  static_assert(std::atomic<T>::is_always_lock_free);
+
+  struct alignas(utils::impl::kInterferenceSize) Shard final {
+    std::atomic<T> value{T{}};
+  };
+
+  std::atomic<T>& GetShard() noexcept {
+    return shards_[impl::GetCurrentShardIndex()].value;
+  }
+
+  utils::FixedArray<Shard> shards_;
+};
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,110 @@
+#pragma once
+
+/// @file userver/utils/statistics/sharded_recentperiod.hpp
+/// @brief @copybrief utils::statistics::ShardedRecentPeriod
+
+#include <atomic>
+#include <chrono>
+
+#include <userver/utils/fixed_array.hpp>
+#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+/** \brief utils::statistics::RecentPeriod that accounts the current epoch in
+ * per-thread shards
+ *
+ * Each thread gets a Counter of the current epoch in its own shard, so hot
+ * paths that account on every request do not contend for the same cache
+ * lines. Shards are merged into an ordinary RecentPeriod lazily: by the
+ * first GetCurrentCounter() call of the shard in a new epoch, or by
+ * GetStatsForPeriod(). Memory overhead is one Counter per shard.
+ *
+ * Counter must provide `Add(const Counter&)` and `Reset()`, e.g.
+ * utils::statistics::Percentile.
+ *
+ * @note Unlike RecentPeriod, the current unfinished epoch is never included
+ * into GetStatsForPeriod() results. A value accounted concurrently with the
+ * merge of its shard may be lost.
+ */
+template <typename Counter, typename Result,
+          typename Timer = std::chrono::steady_clock>
+class ShardedRecentPeriod final {
+ public:
+  using Duration = typename Timer::duration;
+
+  /**
+   * @param epoch_duration duration of epoch.
+   * @param max_duration max duration to calculate statistics for
+   *        must be multiple of epoch_duration.
+   */
+  ShardedRecentPeriod(Duration epoch_duration = std::chrono::seconds(5),
+                      Duration max_duration = std::chrono::seconds(60))
+      : history_(epoch_duration, max_duration),
+        shards_(impl::GetShardCount()) {}
+
+  /// Returns the current epoch Counter of the current thread shard
+  Counter& GetCurrentCounter() {
+    auto& shard = shards_[impl::GetCurrentShardIndex()];
+    const auto epoch = GetCurrentEpoch();
+    const auto shard_epoch = shard.epoch.load(std::memory_order_acquire);
+    if (shard_epoch < epoch) MergeShard(shard, shard_epoch, epoch);
+    return shard.counter;
+  }
+
+  /** \brief Aggregates counters of the finished epochs within given time
+   * range
+   *
+   * @param duration Time range. Special value Duration::min() -> use
+   *        whole ShardedRecentPeriod range.
+   */
+  Result GetStatsForPeriod(Duration duration = Duration::min()) const {
+    const auto epoch = GetCurrentEpoch();
+    for (auto& shard : shards_) {
+      const auto shard_epoch = shard.epoch.load(std::memory_order_acquire);
+      if (shard_epoch < epoch) MergeShard(shard, shard_epoch, epoch);
+    }
+    return history_.GetStatsForPeriod(duration, false);
+  }
+
+  Duration GetEpochDuration() const { return history_.GetEpochDuration(); }
+
+  Duration GetMaxDuration() const { return history_.GetMaxDuration(); }
+
+ private:
+  struct alignas(utils::impl::kInterferenceSize) Shard final {
+    std::atomic<Duration> epoch{Duration::min()};
+    Counter counter{};
+  };
+
+  Duration GetCurrentEpoch() const {
+    const auto now = std::chrono::duration_cast<Duration>(
+        Timer::now().time_since_epoch());
+    return now - now % GetEpochDuration();
+  }
+
+  void MergeShard(Shard& shard, Duration shard_epoch, Duration epoch) const {
+    // Only one thread merges the shard of an epoch
+    if (!shard.epoch.compare_exchange_strong(shard_epoch, epoch)) return;
+
+    if (shard_epoch != Duration::min()) {
+      if (auto* counter = history_.FindCounterForEpoch(shard_epoch)) {
+        counter->Add(shard.counter);
+      }
+    }
+    shard.counter.Reset();
+
+    // Makes sure that history has a counter for the epoch to merge into later
+    history_.UpdateEpochIfOld();
+  }
+
+  mutable RecentPeriod<Counter, Result, Timer> history_;
+  mutable utils::FixedArray<Shard> shards_;
+};
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -16,6 +16,7 @@
 #include <userver/formats/json/value_builder.hpp>
 #include <userver/utils/clang_format_workarounds.hpp>
 #include <userver/utils/statistics/entry.hpp>
+#include <userver/utils/statistics/histogram_view.hpp>
 #include <userver/utils/statistics/writer.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -101,7 +102,7 @@ using StorageIterator = StorageData::iterator;
 
 class BaseFormatBuilder {
  public:
-  using MetricValue = std::variant<std::int64_t, double>;
+  using MetricValue = std::variant<std::int64_t, double, HistogramView>;
 
   virtual ~BaseFormatBuilder();
 
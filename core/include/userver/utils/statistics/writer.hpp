@@ -6,6 +6,7 @@
 #include <string_view>
 #include <type_traits>
 
+#include <userver/utils/statistics/histogram_view.hpp>
 #include <userver/utils/statistics/labels.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -54,10 +55,15 @@ class Writer final {
     Write(value);
   }
 
+  /// Write histogram metric value without labels to metrics builder
+  void operator=(const HistogramView& value) { Write(value); }
+
   /// Write metric value without labels to metrics builder via custom DumpMetric
   /// function.
   template <class T>
-  std::enable_if_t<!std::is_arithmetic_v<T>> operator=(const T& value) {
+  std::enable_if_t<!std::is_arithmetic_v<T> &&
+                   !std::is_same_v<T, HistogramView>>
+  operator=(const T& value) {
     if (state_) {
       using impl::DumpMetric;  // poison pill
       DumpMetric(*this, value);
@@ -70,7 +76,8 @@ class Writer final {
     auto new_writer = MakeChild();
     new_writer.AppendLabelsSpan(labels);
 
-    if constexpr (std::is_arithmetic_v<T>) {
+    if constexpr (std::is_arithmetic_v<T> ||
+                  std::is_same_v<T, HistogramView>) {
       new_writer.Write(value);
     } else {
       if (state_) {
@@ -114,6 +121,7 @@ class Writer final {
   void Write(unsigned long long value);
   void Write(long long value);
   void Write(double value);
+  void Write(const HistogramView& value);
 
   void Write(float value) { Write(static_cast<double>(value)); }
 
@@ -40,6 +40,14 @@ ResolverConfig ParseResolverConfig(
   config.cache_failure_ttl =
       component_config["cache_failure_ttl"].As<std::chrono::milliseconds>(
           config.cache_failure_ttl);
+  config.cache_hot_size =
+      component_config["cache-hot-size"].As<size_t>(config.cache_hot_size);
+  config.cache_hot_threshold =
+      component_config["cache-hot-threshold"].As<size_t>(
+          config.cache_hot_threshold);
+  config.cache_prefetch_interval =
+      component_config["cache-prefetch-interval"].As<std::chrono::milliseconds>(
+          config.cache_prefetch_interval);
   return config;
 }
 
@@ -71,7 +79,17 @@ formats::json::Value Component::ExtendStatistics() {
   json_counters["network-failure"] = counters.network_failure.Load();
   utils::statistics::SolomonChildrenAreLabelValues(json_counters,
                                                    "dns_reply_source");
-  return formats::json::MakeObject("replies", json_counters.ExtractValue());
+
+  const auto& cache_counters = GetResolver().GetNetCacheCounters();
+  formats::json::ValueBuilder json_cache;
+  json_cache["hot-hits"] = cache_counters.hot_hits.Load();
+  json_cache["misses"] = cache_counters.misses.Load();
+  json_cache["prefetches"] = cache_counters.prefetches.Load();
+  json_cache["hot-promotions"] = cache_counters.hot_promotions.Load();
+  json_cache["hot-evictions"] = cache_counters.hot_evictions.Load();
+
+  return formats::json::MakeObject("replies", json_counters.ExtractValue(),
+                                   "cache", json_cache.ExtractValue());
 }
 
 yaml_config::Schema Component::GetStaticConfigSchema() {
@@ -122,6 +140,18 @@ properties:
         type: string
         description: TTL for network failures caching
         defaultDescription: 5s
+    cache-hot-size:
+        type: integer
+        description: max number of hot names served lock-free, 0 to disable
+        defaultDescription: 256
+    cache-hot-threshold:
+        type: integer
+        description: network cache hits that make a name hot
+        defaultDescription: 8
+    cache-prefetch-interval:
+        type: string
+        description: interval of hot names refresh and idle names eviction
+        defaultDescription: 1s
 )");
 }
 
@@ -2,8 +2,11 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <atomic>
 #include <cctype>
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <string_view>
 
 #include <clients/dns/file_resolver.hpp>
@@ -14,10 +17,12 @@
 #include <userver/concurrent/mutex_set.hpp>
 #include <userver/engine/async.hpp>
 #include <userver/logging/log.hpp>
+#include <userver/rcu/rcu_map.hpp>
 #include <userver/utils/assert.hpp>
 #include <userver/utils/from_string.hpp>
 #include <userver/utils/impl/wait_token_storage.hpp>
 #include <userver/utils/mock_now.hpp>
+#include <userver/utils/periodic_task.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -146,12 +151,15 @@ class Resolver::Impl {
   ~Impl();
 
   const LookupSourceCounters& GetLookupSourceCounters() const;
+  const NetCacheCounters& GetNetCacheCounters() const;
 
   void ReloadHosts();
+  void ForcePrefetchHotNames();
   void FlushNetworkCache();
   void FlushNetworkCache(const std::string& name);
 
   AddrVector QueryFileCache(const std::string& name);
+  std::optional<AddrVector> QueryHotCache(const std::string& name);
   NetCacheResult QueryNetCache(const std::string& name);
 
   auto GetUpdateMutex(const std::string& name);
@@ -163,7 +171,7 @@ class Resolver::Impl {
                                engine::Deadline deadline);
 
   template <typename Mutex>
-  void StartBackgroundQuery(std::unique_lock<Mutex>& lock, Mutex&& mutex,
+  bool StartBackgroundQuery(std::unique_lock<Mutex>& lock, Mutex&& mutex,
                             const std::string& name);
 
  private:
@@ -171,8 +179,24 @@ class Resolver::Impl {
     AddrVector addrs;
     std::chrono::steady_clock::time_point expiration;
     bool is_failure{false};
+    // shared between the copies returned by the cache, null for failures
+    std::shared_ptr<std::atomic<size_t>> hits;
   };
 
+  // Hot entries are immutable apart from the hits counter, refreshes replace
+  // them as a whole
+  struct HotCacheEntry {
+    AddrVector addrs;
+    std::chrono::steady_clock::time_point expiration;
+    // lookups since the last prefetch pass
+    std::atomic<size_t> hits{0};
+  };
+
+  void PromoteToHot(const std::string& name, const NetCacheEntry& entry);
+  void UpdateHotEntry(const std::string& name, const AddrVector& addrs,
+                      std::chrono::steady_clock::time_point expiration);
+  void PrefetchHotNames();
+
   template <typename Mutex>
   void MoveQueryToBackground(std::unique_lock<Mutex>& lock, Mutex&& mutex,
                              engine::Future<NetResolver::Response>&& future,
@@ -185,14 +209,20 @@ class Resolver::Impl {
                        FailureMode failure_mode);
 
   LookupSourceCounters source_counters_;
+  NetCacheCounters net_cache_counters_;
   FileResolver file_resolver_;
   NetResolver net_resolver_;
   const std::chrono::milliseconds net_cache_update_margin_;
   const std::chrono::milliseconds net_cache_max_reply_ttl_;
   const std::chrono::milliseconds net_cache_failure_ttl_;
+  const size_t hot_cache_size_;
+  const size_t hot_cache_threshold_;
+  const std::chrono::milliseconds hot_cache_prefetch_interval_;
   cache::NWayLRU<std::string, NetCacheEntry> net_cache_;
+  rcu::RcuMap<std::string, HotCacheEntry> hot_cache_;
   concurrent::MutexSet<std::string> net_cache_update_mutexes_;
   utils::impl::WaitTokenStorage wait_token_storage_;
+  utils::PeriodicTask prefetch_task_;
 };
 
 Resolver::Impl::Impl(engine::TaskProcessor& fs_task_processor,
@@ -204,22 +234,48 @@ Resolver::Impl::Impl(engine::TaskProcessor& fs_task_processor,
       net_cache_update_margin_{config.network_timeout},
       net_cache_max_reply_ttl_{config.cache_max_reply_ttl},
       net_cache_failure_ttl_{config.cache_failure_ttl},
+      hot_cache_size_{config.cache_hot_size},
+      hot_cache_threshold_{config.cache_hot_threshold},
+      hot_cache_prefetch_interval_{config.cache_prefetch_interval},
       net_cache_{config.cache_ways, config.cache_size_per_way},
-      net_cache_update_mutexes_(config.cache_ways) {}
+      net_cache_update_mutexes_(config.cache_ways) {
+  if (hot_cache_size_ > 0) {
+    prefetch_task_.Start("dns-hot-names-prefetch",
+                         utils::PeriodicTask::Settings{
+                             hot_cache_prefetch_interval_, {},
+                             logging::Level::kTrace},
+                         [this] { PrefetchHotNames(); });
+  }
+}
 
-Resolver::Impl::~Impl() { wait_token_storage_.WaitForAllTokens(); }
+Resolver::Impl::~Impl() {
+  prefetch_task_.Stop();
+  wait_token_storage_.WaitForAllTokens();
+}
 
 const Resolver::LookupSourceCounters& Resolver::Impl::GetLookupSourceCounters()
     const {
   return source_counters_;
 }
 
+const Resolver::NetCacheCounters& Resolver::Impl::GetNetCacheCounters() const {
+  return net_cache_counters_;
+}
+
 void Resolver::Impl::ReloadHosts() { file_resolver_.ReloadHosts(); }
 
-void Resolver::Impl::FlushNetworkCache() { net_cache_.Invalidate(); }
+void Resolver::Impl::ForcePrefetchHotNames() {
+  if (hot_cache_size_ > 0) prefetch_task_.SynchronizeDebug();
+}
+
+void Resolver::Impl::FlushNetworkCache() {
+  net_cache_.Invalidate();
+  hot_cache_.Clear();
+}
 
 void Resolver::Impl::FlushNetworkCache(const std::string& name) {
   net_cache_.InvalidateByKey(name);
+  hot_cache_.Erase(name);
 }
 
 AddrVector Resolver::Impl::QueryFileCache(const std::string& name) {
@@ -230,6 +286,23 @@ AddrVector Resolver::Impl::QueryFileCache(const std::string& name) {
   return addrs;
 }
 
+// Hot names never wait for anything, stale replies are served until
+// the prefetch task refreshes them
+std::optional<AddrVector> Resolver::Impl::QueryHotCache(
+    const std::string& name) {
+  const auto hot = hot_cache_.Get(name);
+  if (!hot) return {};
+
+  hot->hits.fetch_add(1, std::memory_order_relaxed);
+  if (hot->expiration >= utils::datetime::MockSteadyNow()) {
+    ++source_counters_.cached;
+  } else {
+    ++source_counters_.cached_stale;
+  }
+  ++net_cache_counters_.hot_hits;
+  return hot->addrs;
+}
+
 Resolver::Impl::NetCacheResult Resolver::Impl::QueryNetCache(
     const std::string& name) {
   NetCacheResult result;
@@ -249,6 +322,9 @@ Resolver::Impl::NetCacheResult Resolver::Impl::QueryNetCache(
   result.addrs = cached->addrs;
   if (cached->expiration >= now) {
     ++source_counters_.cached;
+    UASSERT(cached->hits);
+    const auto hits = cached->hits->fetch_add(1, std::memory_order_relaxed) + 1;
+    if (hits >= hot_cache_threshold_) PromoteToHot(name, *cached);
   } else {
     ++source_counters_.cached_stale;
   }
@@ -270,6 +346,64 @@ void Resolver::Impl::AccountNetUpdateFailure() {
   ++source_counters_.network_failure;
 }
 
+void Resolver::Impl::PromoteToHot(const std::string& name,
+                                  const NetCacheEntry& entry) {
+  // the hits are kept if the hot tier is full, so that the name is promoted
+  // as soon as there is room for it
+  if (hot_cache_.SizeApprox() >= hot_cache_size_ || hot_cache_.Get(name)) {
+    return;
+  }
+  // the name has to earn its way back after it is evicted
+  entry.hits->store(0, std::memory_order_relaxed);
+
+  auto hot = std::make_shared<HotCacheEntry>();
+  hot->addrs = entry.addrs;
+  hot->expiration = entry.expiration;
+  // do not evict it before it had a chance to be used
+  hot->hits = 1;
+  hot_cache_.InsertOrAssign(name, std::move(hot));
+  ++net_cache_counters_.hot_promotions;
+  LOG_DEBUG() << "Name '" << name << "' is hot now";
+}
+
+void Resolver::Impl::UpdateHotEntry(
+    const std::string& name, const AddrVector& addrs,
+    std::chrono::steady_clock::time_point expiration) {
+  const auto old_hot = hot_cache_.Get(name);
+  if (!old_hot) return;
+
+  auto hot = std::make_shared<HotCacheEntry>();
+  hot->addrs = addrs;
+  hot->expiration = expiration;
+  hot->hits = old_hot->hits.load(std::memory_order_relaxed);
+  hot_cache_.InsertOrAssign(name, std::move(hot));
+}
+
+// Refreshes all the hot names that would otherwise expire before the next
+// pass at once and evicts the ones that were not used since the last pass
+void Resolver::Impl::PrefetchHotNames() {
+  const auto now = utils::datetime::MockSteadyNow();
+  for (const auto& [name, hot] : hot_cache_) {
+    if (hot->hits.exchange(0, std::memory_order_relaxed) == 0) {
+      LOG_DEBUG() << "Name '" << name << "' is not hot anymore";
+      hot_cache_.Erase(name);
+      ++net_cache_counters_.hot_evictions;
+      continue;
+    }
+
+    if (hot->expiration - now >=
+        net_cache_update_margin_ + hot_cache_prefetch_interval_) {
+      continue;
+    }
+
+    auto mutex = GetUpdateMutex(name);
+    std::unique_lock lock{mutex, std::defer_lock};
+    if (StartBackgroundQuery(lock, std::move(mutex), name)) {
+      ++net_cache_counters_.prefetches;
+    }
+  }
+}
+
 template <typename Mutex>
 AddrVector Resolver::Impl::DoForegroundQuery(std::unique_lock<Mutex>& lock,
                                              Mutex&& mutex,
@@ -278,6 +412,7 @@ AddrVector Resolver::Impl::DoForegroundQuery(std::unique_lock<Mutex>& lock,
   UINVARIANT(lock, "Foreground query doesn't have a lock");
   UASSERT(lock.mutex() == &mutex);
 
+  ++net_cache_counters_.misses;
   LOG_TRACE() << "Resolving '" << name << "' in foreground";
   auto future = net_resolver_.Resolve(name);
   auto future_status = future.wait_until(deadline);
@@ -297,18 +432,19 @@ AddrVector Resolver::Impl::DoForegroundQuery(std::unique_lock<Mutex>& lock,
 }
 
 template <typename Mutex>
-void Resolver::Impl::StartBackgroundQuery(std::unique_lock<Mutex>& lock,
+bool Resolver::Impl::StartBackgroundQuery(std::unique_lock<Mutex>& lock,
                                           Mutex&& mutex,
                                           const std::string& name) {
   UASSERT(lock.mutex() == &mutex);
   if (!lock && !lock.try_lock()) {
     LOG_TRACE() << "Record for '" << name << "' is already updating, skipping";
-    return;
+    return false;
   }
   LOG_TRACE() << "Updating record for '" << name << "' in background";
   auto future = net_resolver_.Resolve(name);
   MoveQueryToBackground(lock, std::forward<Mutex>(mutex), std::move(future),
                         name, FailureMode::kIgnore);
+  return true;
 }
 
 template <typename Mutex>
@@ -351,7 +487,8 @@ void Resolver::Impl::FinishNetUpdate(
       net_cache_.Put(name, NetCacheEntry{{},
                                          utils::datetime::MockSteadyNow() +
                                              net_cache_failure_ttl_,
-                                         true});
+                                         true, nullptr});
+      hot_cache_.Erase(name);
     }
     ++source_counters_.network_failure;
     throw;
@@ -364,11 +501,17 @@ void Resolver::Impl::FinishNetUpdate(
   if (addrs) *addrs = response.addrs;
   if (effective_ttl.count() > 0) {
     LOG_TRACE() << "Updating cache for '" << name << '\'';
-    net_cache_.Put(
-        name, NetCacheEntry{std::move(response.addrs),
-                            utils::datetime::MockSteadyNow() + effective_ttl});
+    const auto expiration = utils::datetime::MockSteadyNow() + effective_ttl;
+    UpdateHotEntry(name, response.addrs, expiration);
+    // keep counting hits across refreshes of the record
+    std::shared_ptr<std::atomic<size_t>> hits;
+    if (const auto old = net_cache_.Get(name)) hits = old->hits;
+    if (!hits) hits = std::make_shared<std::atomic<size_t>>(0);
+    net_cache_.Put(name, NetCacheEntry{std::move(response.addrs), expiration,
+                                       false, std::move(hits)});
   } else {
     LOG_TRACE() << "Skipping cache update for '" << name << '\'';
+    hot_cache_.Erase(name);
   }
   ++source_counters_.network;
 }
@@ -401,6 +544,11 @@ AddrVector Resolver::Resolve(const std::string& name,
     if (!file_addrs.empty()) return file_addrs;
   }
 
+  {
+    auto hot_addrs = impl_->QueryHotCache(name);
+    if (hot_addrs) return std::move(*hot_addrs);
+  }
+
   auto net_result = impl_->QueryNetCache(name);
 
   if (net_result.status == Impl::NetCacheResult::Status::kHitReply) {
@@ -447,8 +595,14 @@ const Resolver::LookupSourceCounters& Resolver::GetLookupSourceCounters()
   return impl_->GetLookupSourceCounters();
 }
 
+const Resolver::NetCacheCounters& Resolver::GetNetCacheCounters() const {
+  return impl_->GetNetCacheCounters();
+}
+
 void Resolver::ReloadHosts() { impl_->ReloadHosts(); }
 
+void Resolver::PrefetchHotNames() { impl_->ForcePrefetchHotNames(); }
+
 void Resolver::FlushNetworkCache() { impl_->FlushNetworkCache(); }
 
 void Resolver::FlushNetworkCache(const std::string& name) {
@@ -87,6 +87,8 @@ struct MockedResolver {
               config.cache_failure_ttl = std::chrono::seconds{cache_max_ttl},
               config.cache_ways = 1;
               config.cache_size_per_way = cache_size_per_way;
+              // passes are forced by the tests
+              config.cache_prefetch_interval = utest::kMaxTestWaitTime;
               config.network_custom_servers = {server_mock.GetServerAddress()};
               return config;
             }()} {}
@@ -517,4 +519,98 @@ UTEST(Resolver, FirstUpdateCombines) {
   EXPECT_EQ(counters.network_failure, 1);
 }
 
+UTEST(Resolver, HotNames) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  MockedResolver resolver{1, 1};
+
+  utils::datetime::MockNowSet({});
+
+  const auto hot_threshold = clients::dns::ResolverConfig{}.cache_hot_threshold;
+  for (size_t i = 0; i <= hot_threshold; ++i) {
+    EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                        (Expected{kNetV6String, kNetV4String}));
+  }
+
+  const auto& cache_counters = resolver->GetNetCacheCounters();
+  EXPECT_EQ(cache_counters.misses, 1);
+  EXPECT_EQ(cache_counters.hot_promotions, 1);
+  EXPECT_EQ(cache_counters.hot_hits, 0);
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+  EXPECT_EQ(cache_counters.hot_hits, 1);
+
+  const auto& counters = resolver->GetLookupSourceCounters();
+  EXPECT_EQ(counters.file, 0);
+  EXPECT_EQ(counters.cached, hot_threshold + 1);
+  EXPECT_EQ(counters.cached_stale, 0);
+  EXPECT_EQ(counters.cached_failure, 0);
+  EXPECT_GE(counters.network, 1);
+  EXPECT_EQ(counters.network_failure, 0);
+}
+
+UTEST(Resolver, HotNamesEvictedAndPromotedAgain) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  MockedResolver resolver{1000, 1};
+
+  const auto hot_threshold = clients::dns::ResolverConfig{}.cache_hot_threshold;
+  for (size_t i = 0; i <= hot_threshold; ++i) {
+    EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                        (Expected{kNetV6String, kNetV4String}));
+  }
+
+  const auto& cache_counters = resolver->GetNetCacheCounters();
+  EXPECT_EQ(cache_counters.hot_promotions, 1);
+
+  // The first pass forgives the promotion, the second one finds no lookups
+  resolver->PrefetchHotNames();
+  EXPECT_EQ(cache_counters.hot_evictions, 0);
+  resolver->PrefetchHotNames();
+  EXPECT_EQ(cache_counters.hot_evictions, 1);
+
+  // The name earns its way back
+  for (size_t i = 0; i < hot_threshold; ++i) {
+    EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                        (Expected{kNetV6String, kNetV4String}));
+  }
+  EXPECT_EQ(cache_counters.hot_promotions, 2);
+  EXPECT_EQ(cache_counters.hot_hits, 0);
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+  EXPECT_EQ(cache_counters.hot_hits, 1);
+  EXPECT_EQ(cache_counters.misses, 1);
+}
+
+UTEST(Resolver, HotNamesPrefetch) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  MockedResolver resolver{1, 1};
+
+  utils::datetime::MockNowSet({});
+
+  const auto hot_threshold = clients::dns::ResolverConfig{}.cache_hot_threshold;
+  for (size_t i = 0; i <= hot_threshold; ++i) {
+    EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                        (Expected{kNetV6String, kNetV4String}));
+  }
+
+  // The reply expires before the next pass, so it is refreshed right away
+  resolver->PrefetchHotNames();
+  const auto& cache_counters = resolver->GetNetCacheCounters();
+  EXPECT_EQ(cache_counters.prefetches, 1);
+
+  // A stale hot name is served without waiting for the name servers
+  utils::datetime::MockSleep(std::chrono::seconds{3});
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("hot", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+  EXPECT_EQ(cache_counters.hot_hits, 1);
+  EXPECT_EQ(cache_counters.misses, 1);
+}
+
 USERVER_NAMESPACE_END
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdlib>
+#include <exception>
 #include <limits>
 
 #include <moodycamel/concurrentqueue.h>
@@ -15,11 +16,13 @@
 #include <clients/http/destination_statistics.hpp>
 #include <clients/http/easy_wrapper.hpp>
 #include <clients/http/enforce_task_deadline_config.hpp>
+#include <clients/http/single_flight.hpp>
 #include <clients/http/statistics.hpp>
 #include <clients/http/testsuite.hpp>
 #include <crypto/openssl.hpp>
 #include <curl-ev/multi.hpp>
 #include <curl-ev/ratelimit.hpp>
+#include <curl-ev/share.hpp>
 #include <engine/ev/thread_pool.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -29,6 +32,11 @@ namespace {
 
 const std::string kIoThreadName = "curl";
 const auto kEasyReinitPeriod = std::chrono::minutes{1};
+const auto kMultiLoadUpdatePeriod = std::chrono::seconds{1};
+
+// A destination is moved to its alternative multi if the preferred one is
+// loaded that much more
+constexpr double kAffinitySpilloverLoadDiff = 0.2;
 
 // cURL accepts options as long, but we use size_t to avoid writing checks.
 // Clamp too high values to LONG_MAX, it shouldn't matter for these magnitudes.
@@ -36,6 +44,15 @@ long ClampToLong(size_t value) {
   return std::min<size_t>(value, std::numeric_limits<long>::max());
 }
 
+// Returns "host:port" part of the URL, userinfo included
+std::string_view GetUrlAuthority(std::string_view url) noexcept {
+  const auto scheme_end = url.find("://");
+  if (scheme_end != std::string_view::npos) {
+    url.remove_prefix(scheme_end + 3);
+  }
+  return url.substr(0, url.find_first_of("/?#"));
+}
+
 }  // namespace
 
 ClientSettings Parse(const yaml_config::YamlConfig& value,
@@ -45,6 +62,10 @@ ClientSettings Parse(const yaml_config::YamlConfig& value,
       value["thread-name-prefix"].As<std::string>(settings.thread_name_prefix);
   settings.io_threads = value["threads"].As<size_t>(settings.io_threads);
   settings.defer_events = value["defer-events"].As<bool>(settings.defer_events);
+  settings.destination_affinity = value["destination-affinity"].As<bool>(
+      settings.destination_affinity);
+  settings.share_tls_sessions =
+      value["share-tls-sessions"].As<bool>(settings.share_tls_sessions);
 
   return settings;
 }
@@ -53,6 +74,9 @@ Client::Client(ClientSettings settings,
                engine::TaskProcessor& fs_task_processor)
     : destination_statistics_(std::make_shared<DestinationStatistics>()),
       statistics_(settings.io_threads),
+      destination_affinity_(settings.destination_affinity),
+      multi_loads_(settings.io_threads),
+      single_flight_(std::make_shared<impl::SingleFlight>()),
       fs_task_processor_(fs_task_processor),
       user_agent_(utils::GetUserverIdentifier()),
       connect_rate_limiter_(std::make_shared<curl::ConnectRateLimiter>()) {
@@ -81,6 +105,19 @@ Client::Client(ClientSettings settings,
     }
   }).Get();
 
+  if (settings.share_tls_sessions) {
+    tls_session_share_ = std::make_shared<curl::share>();
+    tls_session_share_->set_share_ssl_session(true);
+  }
+
+  if (destination_affinity_) {
+    multi_load_update_task_.Start(
+        "http_multi_load_update",
+        utils::PeriodicTask::Settings(kMultiLoadUpdatePeriod, {},
+                                      logging::Level::kDebug),
+        [this] { UpdateMultiLoads(); });
+  }
+
   easy_reinit_task_.Start(
       "http_easy_reinit",
       utils::PeriodicTask::Settings(kEasyReinitPeriod,
@@ -92,6 +129,7 @@ Client::Client(ClientSettings settings,
 
 Client::~Client() {
   easy_reinit_task_.Stop();
+  multi_load_update_task_.Stop();
 
   // We have to destroy *this only when all the requests are finished, because
   // otherwise `multis_` and `thread_pool_` are destroyed and pending requests
@@ -119,6 +157,7 @@ std::shared_ptr<Request> Client::CreateRequest() {
 
   auto easy = TryDequeueIdle();
   if (easy) {
+    if (tls_session_share_) easy->set_share(tls_session_share_);
     auto idx = FindMultiIndex(easy->GetMulti());
     auto wrapper = std::make_shared<impl::EasyWrapper>(std::move(easy), *this);
     request = std::make_shared<Request>(std::move(wrapper),
@@ -131,8 +170,10 @@ std::shared_ptr<Request> Client::CreateRequest() {
     try {
       request = engine::AsyncNoSpan(fs_task_processor_, [this, &multi, &i] {
                   // GetBound() calls blocking Curl_resolver_init()
+                  auto bound = easy_.Get()->GetBoundBlocking(*multi);
+                  if (tls_session_share_) bound->set_share(tls_session_share_);
                   auto wrapper = std::make_shared<impl::EasyWrapper>(
-                      easy_.Get()->GetBoundBlocking(*multi), *this);
+                      std::move(bound), *this);
                   return std::make_shared<Request>(
                       std::move(wrapper), statistics_[i].CreateRequestStats(),
                       destination_statistics_, resolver_);
@@ -159,6 +200,7 @@ std::shared_ptr<Request> Client::CreateRequest() {
     request->proxy(*proxy_value);
   }
   request->SetEnforceTaskDeadline(enforce_task_deadline_.ReadCopy());
+  request->SetSingleFlight(single_flight_);
 
   return request;
 }
@@ -211,6 +253,56 @@ size_t Client::FindMultiIndex(const curl::multi* multi) const {
   throw std::logic_error("Unknown multi");
 }
 
+curl::multi* Client::FindMultiForUrl(std::string_view url) const noexcept {
+  if (!destination_affinity_ || multis_.size() < 2) return nullptr;
+
+  // Each destination gets a preferred and an alternative multi, so that
+  // a hot destination could use the keepalive connections of both of them.
+  const auto hash = std::hash<std::string_view>{}(GetUrlAuthority(url));
+  const auto preferred = hash % multis_.size();
+  auto alternative = (hash / multis_.size()) % (multis_.size() - 1);
+  if (alternative >= preferred) ++alternative;
+
+  const auto preferred_load =
+      multi_loads_[preferred].load(std::memory_order_relaxed);
+  const auto alternative_load =
+      multi_loads_[alternative].load(std::memory_order_relaxed);
+  if (preferred_load > alternative_load + kAffinitySpilloverLoadDiff) {
+    return multis_[alternative].get();
+  }
+  return multis_[preferred].get();
+}
+
+std::shared_ptr<curl::easy> Client::CloneEasyToAnotherMulti(
+    curl::easy& easy) {
+  const auto index = (FindMultiIndex(easy.GetMulti()) + 1) % multis_.size();
+  auto& multi = *multis_[index];
+
+  // libcurl handles must not be used concurrently, and the handle of the
+  // original attempt is used by its ev thread until the attempt finishes.
+  // CloneBlocking() calls Curl_resolver_init(), which is paid only for the
+  // hedged attempts that are actually sent.
+  std::shared_ptr<curl::easy> result;
+  std::exception_ptr exception;
+  easy.GetThreadControl().RunInEvLoopSync([&] {
+    try {
+      result = easy.CloneBlocking(multi);
+    } catch (const std::exception&) {
+      exception = std::current_exception();
+    }
+  });
+  if (exception) std::rethrow_exception(exception);
+  return result;
+}
+
+void Client::UpdateMultiLoads() {
+  for (size_t i = 0; i < multis_.size(); i++) {
+    multi_loads_[i].store(
+        multis_[i]->Statistics().get_busy_storage().GetCurrentLoad(),
+        std::memory_order_relaxed);
+  }
+}
+
 PoolStatistics Client::GetPoolStatistics() const {
   PoolStatistics stats;
   stats.multi.reserve(multis_.size());
@@ -178,6 +178,30 @@ struct EchoCallback {
   }
 };
 
+HttpResponse KeepAliveCallback(const HttpRequest& request) {
+  LOG_INFO() << "HTTP Server receive: " << request;
+  return {"HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+          HttpResponse::kWriteAndContinue};
+}
+
+struct CacheableCallback {
+  std::shared_ptr<std::size_t> requests = std::make_shared<std::size_t>(0);
+
+  HttpResponse operator()(const HttpRequest& request) const {
+    LOG_INFO() << "HTTP Server receive: " << request;
+    ++*requests;
+
+    // Give the identical requests time to arrive while this one is in flight
+    engine::InterruptibleSleepFor(kTimeout);
+
+    return {fmt::format("HTTP/1.1 200 OK\r\nConnection: close\r\n"
+                        "Cache-Control: max-age=60\r\n"
+                        "Content-Length: {}\r\n\r\n{}",
+                        std::size(kTestData) - 1, kTestData),
+            HttpResponse::kWriteAndClose};
+  }
+};
+
 struct ValidatingSharedCallback {
   const std::shared_ptr<std::string> method_name =
       std::make_shared<std::string>();
@@ -242,6 +266,20 @@ HttpResponse sleep_callback_1s(const HttpRequest& request) {
   return sleep_callback_base(request, std::chrono::seconds(1));
 }
 
+struct SlowFirstCallback {
+  std::shared_ptr<std::size_t> requests = std::make_shared<std::size_t>(0);
+
+  HttpResponse operator()(const HttpRequest& request) const {
+    if ((*requests)++ == 0) return sleep_callback(request);
+
+    LOG_INFO() << "HTTP Server receive: " << request;
+    return {
+        "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: "
+        "0\r\n\r\n",
+        HttpResponse::kWriteAndClose};
+  }
+};
+
 HttpResponse huge_data_callback(const HttpRequest& request) {
   LOG_INFO() << "HTTP Server receive: " << request;
 
@@ -399,16 +437,13 @@ struct ResolverWrapper {
           return file;
         }()},
         fs_task_processor{
-            {
-                "fs-task-processor",
-                false,
-                1,
-                "fs-worker",
-                engine::OsScheduling::kNormal,
-                1000,
-                0,
-                "",
-            },
+            [] {
+              engine::TaskProcessorConfig config;
+              config.name = "fs-task-processor";
+              config.worker_threads = 1;
+              config.thread_name = "fs-worker";
+              return config;
+            }(),
             engine::current_task::GetTaskProcessor().GetTaskProcessorPools()},
         resolver{fs_task_processor, [=] {
                    clients::dns::ResolverConfig config;
@@ -579,6 +614,144 @@ UTEST(HttpClient, PostEcho) {
   }
 }
 
+UTEST(HttpClient, DestinationAffinity) {
+  const utest::SimpleServer http_server{&KeepAliveCallback};
+
+  clients::http::ClientSettings settings;
+  settings.io_threads = 4;
+  settings.destination_affinity = true;
+  settings.share_tls_sessions = true;
+  clients::http::Client http_client{settings,
+                                    engine::current_task::GetTaskProcessor()};
+
+  for (unsigned i = 0; i < kFewRepetitions; ++i) {
+    const auto response = http_client.CreateRequest()
+                              ->get(http_server.GetBaseUrl())
+                              ->retry(1)
+                              ->timeout(kTimeout)
+                              ->perform();
+    EXPECT_EQ(response->status_code(), 200);
+
+    // All the requests go to the same IO thread and reuse its connection
+    if (i != 0) {
+      EXPECT_EQ(response->GetStats().open_socket_count, 0) << i;
+    }
+  }
+}
+
+UTEST(HttpClient, Coalescing) {
+  const CacheableCallback callback;
+  const utest::SimpleServer http_server{callback};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  const auto create_request = [&](std::chrono::milliseconds max_cache_age,
+                                  const std::string& header_value) {
+    return http_client_ptr->CreateRequest()
+        ->get(http_server.GetBaseUrl())
+        ->headers({{kTestHeader, header_value}})
+        ->timeout(utest::kMaxTestWaitTime)
+        ->EnableCoalescing({{kTestHeader}, max_cache_age});
+  };
+
+  std::vector<std::shared_ptr<clients::http::Request>> requests;
+  for (unsigned i = 0; i < kFewRepetitions; ++i) {
+    requests.push_back(create_request(std::chrono::milliseconds{0}, "same"));
+  }
+  requests.push_back(create_request(std::chrono::milliseconds{0}, "other"));
+
+  std::vector<clients::http::ResponseFuture> futures;
+  for (auto& request : requests) futures.push_back(request->async_perform());
+  for (auto& future : futures) {
+    const auto response = future.Get();
+    EXPECT_EQ(response->status_code(), 200);
+    EXPECT_EQ(response->body(), kTestData);
+  }
+  EXPECT_EQ(*callback.requests, 2);
+
+  // Without max_cache_age the response is not reused after it is received
+  EXPECT_EQ(create_request(std::chrono::milliseconds{0}, "same")
+                ->perform()
+                ->body(),
+            kTestData);
+  EXPECT_EQ(*callback.requests, 3);
+
+  for (unsigned i = 0; i < kFewRepetitions; ++i) {
+    const auto response =
+        create_request(std::chrono::minutes{1}, "same")->perform();
+    EXPECT_EQ(response->body(), kTestData);
+  }
+  EXPECT_EQ(*callback.requests, 4);
+}
+
+UTEST(HttpClient, CoalescingLeaderCancelled) {
+  const CacheableCallback callback;
+  const utest::SimpleServer http_server{callback};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  const auto create_request = [&] {
+    return http_client_ptr->CreateRequest()
+        ->get(http_server.GetBaseUrl())
+        ->timeout(utest::kMaxTestWaitTime)
+        ->EnableCoalescing();
+  };
+
+  auto leader = create_request()->async_perform();
+  auto follower = create_request()->async_perform();
+
+  // The shared request keeps running for the follower
+  leader.Cancel();
+  const auto response = follower.Get();
+  EXPECT_EQ(response->status_code(), 200);
+  EXPECT_EQ(response->body(), kTestData);
+  EXPECT_EQ(*callback.requests, 1);
+
+  // The request is cancelled once every caller has left, the next identical
+  // request is issued anew
+  leader = create_request()->async_perform();
+  follower = create_request()->async_perform();
+  follower.Cancel();
+  leader.Cancel();
+  EXPECT_EQ(create_request()->perform()->body(), kTestData);
+}
+
+UTEST(HttpClient, Hedging) {
+  const SlowFirstCallback callback;
+  const utest::SimpleServer http_server{callback};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  clients::http::HedgingSettings hedging;
+  hedging.delay = kTimeout;
+  hedging.max_hedges_percent = 100;
+
+  const auto response = http_client_ptr->CreateRequest()
+                            ->get(http_server.GetBaseUrl())
+                            ->timeout(utest::kMaxTestWaitTime)
+                            ->EnableHedging(hedging)
+                            ->perform();
+  EXPECT_EQ(response->status_code(), 200);
+  EXPECT_EQ(*callback.requests, 2);
+}
+
+UTEST(HttpClient, HedgingReusedRequest) {
+  const SlowFirstCallback callback;
+  const utest::SimpleServer http_server{callback};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  clients::http::HedgingSettings hedging;
+  hedging.delay = kTimeout;
+  hedging.max_hedges_percent = 100;
+
+  auto request = http_client_ptr->CreateRequest()
+                     ->get(http_server.GetBaseUrl())
+                     ->timeout(utest::kMaxTestWaitTime)
+                     ->EnableHedging(hedging);
+  EXPECT_EQ(request->perform()->status_code(), 200);
+
+  // The original attempt is finished by the time the hedged one wins
+  EXPECT_EQ(request->perform()->status_code(), 200);
+  EXPECT_EQ(*callback.requests, 3);
+}
+
 UTEST(HttpClient, StatsOnTimeout) {
   const int kRetries = 5;
   const utest::SimpleServer http_server{&sleep_callback};
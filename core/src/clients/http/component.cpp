@@ -129,6 +129,14 @@ properties:
         type: boolean
         description: whether to defer events execution to a periodic timer; might affect timings a bit, might boost performance, use with care
         defaultDescription: false
+    destination-affinity:
+        type: boolean
+        description: perform requests to the same host:port on the same IO thread to reuse its keepalive connections, spill over to another thread if that one is overloaded
+        defaultDescription: false
+    share-tls-sessions:
+        type: boolean
+        description: share TLS session cache between the IO threads to resume TLS sessions instead of full handshakes
+        defaultDescription: false
     fs-task-processor:
         type: string
         description: task processor to run blocking HTTP related calls, like DNS resolving or hosts reading
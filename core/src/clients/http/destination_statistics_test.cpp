@@ -105,4 +105,37 @@ UTEST(DestinationStatistics, Multiple) {
   }
 }
 
+UTEST(DestinationStatistics, Hedging) {
+  const utest::SimpleServer http_server{
+      [](const HttpRequest& request) { return Callback(200, request); }};
+  auto client = utest::CreateHttpClient();
+
+  // The hedging budget is kept per destination regardless of the limit
+  client->SetDestinationMetricsAutoMaxSize(0);
+
+  clients::http::HedgingSettings hedging;
+  hedging.delay = utest::kMaxTestWaitTime;
+
+  const auto url = http_server.GetBaseUrl();
+  auto response = client->CreateRequest()
+                      ->get(url)
+                      ->timeout(utest::kMaxTestWaitTime)
+                      ->EnableHedging(hedging)
+                      ->perform();
+
+  const auto& dest_stats = client->GetDestinationStatistics();
+  size_t size = 0;
+  for (const auto& [stat_url, stat_ptr] : dest_stats) {
+    ASSERT_EQ(1, ++size);
+
+    EXPECT_EQ(url, stat_url);
+    ASSERT_NE(nullptr, stat_ptr);
+
+    auto stats = clients::http::InstanceStatistics(*stat_ptr);
+    auto ok = static_cast<size_t>(clients::http::Statistics::ErrorGroup::kOk);
+    EXPECT_EQ(1, stats.error_count[ok]);
+  }
+  EXPECT_EQ(1, size);
+}
+
 USERVER_NAMESPACE_END
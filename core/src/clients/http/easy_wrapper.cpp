@@ -17,6 +17,16 @@ EasyWrapper::~EasyWrapper() { client_.PushIdleEasy(std::move(easy_)); }
 
 curl::easy& EasyWrapper::Easy() { return *easy_; }
 
+void EasyWrapper::BindToDestination() {
+  auto* multi = client_.FindMultiForUrl(easy_->get_original_url());
+  if (multi) easy_->SetMulti(*multi);
+}
+
+std::shared_ptr<EasyWrapper> EasyWrapper::CloneToAnotherMulti() {
+  return std::make_shared<EasyWrapper>(client_.CloneEasyToAnotherMulti(*easy_),
+                                       client_);
+}
+
 }  // namespace clients::http::impl
 
 USERVER_NAMESPACE_END
@@ -25,6 +25,15 @@ class EasyWrapper final {
 
   curl::easy& Easy();
 
+  /// Rebinds the easy to the multi that performs the requests to the URL
+  /// destination, if the client has destination affinity enabled. Must not be
+  /// called while the request is performed.
+  void BindToDestination();
+
+  /// Creates a wrapper of a clone of the easy, bound to another multi of the
+  /// client, that performs the same request independently of this one.
+  std::shared_ptr<EasyWrapper> CloneToAnotherMulti();
+
  private:
   std::shared_ptr<curl::easy> easy_;
   Client& client_;
@@ -209,10 +209,26 @@ Request::Request(std::shared_ptr<impl::EasyWrapper>&& wrapper,
 }
 
 ResponseFuture Request::async_perform() {
-  return {pimpl_->async_perform(),
-          std::chrono::milliseconds(
-              complete_timeout(pimpl_->timeout(), pimpl_->retries())),
-          pimpl_};
+  const std::chrono::milliseconds total_timeout{
+      complete_timeout(pimpl_->timeout(), pimpl_->retries())};
+
+  auto coalesced = pimpl_->TryJoinCoalesced();
+  if (coalesced) {
+    // Cancellation of the future leaves the shared request rather than
+    // cancels it, see RequestState::Abandon()
+    return {std::move(coalesced->future), total_timeout,
+            std::move(coalesced->request)};
+  }
+
+  try {
+    if (pimpl_->ShouldHedge()) {
+      return {pimpl_->async_perform_hedged(), total_timeout, pimpl_};
+    }
+    return {pimpl_->async_perform(), total_timeout, pimpl_};
+  } catch (const std::exception&) {
+    pimpl_->ReleaseCoalesced(std::current_exception());
+    throw;
+  }
 }
 
 StreamedResponse Request::async_perform_stream_body(
@@ -361,6 +377,7 @@ std::shared_ptr<Request> Request::cookies(const Cookies& cookies) {
 }
 
 std::shared_ptr<Request> Request::method(HttpMethod method) {
+  pimpl_->SetMethod(method);
   switch (method) {
     case HttpMethod::kDelete:
     case HttpMethod::kOptions:
@@ -475,12 +492,29 @@ std::shared_ptr<Request> Request::DisableAddClientTimeoutHeader() {
   return shared_from_this();
 }
 
+std::shared_ptr<Request> Request::EnableCoalescing(
+    CoalescingSettings settings) {
+  pimpl_->EnableCoalescing(std::move(settings));
+  return shared_from_this();
+}
+
+std::shared_ptr<Request> Request::EnableHedging(HedgingSettings settings) {
+  pimpl_->EnableHedging(std::move(settings));
+  return shared_from_this();
+}
+
 std::shared_ptr<Request> Request::SetEnforceTaskDeadline(
     EnforceTaskDeadlineConfig enforce_task_deadline) {
   pimpl_->SetEnforceTaskDeadline(enforce_task_deadline);
   return shared_from_this();
 }
 
+std::shared_ptr<Request> Request::SetSingleFlight(
+    std::shared_ptr<impl::SingleFlight> single_flight) {
+  pimpl_->SetSingleFlight(std::move(single_flight));
+  return shared_from_this();
+}
+
 const std::string& Request::GetUrl() const {
   return pimpl_->easy().get_original_url();
 }
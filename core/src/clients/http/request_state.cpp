@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <chrono>
 #include <map>
+#include <mutex>
 #include <string_view>
 
 #include <fmt/chrono.h>
@@ -14,6 +15,8 @@
 #include <boost/range/adaptor/transformed.hpp>
 
 #include <userver/clients/dns/resolver.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/task/task.hpp>
 #include <userver/server/request/task_inherited_data.hpp>
 #include <userver/utils/algo.hpp>
 #include <userver/utils/assert.hpp>
@@ -252,6 +255,7 @@ void RequestState::Cancel() {
   // We can not call `retry_.timer.reset();` here because of data race
   is_cancelled_ = true;
   easy().cancel();
+  if (hedged_race_ && !is_hedge_) hedged_race_->CancelHedge();
 }
 
 void RequestState::SetDestinationMetricNameAuto(std::string destination) {
@@ -272,6 +276,7 @@ void RequestState::SetAllowedUrlsExtra(const std::vector<std::string>& urls) {
 }
 
 void RequestState::DisableReplyDecoding() {
+  reply_decoding_disabled_ = true;
   easy().set_accept_encoding(nullptr);
 }
 
@@ -288,6 +293,352 @@ void RequestState::SetEnforceTaskDeadline(
   enforce_task_deadline_ = enforce_task_deadline;
 }
 
+void RequestState::SetSingleFlight(
+    std::shared_ptr<impl::SingleFlight> single_flight) {
+  single_flight_ = std::move(single_flight);
+}
+
+void RequestState::EnableCoalescing(CoalescingSettings settings) {
+  coalescing_ = std::move(settings);
+}
+
+std::optional<impl::SingleFlight::JoinResult>
+RequestState::TryJoinCoalesced() {
+  UASSERT(coalescing_key_.empty());
+  if (!coalescing_ || !single_flight_ || !IsIdempotentWithoutBody()) {
+    return std::nullopt;
+  }
+
+  auto key = MakeCoalescingKey();
+  auto joined = single_flight_->Join(key, shared_from_this());
+  switch (joined.kind) {
+    case impl::SingleFlight::JoinKind::kIssue:
+      coalescing_key_ = std::move(key);
+      coalescing_pending_ = true;
+      WithRequestStats([](RequestStats& stats) { stats.AccountIssued(); });
+      return std::nullopt;
+    case impl::SingleFlight::JoinKind::kCoalesced:
+      WithRequestStats([](RequestStats& stats) { stats.AccountCoalesced(); });
+      break;
+    case impl::SingleFlight::JoinKind::kCached:
+      WithRequestStats(
+          [](RequestStats& stats) { stats.AccountCoalescedFromCache(); });
+      break;
+  }
+  return joined;
+}
+
+void RequestState::ReleaseCoalesced(const Response& response) noexcept {
+  if (!coalescing_pending_.exchange(false)) return;
+  UASSERT(single_flight_ && coalescing_);
+  single_flight_->Complete(coalescing_key_, *this, response,
+                           coalescing_->max_cache_age);
+}
+
+void RequestState::ReleaseCoalesced(std::exception_ptr exception) noexcept {
+  if (!coalescing_pending_.exchange(false)) return;
+  UASSERT(single_flight_);
+  single_flight_->Fail(coalescing_key_, *this, std::move(exception));
+}
+
+void RequestState::Abandon() {
+  if (!coalescing_key_.empty() &&
+      !single_flight_->Leave(coalescing_key_, *this)) {
+    // The request keeps running for the identical requests
+    return;
+  }
+  Cancel();
+}
+
+bool RequestState::IsIdempotentWithoutBody() const {
+  return (method_ == HttpMethod::kGet || method_ == HttpMethod::kHead) &&
+         !easy().has_post_data();
+}
+
+std::string RequestState::MakeCoalescingKey() const {
+  UASSERT(coalescing_);
+  std::string key = method_ == HttpMethod::kHead ? "HEAD " : "GET ";
+  key += easy().get_original_url();
+  for (const auto& name : coalescing_->key_headers) {
+    key += '\n';
+    key += name;
+    const auto value = easy().FindHeaderByName(name);
+    if (value) {
+      key += ": ";
+      key += *value;
+    }
+  }
+  return key;
+}
+
+void RequestState::EnableHedging(HedgingSettings settings) {
+  hedging_ = std::move(settings);
+}
+
+bool RequestState::ShouldHedge() const {
+  return hedging_ && IsIdempotentWithoutBody();
+}
+
+struct RequestState::Outcome {
+  std::shared_ptr<Response> response;
+  std::exception_ptr exception;
+
+  bool IsSuccessful() const {
+    return response && static_cast<int>(response->status_code()) < 500;
+  }
+};
+
+// Races the original attempt of a hedged request against its hedged attempt.
+// The attempts report their outcomes from the ev threads and the hedged
+// attempt is created and sent by a task started by a timer, so no task waits
+// for the race and no hedged attempt is prepared in vain.
+struct RequestState::HedgedRace final
+    : public std::enable_shared_from_this<HedgedRace> {
+  HedgedRace(const std::shared_ptr<RequestState>& primary,
+             engine::TaskProcessor& task_processor)
+      : primary(primary), task_processor(task_processor) {}
+
+  void OnHedgeTimer(std::error_code err);
+  void SendHedge();
+  void AbandonHedge();
+  void CancelHedge();
+  void Report(RequestState& attempt, Outcome&& outcome);
+  void Settle(Outcome&& result, bool hedge_won);
+
+  const std::weak_ptr<RequestState> primary;
+  engine::TaskProcessor& task_processor;
+
+  std::mutex mutex;
+  /// is set once the hedged attempt is created and reset once the race is
+  /// settled, as the hedge refers to the race
+  std::shared_ptr<RequestState> hedge;
+  bool hedge_sent{false};
+  bool settled{false};
+  /// failed original attempt that waits for the hedged one
+  std::optional<Outcome> primary_outcome;
+  /// outcome of the hedged attempt that came before the original one
+  std::optional<Outcome> hedge_outcome;
+};
+
+void RequestState::HedgedRace::OnHedgeTimer(std::error_code err) {
+  if (err) return;
+  const auto holder = primary.lock();
+  if (!holder) return;
+
+  {
+    std::lock_guard lock(mutex);
+    if (settled || holder->is_cancelled_) return;
+    if (!holder->GetHedgingStats().TryAcquireHedge()) {
+      holder->WithRequestStats(
+          [](RequestStats& stats) { stats.AccountHedgeThrottled(); });
+      return;
+    }
+    hedge_sent = true;
+  }
+
+  // The attempt is cloned, starts a span and may resolve the destination, so
+  // it is created and sent from a task rather than from the ev thread
+  engine::AsyncNoSpan(task_processor, [self = shared_from_this()] {
+    self->SendHedge();
+  }).Detach();
+}
+
+void RequestState::HedgedRace::SendHedge() {
+  std::shared_ptr<RequestState> attempt;
+  try {
+    const auto holder = primary.lock();
+    if (!holder) return;
+    attempt = holder->CreateHedge();
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "Failed to create a hedged attempt: " << ex;
+    AbandonHedge();
+    return;
+  }
+
+  {
+    std::lock_guard lock(mutex);
+    if (settled) return;
+    hedge = attempt;
+    attempt->hedged_race_ = shared_from_this();
+  }
+
+  try {
+    [[maybe_unused]] auto future = attempt->PerformBuffered();
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "Failed to send a hedged attempt of "
+                  << attempt->easy().get_original_url() << ": " << ex;
+    Report(*attempt, {{}, std::current_exception()});
+    return;
+  }
+
+  if (const auto holder = primary.lock()) {
+    holder->WithRequestStats([](RequestStats& stats) { stats.AccountHedge(); });
+  }
+}
+
+void RequestState::HedgedRace::AbandonHedge() {
+  std::optional<Outcome> result;
+  {
+    std::lock_guard lock(mutex);
+    if (settled) return;
+
+    // The original attempt does not wait for the hedged one anymore
+    hedge_sent = false;
+    if (!primary_outcome) return;
+    result = std::move(primary_outcome);
+    settled = true;
+  }
+  Settle(std::move(*result), /*hedge_won=*/false);
+}
+
+void RequestState::HedgedRace::CancelHedge() {
+  std::shared_ptr<RequestState> attempt;
+  {
+    std::lock_guard lock(mutex);
+    if (settled || !hedge_sent || hedge_outcome) return;
+    attempt = hedge;
+  }
+  // The hedged attempt that is being created is dropped once the race is
+  // settled by the cancelled original attempt
+  if (attempt) attempt->Cancel();
+}
+
+void RequestState::HedgedRace::Report(RequestState& attempt,
+                                      Outcome&& outcome) {
+  std::shared_ptr<RequestState> loser;
+  std::optional<Outcome> result;
+  bool hedge_won = false;
+  {
+    std::lock_guard lock(mutex);
+    if (settled) return;
+
+    if (!attempt.is_hedge_) {
+      if (hedge_outcome && hedge_outcome->IsSuccessful()) {
+        // The original attempt was cancelled as the hedged one won
+        result = std::move(hedge_outcome);
+        hedge_won = true;
+      } else if (outcome.IsSuccessful() || attempt.is_cancelled_ ||
+                 !hedge_sent || hedge_outcome) {
+        // The hedged attempt may be still created, it is dropped then
+        if (hedge_sent && !hedge_outcome) loser = hedge;
+        result = std::move(outcome);
+      } else {
+        primary_outcome = std::move(outcome);
+      }
+    } else if (primary_outcome) {
+      hedge_won = outcome.IsSuccessful();
+      result = hedge_won ? std::move(outcome) : std::move(primary_outcome);
+    } else {
+      // The request may be reused as soon as the outcome is set, so the
+      // original attempt has to finish first
+      if (outcome.IsSuccessful()) loser = primary.lock();
+      hedge_outcome = std::move(outcome);
+    }
+
+    if (result) {
+      settled = true;
+      hedge.reset();
+    }
+  }
+
+  if (loser) loser->Cancel();
+  if (result) Settle(std::move(*result), hedge_won);
+}
+
+void RequestState::HedgedRace::Settle(Outcome&& result, bool hedge_won) {
+  const auto holder = primary.lock();
+  if (!holder) return;
+  if (hedge_won) {
+    holder->WithRequestStats(
+        [](RequestStats& stats) { stats.AccountHedgeWon(); });
+  }
+  holder->FulfillPromise(std::move(result));
+}
+
+engine::Future<std::shared_ptr<Response>> RequestState::async_perform_hedged() {
+  UASSERT(hedging_);
+  GetHedgingStats().EarnHedge(hedging_->max_hedges_percent);
+
+  if (const auto* span = tracing::Span::CurrentSpanUnchecked()) {
+    span_parent_ = SpanParent{span->GetTraceId(), span->GetSpanId()};
+  } else {
+    span_parent_.reset();
+  }
+
+  // The hedged attempt is created only when the timer fires, see
+  // StartHedgeTimer()
+  hedged_race_ = std::make_shared<HedgedRace>(
+      shared_from_this(), engine::current_task::GetTaskProcessor());
+  try {
+    return PerformBuffered();
+  } catch (const std::exception&) {
+    hedged_race_.reset();
+    throw;
+  }
+}
+
+void RequestState::StartHedgeTimer() {
+  if (!hedged_race_ || is_hedge_ || retry_.current != 1) return;
+
+  // The timer is started right before the request is handed to its ev
+  // thread, which also runs the timer and clones the easy handle for the
+  // hedged attempt, so nothing else modifies the handle by then
+  hedge_timer_.emplace(easy().GetThreadControl());
+  hedge_timer_->SingleshotAsync(
+      GetHedgingDelay(), [race = hedged_race_](std::error_code err) {
+        race->OnHedgeTimer(err);
+      });
+}
+
+std::shared_ptr<RequestState> RequestState::CreateHedge() {
+  auto hedge = std::make_shared<RequestState>(
+      easy_->CloneToAnotherMulti(), stats_->CreateSibling(), dest_stats_,
+      resolver_);
+  hedge->is_hedge_ = true;
+  hedge->span_parent_ = span_parent_;
+
+  hedge->dest_req_stats_ = GetHedgingStats().CreateSibling();
+  hedge->destination_metric_name_ = destination_metric_name_;
+  hedge->testsuite_config_ = testsuite_config_;
+  hedge->allowed_urls_extra_ = allowed_urls_extra_;
+
+  hedge->pkey_ = pkey_;
+  hedge->cert_ = cert_;
+  hedge->ca_ = ca_;
+  if (ca_ || cert_) {
+    hedge->easy().set_ssl_ctx_function(&RequestState::on_certificate_request);
+    hedge->easy().set_ssl_ctx_data(hedge.get());
+  }
+  if (reply_decoding_disabled_) hedge->DisableReplyDecoding();
+
+  hedge->original_timeout_ = original_timeout_;
+  hedge->add_client_timeout_header_ = add_client_timeout_header_;
+  hedge->enforce_task_deadline_ = enforce_task_deadline_;
+  hedge->deadline_ = deadline_;
+  hedge->log_url_ = log_url_;
+  hedge->proxy_url_ = proxy_url_;
+  hedge->method_ = method_;
+  return hedge;
+}
+
+std::chrono::milliseconds RequestState::GetHedgingDelay() {
+  UASSERT(hedging_);
+  if (!hedging_->delay_percentile) return hedging_->delay;
+  return std::max(hedging_->delay, GetHedgingStats().GetRecentTimingPercentile(
+                                       *hedging_->delay_percentile));
+}
+
+RequestStats& RequestState::GetHedgingStats() {
+  // The hedging budget and the timings are kept per destination, so a hedged
+  // request gets the destination statistics even over the limit of the
+  // automatically created ones
+  if (!dest_req_stats_) {
+    dest_req_stats_ =
+        dest_stats_->GetStatisticsForDestination(destination_metric_name_);
+  }
+  return *dest_req_stats_;
+}
+
 size_t RequestState::on_header(void* ptr, size_t size, size_t nmemb,
                                void* userdata) {
   auto* self = static_cast<RequestState*>(userdata);
@@ -385,7 +736,7 @@ void RequestState::on_completed(std::shared_ptr<RequestState> holder,
     if (buffered_data) {
       const auto cleanup_request = holder->response_move();
       holder->span_storage_.reset();
-      buffered_data->promise_.set_exception(holder->PrepareException(err));
+      holder->SetBufferedException(holder->PrepareException(err));
     } else {
       UASSERT(stream_data);
       holder->span_storage_.reset();
@@ -400,7 +751,7 @@ void RequestState::on_completed(std::shared_ptr<RequestState> holder,
 
     holder->span_storage_.reset();
     if (buffered_data) {
-      buffered_data->promise_.set_value(holder->response_move());
+      holder->SetBufferedOutcome({holder->response_move(), {}});
     } else {
       stream_data->headers_promise.set_value();
     }
@@ -501,6 +852,11 @@ void RequestState::parse_header(char* ptr, size_t size) {
 void RequestState::SetLoggedUrl(std::string url) { log_url_ = std::move(url); }
 
 engine::Future<std::shared_ptr<Response>> RequestState::async_perform() {
+  hedged_race_.reset();
+  return PerformBuffered();
+}
+
+engine::Future<std::shared_ptr<Response>> RequestState::PerformBuffered() {
   data_ = FullBufferedData{};
 
   StartNewSpan();
@@ -524,6 +880,7 @@ engine::Future<std::shared_ptr<Response>> RequestState::async_perform() {
 }
 
 void RequestState::async_perform_stream(const std::shared_ptr<Queue>& queue) {
+  hedged_race_.reset();
   data_ = StreamData(queue->GetProducer());
 
   StartNewSpan();
@@ -551,8 +908,6 @@ void RequestState::perform_request(curl::easy::handler_type handler) {
   UASSERT_MSG(!cert_ || pkey_,
               "Setting certificate is useless without setting private key");
 
-  auto* buffered_data = std::get_if<FullBufferedData>(&data_);
-
   UASSERT(response_);
   response_->sink_string().clear();
   response_->body().clear();
@@ -560,30 +915,59 @@ void RequestState::perform_request(curl::easy::handler_type handler) {
   UpdateTimeoutFromDeadline();
   SetEasyTimeout(effective_timeout_);
   if (effective_timeout_ <= std::chrono::milliseconds{0}) {
-    buffered_data->promise_.set_exception(
-        PrepareDeadlineAlreadyPassedException());
+    SetBufferedException(PrepareDeadlineAlreadyPassedException());
     return;
   }
   UpdateTimeoutHeader();
 
+  // Retries are started from the ev thread of the current multi and keep it
+  // Hedged attempts are deliberately performed on another ev thread
+  if (retry_.current == 1 && !is_hedge_) easy_->BindToDestination();
+
   if (resolver_ && retry_.current == 1) {
-    engine::AsyncNoSpan([this, holder = shared_from_this(), buffered_data,
+    engine::AsyncNoSpan([this, holder = shared_from_this(),
                          handler = std::move(handler)]() mutable {
       try {
         ResolveTargetAddress(*resolver_);
+        StartHedgeTimer();
         easy().async_perform(std::move(handler));
       } catch (const clients::dns::ResolverException& ex) {
         // TODO: should retry - TAXICOMMON-4932
-        buffered_data->promise_.set_exception(std::make_exception_ptr(ex));
+        SetBufferedException(std::make_exception_ptr(ex));
       } catch (const BaseException& ex) {
-        buffered_data->promise_.set_exception(std::make_exception_ptr(ex));
+        SetBufferedException(std::make_exception_ptr(ex));
       }
     }).Detach();
   } else {
+    StartHedgeTimer();
     easy().async_perform(std::move(handler));
   }
 }
 
+void RequestState::SetBufferedException(std::exception_ptr exception) {
+  SetBufferedOutcome({{}, std::move(exception)});
+}
+
+void RequestState::SetBufferedOutcome(Outcome&& outcome) {
+  if (hedged_race_) {
+    hedged_race_->Report(*this, std::move(outcome));
+  } else {
+    FulfillPromise(std::move(outcome));
+  }
+}
+
+void RequestState::FulfillPromise(Outcome&& outcome) {
+  auto* buffered_data = std::get_if<FullBufferedData>(&data_);
+  UASSERT(buffered_data);
+  if (outcome.response) {
+    ReleaseCoalesced(*outcome.response);
+    buffered_data->promise_.set_value(std::move(outcome.response));
+  } else {
+    ReleaseCoalesced(outcome.exception);
+    buffered_data->promise_.set_exception(std::move(outcome.exception));
+  }
+}
+
 void RequestState::SetEasyTimeout(std::chrono::milliseconds timeout) {
   UASSERT_MSG(
       timeout >= std::chrono::seconds{0},
@@ -743,7 +1127,13 @@ void RequestState::StartNewSpan() {
       !span_storage_,
       "Attempt to reuse request while the previous one has not finished");
 
-  span_storage_.emplace(std::string{kTracingClientName});
+  if (span_parent_) {
+    span_storage_.emplace(std::string{kTracingClientName},
+                          std::string{span_parent_->trace_id},
+                          std::string{span_parent_->span_id});
+  } else {
+    span_storage_.emplace(std::string{kTracingClientName});
+  }
   auto& span = span_storage_->Get();
   SetTracingHeader(easy(), USERVER_NAMESPACE::http::headers::kXYaSpanId,
                    span.GetSpanId());
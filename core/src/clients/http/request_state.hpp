@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdlib>
 #include <optional>
 #include <string>
@@ -9,6 +10,7 @@
 #include <userver/clients/dns/resolver_fwd.hpp>
 #include <userver/clients/http/error.hpp>
 #include <userver/clients/http/form.hpp>
+#include <userver/clients/http/request.hpp>
 #include <userver/clients/http/response_future.hpp>
 #include <userver/concurrent/queue.hpp>
 #include <userver/crypto/certificate.hpp>
@@ -24,6 +26,7 @@
 #include <clients/http/destination_statistics.hpp>
 #include <clients/http/easy_wrapper.hpp>
 #include <clients/http/enforce_task_deadline_config.hpp>
+#include <clients/http/single_flight.hpp>
 #include <clients/http/testsuite.hpp>
 #include <crypto/helpers.hpp>
 #include <engine/ev/watcher/timer_watcher.hpp>
@@ -100,6 +103,28 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
   void DisableAddClientTimeoutHeader();
   void SetEnforceTaskDeadline(EnforceTaskDeadlineConfig enforce_task_deadline);
 
+  void SetMethod(HttpMethod method) { method_ = method; }
+  void SetSingleFlight(std::shared_ptr<impl::SingleFlight> single_flight);
+  void EnableCoalescing(CoalescingSettings settings);
+
+  void EnableHedging(HedgingSettings settings);
+  bool ShouldHedge() const;
+  /// Perform async http request, racing it against a hedged attempt if there
+  /// is no response for too long
+  engine::Future<std::shared_ptr<Response>> async_perform_hedged();
+
+  /// Returns the future of an identical request and that request, if any,
+  /// if the request should not be performed. Registers the request as the one
+  /// to perform otherwise.
+  std::optional<impl::SingleFlight::JoinResult> TryJoinCoalesced();
+  /// Passes the outcome of the performed request to the identical requests
+  void ReleaseCoalesced(const Response& response) noexcept;
+  void ReleaseCoalesced(std::exception_ptr exception) noexcept;
+
+  /// Called when a caller is no longer interested in the response. Cancels
+  /// the request unless the coalesced identical requests still wait for it.
+  void Abandon();
+
   std::shared_ptr<impl::EasyWrapper> easy_wrapper() { return easy_; }
 
   curl::easy& easy() { return easy_->Easy(); }
@@ -143,6 +168,21 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
   std::exception_ptr PrepareException(std::error_code err);
   std::exception_ptr PrepareDeadlinePassedException(std::string_view url);
 
+  bool IsIdempotentWithoutBody() const;
+  std::string MakeCoalescingKey() const;
+
+  struct Outcome;
+  struct HedgedRace;
+  std::shared_ptr<RequestState> CreateHedge();
+  void StartHedgeTimer();
+  std::chrono::milliseconds GetHedgingDelay();
+  RequestStats& GetHedgingStats();
+  void SetBufferedException(std::exception_ptr exception);
+  /// passes the outcome to the hedging race, if any, or to the promise
+  void SetBufferedOutcome(Outcome&& outcome);
+  void FulfillPromise(Outcome&& outcome);
+
+  engine::Future<std::shared_ptr<Response>> PerformBuffered();
   engine::Future<std::shared_ptr<Response>> StartNewPromise();
   void ApplyTestsuiteConfig();
   void StartNewSpan();
@@ -204,6 +244,32 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
   clients::dns::Resolver* resolver_{nullptr};
   std::string proxy_url_;
 
+  HttpMethod method_{HttpMethod::kGet};
+  std::shared_ptr<impl::SingleFlight> single_flight_;
+  std::optional<CoalescingSettings> coalescing_;
+  /// key of the performed request the identical requests wait for, if any,
+  /// is not changed after the request is issued
+  std::string coalescing_key_;
+  /// the outcome of the request is not passed to the identical requests yet
+  std::atomic<bool> coalescing_pending_{false};
+
+  std::optional<HedgingSettings> hedging_;
+  /// this is a hedged attempt of another request
+  bool is_hedge_{false};
+  /// race of the attempts of the hedged request, shared by the attempts
+  std::shared_ptr<HedgedRace> hedged_race_;
+  /// sends the hedged attempt if there is no response for too long
+  std::optional<engine::ev::TimerWatcher> hedge_timer_;
+  bool reply_decoding_disabled_{false};
+
+  struct SpanParent {
+    std::string trace_id;
+    std::string span_id;
+  };
+  /// parent of the span of a hedged attempt, that is performed from a task
+  /// without the span of the request
+  std::optional<SpanParent> span_parent_;
+
   struct StreamData {
     StreamData(Queue::Producer&& queue_producer)
         : queue_producer(std::move(queue_producer)),
@@ -34,7 +34,7 @@ ResponseFuture::~ResponseFuture() { Cancel(); }
 
 void ResponseFuture::Cancel() {
   if (request_state_) {
-    request_state_->Cancel();
+    request_state_->Abandon();
   }
   Detach();
 }
@@ -47,7 +47,9 @@ void ResponseFuture::Detach() {
 std::future_status ResponseFuture::Wait() {
   auto status = future_.wait_until(deadline_);
   if (status == engine::FutureStatus::kCancelled) {
-    const auto stats = request_state_->easy().get_local_stats();
+    // Responses from the cache of the coalesced requests have no request
+    const auto stats = request_state_ ? request_state_->easy().get_local_stats()
+                                      : LocalStats{};
 
     // request_ has armed timers to retry the request. Stopping those ASAP.
     Cancel();
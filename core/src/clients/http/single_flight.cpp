@@ -0,0 +1,195 @@
+#include <clients/http/single_flight.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+#include <userver/http/common_headers.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/str_icase.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace clients::http::impl {
+
+namespace {
+
+// Expired cached responses are swept only when there are enough of them
+constexpr std::size_t kSweepThreshold = 1024;
+
+std::string_view TrimSpaces(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+}  // namespace
+
+SingleFlight::JoinResult SingleFlight::Join(
+    const std::string& key, const std::shared_ptr<RequestState>& request) {
+  UASSERT(request);
+  const auto now = Clock::now();
+  std::shared_ptr<const Response> cached;
+
+  {
+    std::lock_guard lock(mutex_);
+    auto& flight = flights_[key];
+    if (flight.in_flight) {
+      ++flight.callers;
+      return {JoinKind::kCoalesced, flight.waiters.emplace_back().get_future(),
+              flight.request};
+    }
+
+    if (flight.cached && now < flight.expires_at) {
+      cached = flight.cached;
+    } else {
+      flight.cached.reset();
+      flight.in_flight = true;
+      flight.request = request;
+      flight.callers = 1;
+      return {JoinKind::kIssue, {}, {}};
+    }
+  }
+
+  engine::Promise<ResponsePtr> promise;
+  auto future = promise.get_future();
+  promise.set_value(std::make_shared<Response>(*cached));
+  return {JoinKind::kCached, std::move(future), {}};
+}
+
+bool SingleFlight::Leave(const std::string& key,
+                         const RequestState& request) noexcept {
+  // The promises of the callers that left are destroyed outside of the lock
+  Flight abandoned;
+  {
+    std::lock_guard lock(mutex_);
+    const auto it = flights_.find(key);
+    if (it == flights_.end() || it->second.request.get() != &request) {
+      // Landed already, nobody else waits for the request
+      return true;
+    }
+
+    UASSERT(it->second.callers > 0);
+    if (--it->second.callers != 0) return false;
+
+    // The identical requests that arrive later must not join the cancelled
+    // one
+    abandoned = std::move(it->second);
+    flights_.erase(it);
+  }
+  return true;
+}
+
+void SingleFlight::Complete(const std::string& key, const RequestState& request,
+                            const Response& response,
+                            std::chrono::milliseconds max_cache_age) noexcept {
+  std::vector<engine::Promise<ResponsePtr>> waiters;
+  try {
+    const auto cache_age = std::min(max_cache_age, GetCacheMaxAge(response));
+    std::shared_ptr<const Response> cached;
+    if (cache_age.count() > 0) cached = std::make_shared<Response>(response);
+    waiters = Land(key, request, std::move(cached), Clock::now() + cache_age);
+  } catch (const std::exception&) {
+    // No memory to cache the response, retry without caching
+    waiters = Land(key, request, {}, {});
+  }
+
+  for (auto& waiter : waiters) {
+    try {
+      waiter.set_value(std::make_shared<Response>(response));
+    } catch (const std::exception&) {
+      waiter.set_exception(std::current_exception());
+    }
+  }
+}
+
+void SingleFlight::Fail(const std::string& key, const RequestState& request,
+                        std::exception_ptr exception) noexcept {
+  for (auto& waiter : Land(key, request, {}, {})) {
+    waiter.set_exception(exception);
+  }
+}
+
+std::chrono::milliseconds SingleFlight::GetCacheMaxAge(
+    const Response& response) {
+  if (!response.IsOk()) return {};
+
+  const auto it = response.headers().find(
+      USERVER_NAMESPACE::http::headers::kCacheControl);
+  if (it == response.headers().end()) return {};
+
+  const utils::StrIcaseEqual equal{};
+  std::chrono::seconds max_age{0};
+  std::string_view directives = it->second;
+  while (!directives.empty()) {
+    const auto comma_pos = directives.find(',');
+    const auto directive = TrimSpaces(directives.substr(0, comma_pos));
+    directives.remove_prefix(comma_pos == std::string_view::npos
+                                 ? directives.size()
+                                 : comma_pos + 1);
+
+    const auto eq_pos = directive.find('=');
+    const auto name = directive.substr(0, eq_pos);
+    if (equal(name, "no-store") || equal(name, "no-cache")) return {};
+
+    if (eq_pos != std::string_view::npos && equal(name, "max-age")) {
+      const auto value = directive.substr(eq_pos + 1);
+      std::int64_t seconds = 0;
+      const auto [end, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), seconds);
+      if (ec != std::errc{} || end != value.data() + value.size()) return {};
+      max_age = std::chrono::seconds{std::max<std::int64_t>(seconds, 0)};
+    }
+  }
+  return max_age;
+}
+
+std::vector<engine::Promise<SingleFlight::ResponsePtr>> SingleFlight::Land(
+    const std::string& key, const RequestState& request,
+    std::shared_ptr<const Response> cached, Clock::time_point expires_at) {
+  std::vector<engine::Promise<ResponsePtr>> waiters;
+  // The request is released outside of the lock
+  std::shared_ptr<RequestState> landed;
+
+  std::lock_guard lock(mutex_);
+  const auto it = flights_.find(key);
+  // The flight might be abandoned by the callers and replaced by another one
+  if (it == flights_.end() || it->second.request.get() != &request) {
+    return waiters;
+  }
+
+  waiters = std::move(it->second.waiters);
+  landed = std::move(it->second.request);
+  if (!cached) {
+    flights_.erase(it);
+    return waiters;
+  }
+
+  auto& flight = it->second;
+  flight.in_flight = false;
+  flight.callers = 0;
+  flight.waiters.clear();
+  flight.cached = std::move(cached);
+  flight.expires_at = expires_at;
+  if (flights_.size() > kSweepThreshold) SweepExpired(Clock::now());
+  return waiters;
+}
+
+void SingleFlight::SweepExpired(Clock::time_point now) {
+  for (auto it = flights_.begin(); it != flights_.end();) {
+    if (!it->second.in_flight && it->second.expires_at <= now) {
+      it = flights_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace clients::http::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <userver/clients/http/response.hpp>
+#include <userver/engine/future.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace clients::http {
+
+class RequestState;
+
+namespace impl {
+
+// Registry of the coalesced requests of a Client. The first request with a
+// given key is issued, the identical requests that arrive while it is in
+// flight wait for its outcome, and the requests that arrive after it may be
+// served from a short-lived cache of its response.
+//
+// The issued request serves all the callers, so it is cancelled only after
+// every one of them has left, see Leave().
+//
+// Complete() and Fail() are called from the ev threads, so the registry is
+// guarded by a std::mutex and never waits on anything while holding it.
+class SingleFlight final {
+ public:
+  using ResponsePtr = std::shared_ptr<Response>;
+
+  enum class JoinKind {
+    kIssue,      // the caller must perform the request and report the outcome
+    kCoalesced,  // the identical request is in flight, wait for its outcome
+    kCached,     // the response is already available
+  };
+
+  struct JoinResult {
+    JoinKind kind;
+    // Invalid for JoinKind::kIssue
+    engine::Future<ResponsePtr> future;
+    // The request being performed for JoinKind::kCoalesced
+    std::shared_ptr<RequestState> request;
+  };
+
+  // `request` is registered as the one to perform for JoinKind::kIssue
+  JoinResult Join(const std::string& key,
+                  const std::shared_ptr<RequestState>& request);
+
+  // Called when a caller of the issued `request` is no longer interested in
+  // the response. Returns whether the request may be cancelled, i.e. nobody
+  // else waits for it.
+  bool Leave(const std::string& key, const RequestState& request) noexcept;
+
+  // Fans out a copy of the response to the waiters of the `request` and
+  // caches it for at most max_cache_age, if the response `Cache-Control`
+  // allows that
+  void Complete(const std::string& key, const RequestState& request,
+                const Response& response,
+                std::chrono::milliseconds max_cache_age) noexcept;
+
+  // Fans out the exception to the waiters of the `request`
+  void Fail(const std::string& key, const RequestState& request,
+            std::exception_ptr exception) noexcept;
+
+  // Returns for how long the response may be reused according to its
+  // `Cache-Control` header, zero if it may not be reused.
+  static std::chrono::milliseconds GetCacheMaxAge(const Response& response);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Flight {
+    bool in_flight{false};
+    // The issued request and the number of its callers that did not leave
+    std::shared_ptr<RequestState> request;
+    std::size_t callers{0};
+    std::vector<engine::Promise<ResponsePtr>> waiters;
+    std::shared_ptr<const Response> cached;
+    Clock::time_point expires_at;
+  };
+
+  std::vector<engine::Promise<ResponsePtr>> Land(
+      const std::string& key, const RequestState& request,
+      std::shared_ptr<const Response> cached, Clock::time_point expires_at);
+
+  void SweepExpired(Clock::time_point now);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Flight> flights_;
+};
+
+}  // namespace impl
+
+}  // namespace clients::http
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,7 @@
 #include <clients/http/statistics.hpp>
 
+#include <algorithm>
+
 #include <curl-ev/error_code.hpp>
 
 #include <userver/logging/log.hpp>
@@ -19,6 +21,11 @@ T SumToMean(T sum, U count) {
   return sum / static_cast<T>(count);
 }
 
+// Hedged attempts that may be sent in a row after a quiet period
+constexpr double kMaxHedgeBurst = 10;
+
+constexpr auto kRecentTimingUpdatePeriod = std::chrono::seconds{1};
+
 }  // namespace
 
 RequestStats::RequestStats(Statistics& stats) : stats_(stats) {
@@ -59,6 +66,8 @@ void RequestStats::StoreTimeToStart(
 
 void RequestStats::AccountOpenSockets(size_t sockets) noexcept {
   stats_.socket_open_ += sockets;
+  ++stats_.connection_used_;
+  if (sockets == 0) ++stats_.connection_reused_;
 }
 
 void RequestStats::AccountTimeoutUpdatedByDeadline() noexcept {
@@ -69,6 +78,41 @@ void RequestStats::AccountCancelledByDeadline() noexcept {
   ++stats_.cancelled_by_deadline_;
 }
 
+void RequestStats::AccountIssued() noexcept { ++stats_.coalescing_issued_; }
+
+void RequestStats::AccountCoalesced() noexcept {
+  ++stats_.coalescing_coalesced_;
+}
+
+void RequestStats::AccountCoalescedFromCache() noexcept {
+  ++stats_.coalescing_cache_hits_;
+}
+
+void RequestStats::EarnHedge(double max_hedges_percent) noexcept {
+  stats_.EarnHedge(max_hedges_percent);
+}
+
+bool RequestStats::TryAcquireHedge() noexcept {
+  return stats_.TryAcquireHedge();
+}
+
+void RequestStats::AccountHedge() noexcept { ++stats_.hedges_; }
+
+void RequestStats::AccountHedgeWon() noexcept { ++stats_.hedges_won_; }
+
+void RequestStats::AccountHedgeThrottled() noexcept {
+  ++stats_.hedges_throttled_;
+}
+
+std::chrono::milliseconds RequestStats::GetRecentTimingPercentile(
+    double percent) {
+  return stats_.GetRecentTimingPercentile(percent);
+}
+
+std::shared_ptr<RequestStats> RequestStats::CreateSibling() const {
+  return stats_.CreateRequestStats();
+}
+
 Statistics::ErrorGroup Statistics::ErrorCodeToGroup(std::error_code ec) {
   using ErrorCode = curl::errc::EasyErrorCode;
 
@@ -131,6 +175,45 @@ void Statistics::AccountError(ErrorGroup error) {
 
 void Statistics::AccountStatus(int code) { reply_status_.Account(code); }
 
+void Statistics::EarnHedge(double max_hedges_percent) noexcept {
+  const auto earned = max_hedges_percent / 100;
+  auto budget = hedge_budget_.load(std::memory_order_relaxed);
+  while (budget < kMaxHedgeBurst &&
+         !hedge_budget_.compare_exchange_weak(
+             budget, std::min(budget + earned, kMaxHedgeBurst),
+             std::memory_order_relaxed)) {
+  }
+}
+
+bool Statistics::TryAcquireHedge() noexcept {
+  auto budget = hedge_budget_.load(std::memory_order_relaxed);
+  while (budget >= 1) {
+    if (hedge_budget_.compare_exchange_weak(budget, budget - 1,
+                                            std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::chrono::milliseconds Statistics::GetRecentTimingPercentile(
+    double percent) {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  auto updated = recent_timing_updated_.load();
+  const auto is_stale =
+      now - updated >=
+      std::chrono::steady_clock::duration{kRecentTimingUpdatePeriod}.count();
+
+  // Only one of the concurrent callers recomputes the stale value
+  if ((is_stale || recent_timing_percent_.load() != percent) &&
+      recent_timing_updated_.compare_exchange_strong(updated, now)) {
+    recent_timing_ms_ =
+        timings_percentile_.GetStatsForPeriod().GetPercentile(percent);
+    recent_timing_percent_ = percent;
+  }
+  return std::chrono::milliseconds{recent_timing_ms_.load()};
+}
+
 void DumpMetric(utils::statistics::Writer& writer,
                 const InstanceStatistics& stats, FormatMode format_mode) {
   writer["timings"] = stats.timings_percentile;
@@ -150,6 +233,14 @@ void DumpMetric(utils::statistics::Writer& writer,
   writer["timeout-updated-by-deadline"] = stats.timeout_updated_by_deadline;
   writer["cancelled-by-deadline"] = stats.cancelled_by_deadline;
 
+  writer["coalescing"]["issued"] = stats.coalescing_issued;
+  writer["coalescing"]["coalesced"] = stats.coalescing_coalesced;
+  writer["coalescing"]["cache-hits"] = stats.coalescing_cache_hits;
+
+  writer["hedging"]["hedges"] = stats.hedges;
+  writer["hedging"]["won"] = stats.hedges_won;
+  writer["hedging"]["throttled"] = stats.hedges_throttled;
+
   if (format_mode == FormatMode::kModeAll) {
     writer["last-time-to-start-us"] =
         SumToMean(stats.last_time_to_start_us, stats.instances_aggregated);
@@ -166,6 +257,11 @@ void DumpMetric(utils::statistics::Writer& writer,
   }
 
   writer["sockets"]["open"] = stats.multi.socket_open;
+  writer["sockets"]["reused"] = stats.connection_reused;
+  writer["sockets"]["reuse-ratio"] =
+      stats.connection_used
+          ? static_cast<double>(stats.connection_reused) / stats.connection_used
+          : 0.0;
 }
 
 void DumpMetric(utils::statistics::Writer& writer,
@@ -188,7 +284,15 @@ InstanceStatistics::InstanceStatistics(const Statistics& other)
       reply_status(other.reply_status_.GetSnapshot()),
       retries(other.retries_.load()),
       timeout_updated_by_deadline(other.timeout_updated_by_deadline_.load()),
-      cancelled_by_deadline(other.cancelled_by_deadline_.load()) {
+      cancelled_by_deadline(other.cancelled_by_deadline_.load()),
+      connection_reused(other.connection_reused_.load()),
+      connection_used(other.connection_used_.load()),
+      coalescing_issued(other.coalescing_issued_.load()),
+      coalescing_coalesced(other.coalescing_coalesced_.load()),
+      coalescing_cache_hits(other.coalescing_cache_hits_.load()),
+      hedges(other.hedges_.load()),
+      hedges_won(other.hedges_won_.load()),
+      hedges_throttled(other.hedges_throttled_.load()) {
   for (size_t i = 0; i < error_count.size(); i++)
     error_count[i] = other.error_count_[i].load();
   multi.socket_open = other.socket_open_;
@@ -223,6 +327,17 @@ InstanceStatistics& InstanceStatistics::operator+=(
   timeout_updated_by_deadline += stat.timeout_updated_by_deadline;
   cancelled_by_deadline += stat.cancelled_by_deadline;
 
+  connection_reused += stat.connection_reused;
+  connection_used += stat.connection_used;
+
+  coalescing_issued += stat.coalescing_issued;
+  coalescing_coalesced += stat.coalescing_coalesced;
+  coalescing_cache_hits += stat.coalescing_cache_hits;
+
+  hedges += stat.hedges;
+  hedges_won += stat.hedges_won;
+  hedges_throttled += stat.hedges_throttled;
+
   multi += stat.multi;
   return *this;
 }
@@ -33,6 +33,23 @@ class RequestStats final {
   void AccountTimeoutUpdatedByDeadline() noexcept;
   void AccountCancelledByDeadline() noexcept;
 
+  // Coalesced requests, see Request::EnableCoalescing()
+  void AccountIssued() noexcept;
+  void AccountCoalesced() noexcept;
+  void AccountCoalescedFromCache() noexcept;
+
+  // Hedged requests, see Request::EnableHedging()
+  void EarnHedge(double max_hedges_percent) noexcept;
+  bool TryAcquireHedge() noexcept;
+  void AccountHedge() noexcept;
+  void AccountHedgeWon() noexcept;
+  void AccountHedgeThrottled() noexcept;
+
+  std::chrono::milliseconds GetRecentTimingPercentile(double percent);
+
+  // Returns stats of another request to the same destination
+  std::shared_ptr<RequestStats> CreateSibling() const;
+
  private:
   void StoreTiming() noexcept;
 
@@ -89,6 +106,15 @@ class Statistics {
 
   void AccountStatus(int);
 
+  // Each request earns a max_hedges_percent share of a hedged attempt, and
+  // the earned attempts are accumulated up to a small burst
+  void EarnHedge(double max_hedges_percent) noexcept;
+  bool TryAcquireHedge() noexcept;
+
+  // Percentile of the request timings over the recent period, recomputed at
+  // most once in a while as that is costly
+  std::chrono::milliseconds GetRecentTimingPercentile(double percent);
+
  private:
   std::atomic<uint64_t> easy_handles_{0};
   std::atomic<uint64_t> last_time_to_start_us_{0};
@@ -99,11 +125,26 @@ class Statistics {
       {0, 0, 0, 0, 0, 0, 0}};
   std::atomic_llong retries_{0};
   std::atomic_llong socket_open_{0};
+  std::atomic<std::uint64_t> connection_reused_{0};
+  std::atomic<std::uint64_t> connection_used_{0};
 
   std::atomic<std::uint64_t> timeout_updated_by_deadline_{0};
   std::atomic<std::uint64_t> cancelled_by_deadline_{0};
   utils::statistics::HttpCodes reply_status_;
 
+  std::atomic<std::uint64_t> coalescing_issued_{0};
+  std::atomic<std::uint64_t> coalescing_coalesced_{0};
+  std::atomic<std::uint64_t> coalescing_cache_hits_{0};
+
+  std::atomic<double> hedge_budget_{0};
+  std::atomic<std::uint64_t> hedges_{0};
+  std::atomic<std::uint64_t> hedges_won_{0};
+  std::atomic<std::uint64_t> hedges_throttled_{0};
+
+  std::atomic<double> recent_timing_percent_{0};
+  std::atomic<std::int64_t> recent_timing_ms_{0};
+  std::atomic<std::chrono::steady_clock::rep> recent_timing_updated_{0};
+
   friend struct InstanceStatistics;
   friend class RequestStats;
 };
@@ -132,6 +173,22 @@ struct InstanceStatistics {
   std::uint64_t timeout_updated_by_deadline{0};
   std::uint64_t cancelled_by_deadline{0};
 
+  // Requests that did not open a new connection, out of connection_used
+  std::uint64_t connection_reused{0};
+  std::uint64_t connection_used{0};
+
+  // Requests with coalescing enabled that were sent, that waited for an
+  // identical sent request and that were served from its cached response
+  std::uint64_t coalescing_issued{0};
+  std::uint64_t coalescing_coalesced{0};
+  std::uint64_t coalescing_cache_hits{0};
+
+  // Hedged attempts that were sent, that responded before the original ones
+  // and that were not sent because of the hedging budget
+  std::uint64_t hedges{0};
+  std::uint64_t hedges_won{0};
+  std::uint64_t hedges_throttled{0};
+
   MultiStats multi;
 };
 
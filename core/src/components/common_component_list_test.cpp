@@ -111,6 +111,9 @@ components_manager:
       cache-size-per-way: 256
       cache-max-reply-ttl: 5m
       cache-failure-ttl: 5s
+      cache-hot-size: 256
+      cache-hot-threshold: 8
+      cache-prefetch-interval: 1s
 # /// [Sample dns client component config]
 # /// [Sample dynamic configs client component config]
 # yaml
@@ -1,3 +1,5 @@
+#include <limits>
+
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 #include <userver/components/fs_cache.hpp>
@@ -16,7 +18,9 @@ FsCache::FsCache(const components::ComponentConfig& config,
           config["dir"].As<std::string>("/var/www"),
           config["update-period"].As<std::chrono::milliseconds>(0),
           context.GetTaskProcessor(config["fs-task-processor"].As<std::string>(
-              "fs-task-processor"))) {}
+              "fs-task-processor")),
+          config["max-file-size"].As<std::size_t>(
+              std::numeric_limits<std::size_t>::max())) {}
 
 yaml_config::Schema FsCache::GetStaticConfigSchema() {
   return yaml_config::MergeSchemas<components::LoggableComponentBase>(R"(
@@ -37,6 +41,12 @@ properties:
         type: string
         description: task processor to do filesystem operations
         defaultDescription: fs-task-processor
+    max-file-size:
+        type: integer
+        description: |
+            larger files are not kept in memory and are read from disk on
+            each request
+        defaultDescription: unlimited
 )");
 }
 
@@ -2,8 +2,10 @@
 
 #include <tracing/no_log_spans.hpp>
 #include <userver/components/component.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/dynamic_config/storage/component.hpp>
 #include <userver/dynamic_config/value.hpp>
+#include <userver/logging/component.hpp>
 #include <userver/tracing/tracer.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
@@ -36,9 +38,19 @@ LoggingConfigurator::LoggingConfigurator(const ComponentConfig& config,
       context.FindComponent<components::DynamicConfig>()
           .GetSource()
           .UpdateAndListen(this, kName, &LoggingConfigurator::OnConfigUpdate);
+
+  auto& logging_component = context.FindComponent<Logging>();
+  statistics_holder_ =
+      context.FindComponent<components::StatisticsStorage>()
+          .GetStorage()
+          .RegisterExtender("logger",
+                            [&logging_component](const auto& /*request*/) {
+                              return logging_component.ExtendStatistics();
+                            });
 }
 
 LoggingConfigurator::~LoggingConfigurator() {
+  statistics_holder_.Unregister();
   config_subscription_.Unsubscribe();
 }
 
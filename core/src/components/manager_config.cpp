@@ -92,6 +92,26 @@ properties:
                 type: integer
                 description: size of a single coroutine, bytes
                 defaultDescription: 256 * 1024
+            stack_release_watermark:
+                type: integer
+                description: |
+                    amount of idle coroutines in the pool starting from which
+                    the memory of the stacks of the returned coroutines is
+                    given back to the OS
+                defaultDescription: max_size
+            stack_release_method:
+                type: string
+                description: how to give the stack memory back to the OS
+                defaultDescription: dontneed
+                enum:
+                  - dontneed
+                  - free
+            stack_usage_monitor_enabled:
+                type: boolean
+                description: |
+                    measure the stack usage of the coroutines returned to the
+                    pool and report it in the coro-pool.stack-usage metrics
+                defaultDescription: false
     event_thread_pool:
         type: object
         description: event thread pool options
@@ -107,6 +127,37 @@ properties:
                 description: >
                     Whether to defer timer events to a per-thread periodic timer
                     or notify ev-loop right away
+            cpu-affinity:
+                type: object
+                description: >
+                    CPU and NUMA placement of the ev threads, sockets and
+                    timers prefer the ev threads on the NUMA node of the caller
+                additionalProperties: false
+                properties:
+                    cpus:
+                        type: string
+                        description: |
+                            CPUs to run the threads on in the Linux CPU list
+                            format, e.g. `0-15,32-47`
+                    numa-nodes:
+                        type: array
+                        description: |
+                            NUMA nodes to spread the threads over, thread `i` is
+                            pinned to the CPUs of `numa-nodes[i % size]`
+                        items:
+                            type: integer
+                            description: NUMA node number
+            io_backend:
+                type: string
+                description: |
+                    backend for the socket I/O: `epoll` for the readiness
+                    notifications of the ev-loop or `io_uring` to submit the
+                    operations to an io_uring of the ev thread (falls back to
+                    `epoll` if the kernel does not support it)
+                defaultDescription: epoll
+                enum:
+                  - epoll
+                  - io_uring
     components:
         type: object
         description: 'dictionary of "component name": "options"'
@@ -142,6 +193,36 @@ properties:
                       - normal
                       - low-priority
                       - idle
+                task-processor-queue:
+                    type: string
+                    description: |
+                        Task queue implementation for the task processor.
+                        `global-task-queue` uses a single queue shared by all
+                        the workers. `work-stealing-task-queue` gives each
+                        worker its own queue and lets idle workers steal tasks
+                        from the busy ones.
+                    defaultDescription: global-task-queue
+                    enum:
+                      - global-task-queue
+                      - work-stealing-task-queue
+                cpu-affinity:
+                    type: object
+                    description: CPU and NUMA placement of the task processor threads
+                    additionalProperties: false
+                    properties:
+                        cpus:
+                            type: string
+                            description: |
+                                CPUs to run the threads on in the Linux CPU list
+                                format, e.g. `0-15,32-47`
+                        numa-nodes:
+                            type: array
+                            description: |
+                                NUMA nodes to spread the threads over, thread `i` is
+                                pinned to the CPUs of `numa-nodes[i % size]`
+                            items:
+                                type: integer
+                                description: NUMA node number
                 task-trace:
                     type: object
                     description: .
@@ -57,6 +57,20 @@ formats::json::ValueBuilder GetTaskProcessorStats(
 
   json_task_processor["worker-threads"] = task_processor.GetWorkerCount();
 
+  const auto numa_stats = task_processor.GetNumaNodeStatistics();
+  if (!numa_stats.empty()) {
+    formats::json::ValueBuilder json_numa_nodes(formats::json::Type::kObject);
+    for (const auto& [node, stats] : numa_stats) {
+      formats::json::ValueBuilder json_node(formats::json::Type::kObject);
+      json_node["worker-threads"] = stats.workers;
+      json_node["migrations"] = stats.migrations;
+      json_numa_nodes[std::to_string(node)] = std::move(json_node);
+    }
+    utils::statistics::SolomonChildrenAreLabelValues(json_numa_nodes,
+                                                     "numa_node");
+    json_task_processor["numa-nodes"] = std::move(json_numa_nodes);
+  }
+
   return json_task_processor;
 }
 
@@ -120,6 +134,22 @@ formats::json::Value ManagerControllerComponent::ExtendStatistics(
     json_coro_stats["total"] = coro_stats.total_coroutines;
     json_coro_pool["coroutines"] = std::move(json_coro_stats);
 
+    formats::json::ValueBuilder json_stack_usage(formats::json::Type::kObject);
+    json_stack_usage["max-bytes"] = coro_stats.max_stack_usage;
+    json_stack_usage["released-stacks"] = coro_stats.released_stacks;
+    formats::json::ValueBuilder json_stack_histogram(
+        formats::json::Type::kObject);
+    for (std::size_t i = 0; i < coro_stats.stack_usage_histogram.size(); ++i) {
+      const auto upper_percent =
+          (i + 1) * 100 / coro_stats.stack_usage_histogram.size();
+      json_stack_histogram[std::to_string(upper_percent)] =
+          coro_stats.stack_usage_histogram[i];
+    }
+    utils::statistics::SolomonChildrenAreLabelValues(json_stack_histogram,
+                                                     "stack_usage_percent");
+    json_stack_usage["histogram"] = std::move(json_stack_histogram);
+    json_coro_pool["stack-usage"] = std::move(json_stack_usage);
+
     engine_data["coro-pool"] = std::move(json_coro_pool);
   }
 
@@ -42,6 +42,36 @@ properties:
           - normal
           - low-priority
           - idle
+    task-processor-queue:
+        type: string
+        description: |
+            Task queue implementation for the task processor.
+            `global-task-queue` uses a single queue shared by all
+            the workers. `work-stealing-task-queue` gives each
+            worker its own queue and lets idle workers steal tasks
+            from the busy ones.
+        defaultDescription: global-task-queue
+        enum:
+          - global-task-queue
+          - work-stealing-task-queue
+    cpu-affinity:
+        type: object
+        description: CPU and NUMA placement of the task processor threads
+        additionalProperties: false
+        properties:
+            cpus:
+                type: string
+                description: |
+                    CPUs to run the threads on in the Linux CPU list
+                    format, e.g. `0-15,32-47`
+            numa-nodes:
+                type: array
+                description: |
+                    NUMA nodes to spread the threads over, thread `i` is
+                    pinned to the CPUs of `numa-nodes[i % size]`
+                items:
+                    type: integer
+                    description: NUMA node number
     task-trace:
         type: object
         description: .
@@ -0,0 +1,65 @@
+#include <compression/brotli.hpp>
+
+#include <cstdint>
+
+#include <brotli/encode.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::brotli {
+
+namespace {
+constexpr std::size_t kCompressBufferSize = 16 * 1024;
+}  // namespace
+
+std::string Compress(std::string_view data, int quality) {
+  return Compressor{quality}.Finish(data);
+}
+
+Compressor::Compressor(int quality)
+    : state_(BrotliEncoderCreateInstance(nullptr, nullptr, nullptr)) {
+  if (!state_) {
+    throw CompressionError("failed to initialize brotli compressor");
+  }
+  if (!BrotliEncoderSetParameter(state_, BROTLI_PARAM_QUALITY, quality)) {
+    BrotliEncoderDestroyInstance(state_);
+    throw CompressionError("failed to set brotli compression quality");
+  }
+}
+
+Compressor::~Compressor() { BrotliEncoderDestroyInstance(state_); }
+
+std::string Compressor::Compress(std::string_view chunk) {
+  return Encode(chunk, false);
+}
+
+std::string Compressor::Finish(std::string_view last_chunk) {
+  return Encode(last_chunk, true);
+}
+
+std::string Compressor::Encode(std::string_view data, bool finish) {
+  const auto op = finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH;
+
+  std::string result;
+  std::size_t avail_in = data.size();
+  const auto* next_in = reinterpret_cast<const std::uint8_t*>(data.data());
+  do {
+    const auto offset = result.size();
+    result.resize(offset + kCompressBufferSize);
+    std::size_t avail_out = kCompressBufferSize;
+    auto* next_out = reinterpret_cast<std::uint8_t*>(result.data() + offset);
+
+    if (!BrotliEncoderCompressStream(state_, op, &avail_in, &next_in,
+                                     &avail_out, &next_out, nullptr)) {
+      throw CompressionError("failed to compress data with brotli");
+    }
+    result.resize(result.size() - avail_out);
+  } while (avail_in != 0 || BrotliEncoderHasMoreOutput(state_) ||
+           (finish && !BrotliEncoderIsFinished(state_)));
+
+  return result;
+}
+
+}  // namespace compression::brotli
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string_view>
+
+#include <compression/error.hpp>
+#include <compression/stream_compressor.hpp>
+
+struct BrotliEncoderStateStruct;
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::brotli {
+
+/// Compresses the string with the brotli `quality` from 0 to 11.
+/// @throws CompressionError
+std::string Compress(std::string_view data, int quality);
+
+/// Streaming brotli compressor
+class Compressor final : public StreamCompressor {
+ public:
+  /// @param quality brotli compression quality from 0 to 11
+  explicit Compressor(int quality);
+  ~Compressor() override;
+
+  Compressor(const Compressor&) = delete;
+  Compressor& operator=(const Compressor&) = delete;
+
+  std::string Compress(std::string_view chunk) override;
+  std::string Finish(std::string_view last_chunk) override;
+
+ private:
+  std::string Encode(std::string_view data, bool finish);
+
+  BrotliEncoderStateStruct* state_;
+};
+
+}  // namespace compression::brotli
+
+USERVER_NAMESPACE_END
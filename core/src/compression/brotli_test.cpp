@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <brotli/decode.h>
+
+#include <compression/brotli.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+std::string MakeData(std::size_t size) {
+  std::string data;
+  data.reserve(size);
+  while (data.size() < size) {
+    data += "{\"key\":" + std::to_string(data.size() % 1000) + "},";
+  }
+  data.resize(size);
+  return data;
+}
+
+std::string Decompress(std::string_view compressed, std::size_t size) {
+  std::string result(size, '\0');
+  std::size_t result_size = size;
+  const auto ret = BrotliDecoderDecompress(
+      compressed.size(),
+      reinterpret_cast<const std::uint8_t*>(compressed.data()), &result_size,
+      reinterpret_cast<std::uint8_t*>(result.data()));
+  EXPECT_EQ(ret, BROTLI_DECODER_RESULT_SUCCESS);
+  result.resize(result_size);
+  return result;
+}
+
+}  // namespace
+
+TEST(Brotli, Compress) {
+  for (const std::size_t size : {0, 1, 100, 100'000}) {
+    const auto data = MakeData(size);
+    const auto compressed = compression::brotli::Compress(data, 5);
+    EXPECT_EQ(Decompress(compressed, size), data);
+  }
+
+  const auto data = MakeData(100'000);
+  EXPECT_LT(compression::brotli::Compress(data, 5).size(), data.size() / 10);
+}
+
+TEST(Brotli, StreamCompressor) {
+  const auto data = MakeData(100'000);
+
+  compression::brotli::Compressor compressor{4};
+  std::string compressed;
+  for (std::size_t pos = 0; pos < data.size(); pos += 7'000) {
+    const auto chunk = compressor.Compress(data.substr(pos, 7'000));
+    // Every chunk is flushed
+    EXPECT_FALSE(chunk.empty());
+    compressed += chunk;
+  }
+  compressed += compressor.Finish({});
+
+  EXPECT_EQ(Decompress(compressed, data.size()), data);
+}
+
+USERVER_NAMESPACE_END
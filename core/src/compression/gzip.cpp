@@ -1,15 +1,26 @@
 #include <compression/gzip.hpp>
 
+#include <limits>
+
+#include <zlib.h>
+
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 
+#include <userver/utils/assert.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace compression::gzip {
 
 namespace {
 constexpr auto kDecompressBufferSize = 1024;
-}
+constexpr std::size_t kCompressBufferSize = 16 * 1024;
+
+// 15 is the max window size, +16 to write the gzip header and trailer
+constexpr int kGzipWindowBits = 15 + 16;
+constexpr int kDefaultMemLevel = 8;
+}  // namespace
 
 std::string Decompress(std::string_view compressed, size_t max_size) {
   std::string decompressed;
@@ -38,6 +49,56 @@ std::string Decompress(std::string_view compressed, size_t max_size) {
   return decompressed;
 }
 
+std::string Compress(std::string_view data, int level) {
+  return Compressor{level}.Finish(data);
+}
+
+Compressor::Compressor(int level) : stream_(std::make_unique<z_stream>()) {
+  if (deflateInit2(stream_.get(), level, Z_DEFLATED, kGzipWindowBits,
+                   kDefaultMemLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw CompressionError("failed to initialize gzip compressor");
+  }
+}
+
+Compressor::~Compressor() { deflateEnd(stream_.get()); }
+
+std::string Compressor::Compress(std::string_view chunk) {
+  return Deflate(chunk, Z_SYNC_FLUSH);
+}
+
+std::string Compressor::Finish(std::string_view last_chunk) {
+  return Deflate(last_chunk, Z_FINISH);
+}
+
+std::string Compressor::Deflate(std::string_view data, int flush) {
+  UINVARIANT(data.size() <= std::numeric_limits<uInt>::max(),
+             "Too large chunk for gzip compression");
+
+  std::string result;
+  if (flush == Z_FINISH) {
+    result.reserve(deflateBound(stream_.get(), data.size()));
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream_->avail_in = data.size();
+  do {
+    const auto offset = result.size();
+    result.resize(offset + kCompressBufferSize);
+    stream_->next_out = reinterpret_cast<Bytef*>(result.data() + offset);
+    stream_->avail_out = kCompressBufferSize;
+
+    // Z_BUF_ERROR only means that no progress was possible
+    const auto ret = deflate(stream_.get(), flush);
+    if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+      throw CompressionError("failed to compress data with gzip");
+    }
+    result.resize(result.size() - stream_->avail_out);
+  } while (stream_->avail_out == 0);
+
+  return result;
+}
+
 }  // namespace compression::gzip
 
 USERVER_NAMESPACE_END
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <string_view>
 
 #include <compression/error.hpp>
+#include <compression/stream_compressor.hpp>
+
+struct z_stream_s;
 
 USERVER_NAMESPACE_BEGIN
 
@@ -12,6 +16,26 @@ namespace compression::gzip {
 /// @throws DecompressionError
 std::string Decompress(std::string_view compressed, size_t max_size);
 
+/// Compresses the string with the zlib `level` from 0 to 9.
+/// @throws CompressionError
+std::string Compress(std::string_view data, int level);
+
+/// Streaming gzip compressor
+class Compressor final : public StreamCompressor {
+ public:
+  /// @param level zlib compression level from 0 to 9
+  explicit Compressor(int level);
+  ~Compressor() override;
+
+  std::string Compress(std::string_view chunk) override;
+  std::string Finish(std::string_view last_chunk) override;
+
+ private:
+  std::string Deflate(std::string_view data, int flush);
+
+  std::unique_ptr<z_stream_s> stream_;
+};
+
 }  // namespace compression::gzip
 
 USERVER_NAMESPACE_END
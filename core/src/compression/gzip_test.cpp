@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <compression/gzip.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+std::string MakeData(std::size_t size) {
+  std::string data;
+  data.reserve(size);
+  while (data.size() < size) {
+    data += "{\"key\":" + std::to_string(data.size() % 1000) + "},";
+  }
+  data.resize(size);
+  return data;
+}
+
+}  // namespace
+
+TEST(Gzip, CompressDecompress) {
+  for (const std::size_t size : {0, 1, 100, 100'000}) {
+    const auto data = MakeData(size);
+    const auto compressed = compression::gzip::Compress(data, 6);
+    EXPECT_EQ(compression::gzip::Decompress(compressed, size + 1), data);
+  }
+
+  const auto data = MakeData(100'000);
+  EXPECT_LT(compression::gzip::Compress(data, 6).size(), data.size() / 10);
+}
+
+TEST(Gzip, StreamCompressor) {
+  const auto data = MakeData(100'000);
+
+  compression::gzip::Compressor compressor{1};
+  std::string compressed;
+  for (std::size_t pos = 0; pos < data.size(); pos += 7'000) {
+    const auto chunk = compressor.Compress(data.substr(pos, 7'000));
+    // Every chunk is flushed
+    EXPECT_FALSE(chunk.empty());
+    compressed += chunk;
+  }
+  compressed += compressor.Finish({});
+
+  EXPECT_EQ(compression::gzip::Decompress(compressed, data.size() + 1), data);
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression {
+
+/// Compresses the data chunk by chunk, e.g. streamed HTTP response bodies
+class StreamCompressor {
+ public:
+  virtual ~StreamCompressor() = default;
+
+  /// Compresses and flushes the chunk, so the peer could decode it without
+  /// waiting for the following chunks.
+  /// @throws CompressionError
+  virtual std::string Compress(std::string_view chunk) = 0;
+
+  /// Compresses the last chunk and ends the compressed stream, the
+  /// compressor could not be used after that.
+  /// @throws CompressionError
+  virtual std::string Finish(std::string_view last_chunk) = 0;
+};
+
+}  // namespace compression
+
+USERVER_NAMESPACE_END
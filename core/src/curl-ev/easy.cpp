@@ -95,6 +95,13 @@ bool AddHeaderDoReplace(std::shared_ptr<string_list> headers,
   return false;
 }
 
+std::shared_ptr<string_list> CopyStringList(const string_list& list) {
+  auto copy = std::make_shared<string_list>();
+  list.ForEach(
+      [&copy](std::string_view value) { copy->add(std::string{value}); });
+  return copy;
+}
+
 }  // namespace
 
 using BusyMarker = utils::statistics::BusyMarker;
@@ -138,6 +145,40 @@ std::shared_ptr<easy> easy::GetBoundBlocking(multi& multi_handle) const {
   return std::make_shared<easy>(cloned, &multi_handle);
 }
 
+std::shared_ptr<easy> easy::CloneBlocking(multi& multi_handle) const {
+  UASSERT_MSG(!source_ && !form_ && post_fields_.empty(),
+              "Cloning of the requests with a body is not supported");
+  auto cloned = GetBoundBlocking(multi_handle);
+
+  // The duplicated handle points to the URL and to the string lists of this
+  // easy, which may change independently, so the clone gets copies of them
+  if (!orig_url_str_.empty()) cloned->set_url(orig_url_str_);
+  if (headers_) cloned->set_headers(CopyStringList(*headers_));
+  if (proxy_headers_) {
+    cloned->proxy_headers_ = CopyStringList(*proxy_headers_);
+    const auto rc = native::curl_easy_setopt(
+        cloned->handle_, native::CURLOPT_PROXYHEADER,
+        cloned->proxy_headers_->native_handle());
+    throw_error(std::error_code{static_cast<errc::EasyErrorCode>(rc)},
+                "set_proxy_headers");
+  }
+  if (http200_aliases_) {
+    cloned->set_http200_aliases(CopyStringList(*http200_aliases_));
+  }
+  if (resolved_hosts_) cloned->set_resolves(CopyStringList(*resolved_hosts_));
+
+  // The share and the progress callback are not duplicated by libcurl
+  if (share_) cloned->set_share(share_);
+  if (progress_callback_) cloned->set_progress_callback(progress_callback_);
+
+  return cloned;
+}
+
+void easy::SetMulti(multi& multi_handle) {
+  UASSERT(!multi_registered_);
+  multi_ = &multi_handle;
+}
+
 easy* easy::from_native(native::CURL* native_easy) {
   easy* easy_handle = nullptr;
   native::curl_easy_getinfo(native_easy, native::CURLINFO_PRIVATE,
@@ -591,7 +632,7 @@ void easy::set_share(std::shared_ptr<share> share) {
 void easy::set_share(std::shared_ptr<share> share, std::error_code& ec) {
   share_ = std::move(share);
 
-  if (share) {
+  if (share_) {
     ec = std::error_code{
         static_cast<errc::EasyErrorCode>(native::curl_easy_setopt(
             handle_, native::CURLOPT_SHARE, share_->native_handle()))};
@@ -168,8 +168,17 @@ class easy final : public std::enable_shared_from_this<easy> {
   // resolver initialization).
   std::shared_ptr<easy> GetBoundBlocking(multi&) const;
 
+  // Makes a clone of an easy configured for a request without a body, that
+  // performs the same request independently of this one. May block just
+  // like GetBoundBlocking().
+  std::shared_ptr<easy> CloneBlocking(multi&) const;
+
   const multi* GetMulti() const { return multi_; }
 
+  // Makes the next async_perform() use another multi. Must not be called
+  // while performing.
+  void SetMulti(multi& multi_handle);
+
   inline native::CURL* native_handle() { return handle_; }
   engine::ev::ThreadControl& GetThreadControl();
 
@@ -1,8 +1,10 @@
 #include <userver/utest/utest.hpp>
 
+#include <userver/dynamic_config/impl/snapshot.hpp>
 #include <userver/dynamic_config/snapshot.hpp>
 #include <userver/dynamic_config/source.hpp>
 #include <userver/dynamic_config/storage_mock.hpp>
+#include <userver/dynamic_config/value.hpp>
 #include <userver/formats/json/serialize.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -193,6 +195,87 @@ UTEST(DynamicConfig, Extend2) {
   EXPECT_EQ(config[kIntConfig], 5);
 }
 
+class IntConfigListener final {
+ public:
+  explicit IntConfigListener(dynamic_config::Source source)
+      : subscriber_(source.UpdateAndListen(this, "test",
+                                           &IntConfigListener::OnConfigUpdate,
+                                           kIntConfig)) {}
+
+  ~IntConfigListener() { subscriber_.Unsubscribe(); }
+
+  const std::vector<int>& GetValues() const { return values_; }
+
+ private:
+  void OnConfigUpdate(const dynamic_config::Snapshot& config) {
+    values_.push_back(config[kIntConfig]);
+  }
+
+  std::vector<int> values_;
+  concurrent::AsyncEventSubscriberScope subscriber_;
+};
+
+UTEST(DynamicConfig, UpdateAndListenToKeys) {
+  dynamic_config::StorageMock storage{{kIntConfig, 5}, {kBoolConfig, false}};
+  IntConfigListener listener{storage.GetSource()};
+  EXPECT_EQ(listener.GetValues(), std::vector<int>{5});
+
+  storage.Extend({{kBoolConfig, true}});
+  EXPECT_EQ(listener.GetValues(), std::vector<int>{5});
+
+  storage.Extend({{kIntConfig, 6}});
+  EXPECT_EQ(listener.GetValues(), (std::vector<int>{5, 6}));
+
+  storage.Extend({{kBoolConfig, false}, {kIntConfig, 7}});
+  EXPECT_EQ(listener.GetValues(), (std::vector<int>{5, 6, 7}));
+}
+
+int foo_parsed = 0;
+int bar_parsed = 0;
+
+std::any ParseFoo(const dynamic_config::DocsMap& docs_map) {
+  ++foo_parsed;
+  return docs_map.Get("FOO").As<int>();
+}
+
+std::any ParseBar(const dynamic_config::DocsMap& docs_map) {
+  ++bar_parsed;
+  return docs_map.Get("BAR").As<int>();
+}
+
+dynamic_config::DocsMap MakeDocsMap(const std::string& json) {
+  dynamic_config::DocsMap docs_map;
+  docs_map.Parse(json, false);
+  return docs_map;
+}
+
+UTEST(DynamicConfig, ReparseChangedOnly) {
+  using dynamic_config::impl::SnapshotData;
+  const std::vector<dynamic_config::impl::Factory> factories{&ParseFoo,
+                                                             &ParseBar};
+  constexpr dynamic_config::impl::ConfigId kFooId = 0;
+  constexpr dynamic_config::impl::ConfigId kBarId = 1;
+  dynamic_config::impl::ConfigDependencies dependencies;
+
+  const auto docs = MakeDocsMap(R"({"FOO": 1, "BAR": 2})");
+  const SnapshotData empty{std::vector<dynamic_config::KeyValue>{}};
+  const SnapshotData first{empty, docs, {}, dependencies, factories};
+  EXPECT_EQ(foo_parsed, 1);
+  EXPECT_EQ(bar_parsed, 1);
+
+  const auto new_docs = MakeDocsMap(R"({"FOO": 1, "BAR": 3})");
+  const SnapshotData second{first, new_docs, new_docs.GetChangedNames(docs),
+                            dependencies, factories};
+  EXPECT_TRUE(second.IsSame(kFooId, first));
+  EXPECT_FALSE(second.IsSame(kBarId, first));
+  EXPECT_EQ(foo_parsed, 1);
+  EXPECT_EQ(bar_parsed, 2);
+
+  // The unchanged config still counts as requested for the updaters
+  EXPECT_EQ(new_docs.GetRequestedNames(),
+            (std::unordered_set<std::string>{"FOO", "BAR"}));
+}
+
 }  // namespace
 
 USERVER_NAMESPACE_END
@@ -1,5 +1,7 @@
 #include <userver/dynamic_config/impl/snapshot.hpp>
 
+#include <algorithm>
+
 #include <fmt/format.h>
 
 #include <userver/compiler/demangle.hpp>
@@ -38,7 +40,8 @@ SnapshotData::SnapshotData(const std::vector<KeyValue>& config_variables) {
   user_configs_.resize(Registry().size());
 
   for (const auto& config_variable : config_variables) {
-    user_configs_[config_variable.GetId()] = config_variable.GetValue();
+    user_configs_[config_variable.GetId()] =
+        std::make_shared<const std::any>(config_variable.GetValue());
   }
 }
 
@@ -47,9 +50,9 @@ SnapshotData::SnapshotData(const DocsMap& defaults,
     : SnapshotData(overrides) {
   utils::StreamingCpuRelax relax(1, nullptr);
   for (const auto [id, factory] : utils::enumerate(Registry())) {
-    if (!user_configs_[id].has_value()) {
+    if (!user_configs_[id]) {
       relax.Relax(1);
-      user_configs_[id] = factory(defaults);
+      user_configs_[id] = std::make_shared<const std::any>(factory(defaults));
     }
   }
 }
@@ -58,16 +61,76 @@ SnapshotData::SnapshotData(const SnapshotData& defaults,
                            const std::vector<KeyValue>& overrides)
     : user_configs_(defaults.user_configs_) {
   for (const auto& config_variable : overrides) {
-    user_configs_[config_variable.GetId()] = config_variable.GetValue();
+    user_configs_[config_variable.GetId()] =
+        std::make_shared<const std::any>(config_variable.GetValue());
+  }
+}
+
+SnapshotData::SnapshotData(const DocsMap& docs,
+                           ConfigDependencies& dependencies)
+    : SnapshotData(SnapshotData{std::vector<KeyValue>{}}, docs, {},
+                   dependencies) {}
+
+SnapshotData::SnapshotData(const SnapshotData& previous, const DocsMap& docs,
+                           const std::unordered_set<std::string>& changed_names,
+                           ConfigDependencies& dependencies)
+    : SnapshotData(previous, docs, changed_names, dependencies,
+                   []() -> const std::vector<Factory>& {
+                     utils::impl::AssertStaticRegistrationFinished();
+                     return Registry();
+                   }()) {}
+
+SnapshotData::SnapshotData(const SnapshotData& previous, const DocsMap& docs,
+                           const std::unordered_set<std::string>& changed_names,
+                           ConfigDependencies& dependencies,
+                           const std::vector<Factory>& factories)
+    : user_configs_(previous.user_configs_) {
+  user_configs_.resize(factories.size());
+  dependencies.resize(factories.size());
+
+  const auto is_changed = [&changed_names](const std::string& name) {
+    return changed_names.count(name) != 0;
+  };
+
+  utils::StreamingCpuRelax relax(1, nullptr);
+  for (const auto [id, factory] : utils::enumerate(factories)) {
+    auto& config = user_configs_[id];
+    auto& names = dependencies[id];
+    // Configs that do not read any items can not be tracked, parse them anew
+    if (config && !names.empty() &&
+        std::none_of(names.begin(), names.end(), is_changed)) {
+      // Keep GetRequestedNames() complete for the updaters
+      docs.MarkRequestedNames(names);
+      continue;
+    }
+
+    relax.Relax(1);
+    names.clear();
+    docs.RecordRequestedNames(&names);
+    try {
+      config = std::make_shared<const std::any>(factory(docs));
+    } catch (...) {
+      docs.RecordRequestedNames(nullptr);
+      throw;
+    }
+    docs.RecordRequestedNames(nullptr);
   }
 }
 
+bool SnapshotData::IsSame(impl::ConfigId id, const SnapshotData& other) const {
+  const auto get = [id](const SnapshotData& data) {
+    return id < data.user_configs_.size() ? data.user_configs_[id].get()
+                                          : nullptr;
+  };
+  return get(*this) == get(other);
+}
+
 const std::any& SnapshotData::Get(impl::ConfigId id) const {
   const auto& config = user_configs_[id];
-  if (!config.has_value()) {
+  if (!config || !config->has_value()) {
     throw std::logic_error("This type is not registered as config");
   }
-  return config;
+  return *config;
 }
 
 }  // namespace dynamic_config::impl
@@ -1,6 +1,11 @@
-#include <dynamic_config/storage_data.hpp>
 #include <userver/dynamic_config/source.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+#include <dynamic_config/storage_data.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace dynamic_config {
@@ -19,6 +24,33 @@ concurrent::AsyncEventSubscriberScope Source::DoUpdateAndListen(
                                              [&] { func_copy(GetSnapshot()); });
 }
 
+concurrent::AsyncEventSubscriberScope Source::DoUpdateAndListen(
+    concurrent::FunctionId id, std::string_view name,
+    EventSource::Function&& func, std::vector<impl::ConfigId>&& keys) {
+  // Both the updater and the filter run under the channel lock
+  auto last_snapshot = std::make_shared<std::optional<Snapshot>>();
+  auto filter = [last_snapshot,
+                 keys = std::move(keys)](const Snapshot& snapshot) {
+    const auto& last = last_snapshot->value().GetData();
+    const auto is_same = [&](impl::ConfigId key) {
+      return snapshot.GetData().IsSame(key, last);
+    };
+    if (std::all_of(keys.begin(), keys.end(), is_same)) return false;
+
+    *last_snapshot = snapshot;
+    return true;
+  };
+
+  auto func_copy = func;
+  return storage_->channel.DoUpdateAndListen(
+      id, name, std::move(func),
+      [&] {
+        *last_snapshot = GetSnapshot();
+        func_copy(**last_snapshot);
+      },
+      std::move(filter));
+}
+
 }  // namespace dynamic_config
 
 USERVER_NAMESPACE_END
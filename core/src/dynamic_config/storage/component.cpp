@@ -2,19 +2,25 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <unordered_set>
 
 #include <fmt/format.h>
 
 #include <userver/components/component.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/dynamic_config/storage_mock.hpp>
 #include <userver/engine/condition_variable.hpp>
 #include <userver/engine/mutex.hpp>
 #include <userver/fs/read.hpp>
 #include <userver/fs/write.hpp>
+#include <userver/formats/json/value_builder.hpp>
 #include <userver/tracing/span.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/statistics/relaxed_counter.hpp>
+#include <userver/utils/statistics/storage.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 #include <dynamic_config/storage_data.hpp>
@@ -59,6 +65,10 @@ class DynamicConfig::Impl final {
 
  private:
   void DoSetConfig(const dynamic_config::DocsMap& value);
+  std::optional<dynamic_config::impl::SnapshotData> ParseConfig(
+      const dynamic_config::DocsMap& value);
+
+  formats::json::Value ExtendStatistics() const;
 
   bool Has() const;
   void WaitUntilLoaded();
@@ -70,6 +80,19 @@ class DynamicConfig::Impl final {
   dynamic_config::impl::StorageData cache_{
       dynamic_config::impl::SnapshotData{{}}};
 
+  // Serializes the updates, which may come from several updaters at once
+  engine::Mutex update_mutex_;
+  // The latest applied docs and the items each config was parsed from, only
+  // the configs that depend on the changed items are parsed on update.
+  // Guarded by update_mutex_.
+  dynamic_config::DocsMap docs_;
+  dynamic_config::impl::ConfigDependencies dependencies_;
+
+  utils::statistics::RelaxedCounter<std::uint64_t> updates_;
+  utils::statistics::RelaxedCounter<std::uint64_t> unchanged_updates_;
+  std::atomic<std::int64_t> last_parse_time_ms_{0};
+  utils::statistics::Entry statistics_holder_;
+
   const std::string fs_cache_path_;
   engine::TaskProcessor* fs_task_processor_;
   std::string fs_loading_error_msg_;
@@ -89,6 +112,12 @@ DynamicConfig::Impl::Impl(const ComponentConfig& config,
               ? nullptr
               : &context.GetTaskProcessor(
                     config["fs-task-processor"].As<std::string>())) {
+  auto& storage =
+      context.FindComponent<components::StatisticsStorage>().GetStorage();
+  statistics_holder_ = storage.RegisterExtender(
+      config.Name(),
+      [this](const auto& /*request*/) { return ExtendStatistics(); });
+
   std::vector<std::string> active_updaters;
   for (const auto& name : AllConfigUpdaters()) {
     if (context.Contains(name)) {
@@ -153,16 +182,58 @@ void DynamicConfig::Impl::NotifyLoadingFailed(std::string_view updater,
 }
 
 void DynamicConfig::Impl::DoSetConfig(const dynamic_config::DocsMap& value) {
-  auto config = dynamic_config::impl::SnapshotData(value, {});
+  // Also keeps the snapshots and the events in the order of the updates
+  std::lock_guard update_lock(update_mutex_);
+  auto config = ParseConfig(value);
+  if (!config) {
+    ++unchanged_updates_;
+    return;
+  }
+
   {
     std::lock_guard lock(loaded_mutex_);
-    cache_.config.Assign(std::move(config));
+    cache_.config.Assign(std::move(*config));
     is_loaded_ = true;
   }
+  docs_ = value;
+  ++updates_;
   loaded_cv_.NotifyAll();
   cache_.channel.SendEvent(dynamic_config::Source{cache_}.GetSnapshot());
 }
 
+std::optional<dynamic_config::impl::SnapshotData>
+DynamicConfig::Impl::ParseConfig(const dynamic_config::DocsMap& value) {
+  const auto start = std::chrono::steady_clock::now();
+  std::optional<dynamic_config::impl::SnapshotData> config;
+  try {
+    if (Has()) {
+      const auto changed_names = value.GetChangedNames(docs_);
+      if (changed_names.empty()) return std::nullopt;
+      const auto previous = cache_.config.Read();
+      config.emplace(*previous, value, changed_names, dependencies_);
+    } else {
+      config.emplace(value, dependencies_);
+    }
+  } catch (const std::exception&) {
+    // Dependencies may be left half-updated, parse everything next time
+    dependencies_.clear();
+    throw;
+  }
+
+  last_parse_time_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  return config;
+}
+
+formats::json::Value DynamicConfig::Impl::ExtendStatistics() const {
+  formats::json::ValueBuilder result;
+  result["updates"] = updates_.Load();
+  result["unchanged-updates"] = unchanged_updates_.Load();
+  result["last-parse-time-ms"] = last_parse_time_ms_.load();
+  return result.ExtractValue();
+}
+
 void DynamicConfig::Impl::SetConfig(std::string_view updater,
                                     const dynamic_config::DocsMap& value) {
   LOG_DEBUG() << "Setting new dynamic config value from '" << updater << "'";
@@ -11,6 +11,9 @@ USERVER_NAMESPACE_BEGIN
 namespace dynamic_config {
 
 formats::json::Value DocsMap::Get(const std::string& name) const {
+  // A missing item is a dependency too, it may appear in the next update
+  if (requested_names_recorder_) requested_names_recorder_->push_back(name);
+
   const auto it = docs_.find(name);
   if (it == docs_.end()) {
     throw std::runtime_error("Can't find doc for '" + name + "'");
@@ -78,6 +81,29 @@ bool DocsMap::AreContentsEqual(const DocsMap& other) const {
   return docs_ == other.docs_;
 }
 
+std::unordered_set<std::string> DocsMap::GetChangedNames(
+    const DocsMap& previous) const {
+  std::unordered_set<std::string> changed;
+  for (const auto& [name, value] : docs_) {
+    const auto it = previous.docs_.find(name);
+    if (it == previous.docs_.end() || it->second != value) {
+      changed.insert(name);
+    }
+  }
+  for (const auto& [name, value] : previous.docs_) {
+    if (docs_.find(name) == docs_.end()) changed.insert(name);
+  }
+  return changed;
+}
+
+void DocsMap::RecordRequestedNames(std::vector<std::string>* names) const {
+  requested_names_recorder_ = names;
+}
+
+void DocsMap::MarkRequestedNames(const std::vector<std::string>& names) const {
+  requested_names_.insert(names.begin(), names.end());
+}
+
 const std::string kValueDictDefaultName = "__default__";
 
 }  // namespace dynamic_config
@@ -29,6 +29,32 @@ TEST(DocsMap, AreContentsEqualFalse) {
   EXPECT_FALSE(docs_map1.AreContentsEqual(docs_map2));
 }
 
+TEST(DocsMap, GetChangedNames) {
+  dynamic_config::DocsMap previous;
+  previous.Parse(R"({"a": 1, "b": {"x": 2}, "c": 3})", false);
+
+  dynamic_config::DocsMap current;
+  current.Parse(R"({"a": 1, "b": {"x": 4}, "d": 5})", false);
+
+  EXPECT_EQ(current.GetChangedNames(previous),
+            (std::unordered_set<std::string>{"b", "c", "d"}));
+  EXPECT_TRUE(current.GetChangedNames(current).empty());
+}
+
+TEST(DocsMap, RecordRequestedNames) {
+  dynamic_config::DocsMap docs_map;
+  docs_map.Parse(R"({"a": 1, "b": 2})", false);
+
+  std::vector<std::string> names;
+  docs_map.RecordRequestedNames(&names);
+  (void)docs_map.Get("b");
+  EXPECT_ANY_THROW((void)docs_map.Get("missing"));
+  docs_map.RecordRequestedNames(nullptr);
+  (void)docs_map.Get("a");
+
+  EXPECT_EQ(names, (std::vector<std::string>{"b", "missing"}));
+}
+
 TEST(ValueDict, UseAsRange) {
   using ValueDict = dynamic_config::ValueDict<int>;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>  // for std::max
+#include <array>
 #include <atomic>
 #include <cerrno>
 #include <utility>
@@ -14,6 +15,7 @@
 
 #include "pool_config.hpp"
 #include "pool_stats.hpp"
+#include "stack_memory.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -36,8 +38,14 @@ class Pool final {
   std::size_t GetStackSize() const;
 
  private:
-  Coroutine CreateCoroutine(bool quiet = false);
+  struct IdleCoroutine {
+    Coroutine coroutine;
+    boost::context::stack_context stack;
+  };
+
+  IdleCoroutine CreateCoroutine(bool quiet = false);
   void OnCoroutineDestruction() noexcept;
+  void AccountStackUsage(const boost::context::stack_context& stack) noexcept;
 
   template <typename Token>
   Token& GetToken();
@@ -46,16 +54,21 @@ class Pool final {
   const Executor executor_;
 
   boost::coroutines2::protected_fixedsize_stack stack_allocator_;
-  moodycamel::ConcurrentQueue<Coroutine> coroutines_;
+  moodycamel::ConcurrentQueue<IdleCoroutine> coroutines_;
   std::atomic<std::size_t> idle_coroutines_num_;
   std::atomic<std::size_t> total_coroutines_num_;
+
+  std::array<std::atomic<std::size_t>, kStackUsageHistogramBuckets>
+      stack_usage_histogram_{};
+  std::atomic<std::size_t> max_stack_usage_{0};
+  std::atomic<std::size_t> released_stacks_num_{0};
 };
 
 template <typename Task>
 class Pool<Task>::CoroutinePtr final {
  public:
-  CoroutinePtr(Coroutine&& coro, Pool<Task>& pool) noexcept
-      : coro_(std::move(coro)), pool_(&pool) {}
+  CoroutinePtr(IdleCoroutine&& coro, Pool<Task>& pool) noexcept
+      : coro_(std::move(coro.coroutine)), stack_(coro.stack), pool_(&pool) {}
 
   CoroutinePtr(CoroutinePtr&&) noexcept = default;
   CoroutinePtr& operator=(CoroutinePtr&&) noexcept = default;
@@ -70,6 +83,10 @@ class Pool<Task>::CoroutinePtr final {
     return coro_;
   }
 
+  const boost::context::stack_context& GetStack() const noexcept {
+    return stack_;
+  }
+
   void ReturnToPool() && {
     UASSERT(coro_);
     pool_->PutCoroutine(std::move(*this));
@@ -77,6 +94,7 @@ class Pool<Task>::CoroutinePtr final {
 
  private:
   Coroutine coro_;
+  boost::context::stack_context stack_;
   Pool<Task>* pool_;
 };
 
@@ -101,15 +119,15 @@ Pool<Task>::~Pool() = default;
 template <typename Task>
 typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine() {
   struct CoroutineMover {
-    std::optional<Coroutine>& result;
+    std::optional<IdleCoroutine>& result;
 
-    CoroutineMover& operator=(Coroutine&& coro) {
+    CoroutineMover& operator=(IdleCoroutine&& coro) {
       result.emplace(std::move(coro));
       return *this;
     }
   };
 
-  std::optional<Coroutine> coroutine;
+  std::optional<IdleCoroutine> coroutine;
   CoroutineMover mover{coroutine};
   auto& token = GetToken<moodycamel::ConsumerToken>();
   if (coroutines_.try_dequeue(token, mover)) {
@@ -122,9 +140,27 @@ typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine() {
 
 template <typename Task>
 void Pool<Task>::PutCoroutine(CoroutinePtr&& coroutine_ptr) {
-  if (idle_coroutines_num_.load() >= config_.max_size) return;
+  const auto& stack = coroutine_ptr.GetStack();
+  // Frames of an idle coroutine live at the very top of its stack, the
+  // executor records how deep they go right before suspending
+  const auto idle_stack_size = TakeIdleStackSize(stack);
+  UASSERT_MSG(idle_stack_size != 0,
+              "The executor must call RecordIdleStackPointer() before "
+              "waiting for the next task");
+  if (config_.stack_usage_monitor_enabled) AccountStackUsage(stack);
+
+  const auto idle_coroutines_num = idle_coroutines_num_.load();
+  if (idle_coroutines_num >= config_.max_size) return;
+  if (idle_coroutines_num >= config_.stack_release_watermark &&
+      idle_stack_size != 0 &&
+      ReleaseStackMemory(stack, idle_stack_size,
+                         config_.stack_release_method)) {
+    ++released_stacks_num_;
+  }
+
   auto& token = GetToken<moodycamel::ProducerToken>();
-  const bool ok = coroutines_.enqueue(token, std::move(coroutine_ptr.Get()));
+  const bool ok = coroutines_.enqueue(
+      token, IdleCoroutine{std::move(coroutine_ptr.Get()), stack});
   if (ok) ++idle_coroutines_num_;
 }
 
@@ -135,19 +171,28 @@ PoolStats Pool<Task>::GetStats() const {
       total_coroutines_num_.load() - coroutines_.size_approx();
   stats.total_coroutines =
       std::max(total_coroutines_num_.load(), stats.active_coroutines);
+  for (std::size_t i = 0; i < kStackUsageHistogramBuckets; ++i) {
+    stats.stack_usage_histogram[i] = stack_usage_histogram_[i].load();
+  }
+  stats.max_stack_usage = max_stack_usage_.load();
+  stats.released_stacks = released_stacks_num_.load();
   return stats;
 }
 
 template <typename Task>
-typename Pool<Task>::Coroutine Pool<Task>::CreateCoroutine(bool quiet) {
+typename Pool<Task>::IdleCoroutine Pool<Task>::CreateCoroutine(bool quiet) {
   try {
-    Coroutine coroutine(stack_allocator_, executor_);
+    boost::context::stack_context stack;
+    Coroutine coroutine(
+        RecordingStackAllocator<boost::coroutines2::protected_fixedsize_stack>(
+            stack_allocator_, stack),
+        executor_);
     const auto new_total = ++total_coroutines_num_;
     if (!quiet) {
       LOG_DEBUG() << "Created a coroutine #" << new_total << '/'
                   << config_.max_size;
     }
-    return coroutine;
+    return {std::move(coroutine), stack};
   } catch (const std::bad_alloc&) {
     if (errno == ENOMEM) {
       // It should be ok to allocate here (which LOG_ERROR might do),
@@ -170,6 +215,22 @@ void Pool<Task>::OnCoroutineDestruction() noexcept {
   --total_coroutines_num_;
 }
 
+template <typename Task>
+void Pool<Task>::AccountStackUsage(
+    const boost::context::stack_context& stack) noexcept {
+  const auto usage = GetStackUsage(stack);
+
+  const auto bucket = std::min(usage * kStackUsageHistogramBuckets /
+                                   std::max(config_.stack_size, std::size_t{1}),
+                               kStackUsageHistogramBuckets - 1);
+  stack_usage_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  auto max_usage = max_stack_usage_.load(std::memory_order_relaxed);
+  while (usage > max_usage && !max_stack_usage_.compare_exchange_weak(
+                                  max_usage, usage, std::memory_order_relaxed)) {
+  }
+}
+
 template <typename Task>
 std::size_t Pool<Task>::GetStackSize() const {
   return config_.stack_size;
@@ -1,15 +1,37 @@
 #include "pool_config.hpp"
 
+#include <userver/utils/assert.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+StackReleaseMethod Parse(const yaml_config::YamlConfig& value,
+                         formats::parse::To<StackReleaseMethod>) {
+  const auto str = value.As<std::string>();
+  if (str == "dontneed") {
+    return StackReleaseMethod::kDontNeed;
+  } else if (str == "free") {
+    return StackReleaseMethod::kFree;
+  }
+
+  UINVARIANT(false, "Unknown stack release method: " + str);
+}
+
 PoolConfig Parse(const yaml_config::YamlConfig& value,
                  formats::parse::To<PoolConfig>) {
   PoolConfig config;
   config.initial_size = value["initial_size"].As<size_t>();
   config.max_size = value["max_size"].As<size_t>();
   config.stack_size = value["stack_size"].As<size_t>(config.stack_size);
+  config.stack_release_watermark =
+      value["stack_release_watermark"].As<size_t>(config.max_size);
+  config.stack_release_method =
+      value["stack_release_method"].As<StackReleaseMethod>(
+          config.stack_release_method);
+  config.stack_usage_monitor_enabled =
+      value["stack_usage_monitor_enabled"].As<bool>(
+          config.stack_usage_monitor_enabled);
   return config;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <string>
 
 #include <userver/formats/yaml.hpp>
@@ -9,10 +10,25 @@ USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+enum class StackReleaseMethod {
+  // Memory is released right away, RSS drops immediately
+  kDontNeed,
+  // Memory is reclaimed by the kernel lazily, only under memory pressure
+  kFree,
+};
+
 struct PoolConfig {
   size_t initial_size = 1000;
   size_t max_size = 10000;
   size_t stack_size = 256 * 1024ULL;
+
+  // Stacks of the coroutines returned to the pool while there are at least
+  // that many idle coroutines are given back to the OS
+  size_t stack_release_watermark = std::numeric_limits<size_t>::max();
+  StackReleaseMethod stack_release_method = StackReleaseMethod::kDontNeed;
+
+  // Measure stack usage of the coroutines returned to the pool
+  bool stack_usage_monitor_enabled = false;
 };
 
 PoolConfig Parse(const yaml_config::YamlConfig& value,
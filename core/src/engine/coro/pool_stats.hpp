@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <utility>
 
@@ -7,14 +9,28 @@ USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+inline constexpr std::size_t kStackUsageHistogramBuckets = 10;
+
 struct PoolStats {
   size_t active_coroutines = 0;
   size_t total_coroutines = 0;
+
+  // Bucket `i` counts the coroutines returned to the pool that have used
+  // from `i * 10%` to `(i + 1) * 10%` of the stack. Filled only if the stack
+  // usage monitor is enabled.
+  std::array<size_t, kStackUsageHistogramBuckets> stack_usage_histogram{};
+  size_t max_stack_usage = 0;
+  size_t released_stacks = 0;
 };
 
 inline PoolStats& operator+=(PoolStats& lhs, const PoolStats& rhs) {
   lhs.active_coroutines += rhs.active_coroutines;
   lhs.total_coroutines += rhs.total_coroutines;
+  for (std::size_t i = 0; i < kStackUsageHistogramBuckets; ++i) {
+    lhs.stack_usage_histogram[i] += rhs.stack_usage_histogram[i];
+  }
+  lhs.max_stack_usage = std::max(lhs.max_stack_usage, rhs.max_stack_usage);
+  lhs.released_stacks += rhs.released_stacks;
   return lhs;
 }
 
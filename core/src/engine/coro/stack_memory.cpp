@@ -0,0 +1,117 @@
+#include "stack_memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+#include <vector>
+
+#include <uboost_coro/context/stack_traits.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+namespace {
+
+// The frames of coroutine2 and of the context switch itself lie below the
+// pointer recorded by the executor when an idle coroutine is suspended
+constexpr std::size_t kContextSwitchReserve = 8 * 1024;
+
+thread_local const char* idle_stack_pointer = nullptr;
+
+// The lowest page of a stack is the guard page
+char* GetUsableStackBottom(const boost::context::stack_context& stack) {
+  return static_cast<char*>(stack.sp) - stack.size +
+         boost::context::stack_traits::page_size();
+}
+
+int ToMadviseAdvice(StackReleaseMethod method) {
+  switch (method) {
+    case StackReleaseMethod::kDontNeed:
+      return MADV_DONTNEED;
+    case StackReleaseMethod::kFree:
+#ifdef MADV_FREE
+      return MADV_FREE;
+#else
+      return MADV_DONTNEED;
+#endif
+  }
+  return MADV_DONTNEED;
+}
+
+}  // namespace
+
+std::size_t GetStackUsage(const boost::context::stack_context& stack) noexcept {
+  const auto page_size = boost::context::stack_traits::page_size();
+  auto* const bottom = GetUsableStackBottom(stack);
+  auto* const top = static_cast<char*>(stack.sp);
+  const auto pages = static_cast<std::size_t>(top - bottom) / page_size;
+
+  // PutCoroutine is called from the worker threads, not from coroutines
+  thread_local std::vector<unsigned char> residency;
+  residency.resize(pages);
+
+#ifdef __APPLE__
+  using ResidencyVector = char*;
+#else
+  using ResidencyVector = unsigned char*;
+#endif
+  if (::mincore(bottom, top - bottom,
+                reinterpret_cast<ResidencyVector>(residency.data())) != 0) {
+    return 0;
+  }
+
+  for (std::size_t i = 0; i < pages; ++i) {
+    if (residency[i] & 1) return (pages - i) * page_size;
+  }
+  return 0;
+}
+
+// Must not be inlined, so that the frame of the caller lies above the recorded
+// pointer as a whole
+__attribute__((noinline)) void RecordIdleStackPointer() noexcept {
+  idle_stack_pointer = static_cast<const char*>(__builtin_frame_address(0));
+}
+
+std::size_t TakeIdleStackSize(
+    const boost::context::stack_context& stack) noexcept {
+  const auto* const sp = std::exchange(idle_stack_pointer, nullptr);
+  const auto* const bottom = GetUsableStackBottom(stack);
+  const auto* const top = static_cast<const char*>(stack.sp);
+  if (sp == nullptr || sp < bottom || sp >= top) return 0;
+
+  // ReleaseStackMemory() rounds the size up, i.e. the pointer down, to a page
+  return std::min(static_cast<std::size_t>(top - sp) + kContextSwitchReserve,
+                  static_cast<std::size_t>(top - bottom));
+}
+
+bool ReleaseStackMemory(const boost::context::stack_context& stack,
+                        std::size_t keep_bytes,
+                        StackReleaseMethod method) noexcept {
+  const auto page_size = boost::context::stack_traits::page_size();
+  auto* const bottom = GetUsableStackBottom(stack);
+  auto* const top = static_cast<char*>(stack.sp);
+
+  // Round up to the page boundary to never touch the kept frames
+  const auto keep_pages = (keep_bytes + page_size - 1) / page_size;
+  if (static_cast<std::size_t>(top - bottom) <= keep_pages * page_size) {
+    return false;
+  }
+  const auto release_size =
+      static_cast<std::size_t>(top - bottom) - keep_pages * page_size;
+
+  if (::madvise(bottom, release_size, ToMadviseAdvice(method)) == 0) {
+    return true;
+  }
+
+  // MADV_FREE is not supported by kernels older than 4.5
+  return method == StackReleaseMethod::kFree && errno == EINVAL &&
+         ::madvise(bottom, release_size, MADV_DONTNEED) == 0;
+}
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
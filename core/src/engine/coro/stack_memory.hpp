@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+#include <uboost_coro/context/stack_context.hpp>
+
+#include "pool_config.hpp"
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+/// Wraps a stack allocator and records the allocated stack_context, so that
+/// the pool knows the stack bounds of the coroutine.
+template <typename StackAllocator>
+class RecordingStackAllocator final {
+ public:
+  RecordingStackAllocator(const StackAllocator& allocator,
+                          boost::context::stack_context& recorded) noexcept
+      : allocator_(allocator), recorded_(&recorded) {}
+
+  boost::context::stack_context allocate() {
+    auto stack = allocator_.allocate();
+    if (recorded_) *recorded_ = stack;
+    recorded_ = nullptr;
+    return stack;
+  }
+
+  void deallocate(boost::context::stack_context& stack) noexcept {
+    allocator_.deallocate(stack);
+  }
+
+ private:
+  StackAllocator allocator_;
+  boost::context::stack_context* recorded_;
+};
+
+/// Returns the distance from the top of the stack to its lowest resident
+/// page, i.e. the maximum stack depth since the last ReleaseStackMemory().
+///
+/// Pages released with StackReleaseMethod::kFree stay resident until the
+/// kernel reclaims them, so the result is an upper bound in that case.
+std::size_t GetStackUsage(const boost::context::stack_context& stack) noexcept;
+
+/// Remembers the current stack pointer of the calling coroutine. The pool
+/// executor calls it right before suspending to wait for the next task.
+void RecordIdleStackPointer() noexcept;
+
+/// Returns the size of the top part of `stack` that holds the frames of the
+/// suspended idle coroutine, computed from the stack pointer recorded by the
+/// last RecordIdleStackPointer() call on this thread, or 0 if no pointer was
+/// recorded for that stack. Forgets the recorded pointer.
+std::size_t TakeIdleStackSize(
+    const boost::context::stack_context& stack) noexcept;
+
+/// Gives the memory of the stack back to the OS, except for the top
+/// `keep_bytes` that hold the frames of a suspended idle coroutine.
+/// The memory is committed again on the next touch.
+///
+/// @returns whether the memory was released
+bool ReleaseStackMemory(const boost::context::stack_context& stack,
+                        std::size_t keep_bytes,
+                        StackReleaseMethod method) noexcept;
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
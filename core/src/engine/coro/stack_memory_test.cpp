@@ -0,0 +1,104 @@
+#include <engine/coro/stack_memory.hpp>
+
+#include <cstring>
+
+#include <engine/coro/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <uboost_coro/context/protected_fixedsize_stack.hpp>
+#include <uboost_coro/context/stack_traits.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t kStackSize = 256 * 1024;
+
+class StackMemory : public ::testing::Test {
+ protected:
+  StackMemory() : allocator_(kStackSize), stack_(allocator_.allocate()) {}
+  ~StackMemory() override { allocator_.deallocate(stack_); }
+
+  void TouchTop(std::size_t bytes) {
+    std::memset(static_cast<char*>(stack_.sp) - bytes, 1, bytes);
+  }
+
+  boost::context::protected_fixedsize_stack allocator_;
+  boost::context::stack_context stack_;
+};
+
+struct Job {
+  std::size_t runs{0};
+  bool canary_intact{true};
+};
+
+using JobPool = engine::coro::Pool<Job>;
+
+void RunJobs(JobPool::TaskPipe& pipe) {
+  // Lives in the frames of the idle coroutine while its stack is released
+  volatile char canary[256];
+  for (auto& c : canary) c = 'x';
+
+  for (Job* job : pipe) {
+    ++job->runs;
+    for (const auto& c : canary) {
+      if (c != 'x') job->canary_intact = false;
+    }
+    engine::coro::RecordIdleStackPointer();
+  }
+}
+
+}  // namespace
+
+TEST_F(StackMemory, Usage) {
+  const auto page_size = boost::context::stack_traits::page_size();
+  EXPECT_EQ(engine::coro::GetStackUsage(stack_), 0);
+
+  TouchTop(page_size);
+  EXPECT_EQ(engine::coro::GetStackUsage(stack_), page_size);
+
+  TouchTop(kStackSize / 2);
+  EXPECT_EQ(engine::coro::GetStackUsage(stack_), kStackSize / 2);
+}
+
+TEST_F(StackMemory, Release) {
+  const auto page_size = boost::context::stack_traits::page_size();
+  TouchTop(kStackSize);
+  EXPECT_EQ(engine::coro::GetStackUsage(stack_), kStackSize);
+
+  EXPECT_TRUE(engine::coro::ReleaseStackMemory(
+      stack_, page_size * 2, engine::coro::StackReleaseMethod::kDontNeed));
+  EXPECT_EQ(engine::coro::GetStackUsage(stack_), page_size * 2);
+
+  // The kept part is intact, the released part reads as zeros
+  EXPECT_EQ(*(static_cast<char*>(stack_.sp) - 1), 1);
+  EXPECT_EQ(*(static_cast<char*>(stack_.sp) - page_size * 3), 0);
+}
+
+TEST_F(StackMemory, ReleaseNothing) {
+  EXPECT_FALSE(engine::coro::ReleaseStackMemory(
+      stack_, kStackSize, engine::coro::StackReleaseMethod::kFree));
+}
+
+TEST(StackMemoryPool, ResumeReleased) {
+  engine::coro::PoolConfig config;
+  config.initial_size = 0;
+  config.max_size = 1;
+  config.stack_release_watermark = 0;
+  JobPool pool(config, &RunJobs);
+
+  Job job;
+  constexpr std::size_t kRuns = 3;
+  for (std::size_t i = 0; i < kRuns; ++i) {
+    auto coroutine = pool.GetCoroutine();
+    coroutine.Get()(&job);
+    std::move(coroutine).ReturnToPool();
+  }
+
+  EXPECT_EQ(job.runs, kRuns);
+  EXPECT_TRUE(job.canary_intact);
+  EXPECT_EQ(pool.GetStats().released_stacks, kRuns);
+}
+
+USERVER_NAMESPACE_END
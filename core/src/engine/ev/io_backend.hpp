@@ -0,0 +1,19 @@
+#pragma once
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::ev {
+
+/// Backend for the socket I/O of the tasks
+enum class IoBackend {
+  /// Readiness notifications from the ev-loop (epoll/kqueue) and
+  /// non-blocking syscalls from the task
+  kEpoll,
+  /// Operations are submitted to an io_uring of the ev thread; falls back to
+  /// kEpoll if the kernel does not support it
+  kIoUring,
+};
+
+}  // namespace engine::ev
+
+USERVER_NAMESPACE_END
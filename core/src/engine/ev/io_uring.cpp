@@ -0,0 +1,412 @@
+#include <engine/ev/io_uring.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+
+// MAC_COMPAT: io_uring is Linux only, other platforms always use epoll/kqueue
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+#define USERVER_IMPL_IO_URING_AVAILABLE 1
+#endif
+
+#ifdef USERVER_IMPL_IO_URING_AVAILABLE
+// Older kernel headers. The support is detected at runtime anyway.
+#ifndef IORING_CQE_F_MORE
+#define IORING_CQE_F_MORE (1U << 1)
+#endif
+#ifndef IORING_SQ_CQ_OVERFLOW
+#define IORING_SQ_CQ_OVERFLOW (1U << 1)
+#endif
+#endif
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::ev {
+
+namespace {
+
+const std::size_t kInitQueueCapacity = 128;
+
+#ifdef USERVER_IMPL_IO_URING_AVAILABLE
+constexpr unsigned kRingEntries = 256;
+
+// Completions of the requests may outnumber the submissions because of the
+// multishot requests
+constexpr unsigned kCompletionRingEntries = kRingEntries * 4;
+
+constexpr std::uint8_t kRequiredOps[] = {
+    IORING_OP_RECV,    IORING_OP_SEND,    IORING_OP_SENDMSG,
+    IORING_OP_ACCEPT,  IORING_OP_CONNECT, IORING_OP_ASYNC_CANCEL,
+};
+
+// The ring is shared with the kernel, see io_uring(7) for the protocol
+unsigned LoadAcquire(const unsigned* ptr) noexcept {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* ptr, unsigned value) noexcept {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+int IoUringSetup(unsigned entries, io_uring_params& params) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, void* arg,
+                    unsigned nr_args) noexcept {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+bool AreRequiredOpsSupported(int fd) {
+  constexpr unsigned kMaxOps = 256;
+  std::vector<char> buffer(sizeof(io_uring_probe) +
+                           kMaxOps * sizeof(io_uring_probe_op));
+  auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+  if (IoUringRegister(fd, IORING_REGISTER_PROBE, probe, kMaxOps) != 0) {
+    LOG_WARNING() << "io_uring does not support probing (Linux 5.6+ is "
+                     "required), falling back to epoll";
+    return false;
+  }
+
+  for (const auto op : kRequiredOps) {
+    if (op > probe->last_op ||
+        !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+      LOG_WARNING() << "io_uring operation " << static_cast<int>(op)
+                    << " is not supported by the kernel, falling back to epoll";
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+}  // namespace
+
+#ifdef USERVER_IMPL_IO_URING_AVAILABLE
+struct IoUring::Ring {
+  Ring() = default;
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  ~Ring() {
+    if (sqes) ::munmap(sqes, sqes_map_size);
+    if (rings) ::munmap(rings, rings_map_size);
+    if (fd != -1) ::close(fd);
+  }
+
+  io_uring_sqe* GetSqe() noexcept {
+    const auto tail = *sq_tail;
+    if (tail - LoadAcquire(sq_head) >= sq_entries) return nullptr;
+    return &sqes[tail & sq_mask];
+  }
+
+  void CommitSqe() noexcept {
+    const auto tail = *sq_tail;
+    sq_array[tail & sq_mask] = tail & sq_mask;
+    StoreRelease(sq_tail, tail + 1);
+    ++to_submit;
+  }
+
+  int fd{-1};
+
+  void* rings{nullptr};
+  std::size_t rings_map_size{0};
+  io_uring_sqe* sqes{nullptr};
+  std::size_t sqes_map_size{0};
+
+  unsigned* sq_head{nullptr};
+  unsigned* sq_tail{nullptr};
+  unsigned* sq_flags{nullptr};
+  unsigned* sq_array{nullptr};
+  unsigned sq_mask{0};
+  unsigned sq_entries{0};
+
+  unsigned* cq_head{nullptr};
+  unsigned* cq_tail{nullptr};
+  io_uring_cqe* cqes{nullptr};
+  unsigned cq_mask{0};
+
+  unsigned to_submit{0};
+};
+
+std::unique_ptr<IoUring::Ring> IoUring::MakeRing() {
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionRingEntries;
+
+  auto ring = std::make_unique<Ring>();
+  ring->fd = IoUringSetup(kRingEntries, params);
+  if (ring->fd == -1) {
+    const auto error_code = errno;
+    LOG_WARNING() << "io_uring is not available: "
+                  << std::error_code(error_code, std::system_category())
+                         .message()
+                  << ", falling back to epoll";
+    return nullptr;
+  }
+
+  // Both features are present in all of the kernels that support probing
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_NODROP)) {
+    LOG_WARNING() << "io_uring of this kernel is too old, falling back to "
+                     "epoll";
+    return nullptr;
+  }
+  if (!AreRequiredOpsSupported(ring->fd)) return nullptr;
+
+  ring->rings_map_size =
+      std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+               params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  auto* rings = ::mmap(nullptr, ring->rings_map_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (rings == MAP_FAILED) {
+    LOG_WARNING() << "Failed to map io_uring rings, falling back to epoll";
+    return nullptr;
+  }
+  ring->rings = rings;
+
+  ring->sqes_map_size = params.sq_entries * sizeof(io_uring_sqe);
+  auto* sqes = ::mmap(nullptr, ring->sqes_map_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    LOG_WARNING() << "Failed to map io_uring submission entries, falling "
+                     "back to epoll";
+    return nullptr;
+  }
+  ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+  auto* base = static_cast<char*>(rings);
+  const auto field = [base](std::uint32_t offset) {
+    return reinterpret_cast<unsigned*>(base + offset);
+  };
+  ring->sq_head = field(params.sq_off.head);
+  ring->sq_tail = field(params.sq_off.tail);
+  ring->sq_flags = field(params.sq_off.flags);
+  ring->sq_array = field(params.sq_off.array);
+  ring->sq_mask = *field(params.sq_off.ring_mask);
+  ring->sq_entries = *field(params.sq_off.ring_entries);
+
+  ring->cq_head = field(params.cq_off.head);
+  ring->cq_tail = field(params.cq_off.tail);
+  ring->cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+  ring->cq_mask = *field(params.cq_off.ring_mask);
+
+  return ring;
+}
+
+std::unique_ptr<IoUring> IoUring::TryCreate() {
+  auto ring = MakeRing();
+  if (!ring) return nullptr;
+  return std::unique_ptr<IoUring>(new IoUring(std::move(ring)));
+}
+#else
+struct IoUring::Ring {};
+
+std::unique_ptr<IoUring> IoUring::TryCreate() {
+  LOG_WARNING() << "io_uring is not supported on this platform, falling back "
+                   "to the default I/O backend";
+  return nullptr;
+}
+#endif
+
+IoUring::IoUring(std::unique_ptr<Ring> ring)
+    : ring_(std::move(ring)), queue_(kInitQueueCapacity) {}
+
+IoUring::~IoUring() {
+  UASSERT_MSG(in_flight_ == 0, "io_uring requests are still in flight");
+}
+
+void IoUring::Submit(IoUringRequest& request) {
+  UASSERT(loop_);
+  if (!queue_.push({&request, QueuedAction::kSubmit})) {
+    throw std::runtime_error("can't push io_uring request to queue");
+  }
+  // Coalesced by libev if the ev-loop has not woken up yet
+  ev_async_send(loop_, &watch_submit_);
+}
+
+void IoUring::Cancel(IoUringRequest& request) {
+  UASSERT(loop_);
+  if (!queue_.push({&request, QueuedAction::kCancel})) {
+    throw std::runtime_error("can't push io_uring cancellation to queue");
+  }
+  ev_async_send(loop_, &watch_submit_);
+}
+
+bool IoUring::IsMultishotAcceptSupported() const noexcept {
+  return multishot_accept_supported_.load(std::memory_order_relaxed);
+}
+
+void IoUring::DisableMultishotAccept() noexcept {
+  if (multishot_accept_supported_.exchange(false)) {
+    LOG_INFO() << "Multishot accept is not supported by the kernel, using "
+                  "single shot accept";
+  }
+}
+
+void IoUring::StartWatchers(struct ev_loop* loop) {
+  UASSERT(!loop_);
+  loop_ = loop;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  ev_async_init(&watch_submit_, OnSubmitAsync);
+  watch_submit_.data = this;
+  ev_async_start(loop_, &watch_submit_);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  ev_prepare_init(&watch_flush_, OnPrepare);
+  watch_flush_.data = this;
+  ev_prepare_start(loop_, &watch_flush_);
+
+#ifdef USERVER_IMPL_IO_URING_AVAILABLE
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  ev_io_init(&watch_completions_, OnRingReadable, ring_->fd, EV_READ);
+  watch_completions_.data = this;
+  ev_io_start(loop_, &watch_completions_);
+#endif
+}
+
+void IoUring::StopWatchers(struct ev_loop* loop) {
+  UASSERT(loop_ == loop);
+  ev_async_stop(loop, &watch_submit_);
+  ev_prepare_stop(loop, &watch_flush_);
+  ev_io_stop(loop, &watch_completions_);
+
+  FlushSubmissions();
+  if (in_flight_ != 0) {
+    LOG_INFO() << "Waiting for " << in_flight_
+               << " io_uring requests to complete";
+  }
+  while (in_flight_ != 0) {
+    Enter(/*min_complete=*/1);
+    ReapCompletions();
+    FlushSubmissions();
+  }
+}
+
+void IoUring::OnSubmitAsync(struct ev_loop*, ev_async*, int) noexcept {
+  // Only wakes up the ev-loop, the requests are flushed in OnPrepare
+}
+
+void IoUring::OnPrepare(struct ev_loop*, ev_prepare* watcher, int) noexcept {
+  static_cast<IoUring*>(watcher->data)->FlushSubmissions();
+}
+
+void IoUring::OnRingReadable(struct ev_loop*, ev_io* watcher, int) noexcept {
+  static_cast<IoUring*>(watcher->data)->ReapCompletions();
+}
+
+#ifdef USERVER_IMPL_IO_URING_AVAILABLE
+void IoUring::FlushSubmissions() noexcept {
+  QueuedRequest queued{};
+  while (queue_.pop(queued)) {
+    auto* sqe = ring_->GetSqe();
+    while (!sqe) {
+      // The kernel consumes the submission entries on enter, completions
+      // are reaped to make room in case of the completion ring overflow
+      Enter(/*min_complete=*/0);
+      sqe = ring_->GetSqe();
+      if (!sqe) ReapCompletions();
+    }
+
+    std::memset(sqe, 0, sizeof(*sqe));
+    switch (queued.action) {
+      case QueuedAction::kSubmit:
+        queued.request->Prepare(*sqe);
+        sqe->user_data = reinterpret_cast<std::uintptr_t>(queued.request);
+        ++in_flight_;
+        break;
+      case QueuedAction::kCancel:
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(queued.request);
+        // The completion of the cancellation itself is ignored
+        sqe->user_data = 0;
+        break;
+    }
+    ring_->CommitSqe();
+  }
+
+  if (ring_->to_submit != 0) Enter(/*min_complete=*/0);
+}
+
+void IoUring::ReapCompletions() noexcept {
+  for (;;) {
+    auto head = *ring_->cq_head;
+    const auto tail = LoadAcquire(ring_->cq_tail);
+    if (head == tail) {
+      if (!(LoadAcquire(ring_->sq_flags) & IORING_SQ_CQ_OVERFLOW)) break;
+      // Moves the overflown completions into the ring
+      Enter(/*min_complete=*/0);
+      continue;
+    }
+
+    for (; head != tail; ++head) {
+      const auto& cqe = ring_->cqes[head & ring_->cq_mask];
+      const auto user_data = cqe.user_data;
+      const auto result = cqe.res;
+      const auto flags = cqe.flags;
+      StoreRelease(ring_->cq_head, head + 1);
+
+      if (!user_data) continue;
+      if (!(flags & IORING_CQE_F_MORE)) --in_flight_;
+      // The request may be destroyed right after the call
+      reinterpret_cast<IoUringRequest*>(user_data)->OnCompletion(result,
+                                                                 flags);
+    }
+  }
+}
+
+void IoUring::Enter(unsigned min_complete) noexcept {
+  const auto flags = (min_complete != 0 ||
+                      (LoadAcquire(ring_->sq_flags) & IORING_SQ_CQ_OVERFLOW))
+                         ? IORING_ENTER_GETEVENTS
+                         : 0;
+  for (;;) {
+    const auto ret =
+        IoUringEnter(ring_->fd, ring_->to_submit, min_complete, flags);
+    if (ret >= 0) {
+      ring_->to_submit -= static_cast<unsigned>(ret);
+      return;
+    }
+
+    const auto error_code = errno;
+    if (error_code == EINTR) continue;
+    if (error_code != EAGAIN && error_code != EBUSY) {
+      LOG_ERROR() << "io_uring_enter failed: "
+                  << std::error_code(error_code, std::system_category())
+                         .message();
+    }
+    // Retried on the next ev-loop iteration
+    return;
+  }
+}
+#else
+void IoUring::FlushSubmissions() noexcept { UASSERT(false); }
+void IoUring::ReapCompletions() noexcept { UASSERT(false); }
+void IoUring::Enter(unsigned) noexcept { UASSERT(false); }
+#endif
+
+}  // namespace engine::ev
+
+USERVER_NAMESPACE_END
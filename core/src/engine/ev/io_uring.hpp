@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <ev.h>
+#include <boost/lockfree/queue.hpp>
+
+struct io_uring_sqe;
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::ev {
+
+/// Operation submitted to the io_uring of an ev thread.
+///
+/// Must stay alive until its final completion is delivered to
+/// OnCompletion(), i.e. the one without `IORING_CQE_F_MORE` flag.
+class IoUringRequest {
+ public:
+  /// Called in ev thread to fill the submission entry, the entry is zeroed
+  /// beforehand and `user_data` is set by IoUring
+  virtual void Prepare(io_uring_sqe& sqe) noexcept = 0;
+
+  /// Called in ev thread for each completion of the request
+  virtual void OnCompletion(int result, std::uint32_t flags) noexcept = 0;
+
+ protected:
+  ~IoUringRequest() = default;
+};
+
+/// Owns an io_uring instance of an ev thread.
+///
+/// Requests are accepted from any thread and are batched: all of the requests
+/// received during an ev-loop iteration are submitted with a single
+/// io_uring_enter() right before the ev-loop blocks. Completions are reaped
+/// when the ring fd becomes readable.
+class IoUring final {
+ public:
+  /// Returns nullptr if io_uring or any of the required operations is not
+  /// supported by the kernel
+  static std::unique_ptr<IoUring> TryCreate();
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+  ~IoUring();
+
+  /// Queues the request for submission, thread-safe
+  void Submit(IoUringRequest& request);
+
+  /// Queues the asynchronous cancellation of the request, thread-safe.
+  /// The request still receives its final completion, typically with
+  /// `-ECANCELED` result.
+  void Cancel(IoUringRequest& request);
+
+  /// Multishot accept is available since Linux 5.19, the support is only
+  /// known after the first attempt to use it
+  bool IsMultishotAcceptSupported() const noexcept;
+  void DisableMultishotAccept() noexcept;
+
+  /// Must be called in ev thread
+  void StartWatchers(struct ev_loop* loop);
+
+  /// Must be called in ev thread after all of the users are gone, waits for
+  /// the completion of the requests that are still in flight
+  void StopWatchers(struct ev_loop* loop);
+
+ private:
+  struct Ring;
+
+  enum class QueuedAction { kSubmit, kCancel };
+
+  struct QueuedRequest {
+    IoUringRequest* request;
+    QueuedAction action;
+  };
+
+  explicit IoUring(std::unique_ptr<Ring> ring);
+
+  static std::unique_ptr<Ring> MakeRing();
+
+  static void OnSubmitAsync(struct ev_loop*, ev_async*, int) noexcept;
+  static void OnPrepare(struct ev_loop*, ev_prepare*, int) noexcept;
+  static void OnRingReadable(struct ev_loop*, ev_io*, int) noexcept;
+
+  void FlushSubmissions() noexcept;
+  void ReapCompletions() noexcept;
+  void Enter(unsigned min_complete) noexcept;
+
+  const std::unique_ptr<Ring> ring_;
+
+  // FIFO matters: a cancellation must reach the ring before a new request
+  // that happens to reuse the address of the cancelled one
+  boost::lockfree::queue<QueuedRequest> queue_;
+
+  struct ev_loop* loop_{nullptr};
+  ev_async watch_submit_{};
+  ev_prepare watch_flush_{};
+  ev_io watch_completions_{};
+
+  // Accessed from ev thread only
+  std::size_t in_flight_{0};
+
+  std::atomic<bool> multishot_accept_supported_{true};
+};
+
+}  // namespace engine::ev
+
+USERVER_NAMESPACE_END
@@ -13,6 +13,7 @@
 #include <utils/impl/assert_extra.hpp>
 
 #include "child_process_map.hpp"
+#include "io_uring.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -56,19 +57,27 @@ void ReleaseEvDefaultLoop() {
 }  // namespace
 
 Thread::Thread(const std::string& thread_name,
-               RegisterEventMode register_event_mode)
-    : Thread(thread_name, false, register_event_mode) {}
+               RegisterEventMode register_event_mode,
+               utils::CpuSet cpu_affinity, IoBackend io_backend)
+    : Thread(thread_name, false, register_event_mode, std::move(cpu_affinity),
+             io_backend) {}
 
 Thread::Thread(const std::string& thread_name, UseDefaultEvLoop,
-               RegisterEventMode register_event_mode)
-    : Thread(thread_name, true, register_event_mode) {}
+               RegisterEventMode register_event_mode,
+               utils::CpuSet cpu_affinity, IoBackend io_backend)
+    : Thread(thread_name, true, register_event_mode, std::move(cpu_affinity),
+             io_backend) {}
 
 Thread::Thread(const std::string& thread_name, bool use_ev_default_loop,
-               RegisterEventMode register_event_mode)
+               RegisterEventMode register_event_mode,
+               utils::CpuSet cpu_affinity, IoBackend io_backend)
     : use_ev_default_loop_(use_ev_default_loop),
       register_event_mode_(register_event_mode),
+      cpu_affinity_(std::move(cpu_affinity)),
       func_queue_(kInitFuncQueueCapacity),
       loop_(nullptr),
+      io_uring_(io_backend == IoBackend::kIoUring ? IoUring::TryCreate()
+                                                  : nullptr),
       lock_(loop_mutex_, std::defer_lock),
       is_running_(false) {
   if (use_ev_default_loop_) AcquireEvDefaultLoop(thread_name);
@@ -163,9 +172,18 @@ void Thread::Start(const std::string& name) {
     ev_child_start(loop_, &watch_child_);
   }
 
+  if (io_uring_) io_uring_->StartWatchers(loop_);
+
   is_running_ = true;
   thread_ = std::thread([this, name] {
     utils::SetCurrentThreadName(name);
+    // The set is validated in advance, an exception would terminate
+    try {
+      utils::SetCurrentThreadAffinity(cpu_affinity_);
+    } catch (const std::exception& e) {
+      LOG_ERROR() << "Failed to set the CPU affinity of ev thread " << name
+                  << ": " << e;
+    }
     RunEvLoop();
   });
 }
@@ -196,6 +214,7 @@ void Thread::RunEvLoop() {
     ev_timer_stop(loop_, &timers_driver_);
   }
   if (use_ev_default_loop_) ev_child_stop(loop_, &watch_child_);
+  if (io_uring_) io_uring_->StopWatchers(loop_);
 }
 
 void Thread::UpdateLoopWatcher(struct ev_loop* loop, ev_async*, int) noexcept {
@@ -11,12 +11,16 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include <engine/ev/async_payload_base.hpp>
+#include <engine/ev/io_backend.hpp>
 #include <userver/engine/deadline.hpp>
+#include <utils/cpu_affinity.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::ev {
 
+class IoUring;
+
 class Thread final {
  public:
   struct UseDefaultEvLoop {};
@@ -33,8 +37,12 @@ class Thread final {
     kDeferred
   };
 
-  Thread(const std::string& thread_name, RegisterEventMode);
-  Thread(const std::string& thread_name, UseDefaultEvLoop, RegisterEventMode);
+  Thread(const std::string& thread_name, RegisterEventMode,
+         utils::CpuSet cpu_affinity = {},
+         IoBackend io_backend = IoBackend::kEpoll);
+  Thread(const std::string& thread_name, UseDefaultEvLoop, RegisterEventMode,
+         utils::CpuSet cpu_affinity = {},
+         IoBackend io_backend = IoBackend::kEpoll);
   ~Thread();
 
   struct ev_loop* GetEvLoop() const {
@@ -53,9 +61,13 @@ class Thread final {
 
   bool IsInEvThread() const;
 
+  // nullptr if the thread uses the epoll I/O backend
+  IoUring* GetIoUring() const noexcept { return io_uring_.get(); }
+
  private:
   Thread(const std::string& thread_name, bool use_ev_default_loop,
-         RegisterEventMode register_event_mode);
+         RegisterEventMode register_event_mode, utils::CpuSet cpu_affinity,
+         IoBackend io_backend);
 
   void RegisterInEvLoop(OnAsyncPayload* func, AsyncPayloadPtr&& data);
 
@@ -79,6 +91,7 @@ class Thread final {
 
   bool use_ev_default_loop_;
   RegisterEventMode register_event_mode_;
+  const utils::CpuSet cpu_affinity_;
 
   struct QueueData {
     OnAsyncPayload* func;
@@ -88,6 +101,7 @@ class Thread final {
   boost::lockfree::queue<QueueData> func_queue_;
 
   struct ev_loop* loop_;
+  std::unique_ptr<IoUring> io_uring_;
   std::thread thread_;
   std::mutex loop_mutex_;
   std::unique_lock<std::mutex> lock_;
@@ -75,6 +75,10 @@ bool ThreadControl::IsInEvThread() const noexcept {
   return thread_.IsInEvThread();
 }
 
+IoUring* ThreadControl::GetIoUring() const noexcept {
+  return thread_.GetIoUring();
+}
+
 }  // namespace engine::ev
 
 USERVER_NAMESPACE_END
@@ -98,6 +98,7 @@ class CallerOwnedPayloadBlocking final : public AsyncPayloadBase {
 }  // namespace impl
 
 class Thread;
+class IoUring;
 
 class ThreadControl final {
  public:
@@ -147,6 +148,9 @@ class ThreadControl final {
 
   bool IsInEvThread() const noexcept;
 
+  /// nullptr if the thread uses the epoll I/O backend
+  IoUring* GetIoUring() const noexcept;
+
  private:
   Thread& thread_;
 };
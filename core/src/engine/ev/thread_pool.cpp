@@ -30,18 +30,36 @@ ThreadPool::ThreadPool(ThreadPoolConfig config, bool use_ev_default_loop)
     : use_ev_default_loop_(use_ev_default_loop) {
   const auto register_timer_event_mode =
       GetRegisterEventMode(config.defer_events);
+  const auto cpu_sets = utils::ResolveCpuSets(config.cpu_affinity);
+  const auto get_cpu_set = [&cpu_sets](std::size_t index) {
+    return cpu_sets.empty() ? utils::CpuSet{}
+                            : cpu_sets[index % cpu_sets.size()];
+  };
 
   threads_ = utils::GenerateFixedArray(config.threads, [&](std::size_t index) {
     const auto thread_name = fmt::format("{}_{}", config.thread_name, index);
     return (use_ev_default_loop && index == 0)
                ? Thread(thread_name, Thread::kUseDefaultEvLoop,
-                        register_timer_event_mode)
-               : Thread(thread_name, register_timer_event_mode);
+                        register_timer_event_mode, get_cpu_set(index),
+                        config.io_backend)
+               : Thread(thread_name, register_timer_event_mode,
+                        get_cpu_set(index), config.io_backend);
   });
 
   thread_controls_ = utils::GenerateFixedArray(
       threads_.size(),
       [&](std::size_t index) { return ThreadControl(threads_[index]); });
+
+  if (!config.cpu_affinity.numa_nodes.empty()) {
+    for (std::size_t i = 0; i < thread_controls_.size(); ++i) {
+      const auto node = utils::GetNumaNodeOfCpus(get_cpu_set(i));
+      if (!node) continue;
+      if (*node >= thread_controls_by_numa_node_.size()) {
+        thread_controls_by_numa_node_.resize(*node + 1);
+      }
+      thread_controls_by_numa_node_[*node].push_back(&thread_controls_[i]);
+    }
+  }
 }
 
 ThreadPool::~ThreadPool() = default;
@@ -50,6 +68,17 @@ std::size_t ThreadPool::GetSize() const { return threads_.size(); }
 
 ThreadControl& ThreadPool::NextThread() {
   UASSERT(!thread_controls_.empty());
+  if (!thread_controls_by_numa_node_.empty()) {
+    // Prefer an ev thread on the same NUMA node as the caller
+    const auto node = utils::GetCurrentNumaNode();
+    if (node && *node < thread_controls_by_numa_node_.size()) {
+      const auto& local_threads = thread_controls_by_numa_node_[*node];
+      if (!local_threads.empty()) {
+        return *local_threads[next_thread_idx_++ % local_threads.size()];
+      }
+    }
+  }
+
   // just ignore counter_ overflow
   return thread_controls_[next_thread_idx_++ % thread_controls_.size()];
 }
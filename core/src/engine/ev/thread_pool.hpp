@@ -37,6 +37,8 @@ class ThreadPool final {
   bool use_ev_default_loop_;
   utils::FixedArray<Thread> threads_;
   utils::FixedArray<ThreadControl> thread_controls_;
+  // Index is a NUMA node, empty if the threads are not pinned to NUMA nodes
+  std::vector<std::vector<ThreadControl*>> thread_controls_by_numa_node_;
   std::atomic<std::size_t> next_thread_idx_{0};
 };
 
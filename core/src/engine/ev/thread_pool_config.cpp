@@ -1,15 +1,32 @@
 #include "thread_pool_config.hpp"
 
+#include <userver/utils/assert.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::ev {
 
+IoBackend Parse(const yaml_config::YamlConfig& value,
+                formats::parse::To<IoBackend>) {
+  const auto str = value.As<std::string>();
+  if (str == "epoll") {
+    return IoBackend::kEpoll;
+  } else if (str == "io_uring") {
+    return IoBackend::kIoUring;
+  }
+
+  UINVARIANT(false, "Unknown I/O backend: " + str);
+}
+
 ThreadPoolConfig Parse(const yaml_config::YamlConfig& value,
                        formats::parse::To<ThreadPoolConfig>) {
   ThreadPoolConfig config;
   config.threads = value["threads"].As<size_t>(config.threads);
   config.thread_name = value["thread_name"].As<std::string>(config.thread_name);
   config.defer_events = value["defer_events"].As<bool>(config.defer_events);
+  config.cpu_affinity = value["cpu-affinity"].As<utils::CpuAffinityConfig>(
+      config.cpu_affinity);
+  config.io_backend = value["io_backend"].As<IoBackend>(config.io_backend);
   return config;
 }
 
@@ -5,6 +5,9 @@
 #include <userver/formats/yaml.hpp>
 #include <userver/yaml_config/yaml_config.hpp>
 
+#include <engine/ev/io_backend.hpp>
+#include <utils/cpu_affinity.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::ev {
@@ -14,8 +17,13 @@ struct ThreadPoolConfig {
   std::string thread_name = "event-worker";
   bool ev_default_loop_disabled = false;
   bool defer_events = false;
+  utils::CpuAffinityConfig cpu_affinity;
+  IoBackend io_backend = IoBackend::kEpoll;
 };
 
+IoBackend Parse(const yaml_config::YamlConfig& value,
+                formats::parse::To<IoBackend>);
+
 ThreadPoolConfig Parse(const yaml_config::YamlConfig& value,
                        formats::parse::To<ThreadPoolConfig>);
 
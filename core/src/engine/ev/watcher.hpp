@@ -61,6 +61,10 @@ class Watcher final : private AsyncPayloadBase {
   template <typename Function>
   void RunInBoundEvLoopSync(Function&&);
 
+  const ThreadControl& GetThreadControl() const noexcept {
+    return thread_control_;
+  }
+
  private:
   static void Release(AsyncPayloadBase& base) noexcept;
 
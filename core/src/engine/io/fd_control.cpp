@@ -2,6 +2,7 @@
 
 #include <fcntl.h>
 #include <sys/resource.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <memory>
@@ -11,7 +12,9 @@
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
 
+#include <engine/ev/thread_control.hpp>
 #include <engine/impl/wait_list_light.hpp>
+#include <engine/io/io_uring_socket.hpp>
 #include <engine/task/task_context.hpp>
 #include <utils/check_syscall.hpp>
 
@@ -144,6 +147,10 @@ Direction::Direction(Kind kind)
 
 Direction::~Direction() = default;
 
+ev::IoUring* Direction::GetIoUring() const noexcept {
+  return watcher_.GetThreadControl().GetIoUring();
+}
+
 bool Direction::Wait(Deadline deadline) {
   return DoWait(deadline) == engine::impl::TaskContext::WakeupSource::kWaitList;
 }
@@ -211,7 +218,11 @@ void Direction::IoWatcherCb(struct ev_loop*, ev_io* watcher, int) noexcept {
 }
 
 FdControl::FdControl()
-    : read_(Direction::Kind::kRead), write_(Direction::Kind::kWrite) {}
+    : read_(Direction::Kind::kRead),
+      write_(Direction::Kind::kWrite),
+      // completions and readiness notifications of the fd are served by the
+      // same ev thread
+      io_uring_(read_.GetIoUring()) {}
 
 FdControl::~FdControl() {
   try {
@@ -237,6 +248,11 @@ void FdControl::Close() {
   Invalidate();
 
   const auto fd = Fd();
+  if (io_uring_ops_in_flight_.load() != 0) {
+    // io_uring holds its own reference to the socket, close() alone does not
+    // interrupt the operations in flight
+    ::shutdown(fd, SHUT_RDWR);
+  }
   if (::close(fd) == -1) {
     const auto error_code = errno;
     std::error_code ec(error_code, std::system_category());
@@ -249,10 +265,21 @@ void FdControl::Close() {
 }
 
 void FdControl::Invalidate() {
+  StopIoUringOps();
   read_.Invalidate();
   write_.Invalidate();
 }
 
+void FdControl::StopIoUringOps() noexcept {
+  if (!io_uring_acceptor_) return;
+  try {
+    io_uring_acceptor_->Stop();
+  } catch (const std::exception& e) {
+    LOG_ERROR() << "Failed to stop io_uring accept: " << e;
+  }
+  io_uring_acceptor_.reset();
+}
+
 }  // namespace engine::io::impl
 
 USERVER_NAMESPACE_END
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <sys/types.h>
 #include <sys/uio.h>
 #include <atomic>
 #include <cerrno>
+#include <memory>
 
 #include <userver/engine/deadline.hpp>
 #include <userver/engine/io/exception.hpp>
@@ -18,6 +20,10 @@
 
 USERVER_NAMESPACE_BEGIN
 
+namespace engine::ev {
+class IoUring;
+}  // namespace engine::ev
+
 namespace engine::io::impl {
 
 /// I/O operation transfer mode
@@ -43,6 +49,7 @@ enum class ErrorMode {
 };
 
 class FdControl;
+class IoUringAcceptor;
 
 class Direction final {
  public:
@@ -92,12 +99,21 @@ class Direction final {
                     TransferMode mode, Deadline deadline,
                     const Context&... context);
 
+  // (IoFunc*)(int, off_t*, size_t), e.g. sendfile, advances the offset
+  template <typename IoFunc, typename... Context>
+  size_t PerformIoFile(SingleUserGuard& guard, IoFunc&& io_func, off_t offset,
+                       size_t len, TransferMode mode, Deadline deadline,
+                       const Context&... context);
+
  private:
   friend class FdControl;
   explicit Direction(Kind kind);
 
   engine::impl::TaskContext::WakeupSource DoWait(Deadline);
 
+  // ring of the ev thread the watcher is bound to
+  ev::IoUring* GetIoUring() const noexcept;
+
   void Reset(int fd);
   void StopWatcher();
   void WakeupWaiters();
@@ -146,9 +162,25 @@ class FdControl final {
   // does not close, must have no waiting in progress
   void Invalidate();
 
+  // nullptr if the socket I/O should use the readiness notifications
+  ev::IoUring* GetIoUring() const noexcept { return io_uring_; }
+
+  std::shared_ptr<IoUringAcceptor>& GetIoUringAcceptor() noexcept {
+    return io_uring_acceptor_;
+  }
+
+  void OnIoUringOpStarted() noexcept { ++io_uring_ops_in_flight_; }
+  void OnIoUringOpFinished() noexcept { --io_uring_ops_in_flight_; }
+
  private:
+  void StopIoUringOps() noexcept;
+
   Direction read_;
   Direction write_;
+
+  ev::IoUring* const io_uring_;
+  std::shared_ptr<IoUringAcceptor> io_uring_acceptor_;
+  std::atomic<std::size_t> io_uring_ops_in_flight_{0};
 };
 
 template <typename... Context>
@@ -255,6 +287,29 @@ size_t Direction::PerformIo(SingleUserGuard&, IoFunc&& io_func, void* buf,
   return pos - begin;
 }
 
+template <typename IoFunc, typename... Context>
+size_t Direction::PerformIoFile(SingleUserGuard&, IoFunc&& io_func,
+                                off_t offset, size_t len, TransferMode mode,
+                                Deadline deadline, const Context&... context) {
+  size_t processed_bytes = 0;
+
+  while (processed_bytes < len) {
+    auto chunk_size = io_func(fd_, &offset, len - processed_bytes);
+
+    if (chunk_size > 0) {
+      processed_bytes += chunk_size;
+      if (mode == TransferMode::kOnce) {
+        break;
+      }
+    } else if (!chunk_size ||
+               TryHandleError(errno, processed_bytes, mode, deadline,
+                              context...) == ErrorMode::kFatal) {
+      break;
+    }
+  }
+  return processed_bytes;
+}
+
 }  // namespace engine::io::impl
 
 USERVER_NAMESPACE_END
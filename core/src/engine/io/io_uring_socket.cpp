@@ -0,0 +1,475 @@
+#include <engine/io/io_uring_socket.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+#include <userver/engine/io/exception.hpp>
+#include <userver/engine/single_use_event.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/fast_scope_guard.hpp>
+
+#include <engine/io/fd_control.hpp>
+
+// Older kernel headers. The support is detected at runtime anyway.
+#ifndef IORING_CQE_F_MORE
+#define IORING_CQE_F_MORE (1U << 1)
+#endif
+#ifndef IORING_ACCEPT_MULTISHOT
+#define IORING_ACCEPT_MULTISHOT (1U << 0)
+#endif
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::io::impl {
+
+// MAC_COMPAT: io_uring is Linux only, ev::IoUring is never created elsewhere
+#ifdef __linux__
+namespace {
+
+// MAC_COMPAT: does not support MSG_NOSIGNAL
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+constexpr std::size_t kMaxChunkSize = std::numeric_limits<std::uint32_t>::max();
+
+class SocketRequest final : public ev::IoUringRequest {
+ public:
+  SocketRequest() noexcept { std::memset(&sqe_, 0, sizeof(sqe_)); }
+
+  io_uring_sqe& Sqe() noexcept { return sqe_; }
+
+  void Prepare(io_uring_sqe& sqe) noexcept override { sqe = sqe_; }
+
+  void OnCompletion(int result, std::uint32_t) noexcept override {
+    result_ = result;
+    event_.Send();
+    // Must be the last access to the request, the waiter destroys it
+    completed_.Send();
+  }
+
+  bool WaitUntil(Deadline deadline) {
+    return event_.WaitForEventUntil(deadline);
+  }
+
+  int WaitCompletion() noexcept {
+    completed_.WaitNonCancellable();
+    return result_;
+  }
+
+ private:
+  io_uring_sqe sqe_;
+  int result_{0};
+  engine::SingleConsumerEvent event_;
+  engine::SingleUseEvent completed_;
+};
+
+struct Completion {
+  int result;
+  bool interrupted;
+};
+
+Completion Perform(FdControl& fd_control, SocketRequest& request,
+                   Deadline deadline) {
+  auto* const io_uring = fd_control.GetIoUring();
+  UASSERT(io_uring);
+
+  fd_control.OnIoUringOpStarted();
+  utils::FastScopeGuard guard(
+      [&fd_control]() noexcept { fd_control.OnIoUringOpFinished(); });
+
+  io_uring->Submit(request);
+  const bool interrupted = !request.WaitUntil(deadline);
+  if (interrupted) {
+    try {
+      io_uring->Cancel(request);
+    } catch (const std::exception& e) {
+      LOG_ERROR() << "Failed to cancel io_uring request, waiting for its "
+                     "completion: "
+                  << e;
+    }
+  }
+  return {request.WaitCompletion(), interrupted};
+}
+
+bool IsInterruption(int error_code, bool interrupted) noexcept {
+  return interrupted && (error_code == ECANCELED || error_code == EINTR);
+}
+
+// Same as Direction::TryHandleError. Returns if the transfer should stop with
+// the partial result, throws otherwise.
+template <typename... Context>
+void HandleError(int error_code, bool interrupted, size_t processed_bytes,
+                 int fd, const Context&... context) {
+  if (IsInterruption(error_code, interrupted)) {
+    if (current_task::ShouldCancel()) {
+      throw(IoCancelled(/*bytes_transferred =*/processed_bytes)
+            << ... << context);
+    }
+    throw(IoTimeout(/*bytes_transferred =*/processed_bytes) << ... << context);
+  }
+
+  IoSystemError ex(error_code, "IoUring");
+  ex << "Error while ";
+  (ex << ... << context);
+  ex << ", fd=" << fd;
+  auto log_level = logging::Level::kError;
+  if (error_code == ECONNRESET || error_code == EPIPE) {
+    log_level = logging::Level::kWarning;
+  }
+  LOG(log_level) << ex;
+  if (processed_bytes != 0) return;
+  throw std::move(ex);
+}
+
+template <typename... Context>
+void ThrowIfCancelled(size_t processed_bytes, const Context&... context) {
+  if (current_task::ShouldCancel()) {
+    throw(IoCancelled(/*bytes_transferred =*/processed_bytes)
+          << ... << context);
+  }
+}
+
+void AdvanceIoVec(struct iovec*& list, std::size_t& list_size,
+                  std::size_t offset) noexcept {
+  while (offset != 0) {
+    UASSERT(list_size != 0);
+    const std::size_t len = list->iov_len;
+    if (offset >= len) {
+      ++list;
+      --list_size;
+      offset -= len;
+    } else {
+      list->iov_len -= offset;
+      list->iov_base = static_cast<char*>(list->iov_base) + offset;
+      offset = 0;
+    }
+  }
+}
+
+}  // namespace
+
+size_t IoUringRecvSome(FdControl& fd_control, void* buf, size_t len,
+                       Deadline deadline, const Sockaddr& peer) {
+  const int fd = fd_control.Fd();
+
+  // Under load the data is usually already there, and a plain syscall is the
+  // cheapest way to get it
+  for (;;) {
+    const auto ret = ::recv(fd, buf, len, 0);
+    if (ret >= 0) return ret;
+
+    const auto error_code = errno;
+    if (error_code == EINTR) continue;
+    if (error_code == EAGAIN || error_code == EWOULDBLOCK) break;
+    HandleError(error_code, false, 0, fd, "RecvSome from ", peer);
+    return 0;
+  }
+  ThrowIfCancelled(0, "RecvSome from ", peer);
+
+  // The kernel arms its internal poll and completes the request as soon as
+  // the data arrives, there is no need in a separate readiness notification
+  SocketRequest request;
+  auto& sqe = request.Sqe();
+  sqe.opcode = IORING_OP_RECV;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<std::uintptr_t>(buf);
+  sqe.len = std::min(len, kMaxChunkSize);
+
+  const auto [result, interrupted] = Perform(fd_control, request, deadline);
+  if (result >= 0) return result;
+  HandleError(-result, interrupted, 0, fd, "RecvSome from ", peer);
+  return 0;
+}
+
+size_t IoUringSendAll(FdControl& fd_control, const void* buf, size_t len,
+                      Deadline deadline, const Sockaddr& peer) {
+  const int fd = fd_control.Fd();
+  const char* const begin = static_cast<const char*>(buf);
+  const char* const end = begin + len;
+  const char* pos = begin;
+
+  while (pos < end) {
+    const auto ret = ::send(fd, pos, end - pos, kSendFlags);
+    if (ret > 0) {
+      pos += ret;
+      continue;
+    }
+    if (ret == 0) break;
+
+    const auto error_code = errno;
+    if (error_code == EINTR) continue;
+    if (error_code != EAGAIN && error_code != EWOULDBLOCK) {
+      HandleError(error_code, false, pos - begin, fd, "SendAll to ", peer);
+      break;
+    }
+    ThrowIfCancelled(pos - begin, "SendAll to ", peer);
+
+    // The socket buffer is full, the request completes when there is room
+    SocketRequest request;
+    auto& sqe = request.Sqe();
+    sqe.opcode = IORING_OP_SEND;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(pos);
+    sqe.len = std::min(static_cast<std::size_t>(end - pos), kMaxChunkSize);
+    sqe.msg_flags = kSendFlags;
+
+    const auto [result, interrupted] = Perform(fd_control, request, deadline);
+    if (result > 0) {
+      pos += result;
+      continue;
+    }
+    if (result == 0) break;
+    HandleError(-result, interrupted, pos - begin, fd, "SendAll to ", peer);
+    break;
+  }
+  return pos - begin;
+}
+
+size_t IoUringSendAllV(FdControl& fd_control, struct iovec* list,
+                       std::size_t list_size, Deadline deadline,
+                       const Sockaddr& peer) {
+  UASSERT(list_size > 0);
+  UASSERT(list_size <= IOV_MAX);
+  const int fd = fd_control.Fd();
+  std::size_t processed_bytes = 0;
+
+  while (list_size != 0) {
+    const auto ret = ::writev(fd, list, list_size);
+    if (ret > 0) {
+      processed_bytes += ret;
+      AdvanceIoVec(list, list_size, ret);
+      continue;
+    }
+    if (ret == 0) break;
+
+    const auto error_code = errno;
+    if (error_code == EINTR) continue;
+    if (error_code != EAGAIN && error_code != EWOULDBLOCK) {
+      HandleError(error_code, false, processed_bytes, fd, "SendAll to ", peer);
+      break;
+    }
+    ThrowIfCancelled(processed_bytes, "SendAll to ", peer);
+
+    struct msghdr msg {};
+    msg.msg_iov = list;
+    msg.msg_iovlen = list_size;
+
+    SocketRequest request;
+    auto& sqe = request.Sqe();
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&msg);
+    sqe.len = 1;
+    sqe.msg_flags = kSendFlags;
+
+    const auto [result, interrupted] = Perform(fd_control, request, deadline);
+    if (result > 0) {
+      processed_bytes += result;
+      AdvanceIoVec(list, list_size, result);
+      continue;
+    }
+    if (result == 0) break;
+    HandleError(-result, interrupted, processed_bytes, fd, "SendAll to ",
+                peer);
+    break;
+  }
+  return processed_bytes;
+}
+
+void IoUringConnect(FdControl& fd_control, const Sockaddr& addr,
+                    Deadline deadline) {
+  const int fd = fd_control.Fd();
+  ThrowIfCancelled(0, "Connect to ", addr);
+
+  // Replaces connect() + readiness wait + getsockopt(SO_ERROR)
+  SocketRequest request;
+  auto& sqe = request.Sqe();
+  sqe.opcode = IORING_OP_CONNECT;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<std::uintptr_t>(addr.Data());
+  sqe.off = addr.Size();
+
+  const auto [result, interrupted] = Perform(fd_control, request, deadline);
+  if (result == 0) return;
+
+  const auto error_code = -result;
+  if (IsInterruption(error_code, interrupted)) {
+    if (current_task::ShouldCancel()) {
+      throw IoCancelled() << "Connect to " << addr;
+    }
+    throw IoTimeout() << "Connect to " << addr;
+  }
+  throw IoSystemError(error_code, "Socket")
+      << "Error while establishing connection, fd=" << fd << ", addr=" << addr;
+}
+
+int IoUringAccept(FdControl& fd_control, Sockaddr& peer, Deadline deadline) {
+  auto* const io_uring = fd_control.GetIoUring();
+  UASSERT(io_uring);
+
+  if (io_uring->IsMultishotAcceptSupported()) {
+    auto& acceptor = fd_control.GetIoUringAcceptor();
+    if (!acceptor) {
+      acceptor = std::make_shared<IoUringAcceptor>(*io_uring, fd_control.Fd());
+    }
+
+    const auto fd = acceptor->Accept(deadline);
+    if (fd >= 0) {
+      // Multishot accept does not report the peer addresses
+      auto len = peer.Capacity();
+      if (::getpeername(fd, peer.Data(), &len) == -1) peer = Sockaddr{};
+    }
+    // -EAGAIN makes the caller retry with the single shot accept
+    if (fd != -EAGAIN || io_uring->IsMultishotAcceptSupported()) return fd;
+  }
+
+  ThrowIfCancelled(0, "Accept");
+
+  socklen_t len = peer.Capacity();
+  SocketRequest request;
+  auto& sqe = request.Sqe();
+  sqe.opcode = IORING_OP_ACCEPT;
+  sqe.fd = fd_control.Fd();
+  sqe.addr = reinterpret_cast<std::uintptr_t>(peer.Data());
+  sqe.addr2 = reinterpret_cast<std::uintptr_t>(&len);
+  sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+  const auto [result, interrupted] = Perform(fd_control, request, deadline);
+  if (result < 0 && IsInterruption(-result, interrupted)) {
+    if (current_task::ShouldCancel()) throw IoCancelled() << "Accept";
+    throw IoTimeout() << "Accept";
+  }
+  UASSERT(result < 0 || len <= peer.Capacity());
+  return result;
+}
+
+IoUringAcceptor::IoUringAcceptor(ev::IoUring& io_uring, int fd)
+    : io_uring_(io_uring), fd_(fd) {}
+
+IoUringAcceptor::~IoUringAcceptor() {
+  int fd = -1;
+  while (accepted_.try_dequeue(fd)) ::close(fd);
+}
+
+int IoUringAcceptor::Accept(Deadline deadline) {
+  for (;;) {
+    int fd = -1;
+    if (accepted_.try_dequeue(fd)) return fd;
+    if (const auto error_code = error_.exchange(0)) return -error_code;
+
+    if (!armed_.load()) {
+      if (!io_uring_.IsMultishotAcceptSupported()) return -EAGAIN;
+      ThrowIfCancelled(0, "Accept");
+
+      self_ = shared_from_this();
+      armed_ = true;
+      try {
+        io_uring_.Submit(*this);
+      } catch (const std::exception&) {
+        armed_ = false;
+        self_.reset();
+        throw;
+      }
+    }
+
+    if (!event_.WaitForEventUntil(deadline)) {
+      if (accepted_.try_dequeue(fd)) return fd;
+      ThrowIfCancelled(0, "Accept");
+      throw IoTimeout() << "Accept";
+    }
+  }
+}
+
+void IoUringAcceptor::Stop() {
+  if (armed_.load()) io_uring_.Cancel(*this);
+}
+
+void IoUringAcceptor::Prepare(io_uring_sqe& sqe) noexcept {
+  sqe.opcode = IORING_OP_ACCEPT;
+  sqe.fd = fd_;
+  sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+}
+
+void IoUringAcceptor::OnCompletion(int result, std::uint32_t flags) noexcept {
+  if (result >= 0) {
+    accepted_any_ = true;
+    if (!accepted_.enqueue(result)) ::close(result);
+  } else if (result == -EINVAL && !accepted_any_) {
+    // Kernels older than 5.19 reject the multishot flag
+    io_uring_.DisableMultishotAccept();
+  } else if (result != -ECANCELED) {
+    error_.store(-result);
+  }
+
+  if (flags & IORING_CQE_F_MORE) {
+    event_.Send();
+    return;
+  }
+
+  // The request is finished and will not be touched by the ev thread again.
+  // The acceptor is destroyed with `self` if the socket is already closed.
+  const auto self = std::move(self_);
+  armed_ = false;
+  event_.Send();
+}
+#else
+namespace {
+
+[[noreturn]] void ThrowNotSupported() {
+  throw IoException("io_uring is not supported on this platform");
+}
+
+}  // namespace
+
+size_t IoUringRecvSome(FdControl&, void*, size_t, Deadline, const Sockaddr&) {
+  ThrowNotSupported();
+}
+
+size_t IoUringSendAll(FdControl&, const void*, size_t, Deadline,
+                      const Sockaddr&) {
+  ThrowNotSupported();
+}
+
+size_t IoUringSendAllV(FdControl&, struct iovec*, std::size_t, Deadline,
+                       const Sockaddr&) {
+  ThrowNotSupported();
+}
+
+void IoUringConnect(FdControl&, const Sockaddr&, Deadline) {
+  ThrowNotSupported();
+}
+
+int IoUringAccept(FdControl&, Sockaddr&, Deadline) { ThrowNotSupported(); }
+
+IoUringAcceptor::IoUringAcceptor(ev::IoUring& io_uring, int fd)
+    : io_uring_(io_uring), fd_(fd) {}
+
+IoUringAcceptor::~IoUringAcceptor() = default;
+
+int IoUringAcceptor::Accept(Deadline) { ThrowNotSupported(); }
+
+void IoUringAcceptor::Stop() {}
+
+void IoUringAcceptor::Prepare(io_uring_sqe&) noexcept {}
+
+void IoUringAcceptor::OnCompletion(int, std::uint32_t) noexcept {}
+#endif
+
+}  // namespace engine::io::impl
+
+USERVER_NAMESPACE_END
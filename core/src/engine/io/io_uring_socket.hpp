@@ -0,0 +1,87 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <moodycamel/concurrentqueue.h>
+
+#include <engine/ev/io_uring.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/io/sockaddr.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::io::impl {
+
+class FdControl;
+
+// Socket operations over the io_uring of an ev thread. They throw the same
+// exceptions as the Direction::PerformIo based implementation.
+//
+// Each operation waits for the final completion of its io_uring request
+// before returning, even on timeout or cancellation, because the kernel
+// writes into the buffers of the caller until then.
+
+size_t IoUringRecvSome(FdControl& fd_control, void* buf, size_t len,
+                       Deadline deadline, const Sockaddr& peer);
+
+size_t IoUringSendAll(FdControl& fd_control, const void* buf, size_t len,
+                      Deadline deadline, const Sockaddr& peer);
+
+size_t IoUringSendAllV(FdControl& fd_control, struct iovec* list,
+                       std::size_t list_size, Deadline deadline,
+                       const Sockaddr& peer);
+
+void IoUringConnect(FdControl& fd_control, const Sockaddr& addr,
+                    Deadline deadline);
+
+// Single shot accept, used if multishot accept is not supported.
+// @returns the accepted fd or -errno
+int IoUringAccept(FdControl& fd_control, Sockaddr& peer, Deadline deadline);
+
+/// Multishot accept of a listening socket. The kernel keeps accepting
+/// connections while the request is armed, the accepted sockets are queued
+/// until the next Accept().
+///
+/// Is shared between the FdControl and the io_uring while the request is in
+/// flight, so the socket may be closed without waiting for the cancellation.
+class IoUringAcceptor final
+    : public ev::IoUringRequest,
+      public std::enable_shared_from_this<IoUringAcceptor> {
+ public:
+  IoUringAcceptor(ev::IoUring& io_uring, int fd);
+  ~IoUringAcceptor();
+
+  /// Must not be called concurrently. Returns -EAGAIN if multishot accept
+  /// turns out to be unsupported, the caller should fall back to the single
+  /// shot accept in that case.
+  /// @returns the accepted fd or -errno
+  int Accept(Deadline deadline);
+
+  /// Cancels the request, the queued sockets are closed
+  void Stop();
+
+  void Prepare(io_uring_sqe& sqe) noexcept override;
+  void OnCompletion(int result, std::uint32_t flags) noexcept override;
+
+ private:
+  ev::IoUring& io_uring_;
+  const int fd_;
+
+  moodycamel::ConcurrentQueue<int> accepted_;
+  std::atomic<int> error_{0};
+  std::atomic<bool> armed_{false};
+  // Set only while armed, keeps the acceptor alive for the ev thread
+  std::shared_ptr<IoUringAcceptor> self_;
+  bool accepted_any_{false};
+  engine::SingleConsumerEvent event_;
+};
+
+}  // namespace engine::io::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/engine/io/socket.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/internal/net/net_listener.hpp>
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+namespace io = engine::io;
+using Deadline = engine::Deadline;
+using TcpListener = internal::net::TcpListener;
+
+// Falls back to epoll if the kernel does not support io_uring, the tests
+// must pass with both backends
+void RunWithIoUring(std::function<void()> payload) {
+  engine::TaskProcessorPoolsConfig config;
+  config.ev_io_uring_enabled = true;
+  engine::RunStandalone(2, config, std::move(payload));
+}
+
+}  // namespace
+
+TEST(IoUringSocket, RecvSomeSendAll) {
+  RunWithIoUring([] {
+    const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+    TcpListener listener;
+    auto [server, client] = listener.MakeSocketPair(test_deadline);
+
+    // The reader starts before the data arrives and waits in io_uring
+    auto reader = engine::AsyncNoSpan([&server = server, test_deadline] {
+      std::array<char, 16> buf{};
+      const auto size = server.RecvSome(buf.data(), buf.size(), test_deadline);
+      return std::string(buf.data(), size);
+    });
+    engine::SleepFor(std::chrono::milliseconds{10});
+
+    EXPECT_EQ(client.SendAll("ping", 4, test_deadline), 4);
+    EXPECT_EQ(reader.Get(), "ping");
+  });
+}
+
+TEST(IoUringSocket, SendAllLarge) {
+  RunWithIoUring([] {
+    const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+    TcpListener listener;
+    auto [server, client] = listener.MakeSocketPair(test_deadline);
+
+    // Way larger than the socket buffers, so the sender has to wait
+    const std::string payload(8 * 1024 * 1024, 'x');
+    const std::string header = "header";
+
+    auto reader = engine::AsyncNoSpan(
+        [&server = server, test_deadline, expected = header.size() +
+                                                      payload.size() * 2] {
+          std::vector<char> buf(expected);
+          return server.RecvAll(buf.data(), buf.size(), test_deadline);
+        });
+
+    EXPECT_EQ(client.SendAll(payload.data(), payload.size(), test_deadline),
+              payload.size());
+    EXPECT_EQ(client.SendAll({{header.data(), header.size()},
+                              {payload.data(), payload.size()}},
+                             test_deadline),
+              header.size() + payload.size());
+    EXPECT_EQ(reader.Get(), header.size() + payload.size() * 2);
+  });
+}
+
+TEST(IoUringSocket, AcceptConnect) {
+  RunWithIoUring([] {
+    const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+    TcpListener listener;
+
+    UEXPECT_THROW([[maybe_unused]] auto socket = listener.socket.Accept(
+                      Deadline::FromDuration(std::chrono::milliseconds{10})),
+                  io::IoTimeout);
+
+    constexpr std::size_t kClients = 16;
+    std::vector<io::Socket> clients;
+    for (std::size_t i = 0; i < kClients; ++i) {
+      auto& client = clients.emplace_back(listener.addr.Domain(),
+                                          TcpListener::type);
+      client.Connect(listener.addr, test_deadline);
+    }
+
+    for (std::size_t i = 0; i < kClients; ++i) {
+      auto server = listener.socket.Accept(test_deadline);
+      ASSERT_TRUE(server.IsValid());
+      EXPECT_EQ("::1", server.Getpeername().PrimaryAddressString());
+    }
+  });
+}
+
+TEST(IoUringSocket, RecvTimeoutAndCancel) {
+  RunWithIoUring([] {
+    const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+    TcpListener listener;
+    auto [server, client] = listener.MakeSocketPair(test_deadline);
+
+    std::array<char, 16> buf{};
+    UEXPECT_THROW(
+        [[maybe_unused]] auto size = server.RecvSome(
+            buf.data(), buf.size(),
+            Deadline::FromDuration(std::chrono::milliseconds{10})),
+        io::IoTimeout);
+
+    auto reader = engine::AsyncNoSpan([&server = server, &buf, test_deadline] {
+      [[maybe_unused]] auto size =
+          server.RecvSome(buf.data(), buf.size(), test_deadline);
+    });
+    engine::SleepFor(std::chrono::milliseconds{10});
+    reader.RequestCancel();
+    UEXPECT_THROW(reader.Get(), io::IoCancelled);
+
+    // The socket is still usable after the interrupted requests
+    EXPECT_EQ(client.SendAll("ok", 2, test_deadline), 2);
+    EXPECT_EQ(server.RecvSome(buf.data(), buf.size(), test_deadline), 2);
+  });
+}
+
+USERVER_NAMESPACE_END
@@ -5,6 +5,12 @@
 #include <sys/uio.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <string>
 #include <vector>
@@ -16,6 +22,7 @@
 
 #include <build_config.hpp>
 #include <engine/io/fd_control.hpp>
+#include <engine/io/io_uring_socket.hpp>
 #include <utils/check_syscall.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -69,6 +76,29 @@ Sockaddr& MemoizeAddr(Sockaddr& addr, decltype(&::getpeername) getter,
                     0);
 }
 
+class SendFileWrapper {
+ public:
+  explicit SendFileWrapper(int file_fd) : file_fd_(file_fd) {}
+
+  [[nodiscard]] ssize_t operator()(int fd, off_t* offset, size_t len) {
+#ifdef __linux__
+    return ::sendfile(fd, file_fd_, offset, len);
+#else
+    // MAC_COMPAT: sendfile has a different signature, copy via a buffer
+    std::array<char, 16 * 1024> buf;
+    const auto read = ::pread(file_fd_, buf.data(),
+                              std::min(len, buf.size()), *offset);
+    if (read <= 0) return read;
+    const auto sent = SendWrapper(fd, buf.data(), read);
+    if (sent > 0) *offset += sent;
+    return sent;
+#endif
+  }
+
+ private:
+  const int file_fd_;
+};
+
 class RecvFromWrapper {
  public:
   [[nodiscard]] ssize_t operator()(int fd, void* buf, size_t len) {
@@ -149,6 +179,11 @@ void Socket::Connect(const Sockaddr& addr, Deadline deadline) {
 
   peername_ = addr;
 
+  if (fd_control_->GetIoUring()) {
+    impl::IoUringConnect(*fd_control_, addr, deadline);
+    return;
+  }
+
   if (!::connect(Fd(), addr.Data(), addr.Size())) {
     return;
   }
@@ -220,6 +255,9 @@ size_t Socket::RecvSome(void* buf, size_t len, Deadline deadline) {
   }
   auto& dir = fd_control_->Read();
   impl::Direction::SingleUserGuard guard(dir);
+  if (fd_control_->GetIoUring()) {
+    return impl::IoUringRecvSome(*fd_control_, buf, len, deadline, peername_);
+  }
   return dir.PerformIo(guard, &RecvWrapper, buf, len, impl::TransferMode::kOnce,
                        deadline, "RecvSome from ", peername_);
 }
@@ -253,6 +291,10 @@ size_t Socket::SendAll(const IoData* list, std::size_t list_size,
     /// stack
     std::array<struct iovec, kMaxStackSizeVector> data{};
     FillIoSendData(list, data.data(), list_size);
+    if (fd_control_->GetIoUring()) {
+      return impl::IoUringSendAllV(*fd_control_, data.data(), list_size,
+                                   deadline, peername_);
+    }
     return dir.PerformIoV(guard, &writev, data.data(), list_size,
                           impl::TransferMode::kWhole, deadline, "SendAll to ",
                           peername_);
@@ -260,6 +302,10 @@ size_t Socket::SendAll(const IoData* list, std::size_t list_size,
     /// heap
     std::vector<struct iovec> data(list_size);
     FillIoSendData(list, data.data(), list_size);
+    if (fd_control_->GetIoUring()) {
+      return impl::IoUringSendAllV(*fd_control_, data.data(), list_size,
+                                   deadline, peername_);
+    }
     return dir.PerformIoV(guard, &writev, data.data(), list_size,
                           impl::TransferMode::kWhole, deadline, "SendAll to ",
                           peername_);
@@ -272,12 +318,29 @@ size_t Socket::SendAll(const void* buf, size_t len, Deadline deadline) {
   }
   auto& dir = fd_control_->Write();
   impl::Direction::SingleUserGuard guard(dir);
+  if (fd_control_->GetIoUring()) {
+    return impl::IoUringSendAll(*fd_control_, buf, len, deadline, peername_);
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   return dir.PerformIo(guard, &SendWrapper, const_cast<void*>(buf), len,
                        impl::TransferMode::kWhole, deadline, "SendAll to ",
                        peername_);
 }
 
+size_t Socket::SendFile(int file_fd, std::size_t offset, std::size_t len,
+                        Deadline deadline) {
+  if (!IsValid()) {
+    throw IoException("Attempt to SendFile to closed socket");
+  }
+  auto& dir = fd_control_->Write();
+  impl::Direction::SingleUserGuard guard(dir);
+  // io_uring has no sendfile, readiness notifications are used in any case
+  return dir.PerformIoFile(guard, SendFileWrapper{file_fd},
+                           static_cast<off_t>(offset), len,
+                           impl::TransferMode::kWhole, deadline,
+                           "SendFile to ", peername_);
+}
+
 Socket::RecvFromResult Socket::RecvSomeFrom(void* buf, size_t len,
                                             Deadline deadline) {
   if (!IsValid()) {
@@ -321,19 +384,31 @@ Socket Socket::Accept(Deadline deadline) {
   }
   auto& dir = fd_control_->Read();
   impl::Direction::SingleUserGuard guard(dir);
+  const bool use_io_uring = !!fd_control_->GetIoUring();
   for (;;) {
     Sockaddr buf;
-    auto len = buf.Capacity();
+    int fd = -1;
+
+    if (use_io_uring) {
+      fd = impl::IoUringAccept(*fd_control_, buf, deadline);
+      // -errno on failure
+      if (fd < 0) {
+        errno = -fd;
+        fd = -1;
+      }
+    } else {
+      auto len = buf.Capacity();
 
 // MAC_COMPAT: no accept4
 #ifdef HAVE_ACCEPT4
-    int fd =
-        ::accept4(dir.Fd(), buf.Data(), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      fd = ::accept4(dir.Fd(), buf.Data(), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
 #else
-    int fd = ::accept(dir.Fd(), buf.Data(), &len);
+      fd = ::accept(dir.Fd(), buf.Data(), &len);
 #endif
 
-    UASSERT(len <= buf.Capacity());
+      UASSERT(len <= buf.Capacity());
+    }
+
     if (fd != -1) {
       auto peersock = Socket(fd);
       peersock.peername_ = buf;
@@ -345,6 +420,8 @@ Socket Socket::Accept(Deadline deadline) {
 #if EAGAIN != EWOULDBLOCK
       case EWOULDBLOCK:
 #endif
+        // io_uring waits by itself, EAGAIN means a retry in single shot mode
+        if (use_io_uring) break;
         if (!WaitReadable(deadline)) {
           if (current_task::ShouldCancel()) {
             throw IoCancelled() << "Accept";
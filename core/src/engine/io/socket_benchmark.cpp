@@ -1,8 +1,11 @@
 #include <benchmark/benchmark.h>
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include <userver/engine/async.hpp>
 #include <userver/engine/condition_variable.hpp>
@@ -23,6 +26,14 @@ namespace {
 
 constexpr auto kDeadlineMaxTime = std::chrono::seconds{60};
 
+// state.range(0) selects the I/O backend: 0 - epoll, 1 - io_uring
+void RunStandaloneWithBackend(const benchmark::State& state,
+                              std::function<void()> payload) {
+  engine::TaskProcessorPoolsConfig config;
+  config.ev_io_uring_enabled = state.range(0) != 0;
+  engine::RunStandalone(2, config, std::move(payload));
+}
+
 }  // namespace
 
 void socket_send_all(benchmark::State& state) {
@@ -138,4 +149,101 @@ BENCHMARK(socket_send_all_v);
 // TODO(TAXICOMMON-5510) flaky, sometimes throws engine::io::IoTimeout
 // BENCHMARK(socket_send_all_range)->RangeMultiplier(10)->Range(10, 10000);
 
+// Every RecvSome has to wait for the data, the case where the io_uring
+// backend saves the readiness notification round trip
+void socket_ping_pong(benchmark::State& state) {
+  RunStandaloneWithBackend(state, [&]() {
+    const auto test_deadline = Deadline::FromDuration(kDeadlineMaxTime);
+    internal::net::TcpListener listener;
+    auto [server, client] = listener.MakeSocketPair(test_deadline);
+    auto task_echo = engine::AsyncNoSpan(
+        [test_deadline](auto&& server) {
+          std::array<char, 128> buf = {};
+          for (;;) {
+            const auto size =
+                server.RecvSome(buf.data(), buf.size(), test_deadline);
+            if (size == 0) break;
+            [[maybe_unused]] auto send_bytes =
+                server.SendAll(buf.data(), size, test_deadline);
+          }
+        },
+        std::move(server));
+
+    std::array<char, 128> buf = {};
+    for (auto _ : state) {
+      auto bytes = client.SendAll("ping", 4, test_deadline);
+      bytes += client.RecvAll(buf.data(), 4, test_deadline);
+      benchmark::DoNotOptimize(bytes);
+    }
+    client.Close();
+    task_echo.Get();
+  });
+}
+BENCHMARK(socket_ping_pong)->Arg(0)->Arg(1);
+
+// Many connections multiplexed over the ev threads, io_uring requests are
+// submitted in batches once per ev-loop iteration
+void socket_ping_pong_many(benchmark::State& state) {
+  RunStandaloneWithBackend(state, [&]() {
+    const auto test_deadline = Deadline::FromDuration(kDeadlineMaxTime);
+    internal::net::TcpListener listener;
+    const auto connections = static_cast<std::size_t>(state.range(1));
+
+    std::vector<engine::TaskWithResult<void>> echo_tasks;
+    std::vector<engine::io::Socket> clients;
+    for (std::size_t i = 0; i < connections; ++i) {
+      auto [server, client] = listener.MakeSocketPair(test_deadline);
+      clients.push_back(std::move(client));
+      echo_tasks.push_back(engine::AsyncNoSpan(
+          [test_deadline](auto&& server) {
+            std::array<char, 128> buf = {};
+            for (;;) {
+              const auto size =
+                  server.RecvSome(buf.data(), buf.size(), test_deadline);
+              if (size == 0) break;
+              [[maybe_unused]] auto send_bytes =
+                  server.SendAll(buf.data(), size, test_deadline);
+            }
+          },
+          std::move(server)));
+    }
+
+    std::atomic<bool> running{true};
+    std::vector<engine::TaskWithResult<std::size_t>> client_tasks;
+    for (auto& client : clients) {
+      client_tasks.push_back(engine::AsyncNoSpan([&client, &running,
+                                                  test_deadline] {
+        std::array<char, 128> buf = {};
+        std::size_t round_trips = 0;
+        while (running) {
+          [[maybe_unused]] auto bytes =
+              client.SendAll("ping", 4, test_deadline);
+          bytes += client.RecvAll(buf.data(), 4, test_deadline);
+          ++round_trips;
+        }
+        return round_trips;
+      }));
+    }
+
+    for (auto _ : state) {
+      engine::SleepFor(std::chrono::milliseconds{10});
+    }
+    running = false;
+
+    std::size_t round_trips = 0;
+    for (auto& task : client_tasks) round_trips += task.Get();
+    for (auto& client : clients) client.Close();
+    for (auto& task : echo_tasks) task.Get();
+    state.counters["round_trips"] =
+        benchmark::Counter(round_trips, benchmark::Counter::kIsRate);
+  });
+}
+BENCHMARK(socket_ping_pong_many)
+    ->ArgNames({"io_uring", "connections"})
+    ->Args({0, 16})
+    ->Args({1, 16})
+    ->Args({0, 256})
+    ->Args({1, 256})
+    ->UseRealTime();
+
 USERVER_NAMESPACE_END
@@ -17,6 +17,9 @@
 #include <userver/engine/mutex.hpp>
 #include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
+#include <userver/fs/blocking/temp_file.hpp>
+#include <userver/fs/blocking/write.hpp>
 #include <userver/internal/net/net_listener.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -419,6 +422,43 @@ UTEST_MT(Socket, ConcurrentReadWriteUdp, 2) {
   /// [send self concurrent]
 }
 
+UTEST(Socket, SendFile) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  // Larger than the socket buffers, so the sender has to wait
+  std::string contents(4 * 1024 * 1024, '\0');
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), contents);
+  const auto fd = fs::blocking::FileDescriptor::Open(
+      file.GetPath(), fs::blocking::OpenFlag::kRead);
+
+  TcpListener listener;
+  auto [server, client] = listener.MakeSocketPair(test_deadline);
+
+  constexpr std::size_t kOffset = 100;
+  const std::size_t len = contents.size() - kOffset * 2;
+  auto reader = engine::AsyncNoSpan([&client = client, len, test_deadline] {
+    std::string buf(len, '\0');
+    const auto size = client.RecvAll(buf.data(), buf.size(), test_deadline);
+    buf.resize(size);
+    return buf;
+  });
+
+  EXPECT_EQ(server.SendFile(fd.GetNative(), kOffset, len, test_deadline), len);
+  EXPECT_EQ(reader.Get(), contents.substr(kOffset, len));
+
+  // Stops at the end of the file
+  std::array<char, 16> buf{};
+  EXPECT_EQ(server.SendFile(fd.GetNative(), contents.size() - 3, buf.size(),
+                            test_deadline),
+            3);
+  EXPECT_EQ(client.RecvSome(buf.data(), buf.size(), test_deadline), 3);
+  EXPECT_EQ(std::string_view(buf.data(), 3), "hij");
+}
+
 UTEST(Socket, WriteALot) {
   const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
 
@@ -10,15 +10,14 @@
 #include <userver/engine/mutex.hpp>
 #include <userver/engine/run_standalone.hpp>
 #include <userver/engine/single_waiting_task_mutex.hpp>
+#include <userver/utils/impl/interference_size.hpp>
 #include <userver/utils/rand.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace {
 
-// Minimum offset between two objects to avoid false sharing
-// TODO: replace with std::hardware_destructive_interference_size
-constexpr std::size_t kInterferenceSize = 64;
+using utils::impl::kInterferenceSize;
 
 class ThreadPool {
  public:
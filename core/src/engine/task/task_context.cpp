@@ -521,6 +521,7 @@ void TaskContext::CoroFunc(TaskPipe& task_pipe) {
     context->ProfilerStopExecution();
 
     context->task_pipe_ = nullptr;
+    coro::RecordIdleStackPointer();
   }
 }
 
@@ -170,6 +170,11 @@ class TaskContext final : public boost::intrusive_ref_counter<TaskContext>,
     task_queue_wait_timepoint_ = tp;
   }
 
+  // -1 if the task was never executed on a NUMA-pinned worker
+  int GetLastNumaNode() const { return last_numa_node_; }
+
+  void SetLastNumaNode(int node) { last_numa_node_ = node; }
+
   void SetCancelDeadline(Deadline deadline);
 
   bool HasLocalStorage() const noexcept;
@@ -228,6 +233,7 @@ class TaskContext final : public boost::intrusive_ref_counter<TaskContext>,
   std::chrono::steady_clock::time_point last_state_change_timepoint_;
 
   size_t trace_csw_left_;
+  int last_numa_node_{-1};
 
   AtomicSleepState sleep_state_;
   WakeupSource wakeup_source_{WakeupSource::kNone};
@@ -74,6 +74,21 @@ TaskProcessor::TaskProcessor(TaskProcessorConfig config,
       max_task_queue_wait_length_(0),
       task_trace_logger_{nullptr} {
   utils::impl::FinishStaticRegistration();
+  if (config_.task_queue == TaskQueueType::kWorkStealingTaskQueue) {
+    task_queue_.emplace<WorkStealingTaskQueue>(config_);
+  }
+
+  const auto cpu_sets = utils::ResolveCpuSets(config_.cpu_affinity);
+  if (!cpu_sets.empty()) {
+    for (size_t i = 0; i < config_.worker_threads; ++i) {
+      worker_cpu_sets_.push_back(cpu_sets[i % cpu_sets.size()]);
+      worker_numa_nodes_.push_back(
+          utils::GetNumaNodeOfCpus(worker_cpu_sets_.back()));
+    }
+    worker_numa_counters_ =
+        utils::FixedArray<WorkerNumaCounters>(config_.worker_threads);
+  }
+
   try {
     LOG_INFO() << "creating task_processor " << Name() << " "
                << "worker_threads=" << config_.worker_threads
@@ -92,9 +107,19 @@ TaskProcessor::TaskProcessor(TaskProcessorConfig config,
             break;
         }
 
+        if (!worker_cpu_sets_.empty()) {
+          // The sets are validated in advance, an exception would terminate
+          try {
+            utils::SetCurrentThreadAffinity(worker_cpu_sets_[i]);
+          } catch (const std::exception& e) {
+            LOG_ERROR() << "Failed to set the CPU affinity of worker " << i
+                        << " of task processor " << Name() << ": " << e;
+          }
+        }
+
         utils::SetCurrentThreadName(
             fmt::format("{}_{}", config_.thread_name, i));
-        ProcessTasks();
+        ProcessTasks(i);
       });
     }
   } catch (...) {
@@ -111,7 +136,7 @@ void TaskProcessor::Cleanup() noexcept {
   // Some tasks may be bound but not scheduled yet
   task_counter_.WaitForExhaustion(std::chrono::milliseconds(10));
 
-  task_queue_.enqueue(nullptr);
+  std::visit([](auto& queue) { queue.StopProcessing(); }, task_queue_);
 
   for (auto& w : workers_) {
     w.join();
@@ -146,7 +171,7 @@ void TaskProcessor::Schedule(impl::TaskContext* context) {
   // but oh well
   intrusive_ptr_add_ref(context);
 
-  task_queue_.enqueue(context);
+  std::visit([context](auto& queue) { queue.Push(context); }, task_queue_);
   // NOTE: task may be executed at this point
 }
 
@@ -158,6 +183,11 @@ ev::ThreadPool& TaskProcessor::EventThreadPool() {
   return pools_->EventThreadPool();
 }
 
+size_t TaskProcessor::GetTaskQueueSize() const {
+  return std::visit([](const auto& queue) { return queue.GetSizeApproximate(); },
+                    task_queue_);
+}
+
 impl::CountedCoroutinePtr TaskProcessor::GetCoroutine() {
   return {pools_->GetCoroPool().GetCoroutine(), *this};
 }
@@ -228,22 +258,10 @@ logging::LoggerPtr TaskProcessor::GetTaskTraceLogger() const {
 }
 
 impl::TaskContext* TaskProcessor::DequeueTask() {
-  impl::TaskContext* buf = nullptr;
-
-  /* Current thread handles only a single TaskProcessor, so it's safe to store
-   * a token for the task processor in a thread-local variable.
-   */
-  thread_local moodycamel::ConsumerToken token(task_queue_);
-
-  task_queue_.wait_dequeue(token, buf);
+  auto* context =
+      std::visit([](auto& queue) { return queue.PopBlocking(); }, task_queue_);
   GetTaskCounter().AccountTaskSwitchSlow();
-
-  if (!buf) {
-    // return "stop" token back
-    task_queue_.enqueue(nullptr);
-  }
-
-  return buf;
+  return context;
 }
 
 void RegisterThreadStartedHook(std::function<void()> func) {
@@ -252,7 +270,7 @@ void RegisterThreadStartedHook(std::function<void()> func) {
   ThreadStartedHooks().push_back(std::move(func));
 }
 
-void TaskProcessor::ProcessTasks() noexcept {
+void TaskProcessor::ProcessTasks(std::size_t worker_index) noexcept {
   TaskProcessorThreadStartedHook();
 
   while (true) {
@@ -262,6 +280,7 @@ void TaskProcessor::ProcessTasks() noexcept {
     if (!context) break;
 
     CheckWaitTime(*context);
+    if (!worker_numa_nodes_.empty()) AccountNumaNode(*context, worker_index);
 
     bool has_failed = false;
     try {
@@ -277,6 +296,37 @@ void TaskProcessor::ProcessTasks() noexcept {
   }
 }
 
+void TaskProcessor::AccountNumaNode(impl::TaskContext& context,
+                                    std::size_t worker_index) {
+  const auto& node = worker_numa_nodes_[worker_index];
+  if (!node) return;
+
+  const auto current_node = static_cast<int>(*node);
+  const auto last_node = context.GetLastNumaNode();
+  if (last_node != current_node) {
+    if (last_node != -1) {
+      worker_numa_counters_[worker_index].migrations.fetch_add(
+          1, std::memory_order_relaxed);
+    }
+    context.SetLastNumaNode(current_node);
+  }
+}
+
+std::map<std::size_t, TaskProcessor::NumaNodeStatistics>
+TaskProcessor::GetNumaNodeStatistics() const {
+  std::map<std::size_t, NumaNodeStatistics> result;
+  for (std::size_t i = 0; i < worker_numa_nodes_.size(); ++i) {
+    const auto& node = worker_numa_nodes_[i];
+    if (!node) continue;
+
+    auto& stats = result[*node];
+    ++stats.workers;
+    stats.migrations +=
+        worker_numa_counters_[i].migrations.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
 void TaskProcessor::CheckWaitTime(impl::TaskContext& context) {
   const auto max_wait_time = max_task_queue_wait_time_.load();
   const auto sensor_wait_time = sensor_task_queue_wait_time_.load();
@@ -4,18 +4,25 @@
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <unordered_set>
+#include <variant>
 #include <vector>
 
-#include <moodycamel/blockingconcurrentqueue.h>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include <engine/task/counted_coroutine_ptr.hpp>
 #include <engine/task/task_counter.hpp>
 #include <engine/task/task_processor_config.hpp>
+#include <engine/task/task_queue.hpp>
+#include <engine/task/work_stealing_task_queue.hpp>
 #include <userver/engine/impl/detached_tasks_sync_block.hpp>
+#include <userver/utils/fixed_array.hpp>
+#include <userver/utils/impl/interference_size.hpp>
+#include <utils/cpu_affinity.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -32,6 +39,12 @@ class ThreadPool;
 
 class TaskProcessor final {
  public:
+  struct NumaNodeStatistics {
+    std::size_t workers{0};
+    // Execution slices of tasks that previously ran on another NUMA node
+    std::size_t migrations{0};
+  };
+
   TaskProcessor(TaskProcessorConfig, std::shared_ptr<impl::TaskProcessorPools>);
   ~TaskProcessor();
 
@@ -55,10 +68,13 @@ class TaskProcessor final {
 
   const impl::TaskCounter& GetTaskCounter() const { return task_counter_; }
 
-  size_t GetTaskQueueSize() const { return task_queue_.size_approx(); }
+  size_t GetTaskQueueSize() const;
 
   size_t GetWorkerCount() const { return workers_.size(); }
 
+  /// Empty if the workers are not pinned to NUMA nodes
+  std::map<std::size_t, NumaNodeStatistics> GetNumaNodeStatistics() const;
+
   void SetSettings(const TaskProcessorSettings& settings);
 
   std::chrono::microseconds GetProfilerThreshold() const;
@@ -78,7 +94,9 @@ class TaskProcessor final {
 
   impl::TaskContext* DequeueTask();
 
-  void ProcessTasks() noexcept;
+  void ProcessTasks(std::size_t worker_index) noexcept;
+
+  void AccountNumaNode(impl::TaskContext& context, std::size_t worker_index);
 
   void CheckWaitTime(impl::TaskContext& context);
 
@@ -93,7 +111,7 @@ class TaskProcessor final {
   std::atomic<bool> is_shutting_down_;
   impl::DetachedTasksSyncBlock detached_contexts_;
 
-  moodycamel::BlockingConcurrentQueue<impl::TaskContext*> task_queue_;
+  std::variant<TaskQueue, WorkStealingTaskQueue> task_queue_;
 
   std::atomic<std::chrono::microseconds> sensor_task_queue_wait_time_{};
   std::atomic<std::chrono::microseconds> max_task_queue_wait_time_{};
@@ -102,6 +120,15 @@ class TaskProcessor final {
       TaskProcessorSettings::OverloadAction::kIgnore};
   std::atomic<bool> task_queue_wait_time_overloaded_{false};
 
+  struct alignas(utils::impl::kInterferenceSize) WorkerNumaCounters {
+    std::atomic<std::size_t> migrations{0};
+  };
+
+  // Both are empty if the workers are not pinned to CPUs
+  std::vector<utils::CpuSet> worker_cpu_sets_;
+  std::vector<std::optional<std::size_t>> worker_numa_nodes_;
+  utils::FixedArray<WorkerNumaCounters> worker_numa_counters_;
+
   std::vector<std::thread> workers_;
   impl::TaskCounter task_counter_;
   std::atomic<bool> task_trace_logger_set_{false};
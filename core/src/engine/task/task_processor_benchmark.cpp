@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <vector>
+
+#include <engine/impl/standalone.hpp>
+#include <engine/task/task_processor.hpp>
+#include <engine/task/task_processor_config.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// state.range(0) - worker threads count, state.range(1) - TaskQueueType
+template <typename Func>
+void RunWithTaskQueue(benchmark::State& state, Func payload) {
+  engine::TaskProcessorConfig config;
+  config.worker_threads = state.range(0);
+  config.thread_name = "bench-runner";
+  config.task_queue = static_cast<engine::TaskQueueType>(state.range(1));
+
+  engine::impl::TaskProcessorHolder task_processor(
+      std::make_unique<engine::TaskProcessor>(
+          std::move(config), engine::impl::MakeTaskProcessorPools(
+                                 engine::TaskProcessorPoolsConfig{})));
+
+  engine::impl::RunOnTaskProcessorSync(*task_processor, std::move(payload));
+}
+
+void ApplyArgs(benchmark::internal::Benchmark* b) {
+  for (const auto queue_type : {engine::TaskQueueType::kGlobalTaskQueue,
+                                engine::TaskQueueType::kWorkStealingTaskQueue}) {
+    for (int threads = 1; threads <= 32; threads *= 2) {
+      b->Args({threads, static_cast<int>(queue_type)});
+    }
+  }
+  b->ArgNames({"workers", "work_stealing"});
+}
+
+}  // namespace
+
+void task_processor_spawn_wait(benchmark::State& state) {
+  RunWithTaskQueue(state, [&] {
+    constexpr std::size_t kTasksCount = 1000;
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(kTasksCount);
+
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < kTasksCount; ++i) {
+        tasks.push_back(engine::AsyncNoSpan([] {}));
+      }
+      for (auto& task : tasks) task.Wait();
+      tasks.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * kTasksCount);
+  });
+}
+BENCHMARK(task_processor_spawn_wait)->Apply(ApplyArgs);
+
+void task_processor_yield(benchmark::State& state) {
+  RunWithTaskQueue(state, [&] {
+    std::vector<engine::TaskWithResult<void>> tasks;
+    for (int i = 0; i < state.range(0) - 1; i++) {
+      tasks.push_back(engine::AsyncNoSpan([] {
+        while (!engine::current_task::ShouldCancel()) engine::Yield();
+      }));
+    }
+
+    for (auto _ : state) engine::Yield();
+  });
+}
+BENCHMARK(task_processor_yield)->Apply(ApplyArgs);
+
+// Pairs of tasks wake each other up, which is where the LIFO slot helps most
+void task_processor_ping_pong(benchmark::State& state) {
+  RunWithTaskQueue(state, [&] {
+    constexpr std::size_t kPairsCount = 64;
+    constexpr std::size_t kRoundTrips = 100;
+
+    for (auto _ : state) {
+      std::vector<engine::TaskWithResult<void>> tasks;
+      tasks.reserve(kPairsCount);
+      for (std::size_t i = 0; i < kPairsCount; ++i) {
+        tasks.push_back(engine::AsyncNoSpan([] {
+          engine::SingleConsumerEvent ping;
+          engine::SingleConsumerEvent pong;
+          auto responder = engine::AsyncNoSpan([&] {
+            for (std::size_t j = 0; j < kRoundTrips; ++j) {
+              [[maybe_unused]] const bool ok = ping.WaitForEvent();
+              pong.Send();
+            }
+          });
+          for (std::size_t j = 0; j < kRoundTrips; ++j) {
+            ping.Send();
+            [[maybe_unused]] const bool ok = pong.WaitForEvent();
+          }
+          responder.Get();
+        }));
+      }
+      for (auto& task : tasks) task.Get();
+    }
+    state.SetItemsProcessed(state.iterations() * kPairsCount * kRoundTrips);
+  });
+}
+BENCHMARK(task_processor_ping_pong)->Apply(ApplyArgs);
+
+USERVER_NAMESPACE_END
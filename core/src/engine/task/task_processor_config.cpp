@@ -27,6 +27,18 @@ OsScheduling Parse(const yaml_config::YamlConfig& value,
   UINVARIANT(false, "Unknown OS scheduling value: " + str);
 }
 
+TaskQueueType Parse(const yaml_config::YamlConfig& value,
+                    formats::parse::To<TaskQueueType>) {
+  const auto str = value.As<std::string>();
+  if (str == "global-task-queue") {
+    return TaskQueueType::kGlobalTaskQueue;
+  } else if (str == "work-stealing-task-queue") {
+    return TaskQueueType::kWorkStealingTaskQueue;
+  }
+
+  UINVARIANT(false, "Unknown task queue type value: " + str);
+}
+
 TaskProcessorConfig Parse(const yaml_config::YamlConfig& value,
                           formats::parse::To<TaskProcessorConfig>) {
   TaskProcessorConfig config;
@@ -36,6 +48,10 @@ TaskProcessorConfig Parse(const yaml_config::YamlConfig& value,
   config.thread_name = value["thread_name"].As<std::string>();
   config.os_scheduling =
       value["os-scheduling"].As<OsScheduling>(OsScheduling::kNormal);
+  config.task_queue = value["task-processor-queue"].As<TaskQueueType>(
+      TaskQueueType::kGlobalTaskQueue);
+  config.cpu_affinity = value["cpu-affinity"].As<utils::CpuAffinityConfig>(
+      config.cpu_affinity);
 
   const auto task_trace = value["task-trace"];
   if (!task_trace.IsMissing()) {
@@ -6,6 +6,7 @@
 
 #include <userver/formats/json_fwd.hpp>
 #include <userver/yaml_config/fwd.hpp>
+#include <utils/cpu_affinity.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -17,6 +18,11 @@ enum class OsScheduling {
   kIdle,
 };
 
+enum class TaskQueueType {
+  kGlobalTaskQueue,
+  kWorkStealingTaskQueue,
+};
+
 struct TaskProcessorConfig {
   std::string name;
 
@@ -24,6 +30,8 @@ struct TaskProcessorConfig {
   std::size_t worker_threads{6};
   std::string thread_name;
   OsScheduling os_scheduling{OsScheduling::kNormal};
+  TaskQueueType task_queue{TaskQueueType::kGlobalTaskQueue};
+  utils::CpuAffinityConfig cpu_affinity;
 
   std::size_t task_trace_every{1000};
   std::size_t task_trace_max_csw{0};
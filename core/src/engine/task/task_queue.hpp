@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+#include <moodycamel/blockingconcurrentqueue.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+namespace impl {
+class TaskContext;
+}  // namespace impl
+
+/// A single multi-producer multi-consumer queue shared by all the workers of
+/// a TaskProcessor.
+class TaskQueue final {
+ public:
+  void Push(impl::TaskContext* context);
+
+  /// Returns nullptr after StopProcessing() is called
+  impl::TaskContext* PopBlocking();
+
+  void StopProcessing();
+
+  std::size_t GetSizeApproximate() const noexcept;
+
+ private:
+  moodycamel::BlockingConcurrentQueue<impl::TaskContext*> queue_;
+};
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,235 @@
+#include <engine/task/work_stealing_task_queue.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include <userver/utils/assert.hpp>
+#include <userver/utils/rand.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+namespace {
+
+// Check the global queue first on every Nth pop, otherwise tasks scheduled
+// from non-worker threads could starve behind the local ones.
+constexpr std::size_t kGlobalQueueCheckInterval = 61;
+
+// Two tasks that wake each other up could otherwise occupy the LIFO slot
+// forever and starve the local queue.
+constexpr std::size_t kMaxLifoPopsInARow = 3;
+
+constexpr std::size_t kMaxStealBatchSize = 32;
+
+}  // namespace
+
+thread_local WorkStealingTaskQueue::Consumer*
+    WorkStealingTaskQueue::current_consumer_ = nullptr;
+
+WorkStealingTaskQueue::Consumer::Consumer(WorkStealingTaskQueue& owner)
+    : owner(owner),
+      local_token(local_queue),
+      global_token(owner.global_queue_) {}
+
+WorkStealingTaskQueue::WorkStealingTaskQueue(const TaskProcessorConfig& config)
+    : consumers_(config.worker_threads, *this) {}
+
+WorkStealingTaskQueue::~WorkStealingTaskQueue() = default;
+
+void WorkStealingTaskQueue::Push(impl::TaskContext* context) {
+  UASSERT(context);
+  size_.fetch_add(1, std::memory_order_relaxed);
+  auto* consumer = GetCurrentConsumer();
+  if (!consumer) {
+    global_queue_.enqueue(context);
+    WakeUpSleepingConsumer();
+    return;
+  }
+
+  if (context == consumer->last_popped) {
+    // The task reschedules itself (e.g. engine::Yield()), give the other
+    // tasks a chance to run first.
+    PushLocal(*consumer, context);
+    return;
+  }
+
+  auto* previous =
+      consumer->lifo_slot.exchange(context, std::memory_order_acq_rel);
+  if (previous) {
+    PushLocal(*consumer, previous);
+  } else {
+    // The owner may be busy for long, a sleeping worker can steal the task
+    WakeUpSleepingConsumer();
+  }
+}
+
+impl::TaskContext* WorkStealingTaskQueue::PopBlocking() {
+  auto* consumer = GetCurrentConsumer();
+  if (!consumer) consumer = &RegisterCurrentConsumer();
+
+  impl::TaskContext* context = nullptr;
+  while (true) {
+    context = TryPop(*consumer);
+    if (context || is_stopping_.load()) break;
+
+    sleeping_consumers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Re-check after announcing the sleep, otherwise we could miss a Push()
+    // that has not seen us sleeping.
+    context = TryPop(*consumer);
+    if (context || is_stopping_.load()) {
+      CancelSleep();
+      break;
+    }
+
+    sleep_semaphore_.wait();
+  }
+
+  if (context) size_.fetch_sub(1, std::memory_order_relaxed);
+  consumer->last_popped = context;
+  return context;
+}
+
+void WorkStealingTaskQueue::StopProcessing() {
+  is_stopping_ = true;
+  sleep_semaphore_.signal(consumers_.size());
+}
+
+std::size_t WorkStealingTaskQueue::GetSizeApproximate() const noexcept {
+  // A pop may be accounted before the push it has taken
+  const auto size = size_.load(std::memory_order_relaxed);
+  return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+WorkStealingTaskQueue::Consumer*
+WorkStealingTaskQueue::GetCurrentConsumer() noexcept {
+  auto* consumer = current_consumer_;
+  return (consumer && &consumer->owner == this) ? consumer : nullptr;
+}
+
+WorkStealingTaskQueue::Consumer&
+WorkStealingTaskQueue::RegisterCurrentConsumer() {
+  const auto index = registered_consumers_.fetch_add(1);
+  UINVARIANT(index < consumers_.size(),
+             "More threads than expected pop from the WorkStealingTaskQueue");
+  current_consumer_ = &consumers_[index];
+  return consumers_[index];
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPop(Consumer& consumer) {
+  impl::TaskContext* context = nullptr;
+
+  if (++consumer.pops_count % kGlobalQueueCheckInterval == 0 &&
+      global_queue_.try_dequeue(consumer.global_token, context)) {
+    return context;
+  }
+
+  context = TryPopLocal(consumer);
+  if (context) return context;
+
+  if (global_queue_.try_dequeue(consumer.global_token, context)) {
+    return context;
+  }
+
+  return TrySteal(consumer);
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPopLocal(Consumer& consumer) {
+  if (consumer.lifo_pops_in_a_row < kMaxLifoPopsInARow) {
+    auto* context =
+        consumer.lifo_slot.exchange(nullptr, std::memory_order_acquire);
+    if (context) {
+      ++consumer.lifo_pops_in_a_row;
+      return context;
+    }
+  }
+  consumer.lifo_pops_in_a_row = 0;
+
+  impl::TaskContext* context = nullptr;
+  if (consumer.local_queue.try_dequeue_from_producer(consumer.local_token,
+                                                     context)) {
+    return context;
+  }
+
+  return consumer.lifo_slot.exchange(nullptr, std::memory_order_acquire);
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TrySteal(Consumer& consumer) {
+  const auto size = consumers_.size();
+  if (size <= 1) return nullptr;
+
+  const auto start = utils::RandRange(size);
+  std::array<impl::TaskContext*, kMaxStealBatchSize> batch{};
+
+  for (std::size_t i = 0; i < size; ++i) {
+    auto& victim = consumers_[(start + i) % size];
+    if (&victim == &consumer) continue;
+
+    // Steal a half of the victim's local queue
+    const auto victim_size = victim.local_queue.size_approx();
+    if (victim_size == 0) continue;
+    const auto batch_size =
+        std::min((victim_size + 1) / 2, kMaxStealBatchSize);
+
+    const auto stolen =
+        victim.local_queue.try_dequeue_bulk(batch.data(), batch_size);
+    if (stolen == 0) continue;
+
+    if (stolen > 1) {
+      consumer.local_queue.enqueue_bulk(consumer.local_token,
+                                        batch.data() + 1, stolen - 1);
+      WakeUpSleepingConsumer();
+    }
+    return batch[0];
+  }
+
+  // LIFO slots are checked last, their owners are likely to pick them up soon
+  for (std::size_t i = 0; i < size; ++i) {
+    auto& victim = consumers_[(start + i) % size];
+    if (&victim == &consumer) continue;
+
+    if (victim.lifo_slot.load(std::memory_order_relaxed)) {
+      auto* context =
+          victim.lifo_slot.exchange(nullptr, std::memory_order_acquire);
+      if (context) return context;
+    }
+  }
+
+  return nullptr;
+}
+
+void WorkStealingTaskQueue::PushLocal(Consumer& consumer,
+                                      impl::TaskContext* context) {
+  consumer.local_queue.enqueue(consumer.local_token, context);
+  WakeUpSleepingConsumer();
+}
+
+void WorkStealingTaskQueue::WakeUpSleepingConsumer() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto sleeping = sleeping_consumers_.load(std::memory_order_relaxed);
+  while (sleeping != 0) {
+    if (sleeping_consumers_.compare_exchange_weak(sleeping, sleeping - 1,
+                                                  std::memory_order_relaxed)) {
+      sleep_semaphore_.signal();
+      return;
+    }
+  }
+}
+
+void WorkStealingTaskQueue::CancelSleep() {
+  auto sleeping = sleeping_consumers_.load(std::memory_order_relaxed);
+  while (sleeping != 0) {
+    if (sleeping_consumers_.compare_exchange_weak(sleeping, sleeping - 1,
+                                                  std::memory_order_relaxed)) {
+      return;
+    }
+  }
+
+  // Somebody has already decided to wake us up, consume the signal
+  sleep_semaphore_.wait();
+}
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <moodycamel/concurrentqueue.h>
+#include <moodycamel/lightweightsemaphore.h>
+
+#include <engine/task/task_processor_config.hpp>
+#include <userver/utils/fixed_array.hpp>
+#include <userver/utils/impl/interference_size.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+namespace impl {
+class TaskContext;
+}  // namespace impl
+
+/// Task queue with a local queue per worker.
+///
+/// A task woken up by a worker goes to the LIFO slot of that worker and is
+/// most likely executed next on the same thread with hot caches. The previous
+/// occupant of the LIFO slot is moved to the worker's local FIFO queue. Tasks
+/// scheduled from threads that are not workers of the TaskProcessor go to the
+/// global queue. Idle workers steal tasks from randomly chosen victims.
+class WorkStealingTaskQueue final {
+ public:
+  explicit WorkStealingTaskQueue(const TaskProcessorConfig& config);
+  ~WorkStealingTaskQueue();
+
+  WorkStealingTaskQueue(WorkStealingTaskQueue&&) = delete;
+  WorkStealingTaskQueue& operator=(WorkStealingTaskQueue&&) = delete;
+
+  void Push(impl::TaskContext* context);
+
+  /// Must be called only from the worker threads, at most `worker_threads`
+  /// distinct threads may call it. Returns nullptr after StopProcessing() is
+  /// called and there is no work left.
+  impl::TaskContext* PopBlocking();
+
+  void StopProcessing();
+
+  std::size_t GetSizeApproximate() const noexcept;
+
+ private:
+  struct alignas(utils::impl::kInterferenceSize) Consumer final {
+    explicit Consumer(WorkStealingTaskQueue& owner);
+
+    WorkStealingTaskQueue& owner;
+    std::atomic<impl::TaskContext*> lifo_slot{nullptr};
+    moodycamel::ConcurrentQueue<impl::TaskContext*> local_queue;
+
+    // Accessed only by the owning worker
+    moodycamel::ProducerToken local_token;
+    moodycamel::ConsumerToken global_token;
+    impl::TaskContext* last_popped{nullptr};
+    std::size_t lifo_pops_in_a_row{0};
+    std::size_t pops_count{0};
+  };
+
+  static thread_local Consumer* current_consumer_;
+
+  Consumer* GetCurrentConsumer() noexcept;
+  Consumer& RegisterCurrentConsumer();
+
+  impl::TaskContext* TryPop(Consumer& consumer);
+  impl::TaskContext* TryPopLocal(Consumer& consumer);
+  impl::TaskContext* TrySteal(Consumer& consumer);
+
+  void PushLocal(Consumer& consumer, impl::TaskContext* context);
+  void WakeUpSleepingConsumer();
+  void CancelSleep();
+
+  moodycamel::ConcurrentQueue<impl::TaskContext*> global_queue_;
+
+  utils::FixedArray<Consumer> consumers_;
+  std::atomic<std::size_t> registered_consumers_{0};
+
+  // Updated with relaxed atomics, so reading the queue size is O(1)
+  alignas(utils::impl::kInterferenceSize) std::atomic<std::int64_t> size_{0};
+
+  alignas(utils::impl::kInterferenceSize)
+      std::atomic<std::size_t> sleeping_consumers_{0};
+  moodycamel::LightweightSemaphore sleep_semaphore_;
+  std::atomic<bool> is_stopping_{false};
+};
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,114 @@
+#include <engine/task/work_stealing_task_queue.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <engine/impl/standalone.hpp>
+#include <engine/task/task_processor.hpp>
+#include <engine/task/task_processor_config.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+engine::impl::TaskProcessorHolder MakeWorkStealingTaskProcessor(
+    std::size_t worker_threads) {
+  engine::TaskProcessorConfig config;
+  config.name = "work-stealing";
+  config.thread_name = "ws-worker";
+  config.worker_threads = worker_threads;
+  config.task_queue = engine::TaskQueueType::kWorkStealingTaskQueue;
+
+  return engine::impl::TaskProcessorHolder(
+      std::make_unique<engine::TaskProcessor>(
+          std::move(config),
+          engine::current_task::GetTaskProcessor().GetTaskProcessorPools()));
+}
+
+}  // namespace
+
+UTEST(WorkStealingTaskQueue, ManyTasks) {
+  auto task_processor = MakeWorkStealingTaskProcessor(4);
+
+  constexpr std::size_t kTasksCount = 10000;
+  std::atomic<std::size_t> executed{0};
+  std::vector<engine::TaskWithResult<void>> tasks;
+  tasks.reserve(kTasksCount);
+
+  for (std::size_t i = 0; i < kTasksCount; ++i) {
+    tasks.push_back(engine::AsyncNoSpan(*task_processor, [&executed] {
+      engine::Yield();
+      ++executed;
+    }));
+  }
+  for (auto& task : tasks) task.Get();
+
+  EXPECT_EQ(executed.load(), kTasksCount);
+  EXPECT_EQ(task_processor->GetTaskQueueSize(), 0u);
+}
+
+UTEST(WorkStealingTaskQueue, Mutex) {
+  auto task_processor = MakeWorkStealingTaskProcessor(4);
+
+  constexpr std::size_t kTasksCount = 16;
+  constexpr std::size_t kIterations = 1000;
+  engine::Mutex mutex;
+  std::size_t counter = 0;
+
+  std::vector<engine::TaskWithResult<void>> tasks;
+  for (std::size_t i = 0; i < kTasksCount; ++i) {
+    tasks.push_back(engine::AsyncNoSpan(*task_processor, [&] {
+      for (std::size_t j = 0; j < kIterations; ++j) {
+        std::lock_guard lock(mutex);
+        ++counter;
+      }
+    }));
+  }
+  for (auto& task : tasks) task.Get();
+
+  EXPECT_EQ(counter, kTasksCount * kIterations);
+}
+
+UTEST(WorkStealingTaskQueue, LifoSlotTaskIsStolen) {
+  auto task_processor = MakeWorkStealingTaskProcessor(2);
+
+  auto task = engine::AsyncNoSpan(*task_processor, [] {
+    std::atomic<bool> executed{false};
+    // Goes to the LIFO slot of the current worker, which never yields
+    auto stolen = engine::AsyncNoSpan([&executed] { executed = true; });
+
+    const auto deadline =
+        engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+    while (!executed && !deadline.IsReached()) {
+    }
+    EXPECT_TRUE(executed) << "The sleeping worker was not woken up";
+    stolen.Get();
+  });
+  task.Get();
+}
+
+UTEST(WorkStealingTaskQueue, YieldDoesNotStarveOthers) {
+  auto task_processor = MakeWorkStealingTaskProcessor(1);
+
+  engine::SingleConsumerEvent event;
+  auto task = engine::AsyncNoSpan(*task_processor, [&event] {
+    auto yielder = engine::AsyncNoSpan([] {
+      while (!engine::current_task::ShouldCancel()) engine::Yield();
+    });
+    auto waker = engine::AsyncNoSpan([&event] { event.Send(); });
+    waker.Get();
+    yielder.SyncCancel();
+  });
+
+  EXPECT_TRUE(event.WaitForEventFor(utest::kMaxTestWaitTime));
+  task.Get();
+}
+
+USERVER_NAMESPACE_END
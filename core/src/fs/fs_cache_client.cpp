@@ -1,5 +1,6 @@
 #include <userver/fs/fs_cache_client.hpp>
 
+#include <userver/engine/async.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/rcu/rcu_map.hpp>
 #include <userver/utils/periodic_task.hpp>
@@ -10,8 +11,12 @@ namespace fs {
 
 FsCacheClient::FsCacheClient(std::string_view dir,
                              std::chrono::milliseconds update_period,
-                             engine::TaskProcessor& tp)
-    : dir_(dir), update_period_(update_period), tp_(tp) {
+                             engine::TaskProcessor& tp,
+                             std::size_t max_file_size)
+    : dir_(dir),
+      update_period_(update_period),
+      tp_(tp),
+      max_file_size_(max_file_size) {
   if (update_period_ == std::chrono::milliseconds(0)) {
     UpdateCache();
     return;
@@ -27,7 +32,7 @@ FsCacheClient::FsCacheClient(std::string_view dir,
 
 void FsCacheClient::UpdateCache() {
   auto map = fs::ReadRecursiveFilesInfoWithData(
-      tp_, dir_, {fs::SettingsReadFile::kSkipHidden});
+      tp_, dir_, {fs::SettingsReadFile::kSkipHidden}, max_file_size_);
   data_.Assign(std::move(map));
 }
 
@@ -40,6 +45,16 @@ FileInfoWithDataConstPtr FsCacheClient::TryGetFile(
   return nullptr;
 }
 
+fs::blocking::FileDescriptor FsCacheClient::OpenFile(
+    const FileInfoWithData& file) const {
+  return engine::AsyncNoSpan(tp_,
+                             [&file] {
+                               return fs::blocking::FileDescriptor::Open(
+                                   file.path, fs::blocking::OpenFlag::kRead);
+                             })
+      .Get();
+}
+
 }  // namespace fs
 
 USERVER_NAMESPACE_END
@@ -31,7 +31,7 @@ std::string ReadFileContents(engine::TaskProcessor& async_tp,
 
 FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
     engine::TaskProcessor& async_tp, const std::string& path,
-    utils::Flags<SettingsReadFile> flags) {
+    utils::Flags<SettingsReadFile> flags, std::size_t max_data_size) {
   FileInfoWithDataMap data{};
   for (const auto& f : boost::filesystem::recursive_directory_iterator(path)) {
     // only files
@@ -41,7 +41,14 @@ FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
     FileInfoWithData info{};
     info.size = boost::filesystem::file_size(f.path());
     info.extension = f.path().extension().string();
-    info.data = ReadFileContents(async_tp, f.path().string());
+    info.path = f.path().string();
+    info.last_modified = std::chrono::system_clock::from_time_t(
+        boost::filesystem::last_write_time(f.path()));
+    if (info.size <= max_data_size) {
+      info.data = ReadFileContents(async_tp, info.path);
+    } else {
+      info.has_data = false;
+    }
     data[GetRelative(f.path().string(), path)] =
         std::make_shared<const FileInfoWithData>(std::move(info));
   }
@@ -0,0 +1,556 @@
+#include <logging/async_logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+
+#include <boost/container/small_vector.hpp>
+
+#include <spdlog/sinks/sink.h>
+
+#include <logging/batch_sink.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/impl/interference_size.hpp>
+#include <userver/utils/thread_name.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace logging::impl {
+
+namespace {
+
+constexpr std::size_t kMinRingSize = 1 << 12;
+constexpr std::size_t kRecordAlignment = 8;
+
+// The most messages written to the sinks at once
+constexpr std::size_t kMaxBatchSize = 1024;
+
+// Guards against a lost wakeup, the sleeping flag handshake should make it
+// impossible
+constexpr std::chrono::milliseconds kMaxSleep{50};
+
+std::atomic<std::uint64_t> g_next_logger_id{1};
+
+enum class RecordKind : std::uint8_t {
+  kInline,   // the payload follows the header
+  kHeap,     // a pointer to the heap allocated payload follows the header
+  kPadding,  // skip to the beginning of the buffer
+};
+
+struct RecordHeader final {
+  std::int64_t time;
+  std::size_t thread_id;
+  std::uint32_t payload_size;
+  spdlog::level::level_enum level;
+  RecordKind kind;
+};
+
+constexpr std::size_t AlignRecord(std::size_t size) noexcept {
+  return (size + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+}
+
+constexpr std::size_t RecordSize(RecordKind kind,
+                                 std::size_t payload_size) noexcept {
+  return AlignRecord(sizeof(RecordHeader) + (kind == RecordKind::kHeap
+                                                 ? sizeof(char*)
+                                                 : payload_size));
+}
+
+std::size_t RoundUpToPowerOf2(std::size_t size) noexcept {
+  std::size_t result = kMinRingSize;
+  while (result < size) result *= 2;
+  return result;
+}
+
+}  // namespace
+
+// Lock-free single-producer single-consumer queue of log records. The producer
+// is the thread that owns the queue, the consumer is the AsyncLogger thread.
+//
+// The records are stored in ring buffers. The first ring is small; once it
+// is full, the producer goes on in a ring twice as large, up to the maximum
+// size, and the consumer follows after draining the previous ring. So the
+// threads that rarely log do not hold much memory.
+class LogRing final {
+ public:
+  explicit LogRing(std::size_t max_capacity)
+      : max_capacity_(max_capacity),
+        read_buffer_(std::make_unique<Buffer>(kMinRingSize)),
+        write_buffer_(read_buffer_.get()) {
+    UASSERT(max_capacity_ >= kMinRingSize);
+    UASSERT((max_capacity_ & (max_capacity_ - 1)) == 0);
+  }
+
+  ~LogRing() {
+    auto* next = read_buffer_->next.load(std::memory_order_acquire);
+    while (next) {
+      std::unique_ptr<Buffer> buffer{next};
+      next = buffer->next.load(std::memory_order_acquire);
+    }
+  }
+
+  // Producer side, returns false if the ring is full and may not grow
+  bool TryPush(const spdlog::details::log_msg& msg) {
+    if (write_buffer_->TryPush(msg)) return true;
+    if (write_buffer_->capacity >= max_capacity_) return false;
+
+    auto next = std::make_unique<Buffer>(write_buffer_->capacity * 2);
+    [[maybe_unused]] const bool pushed = next->TryPush(msg);
+    UASSERT(pushed);
+    write_buffer_->next.store(next.get(), std::memory_order_release);
+    write_buffer_ = next.release();
+    return true;
+  }
+
+  // Consumer side, appends at most max_count messages that refer to the ring
+  // memory. The memory stays valid until Commit().
+  void Read(std::vector<spdlog::details::log_msg>& messages,
+            std::vector<std::unique_ptr<char[]>>& heap_payloads,
+            spdlog::string_view_t logger_name, std::size_t max_count) {
+    while (true) {
+      read_buffer_->Read(messages, heap_payloads, logger_name, max_count);
+      if (messages.size() >= max_count) return;
+
+      auto* next = read_buffer_->next.load(std::memory_order_acquire);
+      if (!next) return;
+      // the records pushed right before the producer moved on
+      if (read_buffer_->HasPendingRecords()) continue;
+
+      retired_buffers_.push_back(std::move(read_buffer_));
+      read_buffer_.reset(next);
+    }
+  }
+
+  // Consumer side, releases the memory of the records returned by Read()
+  void Commit() noexcept {
+    read_buffer_->Commit();
+    retired_buffers_.clear();
+  }
+
+  bool HasPendingRecords() const noexcept {
+    return read_buffer_->HasPendingRecords() ||
+           read_buffer_->next.load(std::memory_order_acquire) != nullptr;
+  }
+
+  void MarkProducerExited() noexcept {
+    producer_exited_.store(true, std::memory_order_release);
+  }
+
+  // A ring of an exited thread may be removed once it is drained
+  bool IsAbandoned() const noexcept {
+    return producer_exited_.load(std::memory_order_acquire) &&
+           !HasPendingRecords();
+  }
+
+  void MarkConsumerExited() noexcept {
+    consumer_exited_.store(true, std::memory_order_release);
+  }
+
+  bool IsConsumerExited() const noexcept {
+    return consumer_exited_.load(std::memory_order_acquire);
+  }
+
+ private:
+  // Records are laid out contiguously, a record that does not fit before the
+  // end of the buffer is preceded by padding up to the end. Payloads longer
+  // than 1/8 of the buffer are copied to the heap, so that a single long
+  // message never blocks the ring.
+  struct Buffer final {
+    explicit Buffer(std::size_t capacity)
+        : capacity(capacity),
+          max_inline_payload(capacity / 8),
+          // not zeroed, so the pages of a large buffer are only committed
+          // once the records reach them
+          data(new char[capacity]) {
+      UASSERT((capacity & (capacity - 1)) == 0);
+    }
+
+    ~Buffer() {
+      while (read_pos != head.load(std::memory_order_acquire)) {
+        const auto contiguous = capacity - Offset(read_pos);
+        if (contiguous < sizeof(RecordHeader)) {
+          read_pos += contiguous;
+          continue;
+        }
+        const auto header = ReadHeader(read_pos);
+        if (header.kind == RecordKind::kPadding) {
+          read_pos += contiguous;
+          continue;
+        }
+        if (header.kind == RecordKind::kHeap) {
+          delete[] ReadHeapPayload(read_pos);
+        }
+        read_pos += RecordSize(header.kind, header.payload_size);
+      }
+    }
+
+    bool TryPush(const spdlog::details::log_msg& msg) {
+      const auto payload_size = msg.payload.size();
+      const auto kind = payload_size <= max_inline_payload ? RecordKind::kInline
+                                                           : RecordKind::kHeap;
+      const auto record_size = RecordSize(kind, payload_size);
+
+      const auto head_pos = head.load(std::memory_order_relaxed);
+      const auto tail_pos = tail.load(std::memory_order_acquire);
+      const auto contiguous = capacity - Offset(head_pos);
+      const std::size_t padding = contiguous < record_size ? contiguous : 0;
+      if (head_pos + padding + record_size - tail_pos > capacity) return false;
+
+      if (padding >= sizeof(RecordHeader)) {
+        WriteHeader(head_pos, RecordHeader{0, 0, 0, {}, RecordKind::kPadding});
+      }
+
+      const auto pos = head_pos + padding;
+      WriteHeader(pos, RecordHeader{
+                           msg.time.time_since_epoch().count(),
+                           msg.thread_id,
+                           static_cast<std::uint32_t>(payload_size),
+                           msg.level,
+                           kind,
+                       });
+      char* payload = data.get() + Offset(pos) + sizeof(RecordHeader);
+      if (kind == RecordKind::kInline) {
+        std::memcpy(payload, msg.payload.data(), payload_size);
+      } else {
+        auto* heap_payload = new char[payload_size];
+        std::memcpy(heap_payload, msg.payload.data(), payload_size);
+        std::memcpy(payload, &heap_payload, sizeof(heap_payload));
+      }
+
+      head.store(pos + record_size, std::memory_order_release);
+      return true;
+    }
+
+    void Read(std::vector<spdlog::details::log_msg>& messages,
+              std::vector<std::unique_ptr<char[]>>& heap_payloads,
+              spdlog::string_view_t logger_name, std::size_t max_count) {
+      const auto head_pos = head.load(std::memory_order_acquire);
+      while (read_pos != head_pos && messages.size() < max_count) {
+        const auto contiguous = capacity - Offset(read_pos);
+        if (contiguous < sizeof(RecordHeader)) {
+          read_pos += contiguous;
+          continue;
+        }
+
+        const auto header = ReadHeader(read_pos);
+        if (header.kind == RecordKind::kPadding) {
+          read_pos += contiguous;
+          continue;
+        }
+
+        const char* payload =
+            data.get() + Offset(read_pos) + sizeof(RecordHeader);
+        if (header.kind == RecordKind::kHeap) {
+          payload =
+              heap_payloads.emplace_back(ReadHeapPayload(read_pos)).get();
+        }
+
+        auto& msg = messages.emplace_back(
+            spdlog::log_clock::time_point{
+                spdlog::log_clock::duration{header.time}},
+            spdlog::source_loc{}, logger_name, header.level,
+            spdlog::string_view_t{payload, header.payload_size});
+        msg.thread_id = header.thread_id;
+
+        read_pos += RecordSize(header.kind, header.payload_size);
+      }
+    }
+
+    void Commit() noexcept { tail.store(read_pos, std::memory_order_release); }
+
+    bool HasPendingRecords() const noexcept {
+      return read_pos != head.load(std::memory_order_acquire);
+    }
+
+    std::size_t Offset(std::size_t pos) const noexcept {
+      return pos & (capacity - 1);
+    }
+
+    void WriteHeader(std::size_t pos, const RecordHeader& header) noexcept {
+      std::memcpy(data.get() + Offset(pos), &header, sizeof(header));
+    }
+
+    RecordHeader ReadHeader(std::size_t pos) const noexcept {
+      RecordHeader header;
+      std::memcpy(&header, data.get() + Offset(pos), sizeof(header));
+      return header;
+    }
+
+    char* ReadHeapPayload(std::size_t pos) const noexcept {
+      char* payload = nullptr;
+      std::memcpy(&payload, data.get() + Offset(pos) + sizeof(RecordHeader),
+                  sizeof(payload));
+      return payload;
+    }
+
+    const std::size_t capacity;
+    const std::size_t max_inline_payload;
+    const std::unique_ptr<char[]> data;
+
+    alignas(utils::impl::kInterferenceSize) std::atomic<std::size_t> head{0};
+    alignas(utils::impl::kInterferenceSize) std::atomic<std::size_t> tail{0};
+    std::size_t read_pos{0};
+
+    // the ring the producer went on with, owned by the consumer
+    std::atomic<Buffer*> next{nullptr};
+  };
+
+  const std::size_t max_capacity_;
+
+  // consumer side
+  std::unique_ptr<Buffer> read_buffer_;
+  std::vector<std::unique_ptr<Buffer>> retired_buffers_;
+
+  // producer side
+  Buffer* write_buffer_;
+
+  std::atomic<bool> producer_exited_{false};
+  std::atomic<bool> consumer_exited_{false};
+};
+
+namespace {
+
+// Set once ThreadRings of the current thread is destroyed, messages logged
+// by the destructors of other thread_local objects are written synchronously
+thread_local bool thread_rings_destroyed = false;
+
+// The rings of the current thread, one per AsyncLogger
+class ThreadRings final {
+ public:
+  ThreadRings() = default;
+  ThreadRings(const ThreadRings&) = delete;
+  ThreadRings& operator=(const ThreadRings&) = delete;
+
+  ~ThreadRings() {
+    for (const auto& item : rings_) item.ring->MarkProducerExited();
+    thread_rings_destroyed = true;
+  }
+
+  LogRing* Find(std::uint64_t logger_id) const noexcept {
+    for (const auto& item : rings_) {
+      if (item.logger_id == logger_id) return item.ring.get();
+    }
+    return nullptr;
+  }
+
+  void Add(std::uint64_t logger_id, std::shared_ptr<LogRing> ring) {
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const Item& item) {
+                                  return item.ring->IsConsumerExited();
+                                }),
+                 rings_.end());
+    rings_.push_back({logger_id, std::move(ring)});
+  }
+
+ private:
+  struct Item {
+    std::uint64_t logger_id;
+    std::shared_ptr<LogRing> ring;
+  };
+
+  boost::container::small_vector<Item, 4> rings_;
+};
+
+}  // namespace
+
+struct AsyncLogger::Batch final {
+  void Clear() noexcept {
+    messages.clear();
+    heap_payloads.clear();
+  }
+
+  std::vector<spdlog::details::log_msg> messages;
+  std::vector<std::unique_ptr<char[]>> heap_payloads;
+};
+
+AsyncLogger::AsyncLogger(std::string name, spdlog::sink_ptr sink,
+                         std::size_t ring_size,
+                         OverflowBehavior overflow_behavior)
+    : spdlog::logger(std::move(name), std::move(sink)),
+      id_(g_next_logger_id.fetch_add(1, std::memory_order_relaxed)),
+      ring_size_(RoundUpToPowerOf2(ring_size)),
+      overflow_behavior_(overflow_behavior) {
+  worker_ = std::thread([this] { Run(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+  stopped_.store(true);
+  {
+    std::lock_guard lock(wakeup_mutex_);
+    wakeup_cv_.notify_one();
+  }
+  worker_.join();
+
+  std::lock_guard lock(rings_mutex_);
+  for (const auto& ring : rings_) ring->MarkConsumerExited();
+}
+
+std::uint64_t AsyncLogger::GetDroppedCount() const noexcept {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::sink_it_(const spdlog::details::log_msg& msg) {
+  auto* ring = GetRing();
+  if (!ring) {
+    spdlog::logger::sink_it_(msg);
+    return;
+  }
+
+  while (!ring->TryPush(msg)) {
+    if (overflow_behavior_ == OverflowBehavior::kDiscard) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Wakeup();
+    std::this_thread::yield();
+  }
+
+  if (should_flush_(msg)) {
+    flush_requested_.store(true, std::memory_order_relaxed);
+  }
+  Wakeup();
+}
+
+void AsyncLogger::flush_() {
+  flush_requested_.store(true, std::memory_order_relaxed);
+  Wakeup();
+}
+
+LogRing* AsyncLogger::GetRing() {
+  if (thread_rings_destroyed) return nullptr;
+  thread_local ThreadRings thread_rings;
+
+  if (auto* ring = thread_rings.Find(id_)) return ring;
+
+  auto ring = std::make_shared<LogRing>(ring_size_);
+  {
+    std::lock_guard lock(rings_mutex_);
+    rings_.push_back(ring);
+  }
+  rings_version_.fetch_add(1, std::memory_order_release);
+
+  auto* result = ring.get();
+  thread_rings.Add(id_, std::move(ring));
+  return result;
+}
+
+void AsyncLogger::Wakeup() noexcept {
+  // Pairs with the fence in Run(): either the worker sees the new message or
+  // we see it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(wakeup_mutex_);
+    wakeup_cv_.notify_one();
+  }
+}
+
+void AsyncLogger::Run() noexcept {
+  utils::SetCurrentThreadName("log/" + name_);
+
+  std::vector<std::shared_ptr<LogRing>> rings;
+  std::uint64_t rings_version = 0;
+  Batch batch;
+  batch.messages.reserve(kMaxBatchSize);
+
+  while (true) {
+    UpdateRings(rings, rings_version);
+
+    const bool stopped = stopped_.load();
+    const auto written = Drain(rings, batch);
+    if (flush_requested_.exchange(false)) FlushSinks();
+    if (written != 0) continue;
+    if (stopped) break;
+
+    std::unique_lock lock(wakeup_mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasPendingMessages(rings) && !flush_requested_.load() &&
+        !stopped_.load() && rings_version == rings_version_.load()) {
+      wakeup_cv_.wait_for(lock, kMaxSleep);
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  FlushSinks();
+}
+
+void AsyncLogger::UpdateRings(std::vector<std::shared_ptr<LogRing>>& rings,
+                              std::uint64_t& rings_version) {
+  const bool has_abandoned =
+      std::any_of(rings.begin(), rings.end(),
+                  [](const auto& ring) { return ring->IsAbandoned(); });
+  if (!has_abandoned && rings_version == rings_version_.load()) return;
+
+  std::lock_guard lock(rings_mutex_);
+  if (has_abandoned) {
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const auto& ring) {
+                                  return ring->IsAbandoned();
+                                }),
+                 rings_.end());
+  }
+  rings = rings_;
+  rings_version = rings_version_.load();
+}
+
+bool AsyncLogger::HasPendingMessages(
+    const std::vector<std::shared_ptr<LogRing>>& rings) const {
+  return std::any_of(rings.begin(), rings.end(), [](const auto& ring) {
+    return ring->HasPendingRecords();
+  });
+}
+
+// Every ring gets an equal share of a batch, and the rings are read starting
+// from the next one each time, so that a flooding thread does not delay
+// the messages of the others
+std::size_t AsyncLogger::Drain(
+    const std::vector<std::shared_ptr<LogRing>>& rings, Batch& batch) {
+  if (rings.empty()) return 0;
+  const auto quota = std::max<std::size_t>(kMaxBatchSize / rings.size(), 1);
+  const auto first = drain_round_++ % rings.size();
+  for (std::size_t i = 0; i < rings.size(); ++i) {
+    const auto max_count =
+        std::min(kMaxBatchSize, batch.messages.size() + quota);
+    rings[(first + i) % rings.size()]->Read(batch.messages, batch.heap_payloads,
+                                            name_, max_count);
+  }
+  const auto written = batch.messages.size();
+  if (written == 0) return 0;
+
+  WriteBatch(batch.messages);
+  for (const auto& ring : rings) ring->Commit();
+  batch.Clear();
+  return written;
+}
+
+void AsyncLogger::WriteBatch(
+    const std::vector<spdlog::details::log_msg>& messages) {
+  for (const auto& sink : sinks_) {
+    try {
+      if (auto* batch_sink = dynamic_cast<BatchSink*>(sink.get())) {
+        batch_sink->LogBatch(messages);
+        continue;
+      }
+      for (const auto& msg : messages) {
+        if (sink->should_log(msg.level)) sink->log(msg);
+      }
+    } catch (const std::exception& e) {
+      err_handler_(e.what());
+    }
+  }
+}
+
+void AsyncLogger::FlushSinks() {
+  for (const auto& sink : sinks_) {
+    try {
+      sink->flush();
+    } catch (const std::exception& e) {
+      err_handler_(e.what());
+    }
+  }
+}
+
+}  // namespace logging::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// this header must be included before any spdlog headers
+// to override spdlog's level names
+#include <logging/spdlog.hpp>
+
+#include <logging/config.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace logging::impl {
+
+class LogRing;
+
+// Asynchronous spdlog logger without a shared message queue.
+//
+// Every thread that logs gets its own single-producer single-consumer ring
+// buffer. sink_it_() copies the message payload into the ring of the current
+// thread without locks or allocations, and a background thread drains all
+// the rings and writes the messages to the sinks in batches, see BatchSink.
+//
+// Messages of a single thread keep their order, messages of different threads
+// may be reordered within a batch.
+//
+// Unlike spdlog::async_logger with async_overflow_policy::overrun_oldest,
+// OverflowBehavior::kDiscard drops the new messages while the ring of the
+// thread is full, because only the background thread may release records.
+class AsyncLogger final : public spdlog::logger {
+ public:
+  using OverflowBehavior = LoggerConfig::QueueOveflowBehavior;
+
+  // ring_size is the maximum size of the per-thread ring buffer in bytes,
+  // rounded up to a power of 2. The rings start small and grow while full.
+  AsyncLogger(std::string name, spdlog::sink_ptr sink, std::size_t ring_size,
+              OverflowBehavior overflow_behavior);
+  ~AsyncLogger() override;
+
+  // Count of the messages dropped because the ring of the producing thread
+  // was full, always 0 for OverflowBehavior::kBlock
+  std::uint64_t GetDroppedCount() const noexcept;
+
+ protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override;
+
+  // Requests the background thread to flush the sinks, does not wait for that
+  void flush_() override;
+
+ private:
+  struct Batch;
+
+  LogRing* GetRing();
+  void Wakeup() noexcept;
+
+  void Run() noexcept;
+  void UpdateRings(std::vector<std::shared_ptr<LogRing>>& rings,
+                   std::uint64_t& rings_version);
+  bool HasPendingMessages(
+      const std::vector<std::shared_ptr<LogRing>>& rings) const;
+  std::size_t Drain(const std::vector<std::shared_ptr<LogRing>>& rings,
+                    Batch& batch);
+  void WriteBatch(const std::vector<spdlog::details::log_msg>& messages);
+  void FlushSinks();
+
+  const std::uint64_t id_;
+  const std::size_t ring_size_;
+  const OverflowBehavior overflow_behavior_;
+  std::atomic<std::uint64_t> dropped_{0};
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+  std::atomic<std::uint64_t> rings_version_{0};
+  // background thread only
+  std::size_t drain_round_{0};
+
+  std::mutex wakeup_mutex_;
+  std::condition_variable wakeup_cv_;
+  std::atomic<bool> sleeping_{false};
+  std::atomic<bool> flush_requested_{false};
+  std::atomic<bool> stopped_{false};
+
+  std::thread worker_;
+};
+
+}  // namespace logging::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <logging/async_logger.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/ostream_sink.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t kRingSize = 1 << 12;
+
+using logging::impl::AsyncLogger;
+
+std::shared_ptr<spdlog::sinks::ostream_sink_mt> MakeStreamSink(
+    std::ostringstream& stream) {
+  auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(stream);
+  sink->set_pattern("%v");
+  return sink;
+}
+
+// Holds the AsyncLogger thread inside the sink until Release()
+class BlockingSink final : public spdlog::sinks::base_sink<std::mutex> {
+ public:
+  void Release() {
+    std::lock_guard lock(blocked_mutex_);
+    released_ = true;
+    blocked_cv_.notify_all();
+  }
+
+  std::size_t GetCount() {
+    std::lock_guard lock(mutex_);
+    return count_;
+  }
+
+ protected:
+  void sink_it_(const spdlog::details::log_msg&) override {
+    std::unique_lock lock(blocked_mutex_);
+    blocked_cv_.wait(lock, [this] { return released_; });
+    ++count_;
+  }
+
+  void flush_() override {}
+
+ private:
+  std::mutex blocked_mutex_;
+  std::condition_variable blocked_cv_;
+  bool released_{false};
+  std::size_t count_{0};
+};
+
+std::vector<std::string> SplitLines(const std::string& text) {
+  std::vector<std::string> lines;
+  std::istringstream stream(text);
+  for (std::string line; std::getline(stream, line);) lines.push_back(line);
+  return lines;
+}
+
+}  // namespace
+
+TEST(AsyncLogger, KeepsOrderOfEachThread) {
+  constexpr int kThreads = 4;
+  constexpr int kMessages = 10000;
+
+  std::ostringstream stream;
+  {
+    AsyncLogger logger("test", MakeStreamSink(stream), kRingSize,
+                       AsyncLogger::OverflowBehavior::kBlock);
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kThreads; ++thread) {
+      threads.emplace_back([&logger, thread] {
+        for (int i = 0; i < kMessages; ++i) {
+          logger.info("{} {}", thread, i);
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(logger.GetDroppedCount(), 0);
+  }
+
+  const auto lines = SplitLines(stream.str());
+  ASSERT_EQ(lines.size(), kThreads * kMessages);
+
+  std::vector<int> next(kThreads, 0);
+  for (const auto& line : lines) {
+    std::istringstream line_stream(line);
+    int thread = -1;
+    int i = -1;
+    line_stream >> thread >> i;
+    ASSERT_GE(thread, 0);
+    ASSERT_LT(thread, kThreads);
+    EXPECT_EQ(i, next[thread]++);
+  }
+}
+
+TEST(AsyncLogger, LongMessages) {
+  const std::string long_message(kRingSize * 4, 'x');
+
+  std::ostringstream stream;
+  {
+    AsyncLogger logger("test", MakeStreamSink(stream), kRingSize,
+                       AsyncLogger::OverflowBehavior::kBlock);
+    logger.info("short");
+    logger.info(long_message);
+    logger.info("short");
+  }
+
+  const auto lines = SplitLines(stream.str());
+  ASSERT_EQ(lines.size(), 3);
+  EXPECT_EQ(lines[0], "short");
+  EXPECT_EQ(lines[1], long_message);
+  EXPECT_EQ(lines[2], "short");
+}
+
+TEST(AsyncLogger, DiscardOnOverflow) {
+  constexpr std::size_t kMessages = 1000;
+  const std::string message(100, 'x');
+
+  auto sink = std::make_shared<BlockingSink>();
+  {
+    AsyncLogger logger("test", sink, kRingSize,
+                       AsyncLogger::OverflowBehavior::kDiscard);
+    for (std::size_t i = 0; i < kMessages; ++i) logger.info(message);
+
+    EXPECT_GT(logger.GetDroppedCount(), 0);
+    sink->Release();
+    logger.flush();
+
+    while (sink->GetCount() + logger.GetDroppedCount() < kMessages) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(sink->GetCount() + logger.GetDroppedCount(), kMessages);
+  }
+}
+
+TEST(AsyncLogger, RingGrowsWhileFull) {
+  constexpr std::size_t kMessages = 1000;
+  const std::string message(100, 'x');
+
+  auto sink = std::make_shared<BlockingSink>();
+  {
+    // The messages do not fit into the initial ring, but fit into the largest
+    AsyncLogger logger("test", sink, kRingSize * 64,
+                       AsyncLogger::OverflowBehavior::kDiscard);
+    for (std::size_t i = 0; i < kMessages; ++i) logger.info(message);
+
+    EXPECT_EQ(logger.GetDroppedCount(), 0);
+    sink->Release();
+    logger.flush();
+
+    while (sink->GetCount() < kMessages) std::this_thread::yield();
+    EXPECT_EQ(sink->GetCount(), kMessages);
+  }
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+// this header must be included before any spdlog headers
+// to override spdlog's level names
+#include <logging/spdlog.hpp>
+
+#include <spdlog/details/log_msg.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace logging::impl {
+
+// Sink that writes a batch of messages under a single lock with a single
+// write call. impl::AsyncLogger hands the messages over to such sinks in
+// batches and falls back to per-message spdlog::sinks::sink::log() otherwise.
+class BatchSink {
+ public:
+  // Writes the messages that pass the sink level, in order
+  virtual void LogBatch(const std::vector<spdlog::details::log_msg>& batch) = 0;
+
+ protected:
+  ~BatchSink() = default;
+};
+
+}  // namespace logging::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,242 @@
+#include <logging/binary_format.hpp>
+
+#include <chrono>
+#include <ctime>
+#include <iterator>
+#include <stdexcept>
+
+#include <fmt/chrono.h>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <userver/utils/encoding/tskv.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace logging::impl::binary {
+
+namespace {
+
+// The id of a key is its index. Never remove or reorder the keys, the logs
+// that are already written would be decoded incorrectly.
+constexpr std::string_view kKnownKeys[] = {
+    // LogHelper
+    "module",
+    "task_id",
+    "thread_id",
+    "text",
+    // tracing::Span
+    "trace_id",
+    "span_id",
+    "parent_id",
+    "link",
+    "parent_link",
+    "stopwatch_name",
+    "total_time",
+    "span_ref_type",
+    "stopwatch_units",
+    "start_timestamp",
+    // tracing tags
+    "_type",
+    "http.url",
+    "meta_type",
+    "method",
+    "meta_code",
+    "attempts",
+    "max_attempts",
+    "timeout_ms",
+    "error",
+    "error_msg",
+    "db.type",
+    "db.collection",
+    "db.instance",
+    "db.statement",
+    "db.statement_name",
+    "db.statement_description",
+    "peer.address",
+};
+
+static_assert(std::size(kKnownKeys) < kLiteralKey);
+
+// spdlog level names, see logging/spdlog.hpp
+constexpr std::string_view kLevelNames[] = {
+    "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "OFF",
+};
+
+class Reader final {
+ public:
+  explicit Reader(std::string_view data) : data_(data) {}
+
+  template <typename T>
+  T ReadLittleEndian() {
+    const auto bytes = Read(sizeof(T));
+    T value = 0;
+    for (std::size_t i = sizeof(T); i > 0; --i) {
+      value = static_cast<T>(value << 8) |
+              static_cast<T>(static_cast<unsigned char>(bytes[i - 1]));
+    }
+    return value;
+  }
+
+  std::string_view Read(std::size_t size) {
+    if (size > data_.size()) {
+      throw std::runtime_error("Binary log record is truncated");
+    }
+    const auto result = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return result;
+  }
+
+  bool IsEmpty() const noexcept { return data_.empty(); }
+
+ private:
+  std::string_view data_;
+};
+
+void AppendTimestamp(std::string& out, std::uint64_t timestamp) {
+  const std::chrono::microseconds since_epoch{timestamp};
+  const auto seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+  const auto micros = (since_epoch - seconds).count();
+
+  // Same as the %Y-%m-%dT%H:%M:%S.%f spdlog pattern in local time
+  fmt::format_to(std::back_inserter(out), FMT_COMPILE("{:%Y-%m-%dT%H:%M:%S}"),
+                 fmt::localtime(static_cast<std::time_t>(seconds.count())));
+  fmt::format_to(std::back_inserter(out), FMT_COMPILE(".{:06}"), micros);
+}
+
+void AppendEncoded(std::string& out, std::string_view value,
+                   utils::encoding::EncodeTskvMode mode) {
+  utils::encoding::EncodeTskv(out, value.begin(), value.end(), mode);
+}
+
+// Checks the part of the header that `data` holds: magic, size and level
+bool IsPlausibleHeader(std::string_view data) noexcept {
+  if (data.empty() ||
+      static_cast<std::uint8_t>(data[0]) != kRecordMagic) {
+    return false;
+  }
+  if (data.size() < 1 + 4) return true;
+
+  std::uint32_t size = 0;
+  for (std::size_t i = 4; i > 0; --i) {
+    size = (size << 8) | static_cast<unsigned char>(data[i]);
+  }
+  if (size < kRecordHeaderSize - 1 - 4 || size > kMaxRecordSize) return false;
+  if (data.size() < kRecordHeaderSize) return true;
+
+  const auto level = static_cast<std::uint8_t>(data[kRecordHeaderSize - 1]);
+  return level < std::size(kLevelNames);
+}
+
+// Returns the offset of the first plausible record header in `data` or
+// data.size() if there is none
+std::size_t FindRecordStart(std::string_view data) noexcept {
+  for (std::size_t pos = 0; pos < data.size(); ++pos) {
+    pos = data.find(static_cast<char>(kRecordMagic), pos);
+    if (pos == std::string_view::npos) break;
+    if (IsPlausibleHeader(data.substr(pos))) return pos;
+  }
+  return data.size();
+}
+
+// Appends a record with the header already read, `record` holds its fields
+void AppendFields(std::string& out, std::uint64_t timestamp,
+                  std::uint8_t level, Reader& record) {
+  out += "tskv\ttimestamp=";
+  AppendTimestamp(out, timestamp);
+  out += "\tlevel=";
+  out += kLevelNames[level];
+
+  while (!record.IsEmpty()) {
+    const auto id = record.ReadLittleEndian<std::uint8_t>();
+    auto key = GetKnownKey(id);
+    if (id == kLiteralKey) {
+      key = record.Read(record.ReadLittleEndian<std::uint16_t>());
+    } else if (key.empty()) {
+      throw std::runtime_error("Unknown key id " + std::to_string(id) +
+                               " in a binary log record");
+    }
+    const auto value = record.Read(record.ReadLittleEndian<std::uint32_t>());
+
+    out += utils::encoding::kTskvPairsSeparator;
+    AppendEncoded(out, key, utils::encoding::EncodeTskvMode::kKeyReplacePeriod);
+    out += utils::encoding::kTskvKeyValueSeparator;
+    AppendEncoded(out, value, utils::encoding::EncodeTskvMode::kValue);
+  }
+  out += '\n';
+}
+
+}  // namespace
+
+std::optional<std::uint8_t> FindKnownKey(std::string_view key) noexcept {
+  for (std::size_t i = 0; i < std::size(kKnownKeys); ++i) {
+    if (kKnownKeys[i] == key) return static_cast<std::uint8_t>(i);
+  }
+  return std::nullopt;
+}
+
+std::string_view GetKnownKey(std::uint8_t id) noexcept {
+  return id < std::size(kKnownKeys) ? kKnownKeys[id] : std::string_view{};
+}
+
+std::size_t DecodeRecordToTskv(std::string_view data, std::string& out) {
+  if (data.size() < kRecordHeaderSize) return 0;
+
+  if (!IsPlausibleHeader(data)) {
+    throw std::runtime_error("Not a binary log record");
+  }
+  Reader header(data.substr(1));
+  const auto size = header.ReadLittleEndian<std::uint32_t>();
+  const auto record_size = 1 + 4 + std::size_t{size};
+  if (data.size() < record_size) return 0;
+
+  Reader record(data.substr(1 + 4, size));
+  const auto timestamp = record.ReadLittleEndian<std::uint64_t>();
+  const auto level = record.ReadLittleEndian<std::uint8_t>();
+
+  const auto old_size = out.size();
+  try {
+    AppendFields(out, timestamp, level, record);
+  } catch (const std::exception&) {
+    out.resize(old_size);
+    throw;
+  }
+  return record_size;
+}
+
+std::size_t DecodeRecordsToTskv(std::string_view& data, std::string& out,
+                                bool is_last_chunk) {
+  std::size_t skipped = 0;
+  const auto skip = [&](std::size_t count) {
+    skipped += count;
+    data.remove_prefix(count);
+  };
+
+  skip(FindRecordStart(data));
+  while (!data.empty()) {
+    std::size_t size = 0;
+    bool is_corrupted = false;
+    try {
+      size = DecodeRecordToTskv(data, out);
+    } catch (const std::runtime_error&) {
+      // a magic byte inside of some garbage, look for the next one
+      is_corrupted = true;
+    }
+
+    if (size != 0) {
+      data.remove_prefix(size);
+    } else if (!is_corrupted && !is_last_chunk) {
+      // the rest of the record is in the next chunk
+      break;
+    } else {
+      skip(1);
+    }
+    skip(FindRecordStart(data));
+  }
+  return skipped;
+}
+
+}  // namespace logging::impl::binary
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace logging::impl::binary {
+
+// Records of Format::kBinary, all the integers are little-endian:
+//
+//   record := magic:u8 size:u32 timestamp:u64 level:u8 field*
+//   field  := key value
+//   key    := id:u8                         one of the well-known keys
+//           | kLiteralKey:u8 size:u16 bytes
+//   value  := size:u32 bytes
+//
+// `size` of a record counts the bytes that follow it, `timestamp` is in
+// microseconds since the epoch. Keys and values are written as is, they are
+// escaped only by the decoder.
+
+inline constexpr std::uint8_t kRecordMagic = 0xB1;
+inline constexpr std::uint8_t kLiteralKey = 0xFF;
+
+// magic, size, timestamp and level
+inline constexpr std::size_t kRecordHeaderSize = 1 + 4 + 8 + 1;
+
+// Records with a larger `size` are treated as garbage by the decoder
+inline constexpr std::uint32_t kMaxRecordSize = 64 << 20;
+
+// Offset of the size of a value that is being written
+using ValueMark = std::size_t;
+
+// Returns the id of a well-known key
+std::optional<std::uint8_t> FindKnownKey(std::string_view key) noexcept;
+
+// Returns the well-known key by id, an empty string for unknown ids
+std::string_view GetKnownKey(std::uint8_t id) noexcept;
+
+template <typename Buffer, typename T>
+void AppendLittleEndian(Buffer& buffer, T value) {
+  char bytes[sizeof(T)];
+  for (auto& byte : bytes) {
+    byte = static_cast<char>(value & 0xFF);
+    value >>= 8;
+  }
+  buffer.append(bytes, bytes + sizeof(T));
+}
+
+template <typename Buffer>
+void AppendKey(Buffer& buffer, std::string_view key) {
+  if (const auto id = FindKnownKey(key)) {
+    buffer.push_back(static_cast<char>(*id));
+    return;
+  }
+
+  if (key.size() > UINT16_MAX) key = key.substr(0, UINT16_MAX);
+  buffer.push_back(static_cast<char>(kLiteralKey));
+  AppendLittleEndian(buffer, static_cast<std::uint16_t>(key.size()));
+  buffer.append(key.data(), key.data() + key.size());
+}
+
+// Reserves the size of a value, the value itself is appended next
+template <typename Buffer>
+ValueMark BeginValue(Buffer& buffer) {
+  const ValueMark mark = buffer.size();
+  AppendLittleEndian(buffer, std::uint32_t{0});
+  return mark;
+}
+
+// Fills the size of the value started with BeginValue()
+template <typename Buffer>
+void EndValue(Buffer& buffer, ValueMark mark) {
+  auto size = static_cast<std::uint32_t>(buffer.size() - mark - 4);
+  for (std::size_t i = 0; i < 4; ++i) {
+    buffer[mark + i] = static_cast<char>(size & 0xFF);
+    size >>= 8;
+  }
+}
+
+// Appends the record at the beginning of `data` to `out` as a TSKV line, the
+// way Format::kTskv would have written it. Returns the size of the record or
+// 0 if `data` holds only a part of it.
+// @throws std::runtime_error if `data` does not start with an intact record,
+// `out` is left unchanged in that case
+std::size_t DecodeRecordToTskv(std::string_view data, std::string& out);
+
+// Appends the records from `data` to `out` as TSKV lines and removes them
+// from `data`. Bytes that do not form an intact record (e.g. the tail of a
+// record cut by a rotation) are skipped up to the next magic byte that starts
+// a plausible header. An incomplete record at the end is left in `data` to be
+// completed by the next chunk, unless `is_last_chunk` is set. Returns the
+// number of skipped bytes.
+std::size_t DecodeRecordsToTskv(std::string_view& data, std::string& out,
+                                bool is_last_chunk);
+
+}  // namespace logging::impl::binary
+
+USERVER_NAMESPACE_END
@@ -12,9 +12,9 @@
 
 #include <fmt/format.h>
 
-#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_sinks.h>
 
+#include <logging/async_logger.hpp>
 #include <logging/logger_with_info.hpp>
 #include <logging/reopening_file_sink.hpp>
 #include <logging/spdlog_helpers.hpp>
@@ -26,8 +26,9 @@
 #include <userver/logging/log.hpp>
 #include <userver/logging/logger.hpp>
 #include <userver/os_signals/component.hpp>
+#include <userver/formats/json/value_builder.hpp>
 #include <userver/utils/algo.hpp>
-#include <userver/utils/thread_name.hpp>
+#include <userver/utils/statistics/metadata.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 #include "config.hpp"
@@ -45,6 +46,10 @@ namespace {
 constexpr std::chrono::seconds kDefaultFlushInterval{2};
 constexpr std::string_view unix_socket_prefix = "unix://";
 
+// Every thread that writes to an asynchronous logger gets a ring buffer of
+// at most message_queue_size * kRingBytesPerQueueItem bytes
+constexpr std::size_t kRingBytesPerQueueItem = 16;
+
 struct TestsuiteCaptureConfig {
   std::string host;
   int port{};
@@ -117,25 +122,25 @@ std::shared_ptr<logging::impl::LoggerWithInfo> CreateAsyncLogger(
     return logging::MakeStdoutLogger(logger_name, logger_config.format,
                                      logger_config.level);
 
-  auto overflow_policy = spdlog::async_overflow_policy::overrun_oldest;
-  if (logger_config.queue_overflow_behavior ==
-      logging::LoggerConfig::QueueOveflowBehavior::kBlock) {
-    overflow_policy = spdlog::async_overflow_policy::block;
-  }
-
   CreateLogDirectory(logger_name, logger_config.file_path);
   spdlog::sink_ptr sink = GetSinkFromFilename(logger_config.file_path);
 
-  auto tp = std::make_shared<spdlog::details::thread_pool>(
-      logger_config.message_queue_size, logger_config.thread_pool_size,
-      [thread_name = "log/" + logger_name] {
-        utils::SetCurrentThreadName(thread_name);
-      });
-
   return std::make_shared<logging::impl::LoggerWithInfo>(
-      logger_config.format, tp,
-      utils::MakeSharedRef<spdlog::async_logger>(logger_name, std::move(sink),
-                                                 tp, overflow_policy));
+      logger_config.format,
+      utils::MakeSharedRef<logging::impl::AsyncLogger>(
+          logger_name, std::move(sink),
+          logger_config.message_queue_size * kRingBytesPerQueueItem,
+          logger_config.queue_overflow_behavior));
+}
+
+void ExtendLoggerStatistics(formats::json::ValueBuilder& builder,
+                            const std::string& logger_name,
+                            const logging::LoggerPtr& logger) {
+  const auto* async_logger =
+      dynamic_cast<const logging::impl::AsyncLogger*>(&*logger->ptr);
+  if (!async_logger) return;
+
+  builder[logger_name]["dropped"] = async_logger->GetDroppedCount();
 }
 
 }  // namespace
@@ -215,13 +220,19 @@ Logging::Logging(const ComponentConfig& config, const ComponentContext& context)
 
     logger->ptr->set_level(
         static_cast<spdlog::level::level_enum>(logger_config.level));
-    logger->ptr->set_pattern(logger_config.pattern);
+    logger->ptr->set_formatter(logging::MakeSpdlogFormatter(
+        logger_config.format, logger_config.pattern));
     logger->ptr->flush_on(
         static_cast<spdlog::level::level_enum>(logger_config.flush_level));
 
     if (is_default_logger) {
       if (const auto& testsuite_config =
               GetTestsuiteCaptureConfig(logger_yaml)) {
+        if (logger_config.format == logging::Format::kBinary) {
+          throw std::runtime_error(
+              "testsuite-capture requires a text format of the default "
+              "logger");
+        }
         impl::AddSocketSink(*testsuite_config, socket_sink_,
                             logger->ptr->sinks());
       }
@@ -316,6 +327,16 @@ void Logging::TryReopenFiles() {
   }
 }
 
+formats::json::Value Logging::ExtendStatistics() const {
+  formats::json::ValueBuilder result(formats::json::Type::kObject);
+  ExtendLoggerStatistics(result, "default", logging::DefaultLogger());
+  for (const auto& [name, logger] : loggers_) {
+    ExtendLoggerStatistics(result, name, logger);
+  }
+  utils::statistics::SolomonChildrenAreLabelValues(result, "logger");
+  return result.ExtractValue();
+}
+
 void Logging::FlushLogs() {
   logging::DefaultLogger()->ptr->flush();
   for (auto& item : loggers_) {
@@ -356,21 +377,26 @@ properties:
                       - tskv
                       - ltsv
                       - raw
+                      - binary
                 flush_level:
                     type: string
                     description: messages of this and higher levels get flushed to the file immediately
                     defaultDescription: warning
                 message_queue_size:
                     type: integer
-                    description: the size of internal message queue, must be a power of 2
+                    description: the size of internal message queue, must be a power of 2; every thread that logs gets a buffer that starts at 4 KiB and grows while full up to `message_queue_size * 16` bytes
                     defaultDescription: 65536
                 overflow_behavior:
                     type: string
-                    description: "message handling policy while the queue is full: `discard` drops messages, `block` waits until message gets into the queue"
+                    description: "message handling policy while the buffer of the thread is full: `discard` drops the new messages (the oldest ones are kept), `block` waits until message gets into the buffer"
                     defaultDescription: discard
                     enum:
                       - discard
                       - block
+                thread_pool_size:
+                    type: integer
+                    description: deprecated and ignored, the loggers no longer use a thread pool; kept so that the existing configs stay valid
+                    defaultDescription: 1
                 testsuite-capture:
                     type: object
                     description: if exists, setups additional TCP log sink for testing purposes
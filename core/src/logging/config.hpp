@@ -28,7 +28,7 @@ struct LoggerConfig {
   size_t message_queue_size = kDefaultMessageQueueSize;
   QueueOveflowBehavior queue_overflow_behavior = QueueOveflowBehavior::kDiscard;
 
-  size_t thread_pool_size = kDefaultThreadPoolSize;
+  size_t thread_pool_size = kDefaultThreadPoolSize;  // deprecated
 };
 
 LoggerConfig Parse(const yaml_config::YamlConfig& value,
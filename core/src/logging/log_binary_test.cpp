@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <logging/binary_format.hpp>
+#include <logging/logging_test.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/logging/log_extra.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+std::string DecodeToTskv(std::string_view data) {
+  std::string result;
+  while (!data.empty()) {
+    const auto size = logging::impl::binary::DecodeRecordToTskv(data, result);
+    if (size == 0) {
+      ADD_FAILURE() << "Truncated record";
+      break;
+    }
+    data.remove_prefix(size);
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST_F(LoggingBinaryTest, Basic) {
+  LOG_INFO() << "tab\tseparated" << logging::LogExtra{{"http.url", "/ping"},
+                                                      {"Custom-Key", 42}};
+  logging::LogFlush();
+
+  const auto tskv = DecodeToTskv(GetStreamString());
+  EXPECT_EQ(tskv.rfind("tskv\ttimestamp=", 0), 0) << tskv;
+  EXPECT_NE(tskv.find("\tlevel=INFO\tmodule="), std::string::npos) << tskv;
+  EXPECT_NE(tskv.find("\ttask_id="), std::string::npos) << tskv;
+  EXPECT_NE(tskv.find("\tthread_id=0x"), std::string::npos) << tskv;
+  EXPECT_NE(tskv.find("\ttext=tab\\tseparated\t"), std::string::npos) << tskv;
+  EXPECT_NE(tskv.find("\thttp_url=/ping"), std::string::npos) << tskv;
+  EXPECT_NE(tskv.find("\tcustom-key=42"), std::string::npos) << tskv;
+  EXPECT_EQ(tskv.find('\n'), tskv.size() - 1) << tskv;
+}
+
+TEST_F(LoggingBinaryTest, ValuesAreNotEscaped) {
+  LOG_INFO() << "line\nbreak";
+  logging::LogFlush();
+
+  const auto binary = GetStreamString();
+  EXPECT_NE(binary.find("line\nbreak"), std::string::npos);
+  EXPECT_NE(DecodeToTskv(binary).find("\ttext=line\\nbreak"),
+            std::string::npos);
+}
+
+TEST_F(LoggingBinaryTest, Truncated) {
+  LOG_INFO() << "text";
+  logging::LogFlush();
+
+  const auto binary = GetStreamString();
+  std::string tskv;
+  for (std::size_t size = 0; size < binary.size(); ++size) {
+    EXPECT_EQ(logging::impl::binary::DecodeRecordToTskv(
+                  std::string_view{binary}.substr(0, size), tskv),
+              0);
+  }
+  EXPECT_EQ(tskv, "");
+
+  EXPECT_THROW(logging::impl::binary::DecodeRecordToTskv(
+                   "tskv\ttimestamp=2021-01-01T00:00:00.000000", tskv),
+               std::runtime_error);
+
+  std::string_view pending = binary;
+  pending.remove_suffix(1);
+  EXPECT_EQ(logging::impl::binary::DecodeRecordsToTskv(
+                pending, tskv, /*is_last_chunk=*/false),
+            0);
+  EXPECT_EQ(pending.size(), binary.size() - 1);
+  EXPECT_EQ(logging::impl::binary::DecodeRecordsToTskv(
+                pending, tskv, /*is_last_chunk=*/true),
+            binary.size() - 1);
+  EXPECT_EQ(pending, "");
+  EXPECT_EQ(tskv, "");
+}
+
+TEST_F(LoggingBinaryTest, Resync) {
+  LOG_INFO() << "text";
+  logging::LogFlush();
+
+  const auto record = GetStreamString();
+  const auto line = DecodeToTskv(record);
+  const std::string garbage("\xB1\x10\x00\x00\x00garbage", 12);
+
+  // as if the file was rotated in the middle of a record and then a record
+  // was cut by a crash
+  const auto data = record.substr(record.size() / 2) + record + garbage +
+                    record + record.substr(0, record.size() / 2);
+  const auto skipped = data.size() - 2 * record.size();
+
+  std::string_view pending = data;
+  std::string tskv;
+  EXPECT_EQ(logging::impl::binary::DecodeRecordsToTskv(
+                pending, tskv, /*is_last_chunk=*/true),
+            skipped);
+  EXPECT_EQ(pending, "");
+  EXPECT_EQ(tskv, line + line);
+
+  // the same when the data comes byte by byte
+  std::string chunks;
+  std::string chunked_tskv;
+  std::size_t chunked_skipped = 0;
+  for (std::size_t i = 0; i <= data.size(); ++i) {
+    if (i < data.size()) chunks += data[i];
+    std::string_view chunks_pending = chunks;
+    chunked_skipped += logging::impl::binary::DecodeRecordsToTskv(
+        chunks_pending, chunked_tskv, /*is_last_chunk=*/i == data.size());
+    chunks.erase(0, chunks.size() - chunks_pending.size());
+  }
+  EXPECT_EQ(chunks, "");
+  EXPECT_EQ(chunked_skipped, skipped);
+  EXPECT_EQ(chunked_tskv, line + line);
+}
+
+USERVER_NAMESPACE_END
@@ -26,7 +26,6 @@
 #include <userver/utils/assert.hpp>
 #include <userver/utils/datetime.hpp>
 #include <userver/utils/encoding/hex.hpp>
-#include <userver/utils/encoding/tskv.hpp>
 #include <userver/utils/traceful_exception.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -174,27 +173,17 @@ void LogHelper::AppendLogExtra() {
   if (items->empty()) return;
 
   for (const auto& item : *items) {
-    Put(utils::encoding::kTskvPairsSeparator);
-    {
-      EncodingGuard guard{*this, Encode::kKeyReplacePeriod};
-      Put(item.first);
-    }
-    pimpl_->PutKeyValueSeparator();
+    pimpl_->PutKey(item.first, Encode::kKeyReplacePeriod);
     std::visit([this](const auto& value) { *this << value; },
                item.second.GetValue());
   }
 }
 
-void LogHelper::LogTextKey() {
-  Put(utils::encoding::kTskvPairsSeparator);
-  Put("text");
-  pimpl_->PutKeyValueSeparator();
-}
+void LogHelper::LogTextKey() { pimpl_->PutKey("text"); }
 
 void LogHelper::LogModule(std::string_view path, int line,
                           std::string_view func) {
-  Put("module");
-  pimpl_->PutKeyValueSeparator();
+  pimpl_->PutKey("module");
   Put(func);
   Put(" ( ");
   Put(path);
@@ -208,14 +197,10 @@ void LogHelper::LogIds() {
   uint64_t task_id = task ? reinterpret_cast<uint64_t>(task) : 0;
   auto* thread_id = reinterpret_cast<void*>(pthread_self());
 
-  Put(utils::encoding::kTskvPairsSeparator);
-  Put("task_id");
-  pimpl_->PutKeyValueSeparator();
+  pimpl_->PutKey("task_id");
   *this << HexShort{task_id};
 
-  Put(utils::encoding::kTskvPairsSeparator);
-  Put("thread_id");
-  pimpl_->PutKeyValueSeparator();
+  pimpl_->PutKey("thread_id");
   *this << Hex{thread_id};
 }
 
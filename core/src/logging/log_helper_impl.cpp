@@ -34,6 +34,8 @@ char GetSeparatorFromLogger(const LoggerPtr& logger_ptr) {
       return '=';
     case Format::kLtsv:
       return ':';
+    case Format::kBinary:
+      return '\0';  // Not used
   }
 
   UINVARIANT(false, "Invalid logging::Format enum value");
@@ -56,6 +58,7 @@ std::streamsize LogHelper::Impl::BufferStd::xsputn(const char_type* s,
 LogHelper::Impl::Impl(LoggerPtr logger, Level level) noexcept
     : logger_(std::move(logger)),
       level_(level),
+      is_binary_(logger_ && logger_->format == Format::kBinary),
       key_value_separator_(GetSeparatorFromLogger(logger_)) {
   static_assert(sizeof(LogHelper::Impl) < 4096,
                 "Structures with size more than 4096 would consume at least "
@@ -63,6 +66,12 @@ LogHelper::Impl::Impl(LoggerPtr logger, Level level) noexcept
 }
 
 std::streamsize LogHelper::Impl::xsputn(const char_type* s, std::streamsize n) {
+  // Binary values are written as is, they are escaped only by the decoder
+  if (is_binary_) {
+    msg_.append(s, s + n);
+    return n;
+  }
+
   switch (encode_mode_) {
     case Encode::kNone:
       msg_.append(s, s + n);
@@ -87,6 +96,11 @@ std::streamsize LogHelper::Impl::xsputn(const char_type* s, std::streamsize n) {
 LogHelper::Impl::int_type LogHelper::Impl::overflow(int_type c) {
   if (c == std::streambuf::traits_type::eof()) return c;
 
+  if (is_binary_) {
+    msg_.push_back(c);
+    return c;
+  }
+
   switch (encode_mode_) {
     case Encode::kNone:
       msg_.push_back(c);
@@ -115,11 +129,33 @@ LogHelper::Impl::LazyInitedStream& LogHelper::Impl::GetLazyInitedStream() {
   return *lazy_stream_;
 }
 
-void LogHelper::Impl::LogTheMessage() const {
+void LogHelper::Impl::PutKey(std::string_view key, Encode key_encoding) {
+  UASSERT(encode_mode_ == Encode::kNone);
+
+  if (is_binary_) {
+    if (value_mark_ != kNoValue) impl::binary::EndValue(msg_, value_mark_);
+    impl::binary::AppendKey(msg_, key);
+    value_mark_ = impl::binary::BeginValue(msg_);
+    return;
+  }
+
+  if (msg_.size() != 0) msg_.push_back(utils::encoding::kTskvPairsSeparator);
+  encode_mode_ = key_encoding;
+  xsputn(key.data(), key.size());
+  encode_mode_ = Encode::kNone;
+  msg_.push_back(key_value_separator_);
+}
+
+void LogHelper::Impl::LogTheMessage() {
   if (IsBroken()) {
     return;
   }
 
+  if (value_mark_ != kNoValue) {
+    impl::binary::EndValue(msg_, value_mark_);
+    value_mark_ = kNoValue;
+  }
+
   UASSERT(logger_);
   std::string_view message(msg_.data(), msg_.size());
   logger_->ptr->log(static_cast<spdlog::level::level_enum>(level_), message);
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <limits>
 #include <optional>
 #include <ostream>
 
 #include <fmt/format.h>
 
+#include <logging/binary_format.hpp>
+#include <userver/logging/format.hpp>
 #include <userver/logging/level.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/logging/log_extra.hpp>
@@ -37,9 +40,11 @@ class LogHelper::Impl final {
   std::streamsize xsputn(const char_type* s, std::streamsize n);
   int_type overflow(int_type c);
 
-  void PutKeyValueSeparator() { xsputn(&key_value_separator_, 1); }
+  // Starts a key-value pair, the value is written next. The key is encoded
+  // with key_encoding in the text formats.
+  void PutKey(std::string_view key, Encode key_encoding = Encode::kNone);
 
-  void LogTheMessage() const;
+  void LogTheMessage();
 
   void MarkTextBegin();
   size_t TextSize() const { return msg_.size() - initial_length_; }
@@ -71,9 +76,14 @@ class LogHelper::Impl final {
 
   static constexpr size_t kOptimalBufferSize = 1500;
 
+  static constexpr auto kNoValue =
+      std::numeric_limits<impl::binary::ValueMark>::max();
+
   LoggerPtr logger_;
   const Level level_;
+  const bool is_binary_;
   const char key_value_separator_;
+  impl::binary::ValueMark value_mark_{kNoValue};
   Encode encode_mode_{Encode::kNone};
   fmt::basic_memory_buffer<char, kOptimalBufferSize> msg_;
   std::optional<LazyInitedStream> lazy_stream_;
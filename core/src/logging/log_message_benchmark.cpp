@@ -1,5 +1,15 @@
 #include <benchmark/benchmark.h>
 
+// this header must be included before any spdlog headers
+// to override spdlog's level names
+#include <logging/spdlog.hpp>
+
+#include <spdlog/async.h>
+
+#include <logging/async_logger.hpp>
+#include <logging/logger_with_info.hpp>
+#include <logging/reopening_file_sink.hpp>
+#include <logging/spdlog_helpers.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/logging/logger.hpp>
 
@@ -98,4 +108,70 @@ BENCHMARK_REGISTER_F(LogHelperBenchmark, LogStruct)
     ->Range(8, 8 << 10)
     ->Complexity();
 
+namespace {
+
+constexpr std::size_t kQueueSize =
+    logging::LoggerConfig::kDefaultMessageQueueSize;
+constexpr auto kNullFile = "/dev/null";
+
+logging::LoggerPtr MakeLogger(utils::SharedRef<spdlog::logger> spdlog_logger) {
+  auto logger = std::make_shared<logging::impl::LoggerWithInfo>(
+      logging::Format::kTskv, std::move(spdlog_logger));
+  logger->ptr->set_pattern(logging::GetSpdlogPattern(logging::Format::kTskv));
+  logger->ptr->set_level(spdlog::level::info);
+  return logger;
+}
+
+// spdlog::async_logger holds only a weak_ptr to its thread pool
+struct SpdlogAsyncLogger {
+  std::shared_ptr<spdlog::details::thread_pool> thread_pool;
+  logging::LoggerPtr logger;
+};
+
+logging::LoggerPtr MakeSpdlogAsyncLogger() {
+  auto holder = std::make_shared<SpdlogAsyncLogger>();
+  holder->thread_pool =
+      std::make_shared<spdlog::details::thread_pool>(kQueueSize, 1);
+  holder->logger = MakeLogger(utils::MakeSharedRef<spdlog::async_logger>(
+      "spdlog", std::make_shared<logging::ReopeningFileSinkMT>(kNullFile),
+      holder->thread_pool, spdlog::async_overflow_policy::block));
+  // the pool outlives the logger and drains the queue in its destructor
+  return {holder, holder->logger.get()};
+}
+
+logging::LoggerPtr MakeNativeAsyncLogger() {
+  return MakeLogger(utils::MakeSharedRef<logging::impl::AsyncLogger>(
+      "native", std::make_shared<logging::ReopeningFileSinkMT>(kNullFile),
+      kQueueSize * 16, logging::LoggerConfig::QueueOveflowBehavior::kBlock));
+}
+
+// Messages per second written to a file by 1..N threads, nothing is dropped
+template <logging::LoggerPtr (*MakeAsyncLogger)()>
+void LogAsyncThroughput(benchmark::State& state) {
+  static logging::LoggerPtr logger;
+  if (state.thread_index() == 0) logger = MakeAsyncLogger();
+
+  const std::string msg(state.range(0), '*');
+  for (auto _ : state) {
+    LOG_INFO_TO(logger) << msg;
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  // The writing thread drains the queue in the destructor
+  if (state.thread_index() == 0) logger.reset();
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(LogAsyncThroughput, MakeSpdlogAsyncLogger)
+    ->Arg(64)
+    ->Arg(1024)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(LogAsyncThroughput, MakeNativeAsyncLogger)
+    ->Arg(64)
+    ->Arg(1024)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
 USERVER_NAMESPACE_END
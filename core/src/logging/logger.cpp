@@ -1,11 +1,15 @@
 #include <userver/logging/logger.hpp>
 
 #include <memory>
+#include <string_view>
+
+#include <fmt/format.h>
 
 // this header must be included before any spdlog headers
 // to override spdlog's level names
 #include <logging/spdlog.hpp>
 
+#include <logging/binary_format.hpp>
 #include <logging/logger_with_info.hpp>
 #include <logging/reopening_file_sink.hpp>
 #include <logging/spdlog_helpers.hpp>
@@ -26,11 +30,11 @@ namespace {
 LoggerPtr MakeSimpleLogger(const std::string& name, spdlog::sink_ptr sink,
                            spdlog::level::level_enum level, Format format) {
   auto spdlog_logger = utils::MakeSharedRef<spdlog::logger>(name, sink);
-  auto logger = std::make_shared<impl::LoggerWithInfo>(
-      format, std::shared_ptr<spdlog::details::thread_pool>{},
-      std::move(spdlog_logger));
+  auto logger =
+      std::make_shared<impl::LoggerWithInfo>(format, std::move(spdlog_logger));
 
-  logger->ptr->set_pattern(GetSpdlogPattern(format));
+  logger->ptr->set_formatter(
+      MakeSpdlogFormatter(format, GetSpdlogPattern(format)));
   logger->ptr->set_level(level);
   logger->ptr->flush_on(level);
   return logger;
@@ -78,7 +82,18 @@ namespace impl {
 
 void LogRaw(LoggerWithInfo& logger, Level level, std::string_view message) {
   auto spdlog_level = static_cast<spdlog::level::level_enum>(level);
-  logger.ptr->log(spdlog_level, "{}", message);
+  if (logger.format != Format::kBinary) {
+    logger.ptr->log(spdlog_level, "{}", message);
+    return;
+  }
+
+  fmt::memory_buffer record;
+  binary::AppendKey(record, "text");
+  const auto mark = binary::BeginValue(record);
+  record.append(message.data(), message.data() + message.size());
+  binary::EndValue(record, mark);
+  logger.ptr->log(spdlog_level,
+                  std::string_view{record.data(), record.size()});
 }
 
 }  // namespace impl
@@ -28,8 +28,7 @@ inline logging::LoggerPtr MakeLoggerFromSink(
     const std::string& logger_name,
     std::shared_ptr<spdlog::sinks::sink> sink_ptr, logging::Format format) {
   return std::make_shared<logging::impl::LoggerWithInfo>(
-      format, std::shared_ptr<spdlog::details::thread_pool>{},
-      utils::MakeSharedRef<spdlog::logger>(logger_name, sink_ptr));
+      format, utils::MakeSharedRef<spdlog::logger>(logger_name, sink_ptr));
 }
 
 inline logging::LoggerPtr MakeNamedStreamLogger(const std::string& logger_name,
@@ -164,7 +163,8 @@ class LoggingTestBase : public ::testing::Test {
     std::ostringstream os;
     os << this;
     auto logger = MakeNamedStreamLogger(os.str(), stream, format_);
-    logger->ptr->set_pattern(logging::GetSpdlogPattern(format_));
+    logger->ptr->set_formatter(logging::MakeSpdlogFormatter(
+        format_, logging::GetSpdlogPattern(format_)));
     return logger;
   }
 
@@ -217,4 +217,9 @@ class LoggingLtsvTest : public LoggingTestBase {
   LoggingLtsvTest() : LoggingTestBase(logging::Format::kLtsv, "text:") {}
 };
 
+class LoggingBinaryTest : public LoggingTestBase {
+ protected:
+  LoggingBinaryTest() : LoggingTestBase(logging::Format::kBinary, "text=") {}
+};
+
 USERVER_NAMESPACE_END
@@ -2,6 +2,7 @@
 
 #include <mutex>
 #include <string>
+#include <vector>
 
 // this header must be included before any spdlog headers
 // to override spdlog's level names
@@ -15,12 +16,15 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/version.h>
 
+#include <logging/batch_sink.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace logging {
 
 template <typename Mutex>
-class ReopeningFileSink final : public spdlog::sinks::base_sink<Mutex> {
+class ReopeningFileSink final : public spdlog::sinks::base_sink<Mutex>,
+                                public impl::BatchSink {
  public:
   using filename_t = spdlog::filename_t;
   using sink = spdlog::sinks::base_sink<Mutex>;
@@ -41,6 +45,17 @@ class ReopeningFileSink final : public spdlog::sinks::base_sink<Mutex> {
   }
   void Close() { file_helper_.close(); }
 
+  void LogBatch(const std::vector<spdlog::details::log_msg>& batch) override {
+    std::lock_guard<Mutex> lock(this->mutex_);
+    batch_buffer_.clear();
+    for (const auto& msg : batch) {
+      if (this->should_log(msg.level)) {
+        sink::formatter_->format(msg, batch_buffer_);
+      }
+    }
+    file_helper_.write(batch_buffer_);
+  }
+
  protected:
   void sink_it_(const spdlog::details::log_msg& msg) override {
     spdlog::memory_buf_t formatted;
@@ -53,6 +68,8 @@ class ReopeningFileSink final : public spdlog::sinks::base_sink<Mutex> {
  private:
   filename_t filename_;
   spdlog::details::file_helper file_helper_;
+  // Reused by LogBatch() to avoid an allocation per batch
+  spdlog::memory_buf_t batch_buffer_;
 };
 
 using ReopeningFileSinkST = ReopeningFileSink<spdlog::details::null_mutex>;
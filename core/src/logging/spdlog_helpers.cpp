@@ -1,11 +1,44 @@
 #include <logging/spdlog_helpers.hpp>
 
+#include <chrono>
+
+#include <spdlog/pattern_formatter.h>
+
+#include <logging/binary_format.hpp>
 #include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace logging {
 
+namespace {
+
+// Prepends the binary record header to the fields written by LogHelper
+class BinaryFormatter final : public spdlog::formatter {
+ public:
+  void format(const spdlog::details::log_msg& msg,
+              spdlog::memory_buf_t& dest) override {
+    const auto timestamp =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            msg.time.time_since_epoch())
+            .count();
+    const auto size = sizeof(std::uint64_t) + 1 + msg.payload.size();
+
+    dest.push_back(static_cast<char>(impl::binary::kRecordMagic));
+    impl::binary::AppendLittleEndian(dest, static_cast<std::uint32_t>(size));
+    impl::binary::AppendLittleEndian(dest,
+                                     static_cast<std::uint64_t>(timestamp));
+    dest.push_back(static_cast<char>(msg.level));
+    dest.append(msg.payload.begin(), msg.payload.end());
+  }
+
+  std::unique_ptr<spdlog::formatter> clone() const override {
+    return std::make_unique<BinaryFormatter>();
+  }
+};
+
+}  // namespace
+
 const std::string& GetSpdlogPattern(Format format) {
   static const std::string kSpdlogTskvPattern =
       "tskv\ttimestamp=%Y-%m-%dT%H:%M:%S.%f\tlevel=%l\t%v";
@@ -19,12 +52,20 @@ const std::string& GetSpdlogPattern(Format format) {
     case Format::kLtsv:
       return kSpdlogLtsvPattern;
     case Format::kRaw:
+    // the binary format is not a pattern, see MakeSpdlogFormatter()
+    case Format::kBinary:
       return kSpdlogRawPattern;
   }
 
   UINVARIANT(false, "Invalid logging::Format enum value");
 }
 
+std::unique_ptr<spdlog::formatter> MakeSpdlogFormatter(
+    Format format, const std::string& pattern) {
+  if (format == Format::kBinary) return std::make_unique<BinaryFormatter>();
+  return std::make_unique<spdlog::pattern_formatter>(pattern);
+}
+
 }  // namespace logging
 
 USERVER_NAMESPACE_END
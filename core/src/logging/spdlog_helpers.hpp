@@ -1,7 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
+// this header must be included before any spdlog headers
+// to override spdlog's level names
+#include <logging/spdlog.hpp>
+
+#include <spdlog/formatter.h>
+
 #include <userver/logging/format.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -10,6 +17,10 @@ namespace logging {
 
 const std::string& GetSpdlogPattern(Format format);
 
+// Returns the formatter for the format, the text formats use the pattern
+std::unique_ptr<spdlog::formatter> MakeSpdlogFormatter(
+    Format format, const std::string& pattern);
+
 }  // namespace logging
 
 USERVER_NAMESPACE_END
@@ -2,14 +2,18 @@
 
 #include <mutex>
 #include <string>
+#include <vector>
 
 // this header must be included before any spdlog headers
 // to override spdlog's level names
 #include <logging/spdlog.hpp>
 
+#include <spdlog/details/log_msg.h>
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/base_sink.h>
 
+#include <logging/batch_sink.hpp>
+
 USERVER_NAMESPACE_BEGIN
 namespace logging {
 
@@ -36,7 +40,8 @@ class UnixSocketClient final {
 }  // namespace impl
 
 template <typename Mutex>
-class SocketSink final : public spdlog::sinks::base_sink<Mutex> {
+class SocketSink final : public spdlog::sinks::base_sink<Mutex>,
+                         public impl::BatchSink {
  public:
   using filename_t = spdlog::filename_t;
   using sink = spdlog::sinks::base_sink<Mutex>;
@@ -48,6 +53,17 @@ class SocketSink final : public spdlog::sinks::base_sink<Mutex> {
   // TODO : find out is it necessary to close and where. Destructor or close?
   void Close() { client_.close(); }
 
+  void LogBatch(const std::vector<spdlog::details::log_msg>& batch) override {
+    std::lock_guard<Mutex> lock(this->mutex_);
+    batch_buffer_.clear();
+    for (const auto& msg : batch) {
+      if (this->should_log(msg.level)) {
+        sink::formatter_->format(msg, batch_buffer_);
+      }
+    }
+    client_.send(batch_buffer_.data(), batch_buffer_.size());
+  }
+
  protected:
   void sink_it_(const spdlog::details::log_msg& msg) override {
     spdlog::memory_buf_t formatted;
@@ -60,6 +76,8 @@ class SocketSink final : public spdlog::sinks::base_sink<Mutex> {
  private:
   filename_t filename_;
   impl::UnixSocketClient client_;
+  // Reused by LogBatch() to avoid an allocation per batch
+  spdlog::memory_buf_t batch_buffer_;
 };
 
 using SocketSinkST = SocketSink<spdlog::details::null_mutex>;
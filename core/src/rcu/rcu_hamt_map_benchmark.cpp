@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include <userver/engine/run_standalone.hpp>
+#include <userver/rcu/rcu_hamt_map.hpp>
+#include <userver/rcu/rcu_map.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using RcuMap = rcu::RcuMap<std::uint64_t, std::uint64_t>;
+using RcuHamtMap = rcu::RcuHamtMap<std::uint64_t, std::uint64_t>;
+
+template <typename Map>
+void Fill(Map& map, std::uint64_t size) {
+  std::unordered_map<std::uint64_t, std::shared_ptr<std::uint64_t>> data;
+  data.reserve(size);
+  for (std::uint64_t i = 0; i < size; ++i) {
+    data.emplace(i, std::make_shared<std::uint64_t>(i));
+  }
+  map.Assign(std::move(data));
+}
+
+}  // namespace
+
+template <typename Map>
+void rcu_map_insert_erase(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const std::uint64_t size = state.range(0);
+    Map map;
+    Fill(map, size);
+    const auto value = std::make_shared<std::uint64_t>(0);
+
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+      // keeps the map size constant
+      const auto key = size + i % size;
+      map.Insert(key, value);
+      map.Erase(key - size);
+      map.Insert(key - size, value);
+      map.Erase(key);
+      ++i;
+    }
+  });
+}
+BENCHMARK_TEMPLATE(rcu_map_insert_erase, RcuMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+BENCHMARK_TEMPLATE(rcu_map_insert_erase, RcuHamtMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+
+void rcu_hamt_map_batch_insert(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const std::uint64_t size = state.range(0);
+    const std::uint64_t batch_size = state.range(1);
+    RcuHamtMap map;
+    Fill(map, size);
+    const auto value = std::make_shared<std::uint64_t>(0);
+
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+      auto batch = map.StartBatch();
+      for (std::uint64_t j = 0; j < batch_size; ++j) {
+        batch.InsertOrAssign((i + j) % size, value);
+      }
+      batch.Commit();
+      i += batch_size;
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+  });
+}
+BENCHMARK(rcu_hamt_map_batch_insert)
+    ->RangeMultiplier(8)
+    ->Ranges({{8 << 9, 8 << 15}, {1, 512}});
+
+template <typename Map>
+void rcu_map_lookup(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const std::uint64_t size = state.range(0);
+    Map map;
+    Fill(map, size);
+
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(map.Get(i++ % size));
+    }
+  });
+}
+BENCHMARK_TEMPLATE(rcu_map_lookup, RcuMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+BENCHMARK_TEMPLATE(rcu_map_lookup, RcuHamtMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+
+template <typename Map>
+void rcu_map_iteration(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const std::uint64_t size = state.range(0);
+    Map map;
+    Fill(map, size);
+
+    for (auto _ : state) {
+      for (const auto& [key, value] : map) {
+        benchmark::DoNotOptimize(value);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+  });
+}
+BENCHMARK_TEMPLATE(rcu_map_iteration, RcuMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+BENCHMARK_TEMPLATE(rcu_map_iteration, RcuHamtMap)
+    ->RangeMultiplier(8)
+    ->Range(8, 8 << 15);
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,339 @@
+#include <userver/utest/utest.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <userver/engine/sleep.hpp>
+#include <userver/rcu/rcu_hamt_map.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/rand.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// Forces full hash collisions to exercise collision nodes
+struct BadHash {
+  std::size_t operator()(int value) const { return value / 4; }
+};
+
+template <typename Hamt>
+std::map<int, int> ToMap(const Hamt& hamt) {
+  std::map<int, int> result;
+  for (const auto& entry : hamt) {
+    EXPECT_TRUE(result.emplace(entry.key, entry.value).second);
+  }
+  EXPECT_EQ(result.size(), hamt.size());
+  return result;
+}
+
+template <typename Hash>
+void CheckAgainstModel(int key_range, int iterations) {
+  rcu::impl::Hamt<int, int, Hash> hamt;
+  std::map<int, int> model;
+
+  for (int i = 0; i < iterations; ++i) {
+    const int key = utils::RandRange(key_range);
+    switch (utils::RandRange(3)) {
+      case 0:
+        EXPECT_EQ(hamt.Insert(key, i), model.emplace(key, i).second);
+        break;
+      case 1:
+        EXPECT_EQ(hamt.InsertOrAssign(key, i),
+                  model.insert_or_assign(key, i).second);
+        break;
+      default: {
+        const auto erased = hamt.Erase(key);
+        const auto it = model.find(key);
+        ASSERT_EQ(erased.has_value(), it != model.end());
+        if (erased) {
+          EXPECT_EQ(*erased, it->second);
+          model.erase(it);
+        }
+      }
+    }
+
+    const auto* value = hamt.Find(key);
+    const auto it = model.find(key);
+    ASSERT_EQ(!!value, it != model.end());
+    if (value) {
+      EXPECT_EQ(*value, it->second);
+    }
+  }
+  EXPECT_EQ(ToMap(hamt), model);
+}
+
+}  // namespace
+
+TEST(RcuHamt, Basic) {
+  rcu::impl::Hamt<std::string, int> hamt;
+  EXPECT_TRUE(hamt.empty());
+  EXPECT_EQ(hamt.begin(), hamt.end());
+  EXPECT_FALSE(hamt.Find("a"));
+  EXPECT_FALSE(hamt.Erase("a"));
+
+  EXPECT_TRUE(hamt.Insert("a", 1));
+  EXPECT_FALSE(hamt.Insert("a", 2));
+  EXPECT_EQ(*hamt.Find("a"), 1);
+  EXPECT_FALSE(hamt.InsertOrAssign("a", 3));
+  EXPECT_EQ(*hamt.Find("a"), 3);
+  EXPECT_EQ(hamt.size(), 1);
+
+  EXPECT_EQ(hamt.Erase("a"), 3);
+  EXPECT_TRUE(hamt.empty());
+  EXPECT_EQ(hamt.begin(), hamt.end());
+}
+
+TEST(RcuHamt, RandomOperations) {
+  CheckAgainstModel<std::hash<int>>(1000, 20000);
+}
+
+TEST(RcuHamt, Collisions) { CheckAgainstModel<BadHash>(200, 5000); }
+
+TEST(RcuHamt, StructuralSharing) {
+  rcu::impl::Hamt<int, int> hamt;
+  for (int i = 0; i < 1000; ++i) hamt.Insert(i, i);
+  const auto old_map = ToMap(hamt);
+
+  auto copy = hamt;
+  for (int i = 0; i < 1000; i += 2) copy.Erase(i);
+  copy.InsertOrAssign(1, -1);
+  copy.Insert(5000, 5000);
+
+  EXPECT_EQ(ToMap(hamt), old_map);
+  EXPECT_EQ(copy.size(), 501);
+  EXPECT_EQ(*copy.Find(1), -1);
+  EXPECT_EQ(*hamt.Find(1), 1);
+  EXPECT_FALSE(copy.Find(0));
+  EXPECT_EQ(*hamt.Find(0), 0);
+}
+
+TEST(RcuHamt, TransientEdit) {
+  rcu::impl::Hamt<int, int> hamt;
+  for (int i = 0; i < 100; ++i) hamt.Insert(i, i);
+  const auto old_map = ToMap(hamt);
+
+  auto edited = hamt;
+  edited.BeginEdit();
+  for (int i = 0; i < 100; ++i) edited.InsertOrAssign(i, -i);
+  for (int i = 100; i < 200; ++i) edited.Insert(i, i);
+
+  // Copying in the middle of an edit session must not expose later changes
+  const auto intermediate = edited;
+  for (int i = 0; i < 200; i += 3) edited.Erase(i);
+  edited.EndEdit();
+
+  EXPECT_EQ(ToMap(hamt), old_map);
+  EXPECT_EQ(intermediate.size(), 200);
+  EXPECT_EQ(*intermediate.Find(3), -3);
+  EXPECT_EQ(*intermediate.Find(150), 150);
+  EXPECT_EQ(edited.size(), 200 - 67);
+  EXPECT_FALSE(edited.Find(3));
+  EXPECT_EQ(*edited.Find(4), -4);
+}
+
+UTEST(RcuHamtMap, Empty) {
+  rcu::RcuHamtMap<std::string, int> map;
+  const auto& cmap = map;
+
+  EXPECT_EQ(0, map.SizeApprox());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(cmap.begin(), cmap.end());
+  auto snap = map.GetSnapshot();
+  map.Clear();
+  EXPECT_EQ(snap, map.GetSnapshot());
+}
+
+UTEST(RcuHamtMap, Modify) {
+  rcu::RcuHamtMap<std::string, int> map;
+  const auto& cmap = map;
+
+  UEXPECT_THROW(cmap["any"], rcu::MissingKeyException);
+  EXPECT_FALSE(map.Get("any"));
+  EXPECT_FALSE(cmap.Get("any"));
+  EXPECT_FALSE(map.Erase("any"));
+  EXPECT_FALSE(map.Pop("any"));
+
+  UEXPECT_NO_THROW(*map["any"] = 1);
+
+  EXPECT_EQ(1, *cmap["any"]);
+  EXPECT_EQ(1, *map.Get("any"));
+  EXPECT_EQ(1, *cmap.Get("any"));
+  EXPECT_TRUE(map.Erase("any"));
+  EXPECT_FALSE(map.Erase("any"));
+  EXPECT_FALSE(map.Pop("any"));
+
+  EXPECT_TRUE(map.Insert("any", std::make_shared<int>(3)).inserted);
+  EXPECT_FALSE(map.Insert("any", std::make_shared<int>(0)).inserted);
+  EXPECT_EQ(*map.Insert("any", std::make_shared<int>(0)).value, 3);
+  EXPECT_EQ(*map.Pop("any"), 3);
+
+  EXPECT_TRUE(map.Emplace("any", 4).inserted);
+  EXPECT_FALSE(map.Emplace("any", 0).inserted);
+  EXPECT_EQ(*map.Emplace("any", 0).value, 4);
+  EXPECT_EQ(*map.Pop("any"), 4);
+
+  EXPECT_TRUE(map.TryEmplace("any", 5).inserted);
+  EXPECT_FALSE(map.TryEmplace("any", 0).inserted);
+  EXPECT_EQ(*map.TryEmplace("any", 0).value, 5);
+
+  map.InsertOrAssign("any", std::make_shared<int>(6));
+  EXPECT_EQ(*cmap["any"], 6);
+
+  UEXPECT_NO_THROW(
+      map.Assign(std::unordered_map<std::string, std::shared_ptr<int>>{
+          {"foo", std::make_shared<int>(7)}}));
+  EXPECT_FALSE(map.Get("any"));
+  EXPECT_EQ(*cmap["foo"], 7);
+  EXPECT_EQ(1, map.SizeApprox());
+}
+
+UTEST(RcuHamtMap, Snapshot) {
+  rcu::RcuHamtMap<int, int> map;
+  for (int i = 0; i < 1000; ++i) *map[i] = i;
+
+  auto it = map.begin();
+  map.Clear();
+  std::map<int, int> seen;
+  for (; it != map.end(); ++it) seen.emplace(it->first, *it->second);
+  EXPECT_EQ(seen.size(), 1000);
+  EXPECT_EQ(seen[999], 999);
+
+  EXPECT_TRUE(map.GetSnapshot().empty());
+}
+
+UTEST(RcuHamtMap, Batch) {
+  rcu::RcuHamtMap<int, int> map;
+  *map[-1] = -1;
+
+  {
+    auto batch = map.StartBatch();
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(batch.Insert(i, std::make_shared<int>(i)));
+    }
+    EXPECT_FALSE(batch.Insert(0, std::make_shared<int>(0)));
+    EXPECT_TRUE(batch.Erase(-1));
+    EXPECT_EQ(*batch.Get(42), 42);
+    // Not committed
+  }
+  EXPECT_EQ(map.SizeApprox(), 1);
+  EXPECT_FALSE(map.Get(42));
+
+  auto batch = map.StartBatch();
+  for (int i = 0; i < 100; ++i) {
+    batch.InsertOrAssign(i, std::make_shared<int>(i));
+  }
+  EXPECT_TRUE(batch.Erase(-1));
+  EXPECT_FALSE(map.Get(42));
+  batch.Commit();
+
+  EXPECT_EQ(map.SizeApprox(), 100);
+  EXPECT_EQ(*map.Get(42), 42);
+  EXPECT_FALSE(map.Get(-1));
+}
+
+UTEST_MT(RcuHamtMap, ConcurrentTryEmplace, 16) {
+  const size_t kReps = 100;
+
+  for (size_t rep = 0; rep < kReps; rep++) {
+    rcu::RcuHamtMap<std::string, int> map;
+
+    const size_t kTasks = 16;
+    std::atomic<size_t> insertions = 0;
+
+    std::vector<engine::TaskWithResult<void>> tasks;
+    for (size_t i = 0; i < kTasks; i++) {
+      tasks.push_back(engine::AsyncNoSpan([&map, &insertions, i] {
+        auto key = std::string(20 + i / 2, 'x');
+        auto res = map.TryEmplace(key, i);
+        if (res.inserted) ++insertions;
+        EXPECT_EQ(*res.value / 2, i / 2);
+      }));
+    }
+    for (auto& task : tasks) {
+      task.Get();
+    }
+    EXPECT_EQ(insertions, kTasks / 2);
+  }
+}
+
+UTEST_MT(RcuHamtMap, ConcurrentReadersSeeConsistentBatches, 4) {
+  rcu::RcuHamtMap<int, int> map;
+  constexpr int kKeys = 64;
+  std::atomic<bool> stop_flag{false};
+
+  std::array<engine::TaskWithResult<void>, 3> readers;
+  for (auto& reader : readers) {
+    reader = utils::Async("reader", [&map, &stop_flag] {
+      while (!stop_flag) {
+        std::optional<int> generation;
+        std::size_t size = 0;
+        for (const auto& [key, value] : map) {
+          if (!generation) generation = *value;
+          // Every batch assigns the same generation to all the keys
+          ASSERT_EQ(*generation, *value) << key;
+          ++size;
+        }
+        ASSERT_TRUE(size == 0 || size == kKeys);
+        engine::Yield();
+      }
+    });
+  }
+
+  for (int generation = 0; generation < 1000; ++generation) {
+    auto batch = map.StartBatch();
+    for (int key = 0; key < kKeys; ++key) {
+      batch.InsertOrAssign(key, std::make_shared<int>(generation));
+    }
+    batch.Commit();
+  }
+
+  stop_flag = true;
+  for (auto& reader : readers) reader.Get();
+}
+
+UTEST(RcuHamtMap, SampleRcuHamtMapVariable) {
+  /// [Sample rcu::RcuHamtMap usage]
+  struct Data {
+    // Access to RcuHamtMap content must be synchronized via std::atomic
+    // or other synchronization primitives
+    std::atomic<int> x{0};
+  };
+  rcu::RcuHamtMap<std::string, Data> map;
+
+  // If the key is not in the dictionary,
+  // then a default object will be created
+  map["123"]->x++;
+  ASSERT_EQ(map["123"]->x.load(), 1);
+
+  // Several changes may be published to readers at once
+  auto batch = map.StartBatch();
+  batch.Erase("123");
+  batch.Insert("456", std::make_shared<Data>());
+  batch.Insert("789", std::make_shared<Data>());
+  batch.Commit();
+
+  ASSERT_FALSE(map.Get("123"));
+  ASSERT_EQ(map.SizeApprox(), 2);
+  /// [Sample rcu::RcuHamtMap usage]
+}
+
+UTEST(RcuHamtMap, MapOfConst) {
+  rcu::RcuHamtMap<std::string, const int> map;
+  map.Emplace("foo", 10);
+  map.Emplace("bar", 20);
+  EXPECT_EQ(*map["foo"], 10);
+  EXPECT_EQ(*map["bar"], 20);
+
+  int value_sum = 0;
+  for (const auto& [key, value] : map) {
+    value_sum += *value;
+  }
+  EXPECT_EQ(value_sum, 30);
+}
+
+USERVER_NAMESPACE_END
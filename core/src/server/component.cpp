@@ -133,6 +133,18 @@ properties:
                         type: integer
                         description: timeout in seconds to drop connection if there's not data received from it
                         defaultDescription: 600
+                    http2_enabled:
+                        type: boolean
+                        description: serve HTTP/2 (h2c with prior knowledge) on connections that start with the HTTP/2 connection preface
+                        defaultDescription: false
+                    http2_max_concurrent_streams:
+                        type: integer
+                        description: max count of concurrently processed requests of an HTTP/2 connection
+                        defaultDescription: 100
+                    http2_initial_window_size:
+                        type: integer
+                        description: initial HTTP/2 flow control window of a stream in bytes
+                        defaultDescription: 65535
             shards:
                 type: integer
                 description: how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing
@@ -177,6 +189,18 @@ properties:
                         type: integer
                         description: timeout in seconds to drop connection if there's not data received from it
                         defaultDescription: 600
+                    http2_enabled:
+                        type: boolean
+                        description: serve HTTP/2 (h2c with prior knowledge) on connections that start with the HTTP/2 connection preface
+                        defaultDescription: false
+                    http2_max_concurrent_streams:
+                        type: integer
+                        description: max count of concurrently processed requests of an HTTP/2 connection
+                        defaultDescription: 100
+                    http2_initial_window_size:
+                        type: integer
+                        description: initial HTTP/2 flow control window of a stream in bytes
+                        defaultDescription: 65535
             handler-defaults:
                 type: object
                 description: handler defaults options
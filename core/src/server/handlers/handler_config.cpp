@@ -29,6 +29,29 @@ FallbackHandler Parse(const yaml_config::YamlConfig& yaml,
   return FallbackHandlerFromString(value);
 }
 
+ResponseCompressionConfig Parse(const yaml_config::YamlConfig& value,
+                                formats::parse::To<ResponseCompressionConfig>) {
+  ResponseCompressionConfig config;
+  config.min_size = value["min-size"].As<size_t>(config.min_size);
+  config.gzip_level = value["gzip-level"].As<int>(config.gzip_level);
+  config.brotli_quality =
+      value["brotli-quality"].As<int>(config.brotli_quality);
+  config.task_processor =
+      value["task-processor"].As<std::optional<std::string>>();
+
+  if (config.gzip_level < 0 || config.gzip_level > 9) {
+    throw std::runtime_error(
+        "gzip-level should be in [0, 9], current value is " +
+        std::to_string(config.gzip_level));
+  }
+  if (config.brotli_quality < 0 || config.brotli_quality > 11) {
+    throw std::runtime_error(
+        "brotli-quality should be in [0, 11], current value is " +
+        std::to_string(config.brotli_quality));
+  }
+  return config;
+}
+
 HandlerConfig ParseHandlerConfigsWithDefaults(
     const yaml_config::YamlConfig& value,
     const server::ServerConfig& server_config, bool is_monitor) {
@@ -86,6 +109,9 @@ HandlerConfig ParseHandlerConfigsWithDefaults(
       value["set-response-server-hostname"].As<std::optional<bool>>();
 
   config.response_body_stream = value["response-body-stream"].As<bool>(false);
+  config.response_compression =
+      value["response-compression"]
+          .As<std::optional<ResponseCompressionConfig>>();
 
   if (config.max_requests_per_second &&
       config.max_requests_per_second.value() <= 0) {
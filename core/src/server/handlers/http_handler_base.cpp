@@ -7,11 +7,13 @@
 #include <compression/gzip.hpp>
 #include <server/handlers/http_handler_base_statistics.hpp>
 #include <server/handlers/http_server_settings.hpp>
+#include <server/http/content_encoding.hpp>
 #include <server/http/http_request_impl.hpp>
 #include <server/server_config.hpp>
 #include <userver/components/component.hpp>
 #include <userver/components/statistics_storage.hpp>
 #include <userver/dynamic_config/storage/component.hpp>
+#include <userver/engine/async.hpp>
 #include <userver/engine/task/cancel.hpp>
 #include <userver/engine/task/inherited_variable.hpp>
 #include <userver/formats/json/serialize.hpp>
@@ -78,6 +80,7 @@ std::vector<http::HttpMethod> InitAllowedMethods(const HandlerConfig& config) {
 
 void SetFormattedErrorResponse(http::HttpResponse& http_response,
                                FormattedErrorData&& formatted_error_data) {
+  http_response.ClearBody();
   http_response.SetData(std::move(formatted_error_data.external_body));
   if (formatted_error_data.content_type) {
     http_response.SetContentType(*std::move(formatted_error_data.content_type));
@@ -162,6 +165,7 @@ class RequestProcessor final {
                  << "' handler in " + step_name + ": msg=" << ex;
       response.SetStatus(http_status);
       if (ex.IsExternalErrorBodyFormatted()) {
+        response.ClearBody();
         response.SetData(ex.GetExternalErrorBody());
       } else {
         SetFormattedErrorResponse(response,
@@ -330,6 +334,12 @@ HttpHandlerBase::HttpHandlerBase(const components::ComponentConfig& config,
       log_level_(config["log-level"].As<std::optional<logging::Level>>()),
       rate_limit_(utils::TokenBucket::MakeUnbounded()),
       is_body_streamed_(config["response-body-stream"].As<bool>(false)) {
+  const auto& compression_config = GetConfig().response_compression;
+  if (compression_config && compression_config->task_processor) {
+    compression_task_processor_ =
+        &context.GetTaskProcessor(*compression_config->task_processor);
+  }
+
   if (allowed_methods_.empty()) {
     LOG_WARNING() << "empty allowed methods list in " << config.Name();
   }
@@ -513,6 +523,7 @@ void HttpHandlerBase::HandleRequest(request::RequestBase& request,
             // Though it can be changed in HandleStreamRequest().
             response_body_stream.SetStatusCode(500);
 
+            SetResponseStreamCompressor(http_request, response);
             HandleStreamRequest(http_request, context, response_body_stream);
           } else {
             // !IsBodyStreamed()
@@ -523,6 +534,7 @@ void HttpHandlerBase::HandleRequest(request::RequestBase& request,
     LOG_ERROR() << "unable to handle request: " << ex;
   }
 
+  CompressResponse(http_request, response);
   SetResponseAcceptEncoding(response);
   SetResponseServerHostname(response);
 }
@@ -758,6 +770,90 @@ void HttpHandlerBase::SetResponseAcceptEncoding(
   }
 }
 
+namespace {
+
+void AddVaryAcceptEncoding(http::HttpResponse& response) {
+  const std::string kVary = USERVER_NAMESPACE::http::headers::kVary;
+  const std::string_view kAcceptEncoding =
+      USERVER_NAMESPACE::http::headers::kAcceptEncoding;
+  if (!response.HasHeader(kVary)) {
+    response.SetHeader(kVary, std::string{kAcceptEncoding});
+    return;
+  }
+  const auto& vary = response.GetHeader(kVary);
+  if (vary.find(kAcceptEncoding) == std::string::npos && vary != "*") {
+    response.SetHeader(kVary, fmt::format("{}, {}", vary, kAcceptEncoding));
+  }
+}
+
+bool IsCompressibleStatus(http::HttpStatus status) {
+  // Content-Range of 206 refers to the uncompressed representation
+  return static_cast<int>(status) >= 200 &&
+         status != http::HttpStatus::kNoContent &&
+         status != http::HttpStatus::kPartialContent &&
+         status != http::HttpStatus::kNotModified;
+}
+
+constexpr http::ContentEncodings kResponseContentEncodings{
+    http::ContentEncoding::kGzip, http::ContentEncoding::kBrotli};
+
+}  // namespace
+
+void HttpHandlerBase::CompressResponse(const http::HttpRequest& http_request,
+                                       http::HttpResponse& response) const {
+  const auto& config = GetConfig().response_compression;
+  if (!config || response.IsBodyStreamed() || response.HasBodyFile()) return;
+
+  const auto data = response.GetBodyView();
+  if (data.size() < config->min_size ||
+      !IsCompressibleStatus(response.GetStatus()) ||
+      response.HasHeader(USERVER_NAMESPACE::http::headers::kContentEncoding)) {
+    return;
+  }
+  AddVaryAcceptEncoding(response);
+
+  const auto encoding = http::NegotiateContentEncoding(
+      http_request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding),
+      kResponseContentEncodings);
+  if (encoding == http::ContentEncoding::kNone) return;
+
+  try {
+    const auto compress = [data, encoding, &config] {
+      return http::MakeStreamCompressor(encoding, *config)->Finish(data);
+    };
+    auto compressed = compression_task_processor_
+                          ? engine::AsyncNoSpan(*compression_task_processor_,
+                                                compress)
+                                .Get()
+                          : compress();
+    if (compressed.size() >= data.size()) return;
+
+    // Drops the body set by SetBodyShared(), `data` is dangling from now on
+    response.ClearBody();
+    response.SetData(std::move(compressed));
+    response.SetContentEncoding(std::string{http::ToString(encoding)});
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "Failed to compress the response, sending it as is: "
+                << ex;
+  }
+}
+
+void HttpHandlerBase::SetResponseStreamCompressor(
+    const http::HttpRequest& http_request, http::HttpResponse& response) const {
+  const auto& config = GetConfig().response_compression;
+  if (!config) return;
+  AddVaryAcceptEncoding(response);
+
+  const auto encoding = http::NegotiateContentEncoding(
+      http_request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding),
+      kResponseContentEncodings);
+  if (encoding == http::ContentEncoding::kNone) return;
+
+  response.SetStreamCompressor(std::string{http::ToString(encoding)},
+                               http::MakeStreamCompressor(encoding, *config),
+                               compression_task_processor_);
+}
+
 void HttpHandlerBase::SetResponseServerHostname(
     http::HttpResponse& response) const {
   if (set_response_server_hostname_) {
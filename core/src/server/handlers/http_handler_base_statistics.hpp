@@ -12,7 +12,8 @@
 #include <userver/server/http/http_status.hpp>
 #include <userver/utils/statistics/aggregated_values.hpp>
 #include <userver/utils/statistics/percentile.hpp>
-#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
+#include <userver/utils/statistics/sharded_recentperiod.hpp>
 #include <utils/statistics/http_codes.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -40,11 +41,11 @@ class HttpHandlerMethodStatistics final {
 
   Percentile GetTimings() const { return timings_.GetStatsForPeriod(); }
 
-  size_t GetInFlight() const noexcept { return in_flight_; }
+  size_t GetInFlight() const noexcept { return in_flight_.Load(); }
 
-  void IncrementInFlight() noexcept { in_flight_++; }
+  void IncrementInFlight() noexcept { ++in_flight_; }
 
-  void DecrementInFlight() noexcept { in_flight_--; }
+  void DecrementInFlight() noexcept { --in_flight_; }
 
   void IncrementTooManyRequestsInFlight() noexcept {
     too_many_requests_in_flight_++;
@@ -59,7 +60,7 @@ class HttpHandlerMethodStatistics final {
   size_t GetRateLimitReached() const noexcept { return rate_limit_reached_; }
 
   std::uint64_t GetDeadlineReceived() const noexcept {
-    return deadline_received_.load();
+    return deadline_received_.Load();
   }
 
   std::uint64_t GetCancelledByDeadline() const noexcept {
@@ -68,15 +69,16 @@ class HttpHandlerMethodStatistics final {
 
  private:
   using RecentPeriod =
-      utils::statistics::RecentPeriod<Percentile, Percentile,
-                                      utils::datetime::SteadyClock>;
+      utils::statistics::ShardedRecentPeriod<Percentile, Percentile,
+                                             utils::datetime::SteadyClock>;
 
+  // Counters updated on every request are sharded per thread
   RecentPeriod timings_;
-  utils::statistics::HttpCodes reply_codes_;
-  std::atomic<std::size_t> in_flight_{0};
+  utils::statistics::ShardedHttpCodes reply_codes_;
+  utils::statistics::ShardedCounter<std::size_t> in_flight_;
   std::atomic<std::uint64_t> too_many_requests_in_flight_{0};
   std::atomic<std::uint64_t> rate_limit_reached_{0};
-  std::atomic<std::uint64_t> deadline_received_{0};
+  utils::statistics::ShardedCounter<std::uint64_t> deadline_received_;
   std::atomic<std::uint64_t> cancelled_by_deadline_{0};
 };
 
@@ -118,8 +120,8 @@ class HttpRequestMethodStatistics final {
   Percentile GetTimings() const { return timings_.GetStatsForPeriod(); }
 
  private:
-  utils::statistics::RecentPeriod<Percentile, Percentile,
-                                  utils::datetime::SteadyClock>
+  utils::statistics::ShardedRecentPeriod<Percentile, Percentile,
+                                         utils::datetime::SteadyClock>
       timings_;
 };
 
@@ -1,5 +1,6 @@
 #include <userver/server/handlers/http_handler_json_base.hpp>
 
+#include <userver/components/component.hpp>
 #include <userver/formats/json/exception.hpp>
 #include <userver/formats/json/serialize.hpp>
 #include <userver/http/content_type.hpp>
@@ -10,7 +11,7 @@
 #include <userver/server/handlers/legacy_json_error_builder.hpp>
 #include <userver/server/http/http_error.hpp>
 #include <userver/server/http/http_status.hpp>
-#include <userver/yaml_config/schema.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -27,7 +28,8 @@ const std::string kSerializeJson = "serialize_json";
 HttpHandlerJsonBase::HttpHandlerJsonBase(
     const components::ComponentConfig& config,
     const components::ComponentContext& component_context, bool is_monitor)
-    : HttpHandlerBase(config, component_context, is_monitor) {}
+    : HttpHandlerBase(config, component_context, is_monitor),
+      request_json_arena_(config["request-json-arena"].As<bool>(false)) {}
 
 std::string HttpHandlerJsonBase::HandleRequestThrow(
     const http::HttpRequest& request, request::RequestContext& context) const {
@@ -72,8 +74,12 @@ void HttpHandlerJsonBase::ParseRequestData(
     const http::HttpRequest& request, request::RequestContext& context) const {
   formats::json::Value request_json;
   try {
-    if (!request.RequestBody().empty())
-      request_json = formats::json::FromString(request.RequestBody());
+    const auto& body = request.RequestBody();
+    if (!body.empty()) {
+      request_json = request_json_arena_
+                         ? formats::json::FromStringWithArena(body)
+                         : formats::json::FromString(body);
+    }
   } catch (const formats::json::Exception& e) {
     throw RequestParseError(
         InternalMessage{"Invalid JSON body"},
@@ -84,9 +90,18 @@ void HttpHandlerJsonBase::ParseRequestData(
 }
 
 yaml_config::Schema HttpHandlerJsonBase::GetStaticConfigSchema() {
-  auto schema = HttpHandlerBase::GetStaticConfigSchema();
-  schema.UpdateDescription("HTTP handler JSON base config");
-  return schema;
+  return yaml_config::MergeSchemas<HttpHandlerBase>(R"(
+type: object
+description: HTTP handler JSON base config
+additionalProperties: false
+properties:
+    request-json-arena:
+        type: boolean
+        description: |
+            parse request bodies into a single memory arena, which is faster
+            for large bodies
+        defaultDescription: false
+)");
 }
 
 }  // namespace server::handlers
@@ -1,9 +1,18 @@
 #include <userver/server/handlers/http_handler_static.hpp>
 
+#include <charconv>
+
+#include <fmt/format.h>
+
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 #include <userver/dynamic_config/storage/component.hpp>
 #include <userver/dynamic_config/value.hpp>
+#include <userver/http/common_headers.hpp>
+#include <userver/utils/str_icase.hpp>
+
+#include <server/http/content_encoding.hpp>
+#include <server/http/http_cached_date.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -16,6 +25,112 @@ formats::json::Value ParseContentTypeMap(
   return docs_map.Get("USERVER_FILES_CONTENT_TYPE_MAP");
 }
 constexpr dynamic_config::Key<ParseContentTypeMap> kContentTypeMap{};
+
+constexpr char kBrotliSuffix[] = ".br";
+constexpr char kGzipSuffix[] = ".gz";
+
+std::string MakeETag(const fs::FileInfoWithData& file) {
+  const auto mtime = std::chrono::duration_cast<std::chrono::seconds>(
+                         file.last_modified.time_since_epoch())
+                         .count();
+  return fmt::format(FMT_STRING("\"{:x}-{:x}\""), mtime, file.size);
+}
+
+std::string_view Trim(std::string_view value) {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(" \t");
+  return value.substr(begin, end - begin + 1);
+}
+
+// Weak comparison, https://datatracker.ietf.org/doc/html/rfc7232#section-3.2
+bool IsETagMatching(std::string_view if_none_match, std::string_view etag) {
+  while (!if_none_match.empty()) {
+    const auto comma_pos = if_none_match.find(',');
+    auto tag = Trim(if_none_match.substr(0, comma_pos));
+    if (tag == "*") return true;
+    if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+    if (tag == etag) return true;
+
+    if (comma_pos == std::string_view::npos) break;
+    if_none_match.remove_prefix(comma_pos + 1);
+  }
+  return false;
+}
+
+bool IsNotModified(const http::HttpRequest& request, std::string_view etag,
+                   std::chrono::system_clock::time_point last_modified) {
+  const auto& if_none_match =
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kIfNoneMatch);
+  if (!if_none_match.empty()) return IsETagMatching(if_none_match, etag);
+
+  const auto& if_modified_since =
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kIfModifiedSince);
+  if (if_modified_since.empty()) return false;
+  const auto since = http::impl::ParseHttpDate(if_modified_since);
+  return since && std::chrono::floor<std::chrono::seconds>(last_modified) <=
+                      *since;
+}
+
+enum class RangeStatus { kWhole, kPartial, kUnsatisfiable };
+
+struct ByteRange {
+  std::size_t offset{0};
+  std::size_t size{0};
+};
+
+std::optional<std::size_t> ParseSize(std::string_view value) {
+  std::size_t result = 0;
+  const auto* end = value.data() + value.size();
+  const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+  if (value.empty() || ec != std::errc{} || ptr != end) return std::nullopt;
+  return result;
+}
+
+// Only a single range is supported, the whole file is sent for the others
+// as allowed by https://datatracker.ietf.org/doc/html/rfc7233#section-3.1
+RangeStatus ParseRange(std::string_view range, std::size_t file_size,
+                       ByteRange& result) {
+  constexpr std::string_view kBytesUnit = "bytes=";
+  if (!utils::StrIcaseEqual{}(range.substr(0, kBytesUnit.size()),
+                              kBytesUnit)) {
+    return RangeStatus::kWhole;
+  }
+  range.remove_prefix(kBytesUnit.size());
+  if (range.find(',') != std::string_view::npos) return RangeStatus::kWhole;
+
+  const auto dash_pos = range.find('-');
+  if (dash_pos == std::string_view::npos) return RangeStatus::kWhole;
+  const auto first = Trim(range.substr(0, dash_pos));
+  const auto last = Trim(range.substr(dash_pos + 1));
+
+  if (first.empty()) {
+    // Suffix range, the last N bytes
+    const auto suffix_size = ParseSize(last);
+    if (!suffix_size) return RangeStatus::kWhole;
+    if (*suffix_size == 0 || file_size == 0) {
+      return RangeStatus::kUnsatisfiable;
+    }
+    result.size = std::min(*suffix_size, file_size);
+    result.offset = file_size - result.size;
+    return RangeStatus::kPartial;
+  }
+
+  const auto first_pos = ParseSize(first);
+  if (!first_pos) return RangeStatus::kWhole;
+  auto last_pos = file_size ? file_size - 1 : 0;
+  if (!last.empty()) {
+    const auto parsed_last = ParseSize(last);
+    if (!parsed_last || *parsed_last < *first_pos) return RangeStatus::kWhole;
+    last_pos = std::min(last_pos, *parsed_last);
+  }
+  if (*first_pos >= file_size) return RangeStatus::kUnsatisfiable;
+
+  result.offset = *first_pos;
+  result.size = last_pos - *first_pos + 1;
+  return RangeStatus::kPartial;
+}
+
 }  // namespace
 
 HttpHandlerStatic::HttpHandlerStatic(
@@ -41,14 +156,87 @@ std::string HttpHandlerStatic::GetContentType(
 
 std::string HttpHandlerStatic::HandleRequestThrow(
     const http::HttpRequest& request, request::RequestContext&) const {
-  LOG_DEBUG() << "Handler: " << request.GetRequestPath();
-  const auto file = storage_.TryGetFile(request.GetRequestPath());
-  if (file) {
-    request.GetHttpResponse().SetContentType(GetContentType(file->extension));
-    return file->data;
-  }
-  request.GetResponse().SetStatusNotFound();
-  return "File not found";
+  const auto& path = request.GetRequestPath();
+  LOG_DEBUG() << "Handler: " << path;
+  auto file = storage_.TryGetFile(path);
+  if (!file) {
+    request.GetResponse().SetStatusNotFound();
+    return "File not found";
+  }
+
+  auto& response = request.GetHttpResponse();
+  response.SetContentType(GetContentType(file->extension));
+
+  // Precompressed variants of the file are sent as is, e.g. "app.js.br" for
+  // "app.js". Ranges are served from the original file only.
+  const auto& range_header =
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kRange);
+  if (range_header.empty()) {
+    auto brotli_file = storage_.TryGetFile(path + kBrotliSuffix);
+    auto gzip_file = storage_.TryGetFile(path + kGzipSuffix);
+    http::ContentEncodings available;
+    if (brotli_file) available |= http::ContentEncoding::kBrotli;
+    if (gzip_file) available |= http::ContentEncoding::kGzip;
+
+    if (available) {
+      response.SetHeader(USERVER_NAMESPACE::http::headers::kVary,
+                         USERVER_NAMESPACE::http::headers::kAcceptEncoding);
+      const auto encoding = http::NegotiateContentEncoding(
+          request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding),
+          available);
+      if (encoding != http::ContentEncoding::kNone) {
+        file = std::move(encoding == http::ContentEncoding::kBrotli
+                             ? brotli_file
+                             : gzip_file);
+        response.SetContentEncoding(std::string{http::ToString(encoding)});
+      }
+    }
+  }
+
+  const auto etag = MakeETag(*file);
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kETag, etag);
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kLastModified,
+                     http::impl::MakeHttpDate(file->last_modified));
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kAcceptRanges, "bytes");
+  if (IsNotModified(request, etag, file->last_modified)) {
+    response.SetStatus(http::HttpStatus::kNotModified);
+    return {};
+  }
+
+  ByteRange range{0, file->size};
+  const auto& if_range =
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kIfRange);
+  if (!range_header.empty() && (if_range.empty() || if_range == etag)) {
+    switch (ParseRange(range_header, file->size, range)) {
+      case RangeStatus::kWhole:
+        range = {0, file->size};
+        break;
+      case RangeStatus::kPartial:
+        response.SetStatus(http::HttpStatus::kPartialContent);
+        response.SetHeader(
+            USERVER_NAMESPACE::http::headers::kContentRange,
+            fmt::format(FMT_STRING("bytes {}-{}/{}"), range.offset,
+                        range.offset + range.size - 1, file->size));
+        break;
+      case RangeStatus::kUnsatisfiable:
+        response.SetStatus(http::HttpStatus::kRangeNotSatisfiable);
+        response.SetHeader(USERVER_NAMESPACE::http::headers::kContentRange,
+                           fmt::format(FMT_STRING("bytes */{}"), file->size));
+        return {};
+    }
+  }
+
+  // The data is referenced, not copied to the response
+  if (file->has_data) {
+    response.SetBodyShared(
+        file, std::string_view{file->data}.substr(range.offset, range.size));
+  } else {
+    response.SetBodyFile(std::make_shared<const fs::blocking::FileDescriptor>(
+                             storage_.OpenFile(*file)),
+                         range.offset, range.size,
+                         storage_.GetTaskProcessor());
+  }
+  return {};
 }
 
 }  // namespace server::handlers
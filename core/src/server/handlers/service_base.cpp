@@ -107,6 +107,28 @@ properties:
         type: boolean
         description: TODO
         defaultDescription: false
+    response-compression:
+        type: object
+        description: compress the responses with gzip or brotli according to the Accept-Encoding of the requests
+        defaultDescription: <not compressed>
+        additionalProperties: false
+        properties:
+            min-size:
+                type: integer
+                description: smaller responses are sent as is, the streamed responses and the files set by SetBodyFile() are never compressed
+                defaultDescription: 1024
+            gzip-level:
+                type: integer
+                description: zlib compression level from 0 to 9
+                defaultDescription: 6
+            brotli-quality:
+                type: integer
+                description: brotli compression quality from 0 to 11
+                defaultDescription: 4
+            task-processor:
+                type: string
+                description: task processor to compress the responses on
+                defaultDescription: <task processor of the handler>
     monitor-handler:
         type: boolean
         description: overrides the in-code `is_monitor` flag that makes the handler run either on 'server.listener' or on 'server.listener-monitor'
@@ -0,0 +1,128 @@
+#include <server/http/content_encoding.hpp>
+
+#include <algorithm>
+
+#include <userver/server/handlers/handler_config.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/str_icase.hpp>
+
+#include <compression/brotli.hpp>
+#include <compression/gzip.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+namespace {
+
+constexpr int kMaxQuality = 1000;
+
+std::string_view Trim(std::string_view value) {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(" \t");
+  return value.substr(begin, end - begin + 1);
+}
+
+// Returns the quality value in thousandths, "q=0.5" -> 500.
+// Malformed values are treated as "q=1", the coding is listed after all.
+int ParseQuality(std::string_view params) {
+  while (!params.empty()) {
+    const auto semicolon_pos = params.find(';');
+    const auto param = Trim(params.substr(0, semicolon_pos));
+    if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') &&
+        param[1] == '=') {
+      const auto value = param.substr(2);
+      if (value.empty() || (value[0] != '0' && value[0] != '1')) {
+        return kMaxQuality;
+      }
+      int quality = (value[0] - '0') * kMaxQuality;
+      int scale = kMaxQuality / 10;
+      for (std::size_t i = 2; i < value.size() && scale > 0; ++i) {
+        if (value[1] != '.' || value[i] < '0' || value[i] > '9') break;
+        quality += (value[i] - '0') * scale;
+        scale /= 10;
+      }
+      return std::min(quality, kMaxQuality);
+    }
+
+    if (semicolon_pos == std::string_view::npos) break;
+    params.remove_prefix(semicolon_pos + 1);
+  }
+  return kMaxQuality;
+}
+
+}  // namespace
+
+std::string_view ToString(ContentEncoding encoding) {
+  switch (encoding) {
+    case ContentEncoding::kNone:
+      return "identity";
+    case ContentEncoding::kGzip:
+      return "gzip";
+    case ContentEncoding::kBrotli:
+      return "br";
+  }
+  UINVARIANT(false, "Unexpected content encoding");
+}
+
+ContentEncoding NegotiateContentEncoding(std::string_view accept_encoding,
+                                         ContentEncodings available) {
+  // -1 for the codings that are not listed
+  int brotli_quality = -1;
+  int gzip_quality = -1;
+  int any_quality = -1;
+
+  while (!accept_encoding.empty()) {
+    const auto comma_pos = accept_encoding.find(',');
+    const auto item = accept_encoding.substr(0, comma_pos);
+    const auto semicolon_pos = item.find(';');
+    const auto coding = Trim(item.substr(0, semicolon_pos));
+    const auto quality =
+        semicolon_pos == std::string_view::npos
+            ? kMaxQuality
+            : ParseQuality(item.substr(semicolon_pos + 1));
+
+    if (utils::StrIcaseEqual{}(coding, "br")) {
+      brotli_quality = quality;
+    } else if (utils::StrIcaseEqual{}(coding, "gzip") ||
+               utils::StrIcaseEqual{}(coding, "x-gzip")) {
+      gzip_quality = quality;
+    } else if (coding == "*") {
+      any_quality = quality;
+    }
+
+    if (comma_pos == std::string_view::npos) break;
+    accept_encoding.remove_prefix(comma_pos + 1);
+  }
+
+  if (brotli_quality < 0) brotli_quality = any_quality;
+  if (gzip_quality < 0) gzip_quality = any_quality;
+  if (!(available & ContentEncoding::kBrotli)) brotli_quality = 0;
+  if (!(available & ContentEncoding::kGzip)) gzip_quality = 0;
+
+  if (brotli_quality > 0 && brotli_quality >= gzip_quality) {
+    return ContentEncoding::kBrotli;
+  }
+  if (gzip_quality > 0) return ContentEncoding::kGzip;
+  return ContentEncoding::kNone;
+}
+
+std::unique_ptr<compression::StreamCompressor> MakeStreamCompressor(
+    ContentEncoding encoding,
+    const handlers::ResponseCompressionConfig& config) {
+  switch (encoding) {
+    case ContentEncoding::kGzip:
+      return std::make_unique<compression::gzip::Compressor>(config.gzip_level);
+    case ContentEncoding::kBrotli:
+      return std::make_unique<compression::brotli::Compressor>(
+          config.brotli_quality);
+    case ContentEncoding::kNone:
+      break;
+  }
+  UINVARIANT(false, "No compressor for the identity encoding");
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include <userver/utils/flags.hpp>
+
+#include <compression/stream_compressor.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::handlers {
+struct ResponseCompressionConfig;
+}  // namespace server::handlers
+
+namespace server::http {
+
+/// Content codings the server could compress the responses with
+enum class ContentEncoding {
+  kNone = 0,  ///< identity, not compressed
+  kGzip = 1 << 0,
+  kBrotli = 1 << 1,
+};
+
+using ContentEncodings = utils::Flags<ContentEncoding>;
+
+/// Value of the Content-Encoding header for the `encoding`
+std::string_view ToString(ContentEncoding encoding);
+
+/// Picks the `available` encoding with the highest quality value in the
+/// Accept-Encoding request header, brotli wins the ties. Returns kNone if
+/// none is acceptable.
+ContentEncoding NegotiateContentEncoding(std::string_view accept_encoding,
+                                         ContentEncodings available);
+
+/// Creates the compressor for the `encoding` with the levels from `config`
+std::unique_ptr<compression::StreamCompressor> MakeStreamCompressor(
+    ContentEncoding encoding,
+    const handlers::ResponseCompressionConfig& config);
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <server/http/content_encoding.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::http::ContentEncoding;
+using server::http::NegotiateContentEncoding;
+
+constexpr server::http::ContentEncodings kAll{ContentEncoding::kGzip,
+                                              ContentEncoding::kBrotli};
+
+}  // namespace
+
+TEST(ContentEncoding, Negotiate) {
+  EXPECT_EQ(NegotiateContentEncoding("", kAll), ContentEncoding::kNone);
+  EXPECT_EQ(NegotiateContentEncoding("identity", kAll), ContentEncoding::kNone);
+  EXPECT_EQ(NegotiateContentEncoding("gzip", kAll), ContentEncoding::kGzip);
+  EXPECT_EQ(NegotiateContentEncoding("GZIP", kAll), ContentEncoding::kGzip);
+  EXPECT_EQ(NegotiateContentEncoding("gzip, deflate, br", kAll),
+            ContentEncoding::kBrotli);
+  EXPECT_EQ(NegotiateContentEncoding("*", kAll), ContentEncoding::kBrotli);
+  EXPECT_EQ(NegotiateContentEncoding("br", ContentEncoding::kGzip),
+            ContentEncoding::kNone);
+  EXPECT_EQ(NegotiateContentEncoding("br, *", ContentEncoding::kGzip),
+            ContentEncoding::kGzip);
+}
+
+TEST(ContentEncoding, NegotiateQuality) {
+  EXPECT_EQ(NegotiateContentEncoding("br;q=0.5, gzip", kAll),
+            ContentEncoding::kGzip);
+  EXPECT_EQ(NegotiateContentEncoding("br;q=0.5, gzip;q=0.499", kAll),
+            ContentEncoding::kBrotli);
+  EXPECT_EQ(NegotiateContentEncoding("gzip ; q=0.8 , br ; Q=0.9", kAll),
+            ContentEncoding::kBrotli);
+  EXPECT_EQ(NegotiateContentEncoding("br;q=0, gzip;q=0", kAll),
+            ContentEncoding::kNone);
+  EXPECT_EQ(NegotiateContentEncoding("*;q=0.1, br;q=0", kAll),
+            ContentEncoding::kGzip);
+  EXPECT_EQ(NegotiateContentEncoding("gzip;q=1.000", kAll),
+            ContentEncoding::kGzip);
+}
+
+USERVER_NAMESPACE_END
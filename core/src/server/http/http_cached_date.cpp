@@ -20,6 +20,23 @@ std::string MakeHttpDate(std::chrono::system_clock::time_point date) {
   return cctz::format(kFormatString, date, tz);
 }
 
+std::optional<std::chrono::system_clock::time_point> ParseHttpDate(
+    std::string_view date) {
+  static const std::string kFormatString = "%a, %d %b %Y %H:%M:%S";
+  static const auto tz = cctz::utc_time_zone();
+
+  // The zone is always UTC, both "GMT" and "UTC" are seen in the wild
+  const auto zone_pos = date.rfind(' ');
+  if (zone_pos == std::string_view::npos) return std::nullopt;
+
+  std::chrono::system_clock::time_point result;
+  if (!cctz::parse(kFormatString, std::string{date.substr(0, zone_pos)}, tz,
+                   &result)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
 std::string_view GetCachedDate() {
   constexpr size_t kMaxDateHeaderLength = 128;
 
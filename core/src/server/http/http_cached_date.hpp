@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -17,6 +18,11 @@ namespace impl {
 /// in headers for benchmarking purposes only.
 std::string MakeHttpDate(std::chrono::system_clock::time_point date);
 
+/// @brief Parses the date in the format of MakeHttpDate, as is usually sent
+/// in If-Modified-Since, returns std::nullopt for malformed dates.
+std::optional<std::chrono::system_clock::time_point> ParseHttpDate(
+    std::string_view date);
+
 /// @brief Returns string_view of http-formatted current date (with timezone
 /// being UTC).
 ///
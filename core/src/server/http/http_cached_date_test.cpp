@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>
+
+#include <server/http/http_cached_date.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+TEST(HttpCachedDate, ParseHttpDate) {
+  using server::http::impl::MakeHttpDate;
+  using server::http::impl::ParseHttpDate;
+
+  const std::chrono::system_clock::time_point date{
+      std::chrono::seconds{1'600'000'000}};
+  EXPECT_EQ(ParseHttpDate(MakeHttpDate(date)), date);
+  EXPECT_EQ(ParseHttpDate("Sun, 13 Sep 2020 12:26:40 GMT"), date);
+
+  EXPECT_EQ(ParseHttpDate(""), std::nullopt);
+  EXPECT_EQ(ParseHttpDate("Sunday"), std::nullopt);
+  EXPECT_EQ(ParseHttpDate("13 Sep 2020 12:26:40 GMT"), std::nullopt);
+}
+
+USERVER_NAMESPACE_END
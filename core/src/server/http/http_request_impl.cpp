@@ -245,7 +245,7 @@ void HttpRequestImpl::AccountResponseTime() {
 
 void HttpRequestImpl::MarkAsInternalServerError() const {
   response_.SetStatus(http::HttpStatus::kInternalServerError);
-  response_.SetData({});
+  response_.ClearBody();
   response_.ClearHeaders();
 }
 
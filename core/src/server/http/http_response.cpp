@@ -1,12 +1,19 @@
 #include <userver/server/http/http_response.hpp>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <array>
 
 #include <cctz/time_zone.h>
 #include <fmt/compile.h>
 
+#include <userver/engine/async.hpp>
 #include <userver/engine/deadline.hpp>
+#include <userver/engine/io/exception.hpp>
 #include <userver/engine/io/socket.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
 #include <userver/hostinfo/blocking/get_hostname.hpp>
 #include <userver/http/common_headers.hpp>
 #include <userver/http/content_type.hpp>
@@ -16,7 +23,9 @@
 #include <userver/utils/assert.hpp>
 #include <userver/utils/datetime/wall_coarse_clock.hpp>
 
+#include <compression/stream_compressor.hpp>
 #include <server/http/http_cached_date.hpp>
+#include <server/net/http2_session.hpp>
 
 #include "http_request_impl.hpp"
 
@@ -30,6 +39,13 @@ constexpr std::string_view kKeyValueHeaderSeparator = ": ";
 const auto kDefaultContentTypeString =
     http::ContentType{"text/html; charset=utf-8"}.ToString();
 
+// Size of the chunks of file bodies for the connections without sendfile
+constexpr std::size_t kFileChunkSize = 64 * 1024;
+
+// Size of the file ranges that are loaded into the page cache before
+// sendfile(2), so that it does not wait for the disk
+constexpr std::size_t kFilePrefetchSize = 1024 * 1024;
+
 constexpr std::string_view kClose = "close";
 constexpr std::string_view kKeepAlive = "keep-alive";
 
@@ -72,6 +88,51 @@ bool IsBodyForbiddenForStatus(server::http::HttpStatus status) {
          (static_cast<int>(status) >= 100 && static_cast<int>(status) < 200);
 }
 
+void LogDroppedBody(server::http::HttpStatus status) {
+  LOG_LIMITED_WARNING()
+      << "Non-empty body provided for response with HTTP code "
+      << static_cast<int>(status)
+      << " which does not allow one, it will be dropped";
+}
+
+// Blocking, must be called on the fs task processor
+void PrefetchFileRange(int fd, std::size_t offset, std::size_t size) {
+#ifdef __linux__
+  // Errors are not fatal, sendfile reports them anyway
+  ::readahead(fd, static_cast<off64_t>(offset), size);
+#else
+  // MAC_COMPAT: no readahead(2), reading the range fills the page cache
+  std::array<char, 16 * 1024> buffer;
+  while (size != 0) {
+    const auto read_bytes =
+        ::pread(fd, buffer.data(), std::min(size, buffer.size()),
+                static_cast<off_t>(offset));
+    if (read_bytes <= 0) return;
+    offset += read_bytes;
+    size -= read_bytes;
+  }
+#endif
+}
+
+// https://datatracker.ietf.org/doc/html/rfc7540#section-8.1.2.2
+bool IsConnectionSpecificHeader(std::string_view name) {
+  static constexpr std::array<std::string_view, 5> kHeaders{
+      "Connection", "Keep-Alive", "Proxy-Connection", "Transfer-Encoding",
+      "Upgrade"};
+  return std::any_of(kHeaders.begin(), kHeaders.end(), [name](auto header) {
+    return utils::StrIcaseEqual{}(name, header);
+  });
+}
+
+// HTTP/2 requires lowercase header names
+std::string ToLowerAscii(std::string_view name) {
+  std::string result{name};
+  for (char& c : result) {
+    if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+  }
+  return result;
+}
+
 }  // namespace
 
 namespace server::http {
@@ -125,6 +186,34 @@ void HttpResponse::SetContentEncoding(std::string encoding) {
 
 void HttpResponse::SetStatus(HttpStatus status) { status_ = status; }
 
+void HttpResponse::SetBodyFile(
+    std::shared_ptr<const fs::blocking::FileDescriptor> file,
+    std::size_t offset, std::size_t size,
+    engine::TaskProcessor& fs_task_processor) {
+  UASSERT(file);
+  UASSERT(!IsBodyStreamed());
+  body_file_.emplace(
+      FileBody{std::move(file), offset, size, &fs_task_processor});
+  body_owner_.reset();
+  body_shared_ = {};
+}
+
+void HttpResponse::SetBodyShared(std::shared_ptr<const void> owner,
+                                 std::string_view data) {
+  UASSERT(owner);
+  UASSERT(!IsBodyStreamed());
+  body_owner_ = std::move(owner);
+  body_shared_ = data;
+  body_file_.reset();
+}
+
+void HttpResponse::ClearBody() {
+  SetData({});
+  body_file_.reset();
+  body_owner_.reset();
+  body_shared_ = {};
+}
+
 void HttpResponse::ClearHeaders() { headers_.clear(); }
 
 void HttpResponse::SetCookie(Cookie cookie) {
@@ -183,6 +272,8 @@ void HttpResponse::SendResponse(engine::io::Socket& socket) {
   header.append(HttpStatusString(status_));
   header.append(kCrlf);
 
+  if (IsBodyStreamed()) StartStreamCompression();
+
   headers_.erase(USERVER_NAMESPACE::http::headers::kContentLength);
   const auto end = headers_.cend();
   if (headers_.find(USERVER_NAMESPACE::http::headers::kDate) == end) {
@@ -219,23 +310,25 @@ void HttpResponse::SetBodyNotstreamed(engine::io::Socket& socket,
                                       std::string& header) {
   const bool is_body_forbidden = IsBodyForbiddenForStatus(status_);
   const bool is_head_request = request_.GetOrigMethod() == HttpMethod::kHead;
-  const auto& data = GetData();
+  const auto body_size = GetBodySize();
 
   if (!is_body_forbidden) {
     impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kContentLength,
-                       fmt::format(FMT_COMPILE("{}"), data.size()));
+                       fmt::format(FMT_COMPILE("{}"), body_size));
   }
   header.append(kCrlf);
 
-  if (is_body_forbidden && !data.empty()) {
-    LOG_LIMITED_WARNING()
-        << "Non-empty body provided for response with HTTP code "
-        << static_cast<int>(status_)
-        << " which does not allow one, it will be dropped";
-  }
+  if (is_body_forbidden && body_size != 0) LogDroppedBody(status_);
 
   ssize_t sent_bytes = 0;
-  if (!is_head_request && !is_body_forbidden) {
+  if (!is_head_request && !is_body_forbidden && body_file_) {
+    sent_bytes =
+        socket.SendAll(header.data(), header.size(), engine::Deadline{});
+    if (static_cast<std::size_t>(sent_bytes) == header.size()) {
+      sent_bytes += SendBodyFile(socket);
+    }
+  } else if (!is_head_request && !is_body_forbidden) {
+    const auto data = GetBodyView();
     sent_bytes = socket.SendAll(
         {{header.data(), header.size()}, {data.data(), data.size()}},
         engine::Deadline{});
@@ -258,6 +351,13 @@ void HttpResponse::SetBodyStreamed(engine::io::Socket& socket,
 
   std::string().swap(header);  // free memory before time consuming operation
 
+  const auto send_chunk = [&socket](const std::string& chunk) {
+    auto size = fmt::format("\r\n{:x}\r\n", chunk.size());
+    return socket.SendAll(
+        {{size.data(), size.size()}, {chunk.data(), chunk.size()}},
+        engine::Deadline{});
+  };
+
   // Transmit HTTP response body
   std::string body_part;
 
@@ -267,10 +367,16 @@ void HttpResponse::SetBodyStreamed(engine::io::Socket& socket,
       continue;
     }
 
-    auto size = fmt::format("\r\n{:x}\r\n", body_part.size());
-    sent_bytes += socket.SendAll(
-        {{size.data(), size.size()}, {body_part.data(), body_part.size()}},
-        engine::Deadline{});
+    if (stream_compressor_) {
+      body_part = CompressChunk(body_part, false);
+      if (body_part.empty()) continue;
+    }
+    sent_bytes += send_chunk(body_part);
+  }
+
+  if (stream_compressor_) {
+    const auto tail = CompressChunk({}, true);
+    if (!tail.empty()) sent_bytes += send_chunk(tail);
   }
 
   const constexpr std::string_view terminating_chunk{"\r\n0\r\n\r\n"};
@@ -285,6 +391,202 @@ void HttpResponse::SetBodyStreamed(engine::io::Socket& socket,
   SetSent(sent_bytes);
 }
 
+void HttpResponse::SendResponse(net::Http2Stream& stream) {
+  net::Http2Stream::Headers headers;
+  headers.reserve(headers_.size() + cookies_.size() + 4);
+
+  headers.emplace_back(":status", fmt::format(FMT_COMPILE("{}"),
+                                              static_cast<int>(status_)));
+
+  if (IsBodyStreamed()) StartStreamCompression();
+
+  headers_.erase(USERVER_NAMESPACE::http::headers::kContentLength);
+  const auto end = headers_.cend();
+  if (headers_.find(USERVER_NAMESPACE::http::headers::kDate) == end) {
+    std::string date;
+    AppendCachedDate(date);
+    headers.emplace_back("date", std::move(date));
+  }
+  if (headers_.find(USERVER_NAMESPACE::http::headers::kContentType) == end) {
+    headers.emplace_back("content-type", kDefaultContentTypeString);
+  }
+  for (const auto& item : headers_) {
+    if (IsConnectionSpecificHeader(item.first)) continue;
+    headers.emplace_back(ToLowerAscii(item.first), item.second);
+  }
+  for (const auto& cookie : cookies_) {
+    std::string value;
+    cookie.second.AppendToString(value);
+    headers.emplace_back("set-cookie", std::move(value));
+  }
+
+  const bool is_body_forbidden = IsBodyForbiddenForStatus(status_);
+  const bool is_head_request = request_.GetOrigMethod() == HttpMethod::kHead;
+  const auto body_size = GetBodySize();
+  if (!IsBodyStreamed() && !is_body_forbidden) {
+    headers.emplace_back("content-length",
+                         fmt::format(FMT_COMPILE("{}"), body_size));
+  }
+
+  // HPACK makes the size on the wire smaller, but this is comparable with
+  // HTTP/1.1 responses
+  std::size_t sent_bytes = 0;
+  for (const auto& [name, value] : headers) {
+    sent_bytes += name.size() + value.size();
+  }
+
+  if (IsBodyStreamed()) {
+    stream.SubmitResponse(headers, true);
+    net::Http2Stream::Headers().swap(headers);
+
+    std::string body_part;
+    while (body_stream_->Pop(body_part)) {
+      if (stream_compressor_ && !body_part.empty()) {
+        body_part = CompressChunk(body_part, false);
+      }
+      stream.SendData(body_part);
+      sent_bytes += body_part.size();
+    }
+    if (stream_compressor_) {
+      const auto tail = CompressChunk({}, true);
+      stream.SendData(tail);
+      sent_bytes += tail.size();
+    }
+    stream.Finish();
+
+    body_stream_producer_.reset();
+    body_stream_.reset();
+  } else {
+    if (is_body_forbidden && body_size != 0) LogDroppedBody(status_);
+
+    const bool has_body = !is_head_request && !is_body_forbidden;
+    stream.SubmitResponse(headers, has_body && body_size != 0);
+    if (has_body && body_file_) {
+      SendBodyFile(stream);
+      sent_bytes += body_size;
+    } else if (has_body) {
+      stream.SendData(GetBodyView());
+      sent_bytes += body_size;
+    }
+    stream.Finish();
+  }
+
+  SetSentTime(std::chrono::steady_clock::now());
+  SetSent(sent_bytes);
+}
+
+std::size_t HttpResponse::SendBodyFile(engine::io::Socket& socket) {
+  UASSERT(body_file_);
+  auto& fs_task_processor = *body_file_->fs_task_processor;
+  const int fd = body_file_->file->GetNative();
+  const auto prefetch = [&fs_task_processor, fd](std::size_t offset,
+                                                 std::size_t size) {
+    return engine::AsyncNoSpan(fs_task_processor, &PrefetchFileRange, fd,
+                               offset, size);
+  };
+
+  std::size_t offset = body_file_->offset;
+  std::size_t left = body_file_->size;
+  std::size_t sent_bytes = 0;
+  // The next range is read from the disk while the current one is sent
+  auto prefetch_task = prefetch(offset, std::min(left, kFilePrefetchSize));
+  while (left != 0) {
+    const auto chunk_size = std::min(left, kFilePrefetchSize);
+    prefetch_task.Get();
+    if (left > chunk_size) {
+      prefetch_task = prefetch(offset + chunk_size,
+                               std::min(left - chunk_size, kFilePrefetchSize));
+    }
+
+    const auto chunk_sent_bytes =
+        socket.SendFile(fd, offset, chunk_size, engine::Deadline{});
+    sent_bytes += chunk_sent_bytes;
+    if (chunk_sent_bytes != chunk_size) {
+      // Content-Length is already sent, the connection must be closed
+      throw engine::io::IoException()
+          << "File body is shorter than expected, sent " << sent_bytes
+          << " of " << body_file_->size << " bytes";
+    }
+    offset += chunk_size;
+    left -= chunk_size;
+  }
+  return sent_bytes;
+}
+
+void HttpResponse::SendBodyFile(net::Http2Stream& stream) {
+  UASSERT(body_file_);
+  // No sendfile for HTTP/2 frames, fall back to buffered reads
+  auto& fs_task_processor = *body_file_->fs_task_processor;
+  const int fd = body_file_->file->GetNative();
+  const auto buffer_size = std::min(body_file_->size, kFileChunkSize);
+  // The next chunk is read while the current one is sent, the buffers must
+  // outlive the reading task
+  std::array<std::string, 2> buffers{std::string(buffer_size, '\0'),
+                                     std::string(buffer_size, '\0')};
+  const auto read = [&fs_task_processor, fd](std::string& buffer,
+                                             std::size_t offset,
+                                             std::size_t size) {
+    return engine::AsyncNoSpan(fs_task_processor, [&buffer, fd, offset, size] {
+      return ::pread(fd, buffer.data(), size, static_cast<off_t>(offset));
+    });
+  };
+
+  std::size_t offset = body_file_->offset;
+  std::size_t left = body_file_->size;
+  std::size_t current = 0;
+  auto read_task = read(buffers[current], offset, std::min(left, buffer_size));
+  while (left != 0) {
+    const auto read_bytes = read_task.Get();
+    if (read_bytes <= 0) {
+      // Content-Length is already sent, the caller resets the stream
+      throw engine::io::IoException()
+          << "File body is shorter than expected, failed to read " << left
+          << " of " << body_file_->size << " bytes";
+    }
+    offset += read_bytes;
+    left -= read_bytes;
+    if (left != 0) {
+      read_task =
+          read(buffers[1 - current], offset, std::min(left, buffer_size));
+    }
+
+    stream.SendData(
+        {buffers[current].data(), static_cast<std::size_t>(read_bytes)});
+    current = 1 - current;
+  }
+}
+
+void HttpResponse::StartStreamCompression() {
+  if (!stream_compressor_) return;
+
+  if (HasHeader(USERVER_NAMESPACE::http::headers::kContentEncoding) ||
+      IsBodyForbiddenForStatus(status_)) {
+    stream_compressor_.reset();
+    return;
+  }
+  SetContentEncoding(stream_encoding_);
+}
+
+std::string HttpResponse::CompressChunk(std::string_view chunk, bool finish) {
+  UASSERT(stream_compressor_);
+  const auto compress = [this, chunk, finish] {
+    return finish ? stream_compressor_->Finish(chunk)
+                  : stream_compressor_->Compress(chunk);
+  };
+  if (!compression_task_processor_) return compress();
+  return engine::AsyncNoSpan(*compression_task_processor_, compress).Get();
+}
+
+std::size_t HttpResponse::GetBodySize() const {
+  if (body_file_) return body_file_->size;
+  return GetBodyView().size();
+}
+
+std::string_view HttpResponse::GetBodyView() const {
+  if (body_owner_) return body_shared_;
+  return GetData();
+}
+
 void SetThrottleReason(http::HttpResponse& http_response,
                        std::string log_reason, std::string http_header_reason) {
   http_response.SetHeader(
@@ -308,6 +610,16 @@ void HttpResponse::SetStreamBody() {
 
 bool HttpResponse::IsBodyStreamed() const { return body_stream_.has_value(); }
 
+void HttpResponse::SetStreamCompressor(
+    std::string encoding,
+    std::unique_ptr<compression::StreamCompressor> compressor,
+    engine::TaskProcessor* task_processor) {
+  UASSERT(IsBodyStreamed());
+  stream_encoding_ = std::move(encoding);
+  stream_compressor_ = std::move(compressor);
+  compression_task_processor_ = task_processor;
+}
+
 HttpResponse::Queue::Producer HttpResponse::GetBodyProducer() {
   UASSERT(IsBodyStreamed());
   UASSERT_MSG(body_stream_producer_, "GetBodyProducer() is called twice");
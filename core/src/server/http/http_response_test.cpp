@@ -3,8 +3,12 @@
 
 #include <fmt/format.h>
 
+#include <compression/gzip.hpp>
 #include <server/http/http_request_impl.hpp>
 #include <userver/engine/async.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
+#include <userver/fs/blocking/temp_file.hpp>
+#include <userver/fs/blocking/write.hpp>
 #include <userver/http/common_headers.hpp>
 #include <userver/internal/net/net_listener.hpp>
 #include <userver/server/http/http_response.hpp>
@@ -45,6 +49,176 @@ UTEST(HttpResponse, Smoke) {
             fmt::format("\r\n\r\n{}", kBody));
 }
 
+UTEST(HttpResponse, FileBody) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), "0123456789");
+  response.SetData("overridden");
+  response.SetBodyFile(std::make_shared<const fs::blocking::FileDescriptor>(
+                           fs::blocking::FileDescriptor::Open(
+                               file.GetPath(), fs::blocking::OpenFlag::kRead)),
+                       2, 5, engine::current_task::GetTaskProcessor());
+
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [](auto&& response, auto&& socket) { response.SendResponse(socket); },
+      std::ref(response), std::move(server));
+
+  std::vector<char> buffer(4096, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+
+  std::string_view reply{buffer.data(), reply_size};
+  const auto expected_content_length =
+      fmt::format("\r\n{}: 5\r\n", http::headers::kContentLength);
+  EXPECT_TRUE(reply.find(expected_content_length) != std::string_view::npos);
+  EXPECT_EQ(reply.substr(reply.size() - 9), "\r\n\r\n23456");
+}
+
+UTEST(HttpResponse, LargeFileBody) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  // Spans several prefetched ranges
+  std::string content(5 * 1024 * 1024 + 17, '\0');
+  for (std::size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<char>('a' + i % 26);
+  }
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), content);
+  response.SetBodyFile(std::make_shared<const fs::blocking::FileDescriptor>(
+                           fs::blocking::FileDescriptor::Open(
+                               file.GetPath(), fs::blocking::OpenFlag::kRead)),
+                       1, content.size() - 1,
+                       engine::current_task::GetTaskProcessor());
+
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [](auto&& response, auto&& socket) { response.SendResponse(socket); },
+      std::ref(response), std::move(server));
+
+  std::vector<char> buffer(content.size() + 4096, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+
+  const std::string_view reply{buffer.data(), reply_size};
+  ASSERT_GE(reply.size(), content.size() - 1);
+  EXPECT_EQ(reply.substr(reply.size() - content.size() + 1),
+            std::string_view{content}.substr(1));
+}
+
+UTEST(HttpResponse, SharedBody) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  auto data = std::make_shared<const std::string>("shared test data");
+  response.SetBodyShared(data, std::string_view{*data}.substr(7, 4));
+
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [](auto&& response, auto&& socket) { response.SendResponse(socket); },
+      std::ref(response), std::move(server));
+
+  std::vector<char> buffer(4096, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+
+  std::string_view reply{buffer.data(), reply_size};
+  EXPECT_EQ(reply.substr(reply.size() - 8), "\r\n\r\ntest");
+}
+
+UTEST(HttpResponse, BodyView) {
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  response.SetData("data");
+  EXPECT_EQ(response.GetBodyView(), "data");
+
+  auto data = std::make_shared<const std::string>("shared test data");
+  response.SetBodyShared(data, std::string_view{*data}.substr(7, 4));
+  EXPECT_EQ(response.GetBodyView(), "test");
+  EXPECT_FALSE(response.HasBodyFile());
+
+  // The compressed body replaces the shared one
+  response.ClearBody();
+  response.SetData("compressed");
+  EXPECT_EQ(response.GetBodyView(), "compressed");
+}
+
+UTEST(HttpResponse, StreamCompression) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  response.SetStreamBody();
+  auto producer = response.GetBodyProducer();
+  response.SetStreamCompressor(
+      "gzip", std::make_unique<compression::gzip::Compressor>(6), nullptr);
+
+  const std::string body_part(1000, 'a');
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(producer.Push(std::string{body_part}));
+  }
+  { [[maybe_unused]] auto closed_producer = std::move(producer); }
+
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [](auto&& response, auto&& socket) { response.SendResponse(socket); },
+      std::ref(response), std::move(server));
+
+  std::vector<char> buffer(4096, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+  std::string_view reply{buffer.data(), reply_size};
+
+  const auto expected_encoding =
+      fmt::format("\r\n{}: gzip\r\n", http::headers::kContentEncoding);
+  EXPECT_NE(reply.find(expected_encoding), std::string_view::npos);
+
+  // Every chunk is preceded by CRLF, see SetBodyStreamed
+  const auto headers_end = reply.find("\r\n\r\n");
+  ASSERT_NE(headers_end, std::string_view::npos);
+  reply.remove_prefix(headers_end + 2);
+  std::string compressed;
+  for (;;) {
+    ASSERT_EQ(reply.substr(0, 2), "\r\n");
+    reply.remove_prefix(2);
+    const auto size_end = reply.find("\r\n");
+    ASSERT_NE(size_end, std::string_view::npos);
+    const auto size = std::stoul(std::string{reply.substr(0, size_end)},
+                                 nullptr, 16);
+    reply.remove_prefix(size_end + 2);
+    if (size == 0) break;
+    compressed += reply.substr(0, size);
+    reply.remove_prefix(size);
+  }
+
+  EXPECT_EQ(compression::gzip::Decompress(compressed, 10000),
+            body_part + body_part + body_part);
+}
+
 class HttpResponseBody : public testing::TestWithParam<int> {};
 
 UTEST_P(HttpResponseBody, ForbiddenBody) {
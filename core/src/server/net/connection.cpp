@@ -4,10 +4,12 @@
 #include <array>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
 #include <vector>
 
 #include <server/http/http_request_parser.hpp>
 #include <server/http/request_handler_base.hpp>
+#include <server/net/http2_session.hpp>
 
 #include <userver/engine/async.hpp>
 #include <userver/engine/exception.hpp>
@@ -15,6 +17,7 @@
 #include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/task/cancel.hpp>
 #include <userver/logging/log.hpp>
+#include <userver/server/http/http_response.hpp>
 #include <userver/server/request/request_config.hpp>
 #include <userver/utils/assert.hpp>
 #include <userver/utils/scope_guard.hpp>
@@ -153,6 +156,7 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
 
     std::vector<char> buf(config_.in_buffer_size);
     std::size_t last_bytes_read = 0;
+    bool is_first_read = true;
     while (is_accepting_requests_) {
       auto deadline = engine::Deadline::FromDuration(config_.keepalive_timeout);
 
@@ -190,6 +194,14 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
       LOG_TRACE() << "Received " << last_bytes_read << " byte(s) from "
                   << peer_socket_.Getpeername() << " on fd " << Fd();
 
+      if (std::exchange(is_first_read, false) && config_.http2_enabled &&
+          Http2Session::IsConnectionPreface({buf.data(), last_bytes_read})) {
+        // The whole connection is served by the HTTP/2 session, the responses
+        // are sent by the session as well
+        ServeHttp2({buf.data(), last_bytes_read});
+        return;
+      }
+
       if (!request_parser.Parse(buf.data(), last_bytes_read)) {
         LOG_DEBUG() << "Malformed request from " << peer_socket_.Getpeername()
                     << " on fd " << Fd();
@@ -242,11 +254,52 @@ bool Connection::NewRequest(std::shared_ptr<request::RequestBase>&& request_ptr,
       {request_ptr, request_handler_.StartRequestTask(request_ptr)});
 }
 
+void Connection::ServeHttp2(std::string_view received) {
+  Http2Session session(
+      config_, handler_defaults_config_, request_handler_.GetHandlerInfoIndex(),
+      peer_socket_,
+      [this](std::shared_ptr<request::RequestBase>&& request_ptr,
+             Http2Stream& stream) {
+        return StartHttp2Request(std::move(request_ptr), stream);
+      },
+      stats_->parser_stats, data_accounter_);
+  session.Serve(received);
+}
+
+engine::TaskWithResult<void> Connection::StartHttp2Request(
+    std::shared_ptr<request::RequestBase>&& request_ptr, Http2Stream& stream) {
+  ++stats_->active_request_count;
+  auto request_task = request_handler_.StartRequestTask(request_ptr);
+
+  // Streams are independent, so each response is awaited and sent by its own
+  // task instead of the ordered response sender of HTTP/1.1
+  return engine::AsyncNoSpan(
+      task_processor_,
+      [this, &stream](QueueItem item) { ProcessHttp2Response(item, stream); },
+      QueueItem{std::move(request_ptr), std::move(request_task)});
+}
+
+void Connection::ProcessHttp2Response(QueueItem& item,
+                                      Http2Stream& stream) noexcept {
+  try {
+    if (!HandleQueueItem(item)) stream.Reset();
+
+    engine::TaskCancellationBlocker block_cancel;
+    SendResponse(*item.first, &stream);
+    item.first.reset();
+    item.second = {};
+  } catch (const std::exception& e) {
+    LOG_ERROR() << "Exception for fd " << Fd() << ": " << e;
+    // An open stream would keep the connection alive forever
+    stream.Reset();
+  }
+}
+
 void Connection::ProcessResponses(Queue::Consumer& consumer) noexcept {
   try {
     QueueItem item;
     while (consumer.Pop(item)) {
-      HandleQueueItem(item);
+      if (!HandleQueueItem(item)) is_response_chain_valid_ = false;
 
       // now we must complete processing
       engine::TaskCancellationBlocker block_cancel;
@@ -254,7 +307,7 @@ void Connection::ProcessResponses(Queue::Consumer& consumer) noexcept {
       /* In stream case we don't want a user task to exit
        * until SendResponse() as the task produces body chunks.
        */
-      SendResponse(*item.first);
+      SendResponse(*item.first, nullptr);
       item.first.reset();
       item.second = {};
     }
@@ -263,7 +316,7 @@ void Connection::ProcessResponses(Queue::Consumer& consumer) noexcept {
   }
 }
 
-void Connection::HandleQueueItem(QueueItem& item) {
+bool Connection::HandleQueueItem(QueueItem& item) {
   auto& request = *item.first;
 
   if (engine::current_task::IsCancelRequested()) {
@@ -272,8 +325,7 @@ void Connection::HandleQueueItem(QueueItem& item) {
     auto request_task = std::move(item.second);
     request_task.SyncCancel();
     LOG_DEBUG() << "Request processing interrupted";
-    is_response_chain_valid_ = false;
-    return;  // avoids throwing and catching exception down below
+    return false;  // avoids throwing and catching exception down below
   }
 
   try {
@@ -293,21 +345,30 @@ void Connection::HandleQueueItem(QueueItem& item) {
     }
   } catch (const engine::WaitInterruptedException&) {
     LOG_DEBUG() << "Request processing interrupted";
-    is_response_chain_valid_ = false;
+    return false;
   } catch (const std::exception& e) {
     LOG_WARNING() << "Request failed with unhandled exception: " << e;
     request.MarkAsInternalServerError();
   }
+  return true;
 }
 
-void Connection::SendResponse(request::RequestBase& request) {
+void Connection::SendResponse(request::RequestBase& request,
+                              Http2Stream* http2_stream) {
   auto& response = request.GetResponse();
   UASSERT(!response.IsSent());
   request.SetStartSendResponseTime();
-  if (is_response_chain_valid_ && peer_socket_) {
+  const bool can_send = http2_stream
+                            ? !http2_stream->IsClosed()
+                            : is_response_chain_valid_ && peer_socket_;
+  if (can_send) {
     try {
       // Might be a stream reading or a fully constructed response
-      response.SendResponse(peer_socket_);
+      if (http2_stream) {
+        static_cast<http::HttpResponse&>(response).SendResponse(*http2_stream);
+      } else {
+        response.SendResponse(peer_socket_);
+      }
     } catch (const engine::io::IoSystemError& ex) {
       // working with raw values because std::errc compares error_category
       // default_error_category() fixed only in GCC 9.1 (PR libstdc++/60555)
@@ -316,9 +377,17 @@ void Connection::SendResponse(request::RequestBase& request) {
               ? logging::Level::kWarning
               : logging::Level::kError;
       LOG(log_level) << "I/O error while sending data: " << ex;
+      // The peer must not wait for the rest of the stream
+      if (http2_stream) http2_stream->Reset();
     } catch (const std::exception& ex) {
       LOG_ERROR() << "Error while sending data: " << ex;
       response.SetSendFailed(std::chrono::steady_clock::now());
+      // The response might be sent partially, nothing could follow it
+      if (http2_stream) {
+        http2_stream->Reset();
+      } else {
+        is_response_chain_valid_ = false;
+      }
     }
   } else {
     response.SetSendFailed(std::chrono::steady_clock::now());
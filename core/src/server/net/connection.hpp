@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include <server/http/request_handler_base.hpp>
 #include <server/net/connection_config.hpp>
@@ -22,6 +23,8 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+class Http2Stream;
+
 class Connection final : public std::enable_shared_from_this<Connection> {
   struct EmplaceEnabler {};
 
@@ -68,9 +71,15 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   bool NewRequest(std::shared_ptr<request::RequestBase>&& request_ptr,
                   Queue::Producer&);
 
+  void ServeHttp2(std::string_view received);
+  engine::TaskWithResult<void> StartHttp2Request(
+      std::shared_ptr<request::RequestBase>&& request_ptr,
+      Http2Stream& stream);
+  void ProcessHttp2Response(QueueItem& item, Http2Stream& stream) noexcept;
+
   void ProcessResponses(Queue::Consumer&) noexcept;
-  void HandleQueueItem(QueueItem& item);
-  void SendResponse(request::RequestBase& request);
+  bool HandleQueueItem(QueueItem& item);
+  void SendResponse(request::RequestBase& request, Http2Stream* http2_stream);
 
   engine::TaskProcessor& task_processor_;
   const ConnectionConfig& config_;
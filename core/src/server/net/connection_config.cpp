@@ -18,6 +18,13 @@ ConnectionConfig Parse(const yaml_config::YamlConfig& value,
   config.keepalive_timeout =
       value["keepalive_timeout"].As<std::chrono::seconds>(
           config.keepalive_timeout);
+  config.http2_enabled = value["http2_enabled"].As<bool>(config.http2_enabled);
+  config.http2_max_concurrent_streams =
+      value["http2_max_concurrent_streams"].As<std::uint32_t>(
+          config.http2_max_concurrent_streams);
+  config.http2_initial_window_size =
+      value["http2_initial_window_size"].As<std::uint32_t>(
+          config.http2_initial_window_size);
 
   return config;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -13,6 +14,10 @@ struct ConnectionConfig {
   size_t in_buffer_size = 32 * 1024;
   size_t requests_queue_size_threshold = 100;
   std::chrono::seconds keepalive_timeout{10 * 60};
+
+  bool http2_enabled = false;
+  std::uint32_t http2_max_concurrent_streams = 100;
+  std::uint32_t http2_initial_window_size = 65535;
 };
 
 ConnectionConfig Parse(const yaml_config::YamlConfig& value,
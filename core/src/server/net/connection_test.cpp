@@ -9,6 +9,7 @@
 #include <userver/clients/http/client.hpp>
 #include <userver/engine/io/sockaddr.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
 
 #include <userver/utest/http_client.hpp>
 #include <userver/utest/utest.hpp>
@@ -23,7 +24,7 @@ constexpr auto kAcceptTimeout = utest::kMaxTestWaitTime;
 
 class TestHttprequestHandler : public server::http::RequestHandlerBase {
  public:
-  enum class Behaviors { kNoop, kHang };
+  enum class Behaviors { kNoop, kHang, kShortBodyFile };
 
   explicit TestHttprequestHandler(Behaviors behavior = Behaviors::kNoop)
       : behavior_(behavior) {}
@@ -45,6 +46,17 @@ class TestHttprequestHandler : public server::http::RequestHandlerBase {
           ASSERT_TRUE(engine::current_task::IsCancelRequested());
           ++asyncs_finished;
         });
+      case Behaviors::kShortBodyFile:
+        return engine::AsyncNoSpan([this, &http_request]() {
+          // Sending fails after the headers are sent
+          auto file = std::make_shared<fs::blocking::FileDescriptor>(
+              fs::blocking::FileDescriptor::Open(
+                  "/dev/null", fs::blocking::OpenFlag::kRead));
+          http_request.GetHttpResponse().SetBodyFile(
+              std::move(file), 0, 100,
+              engine::current_task::GetTaskProcessor());
+          ++asyncs_finished;
+        });
     }
 
     UINVARIANT(false, "Unexpected behavior");
@@ -92,6 +104,16 @@ clients::http::ResponseFuture CreateRequest(
   return ret->async_perform();
 }
 
+clients::http::ResponseFuture CreateHttp2Request(
+    clients::http::Client& http_client, engine::io::Socket& request_socket) {
+  return http_client.CreateRequest()
+      ->get(HttpConnectionUriFromSocket(request_socket))
+      ->http_version(clients::http::HttpVersion::k2PriorKnowledge)
+      ->retry(1)
+      ->timeout(std::chrono::milliseconds(100))
+      ->async_perform();
+}
+
 net::ListenerConfig CreateConfig() {
   net::ListenerConfig config;
   config.handler_defaults = server::request::HttpRequestConfig{};
@@ -339,4 +361,122 @@ UTEST(ServerNetConnection, CancelMultipleInFlight) {
   FAIL() << "Failed to simulate cancellation of multiple requests";
 }
 
+UTEST(ServerNetConnection, Http2KeepAlive) {
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.http2_enabled = true;
+  auto request_socket = net::CreateSocket(config);
+
+  auto http_client_ptr = utest::CreateHttpClient();
+  http_client_ptr->SetMaxHostConnections(1);
+
+  auto request = CreateHttp2Request(*http_client_ptr, request_socket);
+
+  auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+  ASSERT_TRUE(peer.IsValid());
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler;
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+
+  connection_ptr->Start();
+  EXPECT_EQ(request.Get()->status_code(), 404);
+  EXPECT_EQ(handler.asyncs_finished, 1);
+
+  request = CreateHttp2Request(*http_client_ptr, request_socket);
+  EXPECT_EQ(request.Get()->status_code(), 404);
+  EXPECT_EQ(handler.asyncs_finished, 2);
+  EXPECT_EQ(stats->connections_created, 1);
+}
+
+UTEST(ServerNetConnection, Http2Multiplexing) {
+  constexpr std::size_t kRequests = 16;
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.http2_enabled = true;
+  auto request_socket = net::CreateSocket(config);
+
+  auto http_client_ptr = utest::CreateHttpClient();
+  http_client_ptr->SetMaxHostConnections(1);
+
+  // Establish the connection to make the next requests multiplexed over it
+  auto request = CreateHttp2Request(*http_client_ptr, request_socket);
+  auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+  ASSERT_TRUE(peer.IsValid());
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler;
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+  connection_ptr->Start();
+  EXPECT_EQ(request.Get()->status_code(), 404);
+
+  std::vector<clients::http::ResponseFuture> requests;
+  for (std::size_t i = 0; i < kRequests; ++i) {
+    requests.push_back(CreateHttp2Request(*http_client_ptr, request_socket));
+  }
+  for (auto& future : requests) {
+    EXPECT_EQ(future.Get()->status_code(), 404);
+  }
+  EXPECT_EQ(handler.asyncs_finished, kRequests + 1);
+
+  connection_ptr->Stop();
+  std::weak_ptr<net::Connection> weak = connection_ptr;
+  connection_ptr.reset();
+
+  auto task = engine::AsyncNoSpan([weak]() {
+    while (weak.lock()) engine::Yield();
+  });
+  task.WaitFor(utest::kMaxTestWaitTime);
+  EXPECT_TRUE(task.IsFinished());
+}
+
+UTEST(ServerNetConnection, Http2SendFailureResetsStream) {
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.http2_enabled = true;
+  config.connection_config.keepalive_timeout = std::chrono::seconds{1};
+  auto request_socket = net::CreateSocket(config);
+
+  auto http_client_ptr = utest::CreateHttpClient();
+  http_client_ptr->SetMaxHostConnections(1);
+
+  // The client must not reset the stream by its own timeout
+  auto request =
+      http_client_ptr->CreateRequest()
+          ->get(HttpConnectionUriFromSocket(request_socket))
+          ->http_version(clients::http::HttpVersion::k2PriorKnowledge)
+          ->retry(1)
+          ->timeout(utest::kMaxTestWaitTime)
+          ->async_perform();
+  auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+  ASSERT_TRUE(peer.IsValid());
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler{
+      TestHttprequestHandler::Behaviors::kShortBodyFile};
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+  connection_ptr->Start();
+  auto wait_task = engine::AsyncNoSpan([&request] { request.Wait(); });
+  wait_task.WaitFor(utest::kMaxTestWaitTime / 2);
+  ASSERT_TRUE(wait_task.IsFinished()) << "the stream was not reset";
+  UEXPECT_THROW(request.Get(), std::exception);
+  EXPECT_EQ(handler.asyncs_finished, 1);
+
+  // The reset stream must not keep the idle connection alive
+  std::weak_ptr<net::Connection> weak = connection_ptr;
+  connection_ptr.reset();
+
+  auto task = engine::AsyncNoSpan([weak]() {
+    while (weak.lock()) engine::SleepFor(std::chrono::milliseconds{10});
+  });
+  task.WaitFor(utest::kMaxTestWaitTime);
+  EXPECT_TRUE(task.IsFinished());
+}
+
 USERVER_NAMESPACE_END
@@ -0,0 +1,592 @@
+#include <server/net/http2_session.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <nghttp2/nghttp2.h>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_method.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/scope_guard.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+namespace {
+
+constexpr std::string_view kConnectionPreface{NGHTTP2_CLIENT_MAGIC,
+                                              NGHTTP2_CLIENT_MAGIC_LEN};
+
+// Frames produced by nghttp2 are glued together to send them with a single
+// syscall, but a slow peer should not make us buffer the whole response
+constexpr std::size_t kMaxWriteBatchSize = 64 * 1024;
+
+std::string_view AsStringView(const std::uint8_t* data, std::size_t size) {
+  return {reinterpret_cast<const char*>(data), size};
+}
+
+}  // namespace
+
+struct Http2Session::Callbacks {
+  static Http2Session& Self(void* user_data) {
+    UASSERT(user_data);
+    return *static_cast<Http2Session*>(user_data);
+  }
+
+  static bool IsRequestHeaders(const nghttp2_frame& frame) {
+    return frame.hd.type == NGHTTP2_HEADERS &&
+           frame.headers.cat == NGHTTP2_HCAT_REQUEST;
+  }
+
+  // Exceptions must not fly through nghttp2, the failure of a callback
+  // terminates the session
+  template <typename Func>
+  static int Guarded(Func&& func) noexcept {
+    try {
+      func();
+      return 0;
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "Error in HTTP/2 session callback: " << ex;
+      return NGHTTP2_ERR_CALLBACK_FAILURE;
+    }
+  }
+
+  static int OnBeginHeaders(nghttp2_session*, const nghttp2_frame* frame,
+                            void* user_data) {
+    if (!IsRequestHeaders(*frame)) return 0;
+    return Guarded(
+        [&] { Self(user_data).OnBeginRequest(frame->hd.stream_id); });
+  }
+
+  static int OnHeader(nghttp2_session*, const nghttp2_frame* frame,
+                      const std::uint8_t* name, std::size_t namelen,
+                      const std::uint8_t* value, std::size_t valuelen,
+                      std::uint8_t /*flags*/, void* user_data) {
+    // Trailers are ignored, as with HTTP/1.1 chunked requests
+    if (!IsRequestHeaders(*frame)) return 0;
+    return Guarded([&] {
+      Self(user_data).OnHeader(frame->hd.stream_id,
+                               AsStringView(name, namelen),
+                               AsStringView(value, valuelen));
+    });
+  }
+
+  static int OnDataChunkRecv(nghttp2_session*, std::uint8_t /*flags*/,
+                             std::int32_t stream_id, const std::uint8_t* data,
+                             std::size_t len, void* user_data) {
+    return Guarded([&] {
+      Self(user_data).OnDataChunk(stream_id, AsStringView(data, len));
+    });
+  }
+
+  static int OnFrameRecv(nghttp2_session*, const nghttp2_frame* frame,
+                         void* user_data) {
+    if (frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA) {
+      return 0;
+    }
+    return Guarded([&] {
+      Self(user_data).OnRequestFrame(
+          frame->hd.stream_id, frame->hd.type == NGHTTP2_HEADERS,
+          (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) != 0);
+    });
+  }
+
+  static int OnStreamClose(nghttp2_session*, std::int32_t stream_id,
+                           std::uint32_t error_code, void* user_data) {
+    return Guarded(
+        [&] { Self(user_data).OnStreamClose(stream_id, error_code); });
+  }
+
+  static ssize_t ReadData(nghttp2_session*, std::int32_t stream_id,
+                          std::uint8_t* buf, std::size_t length,
+                          std::uint32_t* data_flags, nghttp2_data_source*,
+                          void* user_data) {
+    return Self(user_data).OnReadData(stream_id, buf, length, data_flags);
+  }
+};
+
+Http2Stream::Http2Stream(Http2Session& session, std::int32_t id,
+                         const request::HttpRequestConfig& request_config,
+                         const http::HandlerInfoIndex& handler_info_index,
+                         request::ResponseDataAccounter& data_accounter)
+    : session_(session), id_(id) {
+  request_constructor_.emplace(request_config, handler_info_index,
+                               data_accounter);
+}
+
+void Http2Stream::SubmitResponse(const Headers& headers, bool has_body) {
+  std::vector<nghttp2_nv> nva;
+  nva.reserve(headers.size());
+  for (const auto& [name, value] : headers) {
+    nghttp2_nv nv{};
+    // nghttp2 copies the headers, const_cast is safe
+    nv.name = reinterpret_cast<std::uint8_t*>(const_cast<char*>(name.data()));
+    nv.namelen = name.size();
+    nv.value =
+        reinterpret_cast<std::uint8_t*>(const_cast<char*>(value.data()));
+    nv.valuelen = value.size();
+    nv.flags = NGHTTP2_NV_FLAG_NONE;
+    nva.push_back(nv);
+  }
+
+  nghttp2_data_provider data_provider{};
+  data_provider.read_callback = &Http2Session::Callbacks::ReadData;
+
+  {
+    std::lock_guard lock(session_.mutex_);
+    ThrowIfClosed();
+    const auto rv =
+        nghttp2_submit_response(session_.session_, id_, nva.data(), nva.size(),
+                                has_body ? &data_provider : nullptr);
+    if (rv != 0) {
+      throw std::runtime_error(
+          std::string{"nghttp2_submit_response failed: "} +
+          nghttp2_strerror(rv));
+    }
+    eof_ = !has_body;
+  }
+  session_.wakeup_writer_.Send();
+}
+
+void Http2Stream::SendData(std::string_view data) {
+  if (data.empty()) return;
+
+  std::unique_lock lock(session_.mutex_);
+  ThrowIfClosed();
+  UASSERT(pending_data_.empty());
+  UASSERT(!eof_);
+  pending_data_ = data;
+  ResumeData();
+  lock.unlock();
+  session_.wakeup_writer_.Send();
+
+  lock.lock();
+  [[maybe_unused]] const bool is_consumed =
+      session_.data_consumed_cv_.Wait(lock, [this] {
+        return pending_data_.empty() || closed_ || session_.stopped_;
+      });
+  if (!pending_data_.empty()) {
+    // Must not be referenced after return
+    pending_data_ = {};
+    ThrowIfClosed();
+    throw engine::io::IoCancelled();
+  }
+}
+
+void Http2Stream::Finish() {
+  std::unique_lock lock(session_.mutex_);
+  if (!eof_) {
+    ThrowIfClosed();
+    eof_ = true;
+    ResumeData();
+    lock.unlock();
+    session_.wakeup_writer_.Send();
+    lock.lock();
+  }
+
+  [[maybe_unused]] const bool is_closed = session_.data_consumed_cv_.Wait(
+      lock, [this] { return closed_ || session_.stopped_; });
+  if (!closed_ || close_error_code_ != NGHTTP2_NO_ERROR) {
+    throw engine::io::IoSystemError(EPIPE, "Http2Stream::Finish");
+  }
+}
+
+void Http2Stream::Reset() {
+  {
+    std::lock_guard lock(session_.mutex_);
+    if (closed_ || session_.stopped_) return;
+    nghttp2_submit_rst_stream(session_.session_, NGHTTP2_FLAG_NONE, id_,
+                              NGHTTP2_CANCEL);
+    closed_ = true;
+    close_error_code_ = NGHTTP2_CANCEL;
+    pending_data_ = {};
+  }
+  session_.wakeup_writer_.Send();
+}
+
+bool Http2Stream::IsClosed() const {
+  std::lock_guard lock(session_.mutex_);
+  return closed_ || session_.stopped_;
+}
+
+void Http2Stream::AppendHeader(std::string_view name, std::string_view value) {
+  if (request_broken_) return;
+  try {
+    // nghttp2 validates the presence and the order of pseudo-headers
+    if (!name.empty() && name[0] == ':') {
+      if (name == ":method") {
+        request_constructor_->SetMethod(http::HttpMethodFromString(value));
+      } else if (name == ":path") {
+        request_constructor_->AppendUrl(value.data(), value.size());
+      } else if (name == ":authority") {
+        authority_ = value;
+      }
+      return;
+    }
+
+    // Per-handler limits are applied to the headers, so the URL must be
+    // matched first
+    ParseUrl();
+    if (name == "host") authority_.clear();
+    request_constructor_->AppendHeaderField(name.data(), name.size());
+    request_constructor_->AppendHeaderValue(value.data(), value.size());
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't append header of HTTP/2 stream " << id_ << ": "
+                  << ex;
+    request_broken_ = true;
+  }
+}
+
+void Http2Stream::OnHeadersEnd() {
+  if (request_broken_ || headers_complete_) return;
+  headers_complete_ = true;
+  try {
+    ParseUrl();
+    if (!authority_.empty()) {
+      static constexpr std::string_view kHost = "host";
+      request_constructor_->AppendHeaderField(kHost.data(), kHost.size());
+      request_constructor_->AppendHeaderValue(authority_.data(),
+                                              authority_.size());
+    }
+    request_constructor_->AppendHeaderField("", 0);
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't complete headers of HTTP/2 stream " << id_ << ": "
+                  << ex;
+    request_broken_ = true;
+  }
+}
+
+void Http2Stream::AppendBody(std::string_view data) {
+  if (request_broken_) return;
+  try {
+    request_constructor_->AppendBody(data.data(), data.size());
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't append body of HTTP/2 stream " << id_ << ": "
+                  << ex;
+    request_broken_ = true;
+  }
+}
+
+std::shared_ptr<request::RequestBase> Http2Stream::FinalizeRequest() {
+  UASSERT(request_constructor_);
+  auto request = request_constructor_->Finalize();
+  request_constructor_.reset();
+  return request;
+}
+
+void Http2Stream::ParseUrl() {
+  if (url_parsed_) return;
+  url_parsed_ = true;
+  request_constructor_->SetHttpMajor(2);
+  request_constructor_->SetHttpMinor(0);
+  request_constructor_->ParseUrl();
+}
+
+void Http2Stream::ResumeData() {
+  if (!data_deferred_) return;
+  data_deferred_ = false;
+  nghttp2_session_resume_data(session_.session_, id_);
+}
+
+std::ptrdiff_t Http2Stream::ReadData(std::uint8_t* buf, std::size_t length,
+                                     std::uint32_t* data_flags) {
+  if (pending_data_.empty() && !eof_) {
+    data_deferred_ = true;
+    return NGHTTP2_ERR_DEFERRED;
+  }
+
+  const auto size = std::min(length, pending_data_.size());
+  std::memcpy(buf, pending_data_.data(), size);
+  pending_data_.remove_prefix(size);
+  if (pending_data_.empty() && eof_) *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+  return size;
+}
+
+void Http2Stream::ThrowIfClosed() const {
+  if (closed_ || session_.stopped_) {
+    throw engine::io::IoSystemError(EPIPE, "Http2Stream");
+  }
+}
+
+Http2Session::Http2Session(const ConnectionConfig& config,
+                           const request::HttpRequestConfig& request_config,
+                           const http::HandlerInfoIndex& handler_info_index,
+                           engine::io::Socket& socket,
+                           OnNewRequestCb&& on_new_request_cb,
+                           ParserStats& stats,
+                           request::ResponseDataAccounter& data_accounter)
+    : config_(config),
+      request_config_(request_config),
+      handler_info_index_(handler_info_index),
+      socket_(socket),
+      on_new_request_cb_(std::move(on_new_request_cb)),
+      stats_(stats),
+      data_accounter_(data_accounter) {
+  nghttp2_session_callbacks* callbacks = nullptr;
+  if (nghttp2_session_callbacks_new(&callbacks) != 0) throw std::bad_alloc();
+  utils::ScopeGuard callbacks_guard(
+      [callbacks] { nghttp2_session_callbacks_del(callbacks); });
+
+  nghttp2_session_callbacks_set_on_begin_headers_callback(
+      callbacks, &Callbacks::OnBeginHeaders);
+  nghttp2_session_callbacks_set_on_header_callback(callbacks,
+                                                   &Callbacks::OnHeader);
+  nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+      callbacks, &Callbacks::OnDataChunkRecv);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(
+      callbacks, &Callbacks::OnFrameRecv);
+  nghttp2_session_callbacks_set_on_stream_close_callback(
+      callbacks, &Callbacks::OnStreamClose);
+
+  if (nghttp2_session_server_new(&session_, callbacks, this) != 0) {
+    throw std::bad_alloc();
+  }
+
+  const std::array<nghttp2_settings_entry, 2> settings{{
+      {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+       config_.http2_max_concurrent_streams},
+      {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, config_.http2_initial_window_size},
+  }};
+  const auto rv = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE,
+                                          settings.data(), settings.size());
+  if (rv != 0) {
+    LOG_ERROR() << "Failed to submit HTTP/2 settings: " << nghttp2_strerror(rv);
+  }
+}
+
+Http2Session::~Http2Session() {
+  Stop();
+  {
+    std::lock_guard lock(mutex_);
+    for (auto& [id, stream] : streams_) {
+      if (stream->responder_.IsValid()) stream->responder_.RequestCancel();
+    }
+  }
+  if (writer_.IsValid()) writer_.SyncCancel();
+
+  // Nobody modifies the streams now, responders only lock the mutex
+  for (auto& [id, stream] : streams_) {
+    if (stream->responder_.IsValid()) stream->responder_.SyncCancel();
+    if (stream->request_constructor_) --stats_.parsing_request_count;
+  }
+  streams_.clear();
+
+  nghttp2_session_del(session_);
+}
+
+bool Http2Session::IsConnectionPreface(std::string_view data) noexcept {
+  // "PRI" is not a valid HTTP/1.x method, 3 bytes are enough to tell
+  static constexpr std::size_t kMinSize = 3;
+  if (data.size() < kMinSize) return false;
+  const auto size = std::min(data.size(), kConnectionPreface.size());
+  return data.substr(0, size) == kConnectionPreface.substr(0, size);
+}
+
+void Http2Session::Serve(std::string_view received) {
+  LOG_TRACE() << "Starting HTTP/2 session on fd " << socket_.Fd();
+
+  writer_ = engine::AsyncNoSpan([this] { WriteLoop(); });
+  if (!Feed(received)) return;
+
+  std::vector<char> buf(config_.in_buffer_size);
+  while (true) {
+    const auto deadline =
+        engine::Deadline::FromDuration(config_.keepalive_timeout);
+
+    std::size_t bytes_read = 0;
+    try {
+      bytes_read = socket_.RecvSome(buf.data(), buf.size(), deadline);
+    } catch (const engine::io::IoTimeout&) {
+      // Connection is not idle while the responses are being sent
+      if (HasStreams()) continue;
+      throw;
+    }
+
+    if (!bytes_read) {
+      LOG_TRACE() << "Peer " << socket_.Getpeername() << " on fd "
+                  << socket_.Fd() << " closed HTTP/2 connection";
+      return;
+    }
+    if (!Feed({buf.data(), bytes_read})) return;
+  }
+}
+
+void Http2Session::OnBeginRequest(std::int32_t stream_id) {
+  streams_.emplace(stream_id, std::make_unique<Http2Stream>(
+                                  *this, stream_id, request_config_,
+                                  handler_info_index_, data_accounter_));
+  ++stats_.parsing_request_count;
+}
+
+void Http2Session::OnHeader(std::int32_t stream_id, std::string_view name,
+                            std::string_view value) {
+  auto* stream = FindStream(stream_id);
+  if (!stream || !stream->request_constructor_) return;
+  stream->AppendHeader(name, value);
+}
+
+void Http2Session::OnDataChunk(std::int32_t stream_id, std::string_view data) {
+  auto* stream = FindStream(stream_id);
+  if (!stream || !stream->request_constructor_) return;
+  stream->AppendBody(data);
+}
+
+void Http2Session::OnRequestFrame(std::int32_t stream_id, bool is_headers,
+                                  bool is_end_stream) {
+  auto* stream = FindStream(stream_id);
+  if (!stream || !stream->request_constructor_) return;
+
+  if (is_headers) stream->OnHeadersEnd();
+  if (!is_end_stream) return;
+
+  auto request = stream->FinalizeRequest();
+  --stats_.parsing_request_count;
+  if (!request) {
+    LOG_ERROR() << "request is null after Finalize()";
+    nghttp2_submit_rst_stream(session_, NGHTTP2_FLAG_NONE, stream_id,
+                              NGHTTP2_INTERNAL_ERROR);
+    return;
+  }
+  stream->responder_ = on_new_request_cb_(std::move(request), *stream);
+}
+
+void Http2Session::OnStreamClose(std::int32_t stream_id,
+                                 std::uint32_t error_code) {
+  auto* stream = FindStream(stream_id);
+  if (!stream) return;
+
+  LOG_TRACE() << "HTTP/2 stream " << stream_id << " on fd " << socket_.Fd()
+              << " closed with error code " << error_code;
+  stream->closed_ = true;
+  stream->close_error_code_ = error_code;
+  stream->pending_data_ = {};
+  if (stream->request_constructor_) {
+    stream->request_constructor_.reset();
+    --stats_.parsing_request_count;
+  }
+  if (error_code != NGHTTP2_NO_ERROR && stream->responder_.IsValid() &&
+      !stream->responder_.IsFinished()) {
+    stream->responder_.RequestCancel();
+  }
+  data_consumed_cv_.NotifyAll();
+}
+
+std::ptrdiff_t Http2Session::OnReadData(std::int32_t stream_id,
+                                        std::uint8_t* buf, std::size_t length,
+                                        std::uint32_t* data_flags) {
+  auto* stream = FindStream(stream_id);
+  if (!stream) return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+  return stream->ReadData(buf, length, data_flags);
+}
+
+bool Http2Session::Feed(std::string_view data) {
+  bool is_alive = true;
+  {
+    std::lock_guard lock(mutex_);
+    const auto rv = nghttp2_session_mem_recv(
+        session_, reinterpret_cast<const std::uint8_t*>(data.data()),
+        data.size());
+    if (rv < 0) {
+      LOG_WARNING() << "HTTP/2 error on fd " << socket_.Fd() << ": "
+                    << nghttp2_strerror(static_cast<int>(rv));
+      return false;
+    }
+    ReapStreams();
+    is_alive = nghttp2_session_want_read(session_) ||
+               nghttp2_session_want_write(session_);
+  }
+  wakeup_writer_.Send();
+  return is_alive;
+}
+
+void Http2Session::WriteLoop() noexcept {
+  std::string out;
+  try {
+    while (wakeup_writer_.WaitForEvent()) {
+      out.clear();
+      bool is_alive = true;
+      {
+        std::lock_guard lock(mutex_);
+        is_alive = CollectOutput(out);
+        ReapStreams();
+      }
+      data_consumed_cv_.NotifyAll();
+
+      if (!out.empty()) {
+        [[maybe_unused]] const auto sent =
+            socket_.SendAll(out.data(), out.size(), {});
+      }
+      if (!is_alive) break;
+    }
+  } catch (const engine::io::IoCancelled&) {
+    LOG_TRACE() << "HTTP/2 writer on fd " << socket_.Fd() << " cancelled";
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "I/O error while sending HTTP/2 frames on fd "
+                  << socket_.Fd() << ": " << ex;
+  }
+  Stop();
+}
+
+bool Http2Session::CollectOutput(std::string& out) {
+  while (true) {
+    const std::uint8_t* data = nullptr;
+    const auto size = nghttp2_session_mem_send(session_, &data);
+    if (size < 0) {
+      LOG_WARNING() << "HTTP/2 error on fd " << socket_.Fd() << ": "
+                    << nghttp2_strerror(static_cast<int>(size));
+      return false;
+    }
+    if (size == 0) break;
+
+    out.append(reinterpret_cast<const char*>(data), size);
+    if (out.size() >= kMaxWriteBatchSize) {
+      // Send this batch and come back for the rest
+      wakeup_writer_.Send();
+      break;
+    }
+  }
+  return nghttp2_session_want_read(session_) ||
+         nghttp2_session_want_write(session_);
+}
+
+void Http2Session::ReapStreams() {
+  for (auto it = streams_.begin(); it != streams_.end();) {
+    const auto& stream = *it->second;
+    if (stream.closed_ &&
+        (!stream.responder_.IsValid() || stream.responder_.IsFinished())) {
+      it = streams_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool Http2Session::HasStreams() {
+  std::lock_guard lock(mutex_);
+  ReapStreams();
+  return !streams_.empty();
+}
+
+void Http2Session::Stop() noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    stopped_ = true;
+  }
+  data_consumed_cv_.NotifyAll();
+}
+
+Http2Stream* Http2Session::FindStream(std::int32_t stream_id) {
+  const auto it = streams_.find(stream_id);
+  return it == streams_.end() ? nullptr : it->second.get();
+}
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <server/http/handler_info_index.hpp>
+#include <server/http/http_request_constructor.hpp>
+#include <server/net/connection_config.hpp>
+#include <server/net/stats.hpp>
+
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/io/socket.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/server/request/request_base.hpp>
+#include <userver/server/request/request_config.hpp>
+
+struct nghttp2_session;
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+class Http2Session;
+
+/// Response side of an HTTP/2 stream, used by http::HttpResponse.
+///
+/// All the methods block the calling task until the session takes the data,
+/// so the response is sent at the pace allowed by the flow control of the
+/// peer. The methods throw engine::io::IoSystemError if the stream was reset
+/// or the connection is closing.
+class Http2Stream final {
+ public:
+  /// Header names must be lowercase, connection-specific headers are not
+  /// allowed in HTTP/2
+  using Headers = std::vector<std::pair<std::string, std::string>>;
+
+  Http2Stream(Http2Session& session, std::int32_t id,
+              const request::HttpRequestConfig& request_config,
+              const http::HandlerInfoIndex& handler_info_index,
+              request::ResponseDataAccounter& data_accounter);
+
+  Http2Stream(const Http2Stream&) = delete;
+  Http2Stream& operator=(const Http2Stream&) = delete;
+
+  void SubmitResponse(const Headers& headers, bool has_body);
+
+  /// Returns after the whole chunk is consumed by the session, `data` is not
+  /// copied
+  void SendData(std::string_view data);
+
+  /// Ends the response body and waits for the stream to close
+  void Finish();
+
+  /// Resets the stream if the response can not be sent
+  void Reset();
+
+  bool IsClosed() const;
+
+ private:
+  friend class Http2Session;
+
+  void AppendHeader(std::string_view name, std::string_view value);
+  void OnHeadersEnd();
+  void AppendBody(std::string_view data);
+  std::shared_ptr<request::RequestBase> FinalizeRequest();
+
+  void ParseUrl();
+  void ResumeData();
+  std::ptrdiff_t ReadData(std::uint8_t* buf, std::size_t length,
+                          std::uint32_t* data_flags);
+  void ThrowIfClosed() const;
+
+  Http2Session& session_;
+  const std::int32_t id_;
+
+  // Request side
+  std::optional<http::HttpRequestConstructor> request_constructor_;
+  std::string authority_;
+  bool url_parsed_{false};
+  bool headers_complete_{false};
+  bool request_broken_{false};
+  engine::TaskWithResult<void> responder_;
+
+  // Response side, guarded by the mutex of the session
+  std::string_view pending_data_;
+  bool eof_{false};
+  bool data_deferred_{false};
+  bool closed_{false};
+  std::uint32_t close_error_code_{0};
+};
+
+/// Server side of an HTTP/2 connection over nghttp2, started by
+/// net::Connection once the client connection preface is received.
+///
+/// The session is fed by the receiving task, a separate writer task flushes
+/// the frames produced by nghttp2 to the socket, and every request gets its
+/// own responder task, so the streams are processed independently.
+class Http2Session final {
+ public:
+  using OnNewRequestCb = std::function<engine::TaskWithResult<void>(
+      std::shared_ptr<request::RequestBase>&&, Http2Stream&)>;
+
+  Http2Session(const ConnectionConfig& config,
+               const request::HttpRequestConfig& request_config,
+               const http::HandlerInfoIndex& handler_info_index,
+               engine::io::Socket& socket, OnNewRequestCb&& on_new_request_cb,
+               ParserStats& stats,
+               request::ResponseDataAccounter& data_accounter);
+
+  Http2Session(const Http2Session&) = delete;
+  Http2Session& operator=(const Http2Session&) = delete;
+
+  /// Cancels the requests in flight and waits for their responders
+  ~Http2Session();
+
+  /// Checks whether the received data starts with the HTTP/2 client
+  /// connection preface ("prior knowledge" h2c)
+  static bool IsConnectionPreface(std::string_view data) noexcept;
+
+  /// Serves the connection until the peer closes it or an HTTP/2 protocol
+  /// error occurs. `received` is the beginning of the connection, including
+  /// the preface. Throws I/O exceptions of the socket.
+  void Serve(std::string_view received);
+
+ private:
+  friend class Http2Stream;
+
+  // nghttp2 callbacks, see Callbacks in the .cpp file
+  void OnBeginRequest(std::int32_t stream_id);
+  void OnHeader(std::int32_t stream_id, std::string_view name,
+                std::string_view value);
+  void OnDataChunk(std::int32_t stream_id, std::string_view data);
+  void OnRequestFrame(std::int32_t stream_id, bool is_headers,
+                      bool is_end_stream);
+  void OnStreamClose(std::int32_t stream_id, std::uint32_t error_code);
+  std::ptrdiff_t OnReadData(std::int32_t stream_id, std::uint8_t* buf,
+                            std::size_t length, std::uint32_t* data_flags);
+
+  bool Feed(std::string_view data);
+  void WriteLoop() noexcept;
+  bool CollectOutput(std::string& out);
+  void ReapStreams();
+  bool HasStreams();
+  void Stop() noexcept;
+
+  Http2Stream* FindStream(std::int32_t stream_id);
+
+  const ConnectionConfig& config_;
+  const request::HttpRequestConfig& request_config_;
+  const http::HandlerInfoIndex& handler_info_index_;
+  engine::io::Socket& socket_;
+  OnNewRequestCb on_new_request_cb_;
+  ParserStats& stats_;
+  request::ResponseDataAccounter& data_accounter_;
+
+  // nghttp2 session is not thread-safe, the streams are guarded as well
+  engine::Mutex mutex_;
+  engine::ConditionVariable data_consumed_cv_;
+  nghttp2_session* session_{nullptr};
+  std::unordered_map<std::int32_t, std::unique_ptr<Http2Stream>> streams_;
+  bool stopped_{false};
+
+  engine::SingleConsumerEvent wakeup_writer_;
+  engine::TaskWithResult<void> writer_;
+
+  struct Callbacks;
+};
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,247 @@
+#include <utils/cpu_affinity.hpp>
+
+#include <sched.h>
+
+#ifndef __APPLE__
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <fmt/format.h>
+
+#include <userver/fs/blocking/read.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/from_string.hpp>
+#include <userver/yaml_config/yaml_config.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils {
+
+namespace {
+
+constexpr std::string_view kNumaNodesPath = "/sys/devices/system/node";
+constexpr std::string_view kOnlineCpusPath = "/sys/devices/system/cpu/online";
+
+#ifdef __APPLE__
+constexpr std::size_t kMaxCpus = 1024;
+#else
+constexpr std::size_t kMaxCpus = CPU_SETSIZE;
+#endif
+
+// Parses the Linux list format, the numbers must be less than `limit`
+std::vector<std::size_t> ParseList(std::string_view list, std::size_t limit) {
+  std::vector<std::size_t> result;
+
+  std::vector<std::string> ranges;
+  boost::algorithm::split(ranges, list, [](char c) { return c == ','; });
+  for (auto& range : ranges) {
+    boost::algorithm::trim(range);
+    if (range.empty()) continue;
+
+    const auto dash_pos = range.find('-');
+    const auto first =
+        utils::FromString<std::size_t>(range.substr(0, dash_pos));
+    const auto last =
+        dash_pos == std::string::npos
+            ? first
+            : utils::FromString<std::size_t>(range.substr(dash_pos + 1));
+    if (first > last) {
+      throw std::runtime_error(
+          fmt::format("Invalid range '{}' in '{}'", range, list));
+    }
+    // Checked before the range is expanded
+    if (last >= limit) {
+      throw std::runtime_error(fmt::format(
+          "Range '{}' in '{}' exceeds the limit of {}", range, list, limit));
+    }
+    for (auto i = first; i <= last; ++i) result.push_back(i);
+  }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+CpuSet Intersect(const CpuSet& lhs, const CpuSet& rhs) {
+  CpuSet result;
+  std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                        std::back_inserter(result));
+  return result;
+}
+
+// Empty if the online CPUs are unknown
+const CpuSet& GetOnlineCpus() {
+  static const auto kOnlineCpus = [] {
+    if (!fs::blocking::FileExists(std::string{kOnlineCpusPath})) {
+      return CpuSet{};
+    }
+    return ParseList(
+        fs::blocking::ReadFileContents(std::string{kOnlineCpusPath}),
+        kMaxCpus);
+  }();
+  return kOnlineCpus;
+}
+
+CpuSet ReadNumaNodeCpus(std::size_t node) {
+  const auto path = fmt::format("{}/node{}/cpulist", kNumaNodesPath, node);
+  if (!fs::blocking::FileExists(path)) {
+    throw std::runtime_error(
+        fmt::format("NUMA node {} does not exist ({} is missing)", node, path));
+  }
+  auto cpus = ParseList(fs::blocking::ReadFileContents(path), kMaxCpus);
+  // Offline CPUs of the node are skipped rather than rejected
+  const auto& online = GetOnlineCpus();
+  if (!online.empty()) cpus = Intersect(cpus, online);
+  return cpus;
+}
+
+std::vector<std::size_t> ReadNumaNodes() {
+  const auto path = fmt::format("{}/possible", kNumaNodesPath);
+  if (!fs::blocking::FileExists(path)) return {};
+  return ParseList(fs::blocking::ReadFileContents(path),
+                   std::numeric_limits<std::size_t>::max());
+}
+
+// Index is a CPU number, value is a NUMA node or -1 if unknown
+std::vector<int> BuildCpuToNumaNodeMap() {
+  std::vector<int> result;
+  for (const auto node : ReadNumaNodes()) {
+    const auto node_path =
+        fmt::format("{}/node{}/cpulist", kNumaNodesPath, node);
+    if (!fs::blocking::FileExists(node_path)) continue;
+
+    for (const auto cpu : ReadNumaNodeCpus(node)) {
+      if (cpu >= result.size()) result.resize(cpu + 1, -1);
+      result[cpu] = static_cast<int>(node);
+    }
+  }
+  return result;
+}
+
+const std::vector<int>& GetCpuToNumaNodeMap() noexcept {
+  static const auto kMap = []() noexcept {
+    try {
+      return BuildCpuToNumaNodeMap();
+    } catch (const std::exception& e) {
+      LOG_WARNING() << "Failed to read NUMA topology: " << e;
+      return std::vector<int>{};
+    }
+  }();
+  return kMap;
+}
+
+}  // namespace
+
+CpuAffinityConfig Parse(const yaml_config::YamlConfig& value,
+                        formats::parse::To<CpuAffinityConfig>) {
+  CpuAffinityConfig config;
+  config.cpus = ParseCpuList(value["cpus"].As<std::string>(""));
+  config.numa_nodes =
+      value["numa-nodes"].As<std::vector<std::size_t>>(config.numa_nodes);
+  return config;
+}
+
+CpuSet ParseCpuList(std::string_view cpu_list) {
+  return ParseList(cpu_list, kMaxCpus);
+}
+
+void ValidateCpuSet(const CpuSet& cpus) {
+  const auto& online = GetOnlineCpus();
+  for (const auto cpu : cpus) {
+    if (cpu >= kMaxCpus) {
+      throw std::runtime_error(
+          fmt::format("CPU {} exceeds CPU_SETSIZE={}", cpu, kMaxCpus));
+    }
+    if (!online.empty() &&
+        !std::binary_search(online.begin(), online.end(), cpu)) {
+      throw std::runtime_error(fmt::format("CPU {} is not online", cpu));
+    }
+  }
+}
+
+std::vector<CpuSet> ResolveCpuSets(const CpuAffinityConfig& config) {
+  if (config.numa_nodes.empty()) {
+    if (config.cpus.empty()) return {};
+    ValidateCpuSet(config.cpus);
+    return {config.cpus};
+  }
+
+  std::vector<CpuSet> result;
+  result.reserve(config.numa_nodes.size());
+  for (const auto node : config.numa_nodes) {
+    auto cpus = ReadNumaNodeCpus(node);
+    if (!config.cpus.empty()) cpus = Intersect(cpus, config.cpus);
+    if (cpus.empty()) {
+      throw std::runtime_error(fmt::format(
+          "No CPUs left for NUMA node {} after applying the 'cpus' filter",
+          node));
+    }
+    ValidateCpuSet(cpus);
+    result.push_back(std::move(cpus));
+  }
+  return result;
+}
+
+std::optional<std::size_t> GetNumaNodeOfCpus(const CpuSet& cpus) {
+  const auto& map = GetCpuToNumaNodeMap();
+  std::optional<std::size_t> result;
+  for (const auto cpu : cpus) {
+    if (cpu >= map.size() || map[cpu] < 0) return std::nullopt;
+    const auto node = static_cast<std::size_t>(map[cpu]);
+    if (result && *result != node) return std::nullopt;
+    result = node;
+  }
+  return result;
+}
+
+std::optional<std::size_t> GetCurrentNumaNode() noexcept {
+  const auto& map = GetCpuToNumaNodeMap();
+#ifdef __APPLE__
+  (void)map;
+  return std::nullopt;
+#else
+  // sched_getcpu() is served by vDSO and does not enter the kernel
+  const auto cpu = ::sched_getcpu();
+  if (cpu < 0 || static_cast<std::size_t>(cpu) >= map.size() || map[cpu] < 0) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(map[cpu]);
+#endif
+}
+
+void SetCurrentThreadAffinity(const CpuSet& cpus) {
+  if (cpus.empty()) return;
+
+#ifdef __APPLE__
+  LOG_WARNING() << "CPU affinity is not supported on this platform, ignoring";
+#else
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      throw std::runtime_error(
+          fmt::format("CPU {} exceeds CPU_SETSIZE={}", cpu, CPU_SETSIZE));
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+
+  const auto err =
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (err) {
+    throw std::system_error(err, std::system_category(),
+                            "Error while setting thread CPU affinity");
+  }
+#endif
+}
+
+}  // namespace utils
+
+USERVER_NAMESPACE_END
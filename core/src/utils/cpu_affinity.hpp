@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <userver/formats/parse/to.hpp>
+#include <userver/yaml_config/fwd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils {
+
+using CpuSet = std::vector<std::size_t>;
+
+/// CPU and NUMA placement of a group of threads
+struct CpuAffinityConfig {
+  /// CPUs the threads are allowed to run on, empty means no restriction
+  CpuSet cpus;
+
+  /// NUMA nodes to spread the threads over. Thread `i` is pinned to the CPUs
+  /// of the node `numa_nodes[i % numa_nodes.size()]` (intersected with `cpus`
+  /// if they are set).
+  std::vector<std::size_t> numa_nodes;
+
+  bool IsEmpty() const noexcept { return cpus.empty() && numa_nodes.empty(); }
+};
+
+CpuAffinityConfig Parse(const yaml_config::YamlConfig& value,
+                        formats::parse::To<CpuAffinityConfig>);
+
+/// Parses the Linux CPU list format, e.g. "0-3,8,10-11". The CPUs are not
+/// checked to be online, ResolveCpuSets() does that.
+/// @throws std::runtime_error if a CPU is not below CPU_SETSIZE
+CpuSet ParseCpuList(std::string_view cpu_list);
+
+/// @throws std::runtime_error if a CPU can't be used for the thread affinity
+///
+/// @warning Reads sysfs on the first call, must not be called from
+/// coroutines.
+void ValidateCpuSet(const CpuSet& cpus);
+
+/// Resolves the config into the per-thread CPU sets, thread `i` should use
+/// the set `i % result.size()`. Returns an empty vector for an empty config.
+/// The sets are validated, so that the threads could be pinned without
+/// errors.
+///
+/// @warning Reads sysfs, must not be called from coroutines.
+std::vector<CpuSet> ResolveCpuSets(const CpuAffinityConfig& config);
+
+/// Returns the NUMA node of each set from the ResolveCpuSets() result, or
+/// std::nullopt if the set spans several nodes.
+///
+/// @warning Reads sysfs, must not be called from coroutines.
+std::optional<std::size_t> GetNumaNodeOfCpus(const CpuSet& cpus);
+
+/// @warning Reads sysfs on the first call, the first call must not be made
+/// from coroutines.
+std::optional<std::size_t> GetCurrentNumaNode() noexcept;
+
+/// Pins the current thread to the CPUs, does nothing for an empty set
+void SetCurrentThreadAffinity(const CpuSet& cpus);
+
+}  // namespace utils
+
+USERVER_NAMESPACE_END
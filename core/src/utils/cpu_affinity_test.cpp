@@ -0,0 +1,77 @@
+#include <utils/cpu_affinity.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <userver/utest/assert_macros.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// Empty if the online CPUs are unknown
+utils::CpuSet GetOnlineCpus() {
+  std::ifstream file{"/sys/devices/system/cpu/online"};
+  if (!file) return {};
+  const std::string list{std::istreambuf_iterator<char>{file},
+                         std::istreambuf_iterator<char>{}};
+  return utils::ParseCpuList(list);
+}
+
+}  // namespace
+
+TEST(CpuAffinity, ParseCpuList) {
+  using utils::CpuSet;
+  using utils::ParseCpuList;
+
+  EXPECT_EQ(ParseCpuList(""), CpuSet{});
+  EXPECT_EQ(ParseCpuList("3"), CpuSet{3});
+  EXPECT_EQ(ParseCpuList("0-3\n"), (CpuSet{0, 1, 2, 3}));
+  EXPECT_EQ(ParseCpuList("8,0-1, 4-5"), (CpuSet{0, 1, 4, 5, 8}));
+  EXPECT_EQ(ParseCpuList("1,1,0-1"), (CpuSet{0, 1}));
+
+  UEXPECT_THROW(ParseCpuList("3-1"), std::runtime_error);
+  UEXPECT_THROW(ParseCpuList("a-b"), std::exception);
+  UEXPECT_THROW(ParseCpuList("0-1000000000000"), std::runtime_error);
+  UEXPECT_THROW(ParseCpuList("100000"), std::runtime_error);
+}
+
+TEST(CpuAffinity, ValidateCpuSet) {
+  UEXPECT_NO_THROW(utils::ValidateCpuSet({}));
+  UEXPECT_THROW(utils::ValidateCpuSet({100000}), std::runtime_error);
+
+  const auto online = GetOnlineCpus();
+  if (online.empty()) GTEST_SKIP() << "Online CPUs are unknown";
+  UEXPECT_NO_THROW(utils::ValidateCpuSet(online));
+  // Not online, but still below CPU_SETSIZE
+  UEXPECT_THROW(utils::ValidateCpuSet({online.back() + 1}),
+                std::runtime_error);
+
+  utils::CpuAffinityConfig config;
+  config.cpus = {online.front(), 100000};
+  UEXPECT_THROW(utils::ResolveCpuSets(config), std::runtime_error);
+}
+
+TEST(CpuAffinity, ResolveCpuSets) {
+  utils::CpuAffinityConfig config;
+  EXPECT_TRUE(config.IsEmpty());
+  EXPECT_TRUE(utils::ResolveCpuSets(config).empty());
+
+  const auto online = GetOnlineCpus();
+  if (online.empty()) GTEST_SKIP() << "Online CPUs are unknown";
+  config.cpus.assign(online.begin(),
+                     online.begin() + std::min<std::size_t>(online.size(), 2));
+  const auto cpu_sets = utils::ResolveCpuSets(config);
+  ASSERT_EQ(cpu_sets.size(), 1);
+  EXPECT_EQ(cpu_sets[0], config.cpus);
+}
+
+TEST(CpuAffinity, SetCurrentThreadAffinity) {
+  UEXPECT_NO_THROW(utils::SetCurrentThreadAffinity({}));
+}
+
+USERVER_NAMESPACE_END
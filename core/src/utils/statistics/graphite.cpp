@@ -37,23 +37,60 @@ class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
 
   void HandleMetric(std::string_view path, utils::statistics::LabelsSpan labels,
                     const MetricValue& value) override {
+    if (const auto* histogram = std::get_if<HistogramView>(&value)) {
+      DumpHistogram(path, labels, *histogram);
+      return;
+    }
+
     AppendGraphiteSafe(buf_, path);
 
     for (const auto& label : labels) {
       PutLabel(label);
     }
 
-    std::visit(
-        [this](const auto& v) {
-          fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"), v);
-        },
-        value);
+    if (const auto* int_value = std::get_if<std::int64_t>(&value)) {
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"), *int_value);
+    } else {
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"),
+                     std::get<double>(value));
+    }
     buf_.append(ending_);
   }
 
   std::string Release() { return fmt::to_string(buf_); }
 
  private:
+  // Graphite has no histograms, so each bucket is written as a separate
+  // cumulative metric with an `le` tag
+  void DumpHistogram(std::string_view path,
+                     utils::statistics::LabelsSpan labels,
+                     const HistogramView& histogram) {
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < histogram.GetBucketCount(); ++i) {
+      count += histogram.GetValueAt(i);
+      DumpHistogramBucket(path, labels,
+                          fmt::format(FMT_COMPILE("{}"),
+                                      histogram.GetUpperBoundAt(i)),
+                          count);
+    }
+    count += histogram.GetValueAtInf();
+    DumpHistogramBucket(path, labels, "inf", count);
+  }
+
+  void DumpHistogramBucket(std::string_view path,
+                           utils::statistics::LabelsSpan labels,
+                           std::string_view upper_bound, std::uint64_t count) {
+    AppendGraphiteSafe(buf_, path);
+
+    for (const auto& label : labels) {
+      PutLabel(label);
+    }
+    PutLabel(LabelView{"le", upper_bound});
+
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"), count);
+    buf_.append(ending_);
+  }
+
   void PutLabel(const LabelView& label) {
     buf_.push_back(';');
 
@@ -0,0 +1,188 @@
+#include <userver/utils/statistics/hdr_histogram.hpp>
+
+#include <userver/formats/json/serialize.hpp>
+#include <userver/utest/utest.hpp>
+#include <userver/utils/statistics/graphite.hpp>
+#include <userver/utils/statistics/prometheus.hpp>
+#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/utils/statistics/solomon.hpp>
+#include <userver/utils/statistics/storage.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using utils::statistics::HdrHistogram;
+using utils::statistics::Storage;
+using utils::statistics::Writer;
+
+// Values up to 15, buckets 0, 1, 2, 3, [4, 5], [6, 7], [8, 11], [12, 15]
+using SmallHistogram = HdrHistogram<2, 4>;
+
+}  // namespace
+
+TEST(HdrHistogram, Zero) {
+  HdrHistogram<> hist;
+
+  EXPECT_EQ(0U, hist.Count());
+  EXPECT_EQ(0U, hist.GetPercentile(0));
+  EXPECT_EQ(0U, hist.GetPercentile(50));
+  EXPECT_EQ(0U, hist.GetPercentile(100));
+}
+
+TEST(HdrHistogram, Precise) {
+  HdrHistogram<> hist;
+
+  for (int i = 0; i < 64; i++) hist.Account(i);
+
+  EXPECT_EQ(64U, hist.Count());
+  EXPECT_EQ(0U, hist.GetPercentile(0));
+  EXPECT_EQ(31U, hist.GetPercentile(49));
+  EXPECT_EQ(32U, hist.GetPercentile(50));
+  EXPECT_EQ(63U, hist.GetPercentile(100));
+}
+
+TEST(HdrHistogram, Buckets) {
+  SmallHistogram hist;
+
+  hist.Account(4);
+  EXPECT_EQ(5U, hist.GetPercentile(50));
+
+  hist.Reset();
+  hist.Account(12);
+  EXPECT_EQ(15U, hist.GetPercentile(50));
+
+  hist.Reset();
+  hist.Account(8);
+  hist.Account(7);
+  EXPECT_EQ(7U, hist.GetPercentile(0));
+  EXPECT_EQ(11U, hist.GetPercentile(100));
+}
+
+TEST(HdrHistogram, Overflow) {
+  SmallHistogram hist;
+
+  hist.Account(SmallHistogram::kMaxValue);
+  hist.Account(SmallHistogram::kMaxValue + 1, 3);
+
+  EXPECT_EQ(4U, hist.Count());
+  EXPECT_EQ(3U, hist.CountOverflow());
+  EXPECT_EQ(15U, hist.GetPercentile(0));
+  EXPECT_EQ(16U, hist.GetPercentile(50));
+}
+
+TEST(HdrHistogram, RelativeError) {
+  /// [HdrHistogram usage]
+  utils::statistics::HdrHistogram<> hist;
+  EXPECT_DOUBLE_EQ(hist.kMaxRelativeError, 1.0 / 32);
+
+  for (std::uint64_t value = 1; value < (std::uint64_t{1} << 32);
+       value = value * 17 / 16 + 1) {
+    hist.Reset();
+    hist.Account(value);
+
+    const auto result = hist.GetPercentile(50);
+    EXPECT_GE(result, value);
+    EXPECT_LE(result - value, value * hist.kMaxRelativeError) << value;
+  }
+  /// [HdrHistogram usage]
+}
+
+TEST(HdrHistogram, Add) {
+  SmallHistogram first;
+  SmallHistogram second;
+
+  first.Account(1);
+  second.Account(3, 2);
+  second.Account(100);
+  first.Add(second);
+
+  EXPECT_EQ(4U, first.Count());
+  EXPECT_EQ(1U, first.CountOverflow());
+  EXPECT_EQ(3U, first.GetPercentile(50));
+  EXPECT_EQ(3U, second.Count());
+
+  SmallHistogram copy{first};
+  EXPECT_EQ(4U, copy.Count());
+  EXPECT_EQ(3U, copy.GetPercentile(50));
+}
+
+TEST(HdrHistogram, RecentPeriod) {
+  using Histogram = HdrHistogram<>;
+  utils::statistics::RecentPeriod<Histogram, Histogram> period;
+
+  period.GetCurrentCounter().Account(10);
+  period.GetCurrentCounter().Account(1000, 3);
+
+  const auto stats = period.GetStatsForPeriod(
+      utils::statistics::RecentPeriod<Histogram, Histogram>::Duration::min(),
+      true);
+  EXPECT_EQ(4U, stats.Count());
+  EXPECT_EQ(10U, stats.GetPercentile(0));
+  EXPECT_EQ(1007U, stats.GetPercentile(50));
+}
+
+TEST(HdrHistogram, ExportBuckets) {
+  EXPECT_EQ(8U, SmallHistogram::kExportBucketCount);
+  const std::array<double, 8> expected_bounds{0, 1, 2, 3, 5, 7, 11, 15};
+  EXPECT_EQ(expected_bounds, SmallHistogram::kExportUpperBounds);
+
+  SmallHistogram hist;
+  hist.Account(0);
+  hist.Account(3);
+  // The lowest values of the buckets are not counted to the previous bounds
+  hist.Account(4);
+  hist.Account(5, 2);
+  hist.Account(8);
+  hist.Account(9);
+  const std::array<std::uint64_t, 8> expected_values{1, 0, 0, 1, 3, 0, 2, 0};
+  EXPECT_EQ(expected_values, hist.GetExportValues());
+}
+
+UTEST(HdrHistogram, Formats) {
+  SmallHistogram hist;
+  hist.Account(1);
+  hist.Account(3);
+  hist.Account(5, 2);
+  hist.Account(20);
+
+  Storage storage;
+  auto holder = storage.RegisterWriter("hist", [&hist](Writer& writer) {
+    writer.ValueWithLabels(hist, {"label", "value"});
+  });
+
+  EXPECT_EQ(utils::statistics::ToPrometheusFormat(storage),
+            "# TYPE hist histogram\n"
+            "hist_bucket{label=\"value\",le=\"0\"} 0\n"
+            "hist_bucket{label=\"value\",le=\"1\"} 1\n"
+            "hist_bucket{label=\"value\",le=\"2\"} 1\n"
+            "hist_bucket{label=\"value\",le=\"3\"} 2\n"
+            "hist_bucket{label=\"value\",le=\"5\"} 4\n"
+            "hist_bucket{label=\"value\",le=\"7\"} 4\n"
+            "hist_bucket{label=\"value\",le=\"11\"} 4\n"
+            "hist_bucket{label=\"value\",le=\"15\"} 4\n"
+            "hist_bucket{label=\"value\",le=\"+Inf\"} 5\n"
+            "hist_sum{label=\"value\"} 29\n"
+            "hist_count{label=\"value\"} 5\n");
+
+  const auto solomon = utils::statistics::ToSolomonFormat(storage, {});
+  EXPECT_EQ(
+      formats::json::FromString(solomon),
+      formats::json::FromString(R"({"metrics": [{
+        "labels": {"sensor": "hist", "label": "value"},
+        "type": "HIST",
+        "hist": {
+          "bounds": [0, 1, 2, 3, 5, 7, 11, 15],
+          "buckets": [0, 1, 0, 1, 2, 0, 0, 0],
+          "inf": 1
+        }
+      }]})"));
+
+  const auto graphite = utils::statistics::ToGraphiteFormat(storage);
+  EXPECT_NE(graphite.find("hist;label=value;le=5 4 "), std::string::npos)
+      << graphite;
+  EXPECT_NE(graphite.find("hist;label=value;le=inf 5 "), std::string::npos)
+      << graphite;
+}
+
+USERVER_NAMESPACE_END
@@ -47,6 +47,38 @@ HttpCodes::Snapshot HttpCodes::GetSnapshot() const {
   return result;
 }
 
+ShardedHttpCodes::Shard::Shard() {
+  // TODO remove in C++20 after atomics value-initialization
+  for (auto& counter : codes) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+ShardedHttpCodes::ShardedHttpCodes() : shards_(impl::GetShardCount()) {}
+
+void ShardedHttpCodes::Account(Code code) noexcept {
+  if (code < kMinShardedStatus || code >= kMaxShardedStatus) {
+    other_codes_.Account(code);
+    return;
+  }
+  shards_[impl::GetCurrentShardIndex()]
+      .codes[code - kMinShardedStatus]
+      .fetch_add(1, std::memory_order_relaxed);
+}
+
+HttpCodes::Snapshot ShardedHttpCodes::GetSnapshot() const {
+  auto result = other_codes_.GetSnapshot();
+  for (Code code = kMinShardedStatus; code < kMaxShardedStatus; ++code) {
+    Counter count = 0;
+    for (const auto& shard : shards_) {
+      count += shard.codes[code - kMinShardedStatus].load(
+          std::memory_order_relaxed);
+    }
+    if (count != 0) result.codes[code] += count;
+  }
+  return result;
+}
+
 void HttpCodes::Snapshot::Add(const Snapshot& other) {
   for (const auto& [code, count] : other.codes) {
     codes[code] += count;
@@ -6,7 +6,9 @@
 #include <cstdint>
 #include <unordered_map>
 
+#include <userver/utils/fixed_array.hpp>
 #include <userver/utils/statistics/fwd.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -37,6 +39,33 @@ class HttpCodes final {
   std::array<std::atomic<ValueType>, kMaxHttpStatus - kMinHttpStatus> codes_{};
 };
 
+// HttpCodes for the hot paths, 2xx codes are accounted in per-thread shards
+class ShardedHttpCodes final {
+ public:
+  using Code = HttpCodes::Code;
+  using Counter = HttpCodes::Counter;
+
+  ShardedHttpCodes();
+
+  void Account(Code code) noexcept;
+
+  HttpCodes::Snapshot GetSnapshot() const;
+
+ private:
+  static constexpr Code kMinShardedStatus = 200;
+  static constexpr Code kMaxShardedStatus = 300;
+
+  struct alignas(utils::impl::kInterferenceSize) Shard final {
+    Shard();
+
+    std::array<std::atomic<Counter>, kMaxShardedStatus - kMinShardedStatus>
+        codes;
+  };
+
+  utils::FixedArray<Shard> shards_;
+  HttpCodes other_codes_;
+};
+
 void DumpMetric(Writer& writer, const HttpCodes::Snapshot& snapshot);
 
 }  // namespace utils::statistics
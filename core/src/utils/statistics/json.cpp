@@ -30,7 +30,13 @@ class JsonFormat final : public utils::statistics::BaseFormatBuilder {
   void HandleMetric(std::string_view path, utils::statistics::LabelsSpan labels,
                     const MetricValue& value) override {
     formats::json::ValueBuilder node;
-    std::visit([&node](const auto& v) { node["value"] = v; }, value);
+    if (const auto* histogram = std::get_if<HistogramView>(&value)) {
+      node["value"] = BuildHistogram(*histogram);
+    } else if (const auto* int_value = std::get_if<std::int64_t>(&value)) {
+      node["value"] = *int_value;
+    } else {
+      node["value"] = std::get<double>(value);
+    }
     node["labels"] = BuildLabels(labels);
 
     builder_[std::string{path}].PushBack(std::move(node));
@@ -50,6 +56,24 @@ class JsonFormat final : public utils::statistics::BaseFormatBuilder {
     return result;
   }
 
+  static formats::json::ValueBuilder BuildHistogram(
+      const HistogramView& histogram) {
+    formats::json::ValueBuilder bounds{formats::common::Type::kArray};
+    formats::json::ValueBuilder buckets{formats::common::Type::kArray};
+
+    for (std::size_t i = 0; i < histogram.GetBucketCount(); ++i) {
+      bounds.PushBack(histogram.GetUpperBoundAt(i));
+      buckets.PushBack(histogram.GetValueAt(i));
+    }
+
+    formats::json::ValueBuilder result{formats::common::Type::kObject};
+    result["bounds"] = std::move(bounds);
+    result["buckets"] = std::move(buckets);
+    result["inf"] = histogram.GetValueAtInf();
+    result["sum"] = histogram.GetSum();
+    return result;
+  }
+
   formats::json::ValueBuilder builder_{formats::common::Type::kObject};
 };
 
@@ -27,36 +27,85 @@ class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
 
   void HandleMetric(std::string_view path, utils::statistics::LabelsSpan labels,
                     const MetricValue& value) override {
-    DumpMetricName(std::string{path});
+    if (const auto* histogram = std::get_if<HistogramView>(&value)) {
+      DumpHistogram(path, labels, *histogram);
+      return;
+    }
+
+    buf_.append(GetMetricName(std::string{path}, "gauge"));
     DumpLabels(labels);
-    std::visit(
-        [this](const auto& v) {
-          fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"), v);
-        },
-        value);
+    if (const auto* int_value = std::get_if<std::int64_t>(&value)) {
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"), *int_value);
+    } else {
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}"),
+                     std::get<double>(value));
+    }
     buf_.push_back('\n');
   }
 
   std::string Release() { return fmt::to_string(buf_); }
 
  private:
-  void DumpMetricName(const std::string& name) {
+  const std::string& GetMetricName(const std::string& name,
+                                   std::string_view type) {
     if (auto* converted = utils::FindOrNullptr(metrics_, name)) {
-      buf_.append(*converted);
-      return;
+      return *converted;
     }
 
     auto prometheus_name = impl::ToPrometheusName(name);
-    metrics_.emplace(name, prometheus_name);
     if constexpr (IsTyped == Typed::kYes) {
-      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("# TYPE {} gauge\n"),
-                     prometheus_name);
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("# TYPE {} {}\n"),
+                     prometheus_name, type);
     }
-    buf_.append(prometheus_name);
+    return metrics_.emplace(name, std::move(prometheus_name)).first->second;
+  }
+
+  // Cumulative `name_bucket{le="..."}` series followed by `name_sum` and
+  // `name_count`, as in the Prometheus histogram type
+  void DumpHistogram(std::string_view path,
+                     utils::statistics::LabelsSpan labels,
+                     const HistogramView& histogram) {
+    const auto& name = GetMetricName(std::string{path}, "histogram");
+
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < histogram.GetBucketCount(); ++i) {
+      count += histogram.GetValueAt(i);
+      DumpHistogramBucket(name, labels,
+                          fmt::format(FMT_COMPILE("{}"),
+                                      histogram.GetUpperBoundAt(i)),
+                          count);
+    }
+    count += histogram.GetValueAtInf();
+    DumpHistogramBucket(name, labels, "+Inf", count);
+
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("{}_sum"), name);
+    DumpLabels(labels);
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}\n"),
+                   histogram.GetSum());
+
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("{}_count"), name);
+    DumpLabels(labels);
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}\n"), count);
+  }
+
+  void DumpHistogramBucket(std::string_view name,
+                           utils::statistics::LabelsSpan labels,
+                           std::string_view upper_bound, std::uint64_t count) {
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("{}_bucket"), name);
+    buf_.push_back('{');
+    DumpLabelsContent(labels);
+    if (!labels.empty()) buf_.push_back(',');
+    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("le=\"{}\"}} {}\n"),
+                   upper_bound, count);
   }
 
   void DumpLabels(utils::statistics::LabelsSpan labels) {
     buf_.push_back('{');
+    DumpLabelsContent(labels);
+    buf_.push_back('}');
+  }
+
+  void DumpLabelsContent(utils::statistics::LabelsSpan labels) {
     bool sep = false;
     for (const auto& label : labels) {
       if (sep) {
@@ -70,7 +119,6 @@ class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
       buf_.push_back('"');
       sep = true;
     }
-    buf_.push_back('}');
   }
 
   fmt::memory_buffer buf_;
@@ -0,0 +1,45 @@
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics::impl {
+
+namespace {
+
+// A shard of a Percentile takes kilobytes and a handler has dozens of them,
+// so the count is capped at the cost of some contention on large machines
+constexpr std::size_t kMaxShardCount = 8;
+
+std::size_t ComputeShardCount() noexcept {
+  const auto threads = std::clamp<std::size_t>(
+      std::thread::hardware_concurrency(), 1, kMaxShardCount);
+  std::size_t result = 1;
+  while (result < threads) result *= 2;
+  return result;
+}
+
+std::atomic<std::size_t> next_thread_shard{0};
+
+}  // namespace
+
+std::size_t GetShardCount() noexcept {
+  static const std::size_t kShardCount = ComputeShardCount();
+  return kShardCount;
+}
+
+std::size_t GetCurrentShardIndex() noexcept {
+  // Threads get the shards in the round-robin order, so the workers of a task
+  // processor do not share shards unless there are too many of them.
+  thread_local const std::size_t shard =
+      next_thread_shard.fetch_add(1, std::memory_order_relaxed) &
+      (GetShardCount() - 1);
+  return shard;
+}
+
+}  // namespace utils::statistics::impl
+
+USERVER_NAMESPACE_END
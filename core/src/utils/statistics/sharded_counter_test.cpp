@@ -0,0 +1,55 @@
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+TEST(ShardedCounter, Basic) {
+  utils::statistics::ShardedCounter<std::size_t> counter;
+  EXPECT_EQ(counter.Load(), 0);
+
+  ++counter;
+  counter += 5;
+  --counter;
+  counter -= 2;
+  EXPECT_EQ(counter.Load(), 3);
+  EXPECT_EQ(static_cast<std::size_t>(counter), 3);
+}
+
+TEST(ShardedCounter, Threads) {
+  utils::statistics::ShardedCounter<std::size_t> counter;
+  constexpr std::size_t kThreads = 16;
+  constexpr std::size_t kIterations = 10000;
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&counter, i] {
+      for (std::size_t j = 0; j < kIterations; ++j) {
+        // Decrements land into the other shards
+        if (i % 2) {
+          --counter;
+        } else {
+          counter += 2;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(counter.Load(), kThreads / 2 * kIterations);
+}
+
+TEST(ShardedCounter, ShardIndex) {
+  const auto shard_count = utils::statistics::impl::GetShardCount();
+  EXPECT_GE(shard_count, 1);
+  EXPECT_EQ(shard_count & (shard_count - 1), 0);
+
+  const auto index = utils::statistics::impl::GetCurrentShardIndex();
+  EXPECT_LT(index, shard_count);
+  EXPECT_EQ(index, utils::statistics::impl::GetCurrentShardIndex());
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include <userver/utils/datetime.hpp>
+#include <userver/utils/statistics/percentile.hpp>
+#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/utils/statistics/relaxed_counter.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
+#include <userver/utils/statistics/sharded_recentperiod.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// Same as in the HTTP handler statistics
+using Percentile = utils::statistics::Percentile<2048, unsigned int, 120>;
+
+template <typename Counter>
+void CounterContention(benchmark::State& state) {
+  static Counter counter;
+  for (auto _ : state) {
+    ++counter;
+  }
+  benchmark::DoNotOptimize(counter.Load());
+}
+
+template <typename RecentPeriod>
+void PercentileContention(benchmark::State& state) {
+  static RecentPeriod timings;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    timings.GetCurrentCounter().Account(i++ % 100);
+  }
+}
+
+}  // namespace
+
+void statistics_relaxed_counter(benchmark::State& state) {
+  CounterContention<utils::statistics::RelaxedCounter<std::uint64_t>>(state);
+}
+BENCHMARK(statistics_relaxed_counter)->ThreadRange(1, 64)->UseRealTime();
+
+void statistics_sharded_counter(benchmark::State& state) {
+  CounterContention<utils::statistics::ShardedCounter<std::uint64_t>>(state);
+}
+BENCHMARK(statistics_sharded_counter)->ThreadRange(1, 64)->UseRealTime();
+
+void statistics_recentperiod_percentile(benchmark::State& state) {
+  PercentileContention<utils::statistics::RecentPeriod<
+      Percentile, Percentile, utils::datetime::SteadyClock>>(state);
+}
+BENCHMARK(statistics_recentperiod_percentile)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+void statistics_sharded_recentperiod_percentile(benchmark::State& state) {
+  PercentileContention<utils::statistics::ShardedRecentPeriod<
+      Percentile, Percentile, utils::datetime::SteadyClock>>(state);
+}
+BENCHMARK(statistics_sharded_recentperiod_percentile)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,113 @@
+#include <userver/utils/statistics/sharded_recentperiod.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <userver/utils/statistics/percentile.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+class TestTimer {
+ public:
+  using duration = std::chrono::system_clock::duration;
+
+  static std::chrono::system_clock::time_point now() {
+    return std::chrono::system_clock::time_point(timer_.load());
+  }
+
+  static void sleep(duration duration) { timer_ = timer_.load() + duration; }
+
+ private:
+  static std::atomic<duration> timer_;
+};
+
+std::atomic<TestTimer::duration> TestTimer::timer_{TestTimer::duration{0}};
+
+struct Atomic {
+  std::atomic_ulong counter{0};
+
+  void Add(const Atomic& other) { counter += other.counter.load(); }
+
+  void Reset() { counter = 0; }
+};
+
+struct Result {
+  unsigned long counter{0};
+
+  Result& operator+=(const Atomic& a) {
+    counter += a.counter.load();
+    return *this;
+  }
+};
+
+}  // namespace
+
+TEST(ShardedRecentPeriod, Basic) {
+  utils::statistics::ShardedRecentPeriod<Atomic, Result, TestTimer> stat(
+      std::chrono::seconds(10), std::chrono::seconds(60));
+
+  for (int i = 1; i < 10; i++) {
+    stat.GetCurrentCounter().counter += i;
+    TestTimer::sleep(std::chrono::seconds(10));
+  }
+
+  {
+    auto result = stat.GetStatsForPeriod();
+    EXPECT_EQ(result.counter, 39U);
+  }
+
+  {
+    TestTimer::sleep(std::chrono::seconds(10));
+    auto result = stat.GetStatsForPeriod();
+    EXPECT_EQ(result.counter, 35U);
+  }
+
+  {
+    TestTimer::sleep(std::chrono::seconds(60));
+    auto result = stat.GetStatsForPeriod();
+    EXPECT_EQ(result.counter, 0U);
+  }
+}
+
+TEST(ShardedRecentPeriod, CurrentEpochIsNotReported) {
+  utils::statistics::ShardedRecentPeriod<Atomic, Result, TestTimer> stat(
+      std::chrono::seconds(10), std::chrono::seconds(60));
+
+  stat.GetCurrentCounter().counter += 1;
+  EXPECT_EQ(stat.GetStatsForPeriod().counter, 0U);
+
+  // Shards of idle threads are merged by the statistics collection
+  TestTimer::sleep(std::chrono::seconds(10));
+  EXPECT_EQ(stat.GetStatsForPeriod().counter, 1U);
+  EXPECT_EQ(stat.GetStatsForPeriod().counter, 1U);
+}
+
+TEST(ShardedRecentPeriod, Threads) {
+  using Percentile = utils::statistics::Percentile<100>;
+  utils::statistics::ShardedRecentPeriod<Percentile, Percentile, TestTimer>
+      stat(std::chrono::seconds(10), std::chrono::seconds(60));
+  constexpr std::size_t kThreads = 16;
+  constexpr std::size_t kIterations = 10000;
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&stat, i] {
+      for (std::size_t j = 0; j < kIterations; ++j) {
+        stat.GetCurrentCounter().Account(i);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  TestTimer::sleep(std::chrono::seconds(10));
+  const auto result = stat.GetStatsForPeriod();
+  EXPECT_EQ(result.Count(), kThreads * kIterations);
+  EXPECT_EQ(result.GetPercentile(0), 0);
+  EXPECT_EQ(result.GetPercentile(100), kThreads - 1);
+}
+
+USERVER_NAMESPACE_END
@@ -38,6 +38,13 @@ class SolomonJsonBuilder final : public utils::statistics::BaseFormatBuilder {
     formats::json::StringBuilder::ObjectGuard guard{builder_};
     builder_.Key("labels");
     DumpLabels(path, labels);
+    if (const auto* histogram = std::get_if<HistogramView>(&value)) {
+      builder_.Key("type");
+      builder_.WriteString("HIST");
+      builder_.Key("hist");
+      DumpHistogram(*histogram);
+      return;
+    }
     builder_.Key("value");
     if (const auto* int_value = std::get_if<int64_t>(&value)) {
       builder_.WriteInt64(*int_value);
@@ -64,6 +71,26 @@ class SolomonJsonBuilder final : public utils::statistics::BaseFormatBuilder {
   }
 
  private:
+  void DumpHistogram(const HistogramView& histogram) {
+    formats::json::StringBuilder::ObjectGuard guard{builder_};
+    builder_.Key("bounds");
+    {
+      formats::json::StringBuilder::ArrayGuard array_guard{builder_};
+      for (std::size_t i = 0; i < histogram.GetBucketCount(); ++i) {
+        builder_.WriteDouble(histogram.GetUpperBoundAt(i));
+      }
+    }
+    builder_.Key("buckets");
+    {
+      formats::json::StringBuilder::ArrayGuard array_guard{builder_};
+      for (std::size_t i = 0; i < histogram.GetBucketCount(); ++i) {
+        builder_.WriteUInt64(histogram.GetValueAt(i));
+      }
+    }
+    builder_.Key("inf");
+    builder_.WriteUInt64(histogram.GetValueAtInf());
+  }
+
   void DumpLabels(std::string_view path, utils::statistics::LabelsSpan labels) {
     formats::json::StringBuilder::ObjectGuard guard{builder_};
     builder_.Key("sensor");
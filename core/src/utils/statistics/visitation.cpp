@@ -179,7 +179,7 @@ void ProcessLeaf(BaseFormatBuilder& builder, DfsLabelsBag& labels,
   } else {
     path.AppendNode(key);
   }
-  std::optional<std::variant<int64_t, double>> metric_value;
+  std::optional<BaseFormatBuilder::MetricValue> metric_value;
   if (value.IsString()) {
     try {
       metric_value = utils::FromString<double>(value.As<std::string>());
@@ -69,7 +69,7 @@ bool CanSubPathSucceedStartsWith(std::string_view current_path,
 }
 
 void CheckAndWrite(impl::WriterState& state,
-                   std::variant<std::int64_t, double> value) {
+                   const BaseFormatBuilder::MetricValue& value) {
   UINVARIANT(!state.path.empty(),
              "Detected an attempt to write a metric by empty path");
 
@@ -157,6 +157,13 @@ void Writer::Write(double value) {
   }
 }
 
+void Writer::Write(const HistogramView& value) {
+  if (state_) {
+    ValidateUsage();
+    CheckAndWrite(*state_, value);
+  }
+}
+
 void Writer::ResetState() noexcept {
   UASSERT(state_);
 
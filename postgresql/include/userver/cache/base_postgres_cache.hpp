@@ -5,10 +5,12 @@
 
 #include <userver/cache/base_postgres_cache_fwd.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -16,6 +18,11 @@
 #include <userver/cache/caching_component_base.hpp>
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/concurrent/queue.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/engine/wait_all_checked.hpp>
+#include <userver/formats/json/value_builder.hpp>
 
 #include <userver/storages/postgres/cluster.hpp>
 #include <userver/storages/postgres/component.hpp>
@@ -25,8 +32,10 @@
 #include <userver/logging/log.hpp>
 #include <userver/tracing/span.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/async.hpp>
 #include <userver/utils/cpu_relax.hpp>
 #include <userver/utils/meta.hpp>
+#include <userver/utils/statistics/entry.hpp>
 #include <userver/utils/void_t.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
@@ -61,7 +70,9 @@ namespace components {
 /// full-update-op-timeout | timeout for a full update | 1m
 /// incremental-update-op-timeout | timeout for an incremental update | 1s
 /// update-correction | incremental update window adjustment | - (0 for caches with defined GetLastKnownUpdated)
-/// chunk-size | number of rows to request from PostgreSQL, 0 to fetch all rows in one request | 1000
+/// chunk-size | number of rows to parse at once as they are streamed from PostgreSQL, 0 to fetch all rows in one request | 1000
+/// full-update-shards | number of parts of a full update fetched in parallel, see @ref pg_cc_full_update_shards | 1
+/// full-update-parse-task-processor | task processor to parse the rows of a sharded full update on | the cache `task-processor`
 ///
 /// @section pg_cc_cache_policy Cache policy
 ///
@@ -93,6 +104,22 @@ namespace components {
 ///
 /// @snippet cache/postgres_cache_test.cpp Pg Cache Policy Custom Container With Write Notification Example
 ///
+/// @section pg_cc_full_update_shards Sharded Full Update
+///
+/// A full update of a big cache may be split into `full-update-shards` parts
+/// by the hash of the SQL expression from the `kFullUpdateShardKey` policy
+/// member. Every part is streamed over a connection of its own, possibly
+/// from different hosts, while its rows are parsed on the
+/// `full-update-parse-task-processor`. The update task only merges the parsed
+/// values into the container, so rows with the same cache key must belong to
+/// the same part.
+///
+/// @snippet cache/postgres_cache_test.cpp Pg Cache Policy Sharded Full Update Example
+///
+/// The time spent on fetching and on parsing every part during the last full
+/// update is reported in `cache.<name>.full-update-shards` metrics with the
+/// `pg_cache_shard` label.
+///
 /// @section pg_cc_forward_declaration Forward Declaration
 ///
 /// To forward declare a cache you can forward declare a trait and
@@ -157,6 +184,13 @@ using HasWhere = decltype(T::kWhere);
 template <typename T>
 inline constexpr bool kHasWhere = meta::kIsDetected<HasWhere, T>;
 
+// Shard key of a full update in policy
+template <typename T>
+using HasFullUpdateShardKey = decltype(T::kFullUpdateShardKey);
+template <typename T>
+inline constexpr bool kHasFullUpdateShardKey =
+    meta::kIsDetected<HasFullUpdateShardKey, T>;
+
 // Update field
 template <typename T>
 using HasUpdatedField = decltype(T::kUpdatedField);
@@ -354,6 +388,277 @@ inline constexpr std::string_view kFetchStage = "fetch";
 inline constexpr std::string_view kParseStage = "parse";
 
 inline constexpr std::size_t kDefaultChunkSize = 1000;
+
+// Chunks of rows that are fetched or parsed ahead of their consumer
+inline constexpr std::size_t kShardQueueSize = 2;
+
+struct ShardTimings {
+  tracing::ScopeTime::Duration fetch{0};
+  tracing::ScopeTime::Duration parse{0};
+  std::size_t documents{0};
+  std::size_t parse_failures{0};
+};
+
+/// Timings of the shards of the last sharded full update
+class FullUpdateShardsStatistics final {
+ public:
+  explicit FullUpdateShardsStatistics(std::size_t shards);
+
+  void Store(const std::vector<ShardTimings>& timings);
+
+  formats::json::ValueBuilder ExtendStatistics() const;
+
+ private:
+  struct Shard {
+    std::atomic<std::int64_t> fetch_ms{0};
+    std::atomic<std::int64_t> parse_ms{0};
+    std::atomic<std::size_t> documents{0};
+    std::atomic<std::size_t> parse_failures{0};
+  };
+
+  std::vector<Shard> shards_;
+};
+
+/// Full update of PostgreCache split into shards, see
+/// @ref pg_cc_full_update_shards
+template <typename PostgreCachePolicy>
+class ShardedFullUpdate final {
+  static_assert(kHasFullUpdateShardKey<PostgreCachePolicy>,
+                "The PostgreSQL cache policy must contain a static member "
+                "`kFullUpdateShardKey` to split a full update into shards");
+
+ public:
+  using ValueType = pg_cache::detail::ValueType<PostgreCachePolicy>;
+  using RawValueType = pg_cache::detail::RawValueType<PostgreCachePolicy>;
+  using DataType = DataCacheContainerType<PostgreCachePolicy>;
+
+  struct Settings {
+    std::size_t shards{1};
+    std::size_t chunk_size{kDefaultChunkSize};
+    std::chrono::milliseconds timeout{kDefaultFullUpdateTimeout};
+    engine::TaskProcessor* parse_task_processor{nullptr};
+    std::size_t cpu_relax_iterations{0};
+  };
+
+  explicit ShardedFullUpdate(Settings settings);
+
+  /// Query of the rows of `shard` out of `shards`
+  static storages::postgres::Query GetShardQuery(std::size_t shards,
+                                                 std::size_t shard);
+
+  /// Stores the rows of all the shards fetched from `cluster` into `data`,
+  /// adds the timings of the shards to `timings`.
+  /// @returns the number of documents read from `cluster`
+  std::size_t Run(storages::postgres::Cluster& cluster, DataType& data,
+                  tracing::ScopeTime& scope,
+                  cache::UpdateStatisticsScope& stats_scope,
+                  std::vector<ShardTimings>& timings) const;
+
+ private:
+  using RowsQueue =
+      concurrent::SpscQueue<std::vector<storages::postgres::ResultSet>>;
+  using ValuesQueue = concurrent::NonFifoMpscQueue<std::vector<ValueType>>;
+
+  void FetchShard(storages::postgres::Cluster& cluster, std::size_t shard,
+                  typename RowsQueue::Producer producer,
+                  ShardTimings& timings) const;
+  void ParseShard(typename RowsQueue::Consumer consumer,
+                  typename ValuesQueue::Producer producer,
+                  ShardTimings& timings) const;
+  void StoreValues(typename ValuesQueue::Consumer consumer, DataType& data,
+                   tracing::ScopeTime& scope,
+                   cache::UpdateStatisticsScope& stats_scope) const;
+  std::size_t ParseResults(const storages::postgres::ResultSet& res,
+                           std::vector<ValueType>& values,
+                           utils::CpuRelax& relax) const;
+
+  const Settings settings_;
+};
+
+template <typename PostgreCachePolicy>
+ShardedFullUpdate<PostgreCachePolicy>::ShardedFullUpdate(Settings settings)
+    : settings_{settings} {
+  UASSERT(settings_.shards > 0);
+  UASSERT(settings_.parse_task_processor);
+}
+
+template <typename PostgreCachePolicy>
+storages::postgres::Query
+ShardedFullUpdate<PostgreCachePolicy>::GetShardQuery(std::size_t shards,
+                                                     std::size_t shard) {
+  storages::postgres::Query query =
+      PolicyChecker<PostgreCachePolicy>::GetQuery();
+  // The sign bit is cleared, as hashtext may return a negative value
+  const auto shard_condition =
+      fmt::format("(hashtext(({})::text) & 2147483647) % {} = {}",
+                  PostgreCachePolicy::kFullUpdateShardKey, shards, shard);
+
+  if constexpr (kHasWhere<PostgreCachePolicy>) {
+    return {fmt::format("{} where ({}) and {}", query.Statement(),
+                        PostgreCachePolicy::kWhere, shard_condition),
+            query.GetName()};
+  } else {
+    return {fmt::format("{} where {}", query.Statement(), shard_condition),
+            query.GetName()};
+  }
+}
+
+template <typename PostgreCachePolicy>
+std::size_t ShardedFullUpdate<PostgreCachePolicy>::Run(
+    storages::postgres::Cluster& cluster, DataType& data,
+    tracing::ScopeTime& scope, cache::UpdateStatisticsScope& stats_scope,
+    std::vector<ShardTimings>& timings) const {
+  UASSERT(timings.size() == settings_.shards);
+  auto values_queue =
+      ValuesQueue::Create(settings_.shards * kShardQueueSize);
+
+  // Every shard is fetched by a task of its own and parsed by another one, a
+  // single task stores the values of all the shards
+  std::vector<ShardTimings> cluster_timings(settings_.shards);
+  std::vector<engine::TaskWithResult<void>> tasks;
+  tasks.reserve(settings_.shards * 2 + 1);
+  for (std::size_t shard = 0; shard < settings_.shards; ++shard) {
+    auto rows_queue = RowsQueue::Create(kShardQueueSize);
+    tasks.push_back(utils::Async(
+        "pg_cache_fetch_shard",
+        [this, &cluster, shard, &shard_timings = cluster_timings[shard],
+         producer = rows_queue->GetProducer()]() mutable {
+          FetchShard(cluster, shard, std::move(producer), shard_timings);
+        }));
+    tasks.push_back(utils::Async(
+        *settings_.parse_task_processor, "pg_cache_parse_shard",
+        [this, &shard_timings = cluster_timings[shard],
+         consumer = rows_queue->GetConsumer(),
+         producer = values_queue->GetProducer()]() mutable {
+          ParseShard(std::move(consumer), std::move(producer), shard_timings);
+        }));
+  }
+  tasks.push_back(utils::Async(
+      "pg_cache_store_shards",
+      [this, &data, &scope, &stats_scope,
+       consumer = values_queue->GetConsumer()]() mutable {
+        StoreValues(std::move(consumer), data, scope, stats_scope);
+      }));
+
+  // The first failure is rethrown as soon as it happens, the other shards are
+  // not waited for
+  try {
+    engine::WaitAllChecked(tasks);
+  } catch (const std::exception&) {
+    for (auto& task : tasks) task.RequestCancel();
+    throw;
+  }
+
+  std::size_t documents = 0;
+  for (std::size_t shard = 0; shard < settings_.shards; ++shard) {
+    const auto& shard_timings = cluster_timings[shard];
+    timings[shard].fetch += shard_timings.fetch;
+    timings[shard].parse += shard_timings.parse;
+    timings[shard].documents += shard_timings.documents;
+    timings[shard].parse_failures += shard_timings.parse_failures;
+    documents += shard_timings.documents;
+  }
+  return documents;
+}
+
+template <typename PostgreCachePolicy>
+void ShardedFullUpdate<PostgreCachePolicy>::FetchShard(
+    storages::postgres::Cluster& cluster, std::size_t shard,
+    typename RowsQueue::Producer producer, ShardTimings& timings) const {
+  namespace pg = storages::postgres;
+  tracing::Span::CurrentSpan().AddTag("pg_cache_shard", shard);
+  auto scope =
+      tracing::Span::CurrentSpan().CreateScopeTime(std::string{kFetchStage});
+
+  const pg::CommandControl cmd_ctl{settings_.timeout, kStatementTimeoutOff};
+  auto stream = cluster.Stream(ClusterHostType<PostgreCachePolicy>(), cmd_ctl,
+                               GetShardQuery(settings_.shards, shard));
+  const auto chunk_size = settings_.chunk_size;
+  while (!stream.Done()) {
+    scope.Reset(std::string{kFetchStage});
+    std::vector<pg::ResultSet> rows;
+    rows.reserve(chunk_size);
+    while (chunk_size == 0 || rows.size() < chunk_size) {
+      auto row = stream.NextRow();
+      if (!row) break;
+      rows.push_back(std::move(*row));
+    }
+    // Waiting for the parsing task is not accounted as fetching
+    scope.Reset();
+    timings.documents += rows.size();
+    if (rows.empty()) break;
+    // The update has failed if the parsing task is gone
+    if (!producer.Push(std::move(rows))) return;
+  }
+  timings.fetch += scope.DurationTotal(std::string{kFetchStage});
+}
+
+template <typename PostgreCachePolicy>
+void ShardedFullUpdate<PostgreCachePolicy>::ParseShard(
+    typename RowsQueue::Consumer consumer,
+    typename ValuesQueue::Producer producer, ShardTimings& timings) const {
+  auto scope = tracing::Span::CurrentSpan().CreateScopeTime();
+  std::vector<storages::postgres::ResultSet> rows;
+  while (consumer.Pop(rows)) {
+    scope.Reset(std::string{kParseStage});
+    std::vector<ValueType> values;
+    values.reserve(rows.size());
+    utils::CpuRelax relax{settings_.cpu_relax_iterations, &scope};
+    for (const auto& row : rows) {
+      timings.parse_failures += ParseResults(row, values, relax);
+    }
+    scope.Reset();
+    if (!producer.Push(std::move(values))) return;
+  }
+  timings.parse += scope.DurationTotal(std::string{kParseStage});
+}
+
+template <typename PostgreCachePolicy>
+void ShardedFullUpdate<PostgreCachePolicy>::StoreValues(
+    typename ValuesQueue::Consumer consumer, DataType& data,
+    tracing::ScopeTime& scope,
+    cache::UpdateStatisticsScope& stats_scope) const {
+  // The queue is over when all the parsing tasks are finished
+  std::vector<ValueType> values;
+  while (consumer.Pop(values)) {
+    scope.Reset(std::string{kParseStage});
+    utils::CpuRelax relax{settings_.cpu_relax_iterations, &scope};
+    for (auto& value : values) {
+      relax.Relax();
+      try {
+        auto key = std::invoke(PostgreCachePolicy::kKeyMember, value);
+        data.insert_or_assign(std::move(key), std::move(value));
+      } catch (const std::exception& e) {
+        stats_scope.IncreaseDocumentsParseFailures(1);
+        LOG_ERROR() << "Error storing data row in cache '"
+                    << PostgreCachePolicy::kName << "' as '"
+                    << compiler::GetTypeName<ValueType>() << "': " << e.what();
+      }
+    }
+    scope.Reset(std::string{kFetchStage});
+  }
+}
+
+template <typename PostgreCachePolicy>
+std::size_t ShardedFullUpdate<PostgreCachePolicy>::ParseResults(
+    const storages::postgres::ResultSet& res, std::vector<ValueType>& values,
+    utils::CpuRelax& relax) const {
+  std::size_t failures = 0;
+  auto rows = res.AsSetOf<RawValueType>(storages::postgres::kRowTag);
+  for (auto p = rows.begin(); p != rows.end(); ++p) {
+    relax.Relax();
+    try {
+      values.push_back(ExtractValue<PostgreCachePolicy>(*p));
+    } catch (const std::exception& e) {
+      ++failures;
+      LOG_ERROR() << "Error parsing data row in cache '"
+                  << PostgreCachePolicy::kName << "' to '"
+                  << compiler::GetTypeName<ValueType>() << "': " << e.what();
+    }
+  }
+  return failures;
+}
+
 }  // namespace pg_cache::detail
 
 /// @ingroup userver_components
@@ -405,6 +710,10 @@ class PostgreCache final
   void CacheResults(storages::postgres::ResultSet res, CachedData& data_cache,
                     cache::UpdateStatisticsScope& stats_scope,
                     tracing::ScopeTime& scope);
+  void CacheResults(const storages::postgres::ResultSet& res,
+                    CachedData& data_cache,
+                    cache::UpdateStatisticsScope& stats_scope,
+                    utils::CpuRelax& relax);
 
   static storages::postgres::Query GetAllQuery();
   static storages::postgres::Query GetDeltaQuery();
@@ -418,8 +727,13 @@ class PostgreCache final
   const std::chrono::milliseconds full_update_timeout_;
   const std::chrono::milliseconds incremental_update_timeout_;
   const std::size_t chunk_size_;
+  const std::size_t full_update_shards_;
+  engine::TaskProcessor* parse_task_processor_{nullptr};
   std::size_t cpu_relax_iterations_parse_{0};
   std::size_t cpu_relax_iterations_copy_{0};
+
+  pg_cache::detail::FullUpdateShardsStatistics shards_statistics_;
+  utils::statistics::Entry statistics_holder_;
 };
 
 template <typename PostgreCachePolicy>
@@ -437,7 +751,9 @@ PostgreCache<PostgreCachePolicy>::PostgreCache(const ComponentConfig& config,
           config["incremental-update-op-timeout"].As<std::chrono::milliseconds>(
               pg_cache::detail::kDefaultIncrementalUpdateTimeout)},
       chunk_size_{config["chunk-size"].As<size_t>(
-          pg_cache::detail::kDefaultChunkSize)} {
+          pg_cache::detail::kDefaultChunkSize)},
+      full_update_shards_{config["full-update-shards"].As<std::size_t>(1)},
+      shards_statistics_{full_update_shards_} {
   if (this->GetAllowedUpdateTypes() ==
           cache::AllowedUpdateTypes::kFullAndIncremental &&
       !kIncrementalUpdates) {
@@ -452,6 +768,23 @@ PostgreCache<PostgreCachePolicy>::PostgreCache(const ComponentConfig& config,
         "config for '" +
         config.Name() + "' cache");
   }
+  if (full_update_shards_ == 0) {
+    throw std::logic_error("Zero full update shards requested in config for '" +
+                           config.Name() + "' cache");
+  }
+  if (full_update_shards_ > 1 &&
+      !pg_cache::detail::kHasFullUpdateShardKey<PostgreCachePolicy>) {
+    throw std::logic_error(
+        "Full update sharding is requested in config but no shard key is "
+        "specified in traits of '" +
+        config.Name() + "' cache");
+  }
+
+  const auto parse_task_processor =
+      config["full-update-parse-task-processor"].As<std::string>("");
+  parse_task_processor_ = parse_task_processor.empty()
+                              ? &this->GetCacheTaskProcessor()
+                              : &context.GetTaskProcessor(parse_task_processor);
 
   const auto pg_alias = config["pgcomponent"].As<std::string>("");
   if (pg_alias.empty()) {
@@ -469,12 +802,24 @@ PostgreCache<PostgreCachePolicy>::PostgreCache(const ComponentConfig& config,
              << GetAllQuery().Statement() << "` incremental update query `"
              << GetDeltaQuery().Statement() << "`";
 
+  if (full_update_shards_ > 1) {
+    statistics_holder_ =
+        context.FindComponent<components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterExtender(
+                fmt::format("cache.{}.full-update-shards", this->Name()),
+                [this](auto&) {
+                  return shards_statistics_.ExtendStatistics();
+                });
+  }
+
   this->StartPeriodicUpdates();
 }
 
 template <typename PostgreCachePolicy>
 PostgreCache<PostgreCachePolicy>::~PostgreCache() {
   this->StopPeriodicUpdates();
+  statistics_holder_.Unregister();
 }
 
 template <typename PostgreCachePolicy>
@@ -556,27 +901,58 @@ void PostgreCache<PostgreCachePolicy>::Update(
 
   scope.Reset(std::string{pg_cache::detail::kFetchStage});
 
+  const bool sharded =
+      type == cache::UpdateType::kFull && full_update_shards_ > 1;
+  std::vector<pg_cache::detail::ShardTimings> shard_timings(
+      sharded ? full_update_shards_ : 0);
+
   size_t changes = 0;
   // Iterate clusters
   for (auto& cluster : clusters_) {
+    if constexpr (pg_cache::detail::kHasFullUpdateShardKey<PolicyType>) {
+      if (sharded) {
+        const pg_cache::detail::ShardedFullUpdate<PolicyType> sharded_update{
+            {full_update_shards_, chunk_size_, timeout, parse_task_processor_,
+             cpu_relax_iterations_parse_}};
+        const auto documents = sharded_update.Run(*cluster, *data_cache, scope,
+                                                  stats_scope, shard_timings);
+        stats_scope.IncreaseDocumentsReadCount(documents);
+        changes += documents;
+        continue;
+      }
+    }
+
+    bool has_parameter = query.Statement().find('$') != std::string::npos;
     if (chunk_size_ > 0) {
-      auto trx = cluster->Begin(
-          kClusterHostTypeFlags, pg::Transaction::RO,
-          pg::CommandControl{timeout, pg_cache::detail::kStatementTimeoutOff});
-      auto portal =
-          trx.MakePortal(query, GetLastUpdated(last_update, *data_cache));
-      while (portal) {
+      // The rows are parsed as they arrive, only a chunk of them is kept in
+      // memory besides the cache
+      const pg::CommandControl cmd_ctl{timeout,
+                                       pg_cache::detail::kStatementTimeoutOff};
+      auto stream =
+          has_parameter
+              ? cluster->Stream(kClusterHostTypeFlags, cmd_ctl, query,
+                                GetLastUpdated(last_update, *data_cache))
+              : cluster->Stream(kClusterHostTypeFlags, cmd_ctl, query);
+      std::vector<pg::ResultSet> rows;
+      rows.reserve(chunk_size_);
+      while (!stream.Done()) {
         scope.Reset(std::string{pg_cache::detail::kFetchStage});
-        auto res = portal.Fetch(chunk_size_);
-        stats_scope.IncreaseDocumentsReadCount(res.Size());
+        rows.clear();
+        while (rows.size() < chunk_size_) {
+          auto row = stream.NextRow();
+          if (!row) break;
+          rows.push_back(std::move(*row));
+        }
+        stats_scope.IncreaseDocumentsReadCount(rows.size());
 
         scope.Reset(std::string{pg_cache::detail::kParseStage});
-        CacheResults(res, data_cache, stats_scope, scope);
-        changes += res.Size();
+        utils::CpuRelax relax{cpu_relax_iterations_parse_, &scope};
+        for (const auto& row : rows) {
+          CacheResults(row, data_cache, stats_scope, relax);
+        }
+        changes += rows.size();
       }
-      trx.Commit();
     } else {
-      bool has_parameter = query.Statement().find('$') != std::string::npos;
       auto res = has_parameter
                      ? cluster->Execute(
                            kClusterHostTypeFlags,
@@ -598,6 +974,13 @@ void PostgreCache<PostgreCachePolicy>::Update(
 
   scope.Reset();
 
+  if (sharded) {
+    for (const auto& timings : shard_timings) {
+      stats_scope.IncreaseDocumentsParseFailures(timings.parse_failures);
+    }
+    shards_statistics_.Store(shard_timings);
+  }
+
   if constexpr (pg_cache::detail::kIsContainerCopiedByElement<DataType>) {
     if (old_size > 0) {
       const auto elapsed_copy =
@@ -646,8 +1029,15 @@ template <typename PostgreCachePolicy>
 void PostgreCache<PostgreCachePolicy>::CacheResults(
     storages::postgres::ResultSet res, CachedData& data_cache,
     cache::UpdateStatisticsScope& stats_scope, tracing::ScopeTime& scope) {
-  auto values = res.AsSetOf<RawValueType>(storages::postgres::kRowTag);
   utils::CpuRelax relax{cpu_relax_iterations_parse_, &scope};
+  CacheResults(res, data_cache, stats_scope, relax);
+}
+
+template <typename PostgreCachePolicy>
+void PostgreCache<PostgreCachePolicy>::CacheResults(
+    const storages::postgres::ResultSet& res, CachedData& data_cache,
+    cache::UpdateStatisticsScope& stats_scope, utils::CpuRelax& relax) {
+  auto values = res.AsSetOf<RawValueType>(storages::postgres::kRowTag);
   for (auto p = values.begin(); p != values.end(); ++p) {
     relax.Relax();
     try {
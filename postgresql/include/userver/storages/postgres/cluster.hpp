@@ -189,6 +189,38 @@ class Cluster {
   ResultSet Execute(ClusterHostTypeFlags flags,
                     OptionalCommandControl statement_cmd_ctl,
                     const Query& query, const ParameterStore& store);
+
+  /// @brief Execute a statement with specified host selection rules and
+  /// return a stream to receive the rows of its result one by one, see
+  /// ResultStream.
+  /// @note You must specify at least one role from ClusterHostType here
+  ///
+  /// The statement runs on a connection of its own, even if the statements
+  /// are pipelined, and the connection goes back to the pool as soon as the
+  /// stream is done or destroyed.
+  template <typename... Args>
+  ResultStream Stream(ClusterHostTypeFlags, const Query& query,
+                      const Args&... args);
+
+  /// @brief Execute a statement with specified host selection rules and
+  /// command control settings and return a stream to receive the rows of its
+  /// result.
+  /// @note You must specify at least one role from ClusterHostType here
+  template <typename... Args>
+  ResultStream Stream(ClusterHostTypeFlags, OptionalCommandControl,
+                      const Query& query, const Args&... args);
+
+  /// @brief Execute a statement with stored arguments and specified host
+  /// selection rules and return a stream to receive the rows of its result.
+  ResultStream Stream(ClusterHostTypeFlags flags, const Query& query,
+                      const ParameterStore& store);
+
+  /// @brief Execute a statement with stored arguments, specified host
+  /// selection rules and command control settings and return a stream to
+  /// receive the rows of its result.
+  ResultStream Stream(ClusterHostTypeFlags flags,
+                      OptionalCommandControl statement_cmd_ctl,
+                      const Query& query, const ParameterStore& store);
   /// @}
 
   /// Replaces globally updated command control with a static user-provided one
@@ -223,6 +255,8 @@ class Cluster {
 
  private:
   detail::NonTransaction Start(ClusterHostTypeFlags, OptionalCommandControl);
+  detail::NonTransaction StartDedicated(ClusterHostTypeFlags,
+                                        OptionalCommandControl);
 
   OptionalCommandControl GetQueryCmdCtl(const std::string& query_name) const;
   OptionalCommandControl GetHandlersCmdCtl(
@@ -249,6 +283,24 @@ ResultSet Cluster::Execute(ClusterHostTypeFlags flags,
   return ntrx.Execute(statement_cmd_ctl, query, args...);
 }
 
+template <typename... Args>
+ResultStream Cluster::Stream(ClusterHostTypeFlags flags, const Query& query,
+                             const Args&... args) {
+  return Stream(flags, OptionalCommandControl{}, query, args...);
+}
+
+template <typename... Args>
+ResultStream Cluster::Stream(ClusterHostTypeFlags flags,
+                             OptionalCommandControl statement_cmd_ctl,
+                             const Query& query, const Args&... args) {
+  if (!statement_cmd_ctl && query.GetName()) {
+    statement_cmd_ctl = GetQueryCmdCtl(query.GetName()->GetUnderlying());
+  }
+  statement_cmd_ctl = GetHandlersCmdCtl(statement_cmd_ctl);
+  auto ntrx = StartDedicated(flags, statement_cmd_ctl);
+  return ntrx.Stream(statement_cmd_ctl, query, args...);
+}
+
 }  // namespace storages::postgres
 
 USERVER_NAMESPACE_END
@@ -129,6 +129,7 @@ namespace components {
 /// max_pool_size           | maximum number of created connections                     | 15
 /// max_queue_size          | maximum number of clients waiting for a connection        | 200
 /// connecting_limit        | limit for concurrent establishing connections number per pool (0 - unlimited) | 0
+/// pipeline_connections    | number of connections that execute single statements of different tasks together in pipeline mode (0 - disabled) | 0
 
 // clang-format on
 
@@ -0,0 +1,185 @@
+#pragma once
+
+/// @file userver/storages/postgres/copy.hpp
+/// @brief Streaming of rows with COPY statements in binary format
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <userver/storages/postgres/exceptions.hpp>
+#include <userver/storages/postgres/io/field_buffer.hpp>
+#include <userver/storages/postgres/io/row_types.hpp>
+#include <userver/storages/postgres/io/supported_types.hpp>
+#include <userver/storages/postgres/io/user_types.hpp>
+#include <userver/storages/postgres/options.hpp>
+#include <userver/storages/postgres/postgres_fwd.hpp>
+#include <userver/storages/postgres/query.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres {
+
+/// @brief Stream of rows for a `COPY ... FROM STDIN (FORMAT binary)`
+/// statement, see Transaction::CopyIn.
+///
+/// Rows are formatted with the same io formatters as the query parameters,
+/// the types of the C++ values must match the types of the table columns
+/// exactly, as binary COPY does no type conversion. Rows are sent to the
+/// server in chunks, a write waits while the server does not keep up.
+///
+/// The rows are not committed until Finish() is called, a stream that is
+/// destroyed unfinished aborts the statement and so fails the transaction.
+class CopyInStream {
+ public:
+  /// @cond
+  CopyInStream(detail::Connection* conn, const Query& query,
+               OptionalCommandControl cmd_ctl);
+  /// @endcond
+
+  CopyInStream(CopyInStream&&) noexcept;
+  CopyInStream& operator=(CopyInStream&&) noexcept;
+
+  CopyInStream(const CopyInStream&) = delete;
+  CopyInStream& operator=(const CopyInStream&) = delete;
+
+  ~CopyInStream();
+
+  /// Write a row with a field per value
+  template <typename... T>
+  void Write(const T&... values);
+
+  /// Write a row with a field per member of a row type
+  template <typename T>
+  void WriteRow(const T& row);
+
+  /// Send the rest of the rows and complete the statement
+  /// @returns count of the copied rows
+  /// @throws CommandError and its descendants if the server rejected the data
+  std::size_t Finish();
+
+  bool IsFinished() const { return conn_ == nullptr; }
+
+ private:
+  static constexpr std::size_t kChunkSize = 64 * 1024;
+
+  void CheckActive() const;
+  void SendBuffer();
+
+  detail::Connection* conn_;
+  Query query_;
+  OptionalCommandControl cmd_ctl_;
+  const UserTypes* types_;
+  std::string buffer_;
+};
+
+/// @brief Stream of rows of a `COPY ... TO STDOUT (FORMAT binary)` statement,
+/// see Transaction::CopyOut.
+///
+/// Fields are parsed with the same io parsers as the fields of a ResultSet,
+/// the types of the C++ values must match the types of the columns exactly.
+/// Rows are received one by one, so the whole result never has to fit in
+/// memory.
+///
+/// A stream that is destroyed before reading all the rows cancels the
+/// statement and so fails the transaction.
+class CopyOutStream {
+ public:
+  /// @cond
+  CopyOutStream(detail::Connection* conn, const Query& query,
+                OptionalCommandControl cmd_ctl);
+  /// @endcond
+
+  CopyOutStream(CopyOutStream&&) noexcept;
+  CopyOutStream& operator=(CopyOutStream&&) noexcept;
+
+  CopyOutStream(const CopyOutStream&) = delete;
+  CopyOutStream& operator=(const CopyOutStream&) = delete;
+
+  ~CopyOutStream();
+
+  /// Read the next row into a value per field
+  /// @returns false if there are no more rows
+  /// @throws InvalidTupleSizeRequested if the count of the fields differs
+  template <typename... T>
+  bool Read(T&... values);
+
+  /// Read the next row into the members of a row type
+  /// @returns false if there are no more rows
+  template <typename T>
+  bool ReadRow(T& row);
+
+  bool Done() const { return conn_ == nullptr; }
+
+ private:
+  bool FetchRow();
+
+  template <typename T>
+  void ReadField(std::size_t index, T& value) const;
+
+  detail::Connection* conn_;
+  Query query_;
+  OptionalCommandControl cmd_ctl_;
+  const io::TypeBufferCategory* categories_;
+  bool header_read_{false};
+  std::vector<io::FieldBuffer> fields_;
+};
+
+template <typename... T>
+void CopyInStream::Write(const T&... values) {
+  CheckActive();
+  io::WriteBuffer(*types_, buffer_, static_cast<Smallint>(sizeof...(T)));
+  (io::WriteRawBinary(*types_, buffer_, values), ...);
+  if (buffer_.size() >= kChunkSize) {
+    SendBuffer();
+  }
+}
+
+template <typename T>
+void CopyInStream::WriteRow(const T& row) {
+  static_assert(io::traits::kIsRowType<T>,
+                "WriteRow requires a row type, use Write for single values");
+  std::apply([this](const auto&... fields) { Write(fields...); },
+             io::RowType<T>::GetTuple(row));
+}
+
+template <typename... T>
+bool CopyOutStream::Read(T&... values) {
+  if (!FetchRow()) {
+    return false;
+  }
+  if (fields_.size() != sizeof...(T)) {
+    throw InvalidTupleSizeRequested{fields_.size(), sizeof...(T)};
+  }
+  std::size_t index = 0;
+  (ReadField(index++, values), ...);
+  return true;
+}
+
+template <typename T>
+bool CopyOutStream::ReadRow(T& row) {
+  static_assert(io::traits::kIsRowType<T>,
+                "ReadRow requires a row type, use Read for single values");
+  return std::apply([this](auto&... fields) { return Read(fields...); },
+                    io::RowType<T>::GetTuple(row));
+}
+
+template <typename T>
+void CopyOutStream::ReadField(std::size_t index, T& value) const {
+  auto buffer = fields_[index];
+  if (buffer.is_null) {
+    if constexpr (io::traits::kIsNullable<T>) {
+      io::traits::GetSetNull<T>::SetNull(value);
+      return;
+    } else {
+      throw FieldValueIsNull{index, {}, value};
+    }
+  }
+  buffer.category = io::traits::kTypeBufferCategory<T>;
+  io::ReadBuffer(buffer, value, *categories_);
+}
+
+}  // namespace storages::postgres
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <userver/storages/postgres/options.hpp>
@@ -7,6 +8,7 @@
 #include <userver/storages/postgres/postgres_fwd.hpp>
 #include <userver/storages/postgres/query.hpp>
 #include <userver/storages/postgres/result_set.hpp>
+#include <userver/storages/postgres/result_stream.hpp>
 
 #include <userver/storages/postgres/detail/connection_ptr.hpp>
 #include <userver/storages/postgres/detail/query_parameters.hpp>
@@ -16,12 +18,19 @@ USERVER_NAMESPACE_BEGIN
 
 namespace storages::postgres::detail {
 
+class ConnectionPool;
+
 class NonTransaction {
  public:
   explicit NonTransaction(
       ConnectionPtr&& conn,
       SteadyClock::time_point start_time = detail::SteadyClock::now());
 
+  /// Statements are executed together with the statements of other tasks on
+  /// the pipelined connections of the pool
+  NonTransaction(std::shared_ptr<ConnectionPool> pool,
+                 std::shared_ptr<const UserTypes> user_types);
+
   NonTransaction(NonTransaction&&) noexcept;
   NonTransaction& operator=(NonTransaction&&) noexcept;
 
@@ -64,13 +73,35 @@ class NonTransaction {
   /// Suspends coroutine for execution.
   ResultSet Execute(OptionalCommandControl statement_cmd_ctl,
                     const std::string& statement, const ParameterStore& store);
+
+  /// Execute statement and return a stream to receive the rows of its
+  /// result, the stream takes the connection over.
+  ///
+  /// Requires a connection of its own, see ConnectionPool::StartDedicated.
+  template <typename... Args>
+  ResultStream Stream(OptionalCommandControl statement_cmd_ctl,
+                      const Query& query, const Args&... args) {
+    detail::StaticQueryParameters<sizeof...(args)> params;
+    params.Write(GetConnectionUserTypes(), args...);
+    return DoStream(query, detail::QueryParameters{params}, statement_cmd_ctl);
+  }
+
+  /// Execute statement with stored arguments and return a stream to receive
+  /// the rows of its result, the stream takes the connection over.
+  ResultStream Stream(OptionalCommandControl statement_cmd_ctl,
+                      const Query& query, const ParameterStore& store);
   /// @}
  private:
   ResultSet DoExecute(const Query& query, const detail::QueryParameters& params,
                       OptionalCommandControl statement_cmd_ctl);
+  ResultStream DoStream(const Query& query,
+                        const detail::QueryParameters& params,
+                        OptionalCommandControl statement_cmd_ctl);
   const UserTypes& GetConnectionUserTypes() const;
 
   detail::ConnectionPtr conn_;
+  std::shared_ptr<ConnectionPool> pool_;
+  std::shared_ptr<const UserTypes> user_types_;
 };
 
 }  // namespace storages::postgres::detail
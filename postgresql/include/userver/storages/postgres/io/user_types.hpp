@@ -91,6 +91,9 @@ class UserTypes {
 
   void Reset();
 
+  /// Make a copy of the types, the lookup indexes are rebuilt for the copy
+  UserTypes Clone() const;
+
   Oid FindOid(DBTypeName) const;
   Oid FindArrayOid(DBTypeName) const;
   /// Find element type oid for an array type.
@@ -181,10 +181,15 @@ struct PoolSettings {
   /// Limits number of concurrent establishing connections (0 - unlimited)
   size_t connecting_limit{kDefaultConnectingLimit};
 
+  /// Number of connections that execute single statements of different tasks
+  /// together in pipeline mode (0 - disabled)
+  size_t pipeline_connections{0};
+
   bool operator==(const PoolSettings& rhs) const {
     return min_size == rhs.min_size && max_size == rhs.max_size &&
            max_queue_size == rhs.max_queue_size &&
-           connecting_limit == rhs.connecting_limit;
+           connecting_limit == rhs.connecting_limit &&
+           pipeline_connections == rhs.pipeline_connections;
   }
 };
 
@@ -0,0 +1,180 @@
+#pragma once
+
+/// @file userver/storages/postgres/result_stream.hpp
+/// @brief Streaming of the rows of a statement result
+
+#include <cstddef>
+#include <optional>
+
+#include <userver/storages/postgres/detail/connection_ptr.hpp>
+#include <userver/storages/postgres/detail/query_parameters.hpp>
+#include <userver/storages/postgres/io/type_traits.hpp>
+#include <userver/storages/postgres/options.hpp>
+#include <userver/storages/postgres/postgres_fwd.hpp>
+#include <userver/storages/postgres/query.hpp>
+#include <userver/storages/postgres/result_set.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres {
+
+/// @brief Rows of a statement result received one by one, see
+/// Transaction::Stream and Cluster::Stream.
+///
+/// The rows are sent by the server without waiting for the client, as for
+/// Transaction::Execute, but are parsed and handed out one at a time, so
+/// the whole result never has to fit in memory. Unlike a Portal, there is
+/// no cursor on the server and no roundtrip per chunk of rows.
+///
+/// The rows are converted with the same io parsers and tags as the rows of
+/// a ResultSet. User types can't be reloaded while the rows are streamed, so
+/// a user type created after the connection has loaded the types can't be
+/// read from a statement that is not prepared.
+///
+/// The execute timeout of the command control limits waiting for every row,
+/// the statement timeout limits the whole statement. A stream that is
+/// destroyed before reading all the rows cancels the statement, and so fails
+/// the transaction it belongs to.
+///
+/// ## Usage synopsis
+/// ```
+/// auto trx = ...;
+/// auto stream = trx.Stream("select id, name from table");
+/// while (auto row = stream.Next<MyRowType>(kRowTag)) {
+///   // Process *row
+/// }
+/// ```
+class ResultStream {
+ public:
+  /// @cond
+  ResultStream(detail::Connection* conn, const Query& query,
+               const detail::QueryParameters& params,
+               OptionalCommandControl cmd_ctl);
+  /// The stream returns the connection to the pool as soon as it is done
+  ResultStream(detail::ConnectionPtr&& conn, const Query& query,
+               const detail::QueryParameters& params,
+               OptionalCommandControl cmd_ctl);
+  /// @endcond
+
+  ResultStream(ResultStream&&) noexcept;
+  ResultStream& operator=(ResultStream&&) noexcept;
+
+  ResultStream(const ResultStream&) = delete;
+  ResultStream& operator=(const ResultStream&) = delete;
+
+  ~ResultStream();
+
+  /// Receive the next row
+  /// @returns a result set with a single row, std::nullopt if there are no
+  /// more rows
+  /// @throws CommandError and its descendants if the statement failed, the
+  /// stream is done then
+  std::optional<ResultSet> NextRow();
+
+  /// @brief Receive the next row and convert it as ResultSet::AsSingleRow
+  /// does.
+  /// @returns std::nullopt if there are no more rows
+  template <typename T>
+  std::optional<T> Next();
+  template <typename T>
+  std::optional<T> Next(RowTag);
+  template <typename T>
+  std::optional<T> Next(FieldTag);
+
+  /// @brief Receive up to `max_rows` next rows and append them to the
+  /// container, converted as ResultSet::AsContainer does.
+  /// @returns count of the received rows, less than `max_rows` only if the
+  /// rows are over
+  template <typename Container>
+  std::size_t ReadChunk(Container& rows, std::size_t max_rows);
+  template <typename Container>
+  std::size_t ReadChunk(Container& rows, std::size_t max_rows, RowTag);
+
+  /// Receive the rest of the rows into a container
+  template <typename Container>
+  Container AsContainer();
+  template <typename Container>
+  Container AsContainer(RowTag);
+
+  bool Done() const { return conn_ == nullptr; }
+
+ private:
+  void Finish();
+
+  template <typename T, typename... Tag>
+  std::optional<T> DoNext(Tag... tag);
+
+  template <typename Container, typename... Tag>
+  std::size_t DoReadChunk(Container& rows, std::size_t max_rows, Tag... tag);
+
+  detail::Connection* conn_;
+  detail::ConnectionPtr owned_conn_;
+  Query query_;
+  OptionalCommandControl cmd_ctl_;
+};
+
+template <typename T>
+std::optional<T> ResultStream::Next() {
+  return DoNext<T>();
+}
+
+template <typename T>
+std::optional<T> ResultStream::Next(RowTag) {
+  return DoNext<T>(kRowTag);
+}
+
+template <typename T>
+std::optional<T> ResultStream::Next(FieldTag) {
+  return DoNext<T>(kFieldTag);
+}
+
+template <typename Container>
+std::size_t ResultStream::ReadChunk(Container& rows, std::size_t max_rows) {
+  return DoReadChunk(rows, max_rows);
+}
+
+template <typename Container>
+std::size_t ResultStream::ReadChunk(Container& rows, std::size_t max_rows,
+                                    RowTag) {
+  return DoReadChunk(rows, max_rows, kRowTag);
+}
+
+template <typename Container>
+Container ResultStream::AsContainer() {
+  Container rows;
+  DoReadChunk(rows, ResultSet::npos);
+  return rows;
+}
+
+template <typename Container>
+Container ResultStream::AsContainer(RowTag) {
+  Container rows;
+  DoReadChunk(rows, ResultSet::npos, kRowTag);
+  return rows;
+}
+
+template <typename T, typename... Tag>
+std::optional<T> ResultStream::DoNext(Tag... tag) {
+  auto row = NextRow();
+  if (!row) return std::nullopt;
+  return row->template AsSingleRow<T>(tag...);
+}
+
+template <typename Container, typename... Tag>
+std::size_t ResultStream::DoReadChunk(Container& rows, std::size_t max_rows,
+                                      Tag... tag) {
+  using ValueType = typename Container::value_type;
+  auto inserter = io::traits::Inserter(rows);
+  std::size_t count = 0;
+  for (; count < max_rows; ++count) {
+    auto row = NextRow();
+    if (!row) break;
+    *inserter = row->template AsSingleRow<ValueType>(tag...);
+    ++inserter;
+  }
+  return count;
+}
+
+}  // namespace storages::postgres
+
+USERVER_NAMESPACE_END
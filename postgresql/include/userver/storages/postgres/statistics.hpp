@@ -116,6 +116,9 @@ struct InstanceStatisticsTemplate {
   PercentileAccumulator connection_percentile;
   /// Acquire connection percentile
   PercentileAccumulator acquire_percentile;
+  /// Time spent in the wait queue by the requests that found no idle
+  /// connection
+  PercentileAccumulator wait_percentile;
 };
 
 using Percentile = USERVER_NAMESPACE::utils::statistics::Percentile<2048>;
@@ -187,6 +190,7 @@ struct InstanceStatisticsNonatomic : InstanceStatisticsNonatomicBase {
     queue_size_errors = stats.queue_size_errors;
     connection_percentile = stats.connection_percentile.GetStatsForPeriod();
     acquire_percentile = stats.acquire_percentile.GetStatsForPeriod();
+    wait_percentile = stats.wait_percentile.GetStatsForPeriod();
 
     return *this;
   }
@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 
+#include <userver/storages/postgres/copy.hpp>
 #include <userver/storages/postgres/detail/connection_ptr.hpp>
 #include <userver/storages/postgres/detail/query_parameters.hpp>
 #include <userver/storages/postgres/detail/time_types.hpp>
@@ -15,6 +16,7 @@
 #include <userver/storages/postgres/postgres_fwd.hpp>
 #include <userver/storages/postgres/query.hpp>
 #include <userver/storages/postgres/result_set.hpp>
+#include <userver/storages/postgres/result_stream.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -257,6 +259,84 @@ class Transaction {
   Portal MakePortal(OptionalCommandControl statement_cmd_ctl,
                     const Query& query, const ParameterStore& store);
 
+  /// Start a `COPY table FROM STDIN (FORMAT binary)` statement and return
+  /// a stream to write the rows with.
+  ///
+  /// The execute timeout of the command control limits every network
+  /// operation of the stream, the statement timeout limits the whole COPY.
+  /// The stream must be finished or destroyed before any other statement of
+  /// the transaction and must not outlive the transaction.
+  CopyInStream CopyIn(const Query& query) {
+    return CopyIn(OptionalCommandControl{}, query);
+  }
+
+  /// Start a `COPY table FROM STDIN (FORMAT binary)` statement with
+  /// per-statement command control.
+  CopyInStream CopyIn(OptionalCommandControl statement_cmd_ctl,
+                      const Query& query);
+
+  /// Copy the rows of a container with a `COPY table FROM STDIN
+  /// (FORMAT binary)` statement. The elements of the container are either row
+  /// types with a field per column or single values for a single column.
+  /// @returns count of the copied rows
+  template <typename Container>
+  std::size_t CopyIn(const Query& query, const Container& rows) {
+    return CopyIn(OptionalCommandControl{}, query, rows);
+  }
+
+  /// Copy the rows of a container with a `COPY table FROM STDIN
+  /// (FORMAT binary)` statement and per-statement command control.
+  /// @returns count of the copied rows
+  template <typename Container>
+  std::size_t CopyIn(OptionalCommandControl statement_cmd_ctl,
+                     const Query& query, const Container& rows);
+
+  /// Start a `COPY ... TO STDOUT (FORMAT binary)` statement and return
+  /// a stream to read the rows from.
+  ///
+  /// Unlike a Portal, the rows are streamed by the server without
+  /// a roundtrip per chunk. The timeouts and the lifetime of the stream are
+  /// the same as for CopyIn.
+  CopyOutStream CopyOut(const Query& query) {
+    return CopyOut(OptionalCommandControl{}, query);
+  }
+
+  /// Start a `COPY ... TO STDOUT (FORMAT binary)` statement with
+  /// per-statement command control.
+  CopyOutStream CopyOut(OptionalCommandControl statement_cmd_ctl,
+                        const Query& query);
+
+  /// Execute a statement with arbitrary parameters and return a stream to
+  /// receive the rows of its result one by one, see ResultStream.
+  ///
+  /// The stream must be done or destroyed before any other statement of the
+  /// transaction and must not outlive the transaction.
+  template <typename... Args>
+  ResultStream Stream(const Query& query, const Args&... args) {
+    return Stream(OptionalCommandControl{}, query, args...);
+  }
+
+  /// Execute a statement with arbitrary parameters and per-statement command
+  /// control and return a stream to receive the rows of its result.
+  template <typename... Args>
+  ResultStream Stream(OptionalCommandControl statement_cmd_ctl,
+                      const Query& query, const Args&... args) {
+    detail::StaticQueryParameters<sizeof...(args)> params;
+    params.Write(GetConnectionUserTypes(), args...);
+    return DoStream(query, detail::QueryParameters{params}, statement_cmd_ctl);
+  }
+
+  /// Execute a statement with stored parameters and return a stream to
+  /// receive the rows of its result.
+  ResultStream Stream(const Query& query, const ParameterStore& store) {
+    return Stream(OptionalCommandControl{}, query, store);
+  }
+
+  /// Execute a statement with stored parameters and per-statement command
+  /// control and return a stream to receive the rows of its result.
+  ResultStream Stream(OptionalCommandControl statement_cmd_ctl,
+                      const Query& query, const ParameterStore& store);
+
   /// Set a connection parameter
   /// https://www.postgresql.org/docs/current/sql-set.html
   /// The parameter is set for this transaction only
@@ -285,6 +365,10 @@ class Transaction {
                     const detail::QueryParameters& params,
                     OptionalCommandControl statement_cmd_ctl);
 
+  ResultStream DoStream(const Query& query,
+                        const detail::QueryParameters& params,
+                        OptionalCommandControl statement_cmd_ctl);
+
   const UserTypes& GetConnectionUserTypes() const;
 
   detail::ConnectionPtr conn_;
@@ -309,6 +393,21 @@ void Transaction::ExecuteBulk(OptionalCommandControl statement_cmd_ctl,
   }
 }
 
+template <typename Container>
+std::size_t Transaction::CopyIn(OptionalCommandControl statement_cmd_ctl,
+                                const Query& query, const Container& rows) {
+  auto stream = CopyIn(std::move(statement_cmd_ctl), query);
+  for (const auto& row : rows) {
+    using RowType = std::decay_t<decltype(row)>;
+    if constexpr (io::traits::kIsRowType<RowType>) {
+      stream.WriteRow(row);
+    } else {
+      stream.Write(row);
+    }
+  }
+  return stream.Finish();
+}
+
 }  // namespace storages::postgres
 
 USERVER_NAMESPACE_END
@@ -1,10 +1,51 @@
 #include <userver/cache/base_postgres_cache.hpp>
 
+#include <string>
+
+#include <userver/utils/statistics/metadata.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
-namespace components::impl {
+namespace components {
+
+namespace pg_cache::detail {
+
+FullUpdateShardsStatistics::FullUpdateShardsStatistics(std::size_t shards)
+    : shards_(shards) {}
+
+void FullUpdateShardsStatistics::Store(
+    const std::vector<ShardTimings>& timings) {
+  UASSERT(timings.size() == shards_.size());
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    shards_[i].fetch_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(timings[i].fetch)
+            .count();
+    shards_[i].parse_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(timings[i].parse)
+            .count();
+    shards_[i].documents = timings[i].documents;
+    shards_[i].parse_failures = timings[i].parse_failures;
+  }
+}
+
+formats::json::ValueBuilder FullUpdateShardsStatistics::ExtendStatistics()
+    const {
+  formats::json::ValueBuilder result(formats::json::Type::kObject);
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    auto shard = result[std::to_string(i)];
+    shard["fetch-time-ms"] = shards_[i].fetch_ms.load();
+    shard["parse-time-ms"] = shards_[i].parse_ms.load();
+    shard["documents"]["read_count"] = shards_[i].documents.load();
+    shard["documents"]["parse_failures"] = shards_[i].parse_failures.load();
+  }
+  utils::statistics::SolomonChildrenAreLabelValues(result, "pg_cache_shard");
+  return result;
+}
+
+}  // namespace pg_cache::detail
+
+namespace impl {
 
 std::string GetPostgreCacheSchema() {
   return R"(
@@ -26,8 +67,16 @@ properties:
         defaultDescription: 0 for caches with defined GetLastKnownUpdated
     chunk-size:
         type: integer
-        description: number of rows to request from PostgreSQL, 0 to fetch all rows in one request
+        description: number of rows to parse at once as they are streamed from PostgreSQL, 0 to fetch all rows in one request
         defaultDescription: 1000
+    full-update-shards:
+        type: integer
+        description: number of parts of a full update fetched in parallel, requires kFullUpdateShardKey in the cache policy
+        defaultDescription: 1
+    full-update-parse-task-processor:
+        type: string
+        description: task processor to parse the rows of a sharded full update on
+        defaultDescription: the cache task-processor
     pgcomponent:
         type: string
         description: PostgreSQL component name
@@ -35,6 +84,8 @@ properties:
 )";
 }
 
-}  // namespace components::impl
+}  // namespace impl
+
+}  // namespace components
 
 USERVER_NAMESPACE_END
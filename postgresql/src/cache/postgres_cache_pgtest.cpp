@@ -0,0 +1,141 @@
+#include <storages/postgres/tests/util_pgtest.hpp>
+
+#include <string>
+#include <vector>
+
+#include <userver/cache/base_postgres_cache.hpp>
+#include <userver/cache/cache_statistics.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/storages/postgres/exceptions.hpp>
+#include <userver/tracing/span.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace pg = storages::postgres;
+
+namespace {
+
+constexpr std::size_t kRowCount = 1000;
+constexpr std::size_t kShards = 4;
+
+struct ShardedValue {
+  int id;
+  std::string value;
+
+  bool operator==(const ShardedValue& other) const {
+    return id == other.id && value == other.value;
+  }
+};
+
+struct ShardedPolicy {
+  static constexpr std::string_view kName = "sharded-pg-cache";
+
+  using ValueType = ShardedValue;
+
+  static constexpr auto kKeyMember = &ShardedValue::id;
+
+  static constexpr const char* kQuery =
+      "select id, value from pg_cache_sharded_test";
+  static constexpr const char* kUpdatedField = nullptr;
+  static constexpr auto kClusterHostType = pg::ClusterHostType::kMaster;
+
+  static constexpr const char* kFullUpdateShardKey = "id";
+};
+
+// The division fails for a single row in the middle of one of the shards
+struct FailingShardedPolicy : ShardedPolicy {
+  static constexpr const char* kQuery =
+      "select id, (10 / (id - 500))::text from pg_cache_sharded_test";
+};
+
+template <typename Policy>
+using ShardedUpdate = components::pg_cache::detail::ShardedFullUpdate<Policy>;
+using Timings = std::vector<components::pg_cache::detail::ShardTimings>;
+
+pg::Cluster CreateCluster(const pg::Dsn& dsn,
+                          engine::TaskProcessor& bg_task_processor,
+                          size_t max_size) {
+  return pg::Cluster({dsn}, nullptr, bg_task_processor,
+                     {{},
+                      {utest::kMaxTestWaitTime},
+                      {0, max_size, max_size},
+                      kCachePreparedStatements,
+                      storages::postgres::InitMode::kAsync,
+                      ""},
+                     {kTestCmdCtl, {}, {}}, {}, {});
+}
+
+template <typename Policy>
+typename ShardedUpdate<Policy>::Settings MakeSettings(
+    engine::TaskProcessor& task_processor) {
+  return {kShards, 10, utest::kMaxTestWaitTime, &task_processor, 0};
+}
+
+class PostgreCacheSharded : public PostgreSQLBase {};
+
+}  // namespace
+
+UTEST_F(PostgreCacheSharded, SameAsUnsharded) {
+  auto cluster = CreateCluster(GetDsnFromEnv(), GetTaskProcessor(), kShards);
+  cluster.Execute(pg::ClusterHostType::kMaster,
+                  "drop table if exists pg_cache_sharded_test");
+  cluster.Execute(pg::ClusterHostType::kMaster,
+                  "create table pg_cache_sharded_test(id integer primary key, "
+                  "value text)");
+  cluster.Execute(pg::ClusterHostType::kMaster,
+                  "insert into pg_cache_sharded_test select i, 'value #' || "
+                  "i::text from generate_series(1, $1) i",
+                  static_cast<int>(kRowCount));
+
+  ShardedUpdate<ShardedPolicy>::DataType expected;
+  for (auto& value :
+       cluster.Execute(pg::ClusterHostType::kMaster, ShardedPolicy::kQuery)
+           .AsContainer<std::vector<ShardedValue>>(pg::kRowTag)) {
+    const auto id = value.id;
+    expected.emplace(id, std::move(value));
+  }
+  ASSERT_EQ(kRowCount, expected.size());
+
+  tracing::Span span{"pg_cache_update"};
+  auto scope = span.CreateScopeTime();
+  cache::impl::Statistics stats;
+  cache::UpdateStatisticsScope stats_scope{stats, cache::UpdateType::kFull};
+
+  const ShardedUpdate<ShardedPolicy> update{
+      MakeSettings<ShardedPolicy>(GetTaskProcessor())};
+  ShardedUpdate<ShardedPolicy>::DataType data;
+  Timings timings(kShards);
+  EXPECT_EQ(kRowCount, update.Run(cluster, data, scope, stats_scope, timings));
+  EXPECT_EQ(expected, data);
+
+  // Every call reports its own documents, the timings are summed up
+  EXPECT_EQ(kRowCount, update.Run(cluster, data, scope, stats_scope, timings));
+  EXPECT_EQ(expected, data);
+  std::size_t documents = 0;
+  for (const auto& shard_timings : timings) {
+    EXPECT_LT(0u, shard_timings.documents);
+    EXPECT_EQ(0u, shard_timings.parse_failures);
+    documents += shard_timings.documents;
+  }
+  EXPECT_EQ(2 * kRowCount, documents);
+  EXPECT_EQ(0u, stats.full_update.documents_parse_failures.load());
+
+  const ShardedUpdate<FailingShardedPolicy> failing_update{
+      MakeSettings<FailingShardedPolicy>(GetTaskProcessor())};
+  ShardedUpdate<FailingShardedPolicy>::DataType failing_data;
+  Timings failing_timings(kShards);
+  UEXPECT_THROW(failing_update.Run(cluster, failing_data, scope, stats_scope,
+                                   failing_timings),
+                pg::DataException);
+  // The failure is rethrown as is and the timings of a failed update are
+  // not reported
+  for (const auto& shard_timings : failing_timings) {
+    EXPECT_EQ(0u, shard_timings.documents);
+  }
+
+  stats_scope.Finish(data.size());
+  cluster.Execute(pg::ClusterHostType::kMaster,
+                  "drop table pg_cache_sharded_test");
+}
+
+USERVER_NAMESPACE_END
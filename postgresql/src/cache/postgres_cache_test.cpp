@@ -4,6 +4,8 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <gtest/gtest.h>
+
 #include <userver/components/minimal_server_component_list.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -281,6 +283,45 @@ struct PostgresExamplePolicy6 {
   using CacheContainer = UserSpecificCacheWithWriteNotification;
 };
 
+/*! [Pg Cache Policy Sharded Full Update Example] */
+struct PostgresExamplePolicy7 {
+  static constexpr std::string_view kName = "my-pg-cache";
+
+  using ValueType = MyStructure;
+
+  static constexpr auto kKeyMember = &MyStructure::id;
+
+  static constexpr const char* kQuery =
+      "select id, bar, updated from test.my_data";
+
+  static constexpr const char* kUpdatedField = "updated";
+  using UpdatedFieldType = storages::postgres::TimePointTz;
+
+  // SQL expression to split the rows of a full update by, rows with the same
+  // key must have the same value of the expression
+  static constexpr const char* kFullUpdateShardKey = "id";
+};
+/*! [Pg Cache Policy Sharded Full Update Example] */
+
+struct PostgresExamplePolicy8 {
+  static constexpr std::string_view kName = "my-pg-cache";
+
+  using ValueType = MyStructure;
+
+  static constexpr auto kKeyMember = &MyStructure::id;
+
+  static constexpr const char* kQuery = "select id, bar from test.my_data";
+  static constexpr const char* kWhere = "id > 10";
+
+  static constexpr const char* kUpdatedField = nullptr;
+
+  static constexpr const char* kFullUpdateShardKey = "bar";
+};
+
+static_assert(
+    pg_cache::detail::kHasFullUpdateShardKey<PostgresExamplePolicy7>);
+static_assert(!pg_cache::detail::kHasFullUpdateShardKey<PostgresExamplePolicy>);
+
 // Instantiation test
 using MyCache1 = PostgreCache<PostgresExamplePolicy>;
 using MyCache2 = PostgreCache<PostgresExamplePolicy2>;
@@ -289,6 +330,7 @@ using MyCache4 = PostgreCache<PostgresExamplePolicy4>;
 using MyTrivialCache = PostgreCache<PostgresTrivialPolicy>;
 using MyCache5 = PostgreCache<PostgresExamplePolicy5>;
 using MyCache6 = PostgreCache<PostgresExamplePolicy6>;
+using MyCache7 = PostgreCache<PostgresExamplePolicy7>;
 
 // NB: field access required for actual instantiation
 static_assert(MyCache1::kIncrementalUpdates);
@@ -297,6 +339,7 @@ static_assert(MyCache3::kIncrementalUpdates);
 static_assert(MyCache4::kIncrementalUpdates);
 static_assert(MyCache5::kIncrementalUpdates);
 static_assert(MyCache6::kIncrementalUpdates);
+static_assert(MyCache7::kIncrementalUpdates);
 
 namespace pg = storages::postgres;
 static_assert(MyCache1::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
@@ -305,6 +348,7 @@ static_assert(MyCache3::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
 static_assert(MyCache4::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
 static_assert(MyCache5::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
 static_assert(MyCache6::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
+static_assert(MyCache7::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
 
 // Update() instantiation test
 [[maybe_unused]] void VerifyUpdateCompiles(
@@ -316,6 +360,26 @@ static_assert(MyCache6::kClusterHostTypeFlags == pg::ClusterHostType::kSlave);
   MyCache4 cache4{config, context};
   MyCache5 cache5{config, context};
   MyCache6 cache6{config, context};
+  MyCache7 cache7{config, context};
+}
+
+TEST(PostgreCache, ShardQuery) {
+  using ShardedUpdate =
+      pg_cache::detail::ShardedFullUpdate<PostgresExamplePolicy7>;
+  EXPECT_EQ(ShardedUpdate::GetShardQuery(4, 0).Statement(),
+            "select id, bar, updated from test.my_data "
+            "where (hashtext((id)::text) & 2147483647) % 4 = 0");
+  EXPECT_EQ(ShardedUpdate::GetShardQuery(4, 3).Statement(),
+            "select id, bar, updated from test.my_data "
+            "where (hashtext((id)::text) & 2147483647) % 4 = 3");
+}
+
+TEST(PostgreCache, ShardQueryWithWhere) {
+  using ShardedUpdate =
+      pg_cache::detail::ShardedFullUpdate<PostgresExamplePolicy8>;
+  EXPECT_EQ(ShardedUpdate::GetShardQuery(2, 1).Statement(),
+            "select id, bar from test.my_data where (id > 10) and "
+            "(hashtext((bar)::text) & 2147483647) % 2 = 1");
 }
 
 inline auto SampleOfComponentRegistration() {
@@ -91,6 +91,11 @@ detail::NonTransaction Cluster::Start(ClusterHostTypeFlags flags,
   return pimpl_->Start(flags, cmd_ctl);
 }
 
+detail::NonTransaction Cluster::StartDedicated(ClusterHostTypeFlags flags,
+                                               OptionalCommandControl cmd_ctl) {
+  return pimpl_->StartDedicated(flags, cmd_ctl);
+}
+
 OptionalCommandControl Cluster::GetQueryCmdCtl(
     const std::string& query_name) const {
   return pimpl_->GetQueryCmdCtl(query_name);
@@ -117,6 +122,22 @@ ResultSet Cluster::Execute(ClusterHostTypeFlags flags,
   return ntrx.Execute(statement_cmd_ctl, query.Statement(), store);
 }
 
+ResultStream Cluster::Stream(ClusterHostTypeFlags flags, const Query& query,
+                             const ParameterStore& store) {
+  return Stream(flags, OptionalCommandControl{}, query, store);
+}
+
+ResultStream Cluster::Stream(ClusterHostTypeFlags flags,
+                             OptionalCommandControl statement_cmd_ctl,
+                             const Query& query, const ParameterStore& store) {
+  if (!statement_cmd_ctl && query.GetName()) {
+    statement_cmd_ctl = GetQueryCmdCtl(query.GetName()->GetUnderlying());
+  }
+  statement_cmd_ctl = GetHandlersCmdCtl(statement_cmd_ctl);
+  auto ntrx = StartDedicated(flags, statement_cmd_ctl);
+  return ntrx.Stream(statement_cmd_ctl, query, store);
+}
+
 }  // namespace storages::postgres
 
 USERVER_NAMESPACE_END
@@ -75,6 +75,9 @@ formats::json::ValueBuilder InstanceStatisticsToJson(
   timing["acquire-connection"]["1min"] =
       utils::statistics::PercentileToJson(stats.acquire_percentile);
   utils::statistics::SolomonSkip(timing["acquire-connection"]["1min"]);
+  timing["wait-connection"]["1min"] =
+      utils::statistics::PercentileToJson(stats.wait_percentile);
+  utils::statistics::SolomonSkip(timing["wait-connection"]["1min"]);
 
   auto query = instance["queries"];
   query["parsed"] = stats.transaction.parse_total;
@@ -416,6 +419,10 @@ properties:
         type: integer
         description: limit for concurrent establishing connections number per pool (0 - unlimited)
         defaultDescription: 0
+    pipeline_connections:
+        type: integer
+        description: number of connections that execute single statements of different tasks together in pipeline mode (0 - disabled)
+        defaultDescription: 0
 )");
 }
 
@@ -0,0 +1,221 @@
+#include <userver/storages/postgres/copy.hpp>
+
+#include <string_view>
+#include <utility>
+
+#include <storages/postgres/detail/connection.hpp>
+#include <userver/logging/log.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres {
+
+namespace {
+
+// https://www.postgresql.org/docs/current/sql-copy.html#id-1.9.3.55.9.4.5
+constexpr std::string_view kCopySignature{"PGCOPY\n\377\r\n\0", 11};
+constexpr Smallint kCopyTrailer = -1;
+
+class CopyDataReader {
+ public:
+  explicit CopyDataReader(std::string_view data) : data_{data} {}
+
+  template <typename T>
+  T Read() {
+    const auto bytes = ReadBytes(sizeof(T));
+    T value{};
+    io::ReadBuffer(io::FieldBuffer{false, io::BufferCategory::kPlainBuffer,
+                                   bytes.size(), AsBuffer(bytes)},
+                   value);
+    return value;
+  }
+
+  std::string_view ReadBytes(std::size_t size) {
+    if (size > data_.size()) {
+      throw InvalidBinaryBuffer{"COPY data is truncated"};
+    }
+    const auto bytes = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return bytes;
+  }
+
+  bool IsEmpty() const { return data_.empty(); }
+
+  static const std::uint8_t* AsBuffer(std::string_view bytes) {
+    return reinterpret_cast<const std::uint8_t*>(bytes.data());
+  }
+
+ private:
+  std::string_view data_;
+};
+
+}  // namespace
+
+CopyInStream::CopyInStream(detail::Connection* conn, const Query& query,
+                           OptionalCommandControl cmd_ctl)
+    : conn_{conn},
+      query_{query},
+      cmd_ctl_{std::move(cmd_ctl)},
+      types_{&conn->GetUserTypes()} {
+  if (!cmd_ctl_) {
+    cmd_ctl_ = conn_->GetQueryCmdCtl(query_.GetName());
+  }
+  conn_->CopyInStart(query_, cmd_ctl_);
+
+  buffer_.reserve(kChunkSize + kChunkSize / 4);
+  buffer_.append(kCopySignature);
+  // flags and header extension length
+  io::WriteBuffer(*types_, buffer_, Integer{0});
+  io::WriteBuffer(*types_, buffer_, Integer{0});
+}
+
+CopyInStream::CopyInStream(CopyInStream&& rhs) noexcept
+    : conn_{std::exchange(rhs.conn_, nullptr)},
+      query_{std::move(rhs.query_)},
+      cmd_ctl_{std::move(rhs.cmd_ctl_)},
+      types_{rhs.types_},
+      buffer_{std::move(rhs.buffer_)} {}
+
+CopyInStream& CopyInStream::operator=(CopyInStream&& rhs) noexcept {
+  CopyInStream tmp{std::move(rhs)};
+  std::swap(conn_, tmp.conn_);
+  std::swap(query_, tmp.query_);
+  std::swap(cmd_ctl_, tmp.cmd_ctl_);
+  std::swap(types_, tmp.types_);
+  std::swap(buffer_, tmp.buffer_);
+  return *this;
+}
+
+CopyInStream::~CopyInStream() {
+  if (!conn_) return;
+  LOG_WARNING() << "COPY FROM STDIN stream is destroyed unfinished, "
+                   "the statement is aborted";
+  try {
+    conn_->CopyInAbandon(cmd_ctl_);
+  } catch (const std::exception& e) {
+    LOG_WARNING() << "Failed to abort COPY FROM STDIN: " << e;
+  }
+}
+
+std::size_t CopyInStream::Finish() {
+  CheckActive();
+  io::WriteBuffer(*types_, buffer_, kCopyTrailer);
+  SendBuffer();
+  // The server reports errors in the data only at the end of COPY, the
+  // connection leaves the COPY state whatever the result is
+  auto* conn = std::exchange(conn_, nullptr);
+  return conn->CopyInEnd(query_, cmd_ctl_).RowsAffected();
+}
+
+void CopyInStream::CheckActive() const {
+  if (!conn_) {
+    throw LogicError{"COPY FROM STDIN stream is already finished"};
+  }
+}
+
+void CopyInStream::SendBuffer() {
+  conn_->CopyInPutData(buffer_, cmd_ctl_);
+  buffer_.clear();
+}
+
+CopyOutStream::CopyOutStream(detail::Connection* conn, const Query& query,
+                             OptionalCommandControl cmd_ctl)
+    : conn_{conn},
+      query_{query},
+      cmd_ctl_{std::move(cmd_ctl)},
+      categories_{&conn->GetUserTypes().GetTypeBufferCategories()} {
+  if (!cmd_ctl_) {
+    cmd_ctl_ = conn_->GetQueryCmdCtl(query_.GetName());
+  }
+  conn_->CopyOutStart(query_, cmd_ctl_);
+}
+
+CopyOutStream::CopyOutStream(CopyOutStream&& rhs) noexcept
+    : conn_{std::exchange(rhs.conn_, nullptr)},
+      query_{std::move(rhs.query_)},
+      cmd_ctl_{std::move(rhs.cmd_ctl_)},
+      categories_{rhs.categories_},
+      header_read_{rhs.header_read_},
+      fields_{std::move(rhs.fields_)} {}
+
+CopyOutStream& CopyOutStream::operator=(CopyOutStream&& rhs) noexcept {
+  CopyOutStream tmp{std::move(rhs)};
+  std::swap(conn_, tmp.conn_);
+  std::swap(query_, tmp.query_);
+  std::swap(cmd_ctl_, tmp.cmd_ctl_);
+  std::swap(categories_, tmp.categories_);
+  std::swap(header_read_, tmp.header_read_);
+  std::swap(fields_, tmp.fields_);
+  return *this;
+}
+
+CopyOutStream::~CopyOutStream() {
+  if (!conn_) return;
+  LOG_DEBUG() << "COPY TO STDOUT stream is destroyed before reading all the "
+                 "rows, the statement is cancelled";
+  try {
+    conn_->CopyOutAbandon(cmd_ctl_);
+  } catch (const std::exception& e) {
+    LOG_WARNING() << "Failed to cancel COPY TO STDOUT: " << e;
+  }
+}
+
+bool CopyOutStream::FetchRow() {
+  if (!conn_) return false;
+
+  // Every row is a separate message, the header comes with the first one
+  const auto data = conn_->CopyOutGetData(query_, cmd_ctl_);
+  if (data.empty()) {
+    conn_ = nullptr;
+    return false;
+  }
+  CopyDataReader reader{data};
+  if (!header_read_) {
+    if (reader.ReadBytes(kCopySignature.size()) != kCopySignature) {
+      throw InvalidBinaryBuffer{"COPY data has no binary format signature"};
+    }
+    reader.Read<Integer>();  // flags
+    const auto extension_size = reader.Read<Integer>();
+    if (extension_size < 0) {
+      throw InvalidBinaryBuffer{"COPY header extension size is negative"};
+    }
+    reader.ReadBytes(extension_size);
+    header_read_ = true;
+  }
+
+  const auto field_count = reader.Read<Smallint>();
+  if (field_count == kCopyTrailer) {
+    if (!conn_->CopyOutGetData(query_, cmd_ctl_).empty()) {
+      throw InvalidBinaryBuffer{"COPY data continues after the trailer"};
+    }
+    conn_ = nullptr;
+    return false;
+  }
+  if (field_count < 0) {
+    throw InvalidBinaryBuffer{"COPY row field count is negative"};
+  }
+
+  fields_.clear();
+  for (Smallint i = 0; i < field_count; ++i) {
+    const auto length = reader.Read<Integer>();
+    if (length == io::kPgNullBufferSize) {
+      fields_.push_back(io::FieldBuffer{true});
+      continue;
+    }
+    if (length < 0) {
+      throw InvalidBinaryBuffer{"COPY field length is negative"};
+    }
+    const auto bytes = reader.ReadBytes(length);
+    fields_.push_back(io::FieldBuffer{false, io::BufferCategory::kPlainBuffer,
+                                      bytes.size(),
+                                      CopyDataReader::AsBuffer(bytes)});
+  }
+  if (!reader.IsEmpty()) {
+    throw InvalidBinaryBuffer{"COPY row has more data than its fields"};
+  }
+  return true;
+}
+
+}  // namespace storages::postgres
+
+USERVER_NAMESPACE_END
@@ -235,6 +235,16 @@ ClusterImpl::ConnectionPoolPtr ClusterImpl::FindPool(
   return host_pools_.at(dsn_index);
 }
 
+ClusterImpl::ConnectionPoolPtr ClusterImpl::FindStatementPool(
+    ClusterHostTypeFlags flags) {
+  if (!(flags & kClusterHostRolesMask)) {
+    throw LogicError(
+        "Host role must be specified for execution of a single statement");
+  }
+  LOG_TRACE() << "Requested single statement on " << flags;
+  return FindPool(flags);
+}
+
 Transaction ClusterImpl::Begin(ClusterHostTypeFlags flags,
                                const TransactionOptions& options,
                                OptionalCommandControl cmd_ctl) {
@@ -255,12 +265,12 @@ Transaction ClusterImpl::Begin(ClusterHostTypeFlags flags,
 
 NonTransaction ClusterImpl::Start(ClusterHostTypeFlags flags,
                                   OptionalCommandControl cmd_ctl) {
-  if (!(flags & kClusterHostRolesMask)) {
-    throw LogicError(
-        "Host role must be specified for execution of a single statement");
-  }
-  LOG_TRACE() << "Requested single statement on " << flags;
-  return FindPool(flags)->Start(cmd_ctl);
+  return FindStatementPool(flags)->Start(cmd_ctl);
+}
+
+NonTransaction ClusterImpl::StartDedicated(ClusterHostTypeFlags flags,
+                                           OptionalCommandControl cmd_ctl) {
+  return FindStatementPool(flags)->StartDedicated(cmd_ctl);
 }
 
 void ClusterImpl::SetDefaultCommandControl(CommandControl cmd_ctl,
@@ -39,6 +39,7 @@ class ClusterImpl {
                     OptionalCommandControl);
 
   NonTransaction Start(ClusterHostTypeFlags, OptionalCommandControl);
+  NonTransaction StartDedicated(ClusterHostTypeFlags, OptionalCommandControl);
 
   void SetDefaultCommandControl(CommandControl, DefaultCommandControlSource);
   CommandControl GetDefaultCommandControl() const;
@@ -65,6 +66,7 @@ class ClusterImpl {
   using ConnectionPoolPtr = std::shared_ptr<ConnectionPool>;
 
   ConnectionPoolPtr FindPool(ClusterHostTypeFlags);
+  ConnectionPoolPtr FindStatementPool(ClusterHostTypeFlags);
 
   DefaultCommandControls default_cmd_ctls_;
   std::unique_ptr<topology::TopologyBase> topology_;
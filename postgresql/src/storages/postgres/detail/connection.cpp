@@ -112,6 +112,12 @@ ResultSet Connection::Execute(CommandControl statement_cmd_ctl,
                  OptionalCommandControl{statement_cmd_ctl});
 }
 
+void Connection::ExecuteBatch(std::vector<BatchStatement>& statements,
+                              TimeoutDuration statement_timeout,
+                              engine::Deadline deadline) {
+  pimpl_->ExecuteBatch(statements, statement_timeout, deadline);
+}
+
 Connection::StatementId Connection::PortalBind(
     const std::string& statement, const std::string& portal_name,
     const detail::QueryParameters& params,
@@ -128,6 +134,54 @@ ResultSet Connection::PortalExecute(StatementId statement_id,
                                std::move(statement_cmd_ctl));
 }
 
+void Connection::CopyInStart(const Query& query,
+                             OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->CopyInStart(query, std::move(statement_cmd_ctl));
+}
+
+void Connection::CopyInPutData(std::string_view data,
+                               OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->CopyInPutData(data, std::move(statement_cmd_ctl));
+}
+
+ResultSet Connection::CopyInEnd(const Query& query,
+                                OptionalCommandControl statement_cmd_ctl) {
+  return pimpl_->CopyInEnd(query, std::move(statement_cmd_ctl));
+}
+
+void Connection::CopyInAbandon(OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->CopyInAbandon(std::move(statement_cmd_ctl));
+}
+
+void Connection::CopyOutStart(const Query& query,
+                              OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->CopyOutStart(query, std::move(statement_cmd_ctl));
+}
+
+std::string_view Connection::CopyOutGetData(
+    const Query& query, OptionalCommandControl statement_cmd_ctl) {
+  return pimpl_->CopyOutGetData(query, std::move(statement_cmd_ctl));
+}
+
+void Connection::CopyOutAbandon(OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->CopyOutAbandon(std::move(statement_cmd_ctl));
+}
+
+void Connection::StreamStart(const Query& query,
+                             const detail::QueryParameters& params,
+                             OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->StreamStart(query, params, std::move(statement_cmd_ctl));
+}
+
+std::optional<ResultSet> Connection::StreamFetchRow(
+    const Query& query, OptionalCommandControl statement_cmd_ctl) {
+  return pimpl_->StreamFetchRow(query, std::move(statement_cmd_ctl));
+}
+
+void Connection::StreamAbandon(OptionalCommandControl statement_cmd_ctl) {
+  pimpl_->StreamAbandon(std::move(statement_cmd_ctl));
+}
+
 void Connection::CancelAndCleanup(TimeoutDuration timeout) {
   pimpl_->CancelAndCleanup(timeout);
 }
@@ -147,6 +201,10 @@ const UserTypes& Connection::GetUserTypes() const {
   return pimpl_->GetUserTypes();
 }
 
+std::uint64_t Connection::GetUserTypesVersion() const {
+  return pimpl_->GetUserTypesVersion();
+}
+
 TimeoutDuration Connection::GetIdleDuration() const {
   return pimpl_->GetIdleDuration();
 }
@@ -2,7 +2,12 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <exception>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
@@ -48,6 +53,16 @@ class Connection {
                   //!< finished
   };
 
+  /// @brief A statement of a pipelined batch, see ExecuteBatch
+  struct BatchStatement {
+    const Query* query{nullptr};
+    detail::QueryParameters params;
+    /// Set if the statement succeeded
+    std::optional<ResultSet> result;
+    /// Set if the statement failed
+    std::exception_ptr error;
+  };
+
   /// Strong typedef for IDs assigned to prepared statements
   using StatementId =
       USERVER_NAMESPACE::utils::StrongTypedef<struct StatementIdTag,
@@ -218,6 +233,16 @@ class Connection {
   ResultSet Execute(CommandControl statement_cmd_ctl, const Query& query,
                     const ParameterStore& store);
 
+  /// Send the statements out of transaction in pipeline mode and wait for
+  /// the results of all of them in a single roundtrip. Every statement is
+  /// executed in an implicit transaction of its own and gets either a result
+  /// or an error.
+  /// @throws ConnectionError and descendants if the whole batch failed, the
+  /// connection is closed in that case
+  void ExecuteBatch(std::vector<BatchStatement>& statements,
+                    TimeoutDuration statement_timeout,
+                    engine::Deadline deadline);
+
   StatementId PortalBind(const std::string& statement,
                          const std::string& portal_name,
                          const detail::QueryParameters& params,
@@ -225,6 +250,33 @@ class Connection {
   ResultSet PortalExecute(StatementId, const std::string& portal_name,
                           std::uint32_t n_rows, OptionalCommandControl);
 
+  /// Send a COPY ... FROM STDIN statement and wait for the server to accept
+  /// the binary data
+  void CopyInStart(const Query& query, OptionalCommandControl);
+  /// Send a chunk of COPY data, blocks while the server does not read it
+  void CopyInPutData(std::string_view data, OptionalCommandControl);
+  /// Finish the COPY and return the command result
+  ResultSet CopyInEnd(const Query& query, OptionalCommandControl);
+  /// Abort the COPY in progress, the server fails the statement
+  void CopyInAbandon(OptionalCommandControl);
+
+  /// Send a COPY ... TO STDOUT statement and wait for the binary data
+  void CopyOutStart(const Query& query, OptionalCommandControl);
+  /// Get the next row of COPY data, an empty view when the data is over.
+  /// The view is valid until the next call.
+  std::string_view CopyOutGetData(const Query& query, OptionalCommandControl);
+  /// Cancel the COPY in progress and discard the rest of the data
+  void CopyOutAbandon(OptionalCommandControl);
+
+  /// Send a statement with its rows received one by one in single row mode
+  void StreamStart(const Query& query, const detail::QueryParameters& params,
+                   OptionalCommandControl);
+  /// Get a result set with the next row, std::nullopt when the rows are over
+  std::optional<ResultSet> StreamFetchRow(const Query& query,
+                                          OptionalCommandControl);
+  /// Cancel the statement being streamed and discard the rest of the rows
+  void StreamAbandon(OptionalCommandControl);
+
   /// Send cancel to the database backend
   /// Try to return connection to idle state discarding all results.
   /// If there is a transaction in progress - roll it back.
@@ -250,6 +302,9 @@ class Connection {
   /// @brief Reload user types after creating a type
   void ReloadUserTypes();
   const UserTypes& GetUserTypes() const;
+  /// Types loaded later by any connection have a greater version, 0 if the
+  /// user types were never loaded
+  std::uint64_t GetUserTypesVersion() const;
   //@}
 
   /// Get duration since last network operation
@@ -1,5 +1,8 @@
 #include <storages/postgres/detail/connection_impl.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 #include <boost/functional/hash.hpp>
 
 #include <userver/error_injection/hook.hpp>
@@ -21,6 +24,9 @@ namespace {
 
 const char* const kStatementTimeoutParameter = "statement_timeout";
 
+// Versions of the user types loaded by all the connections
+std::atomic<std::uint64_t> user_types_loads{0};
+
 // we hope lc_messages is en_US, we don't control it anyway
 const std::string kBadCachedPlanErrorMessage =
     "cached plan must not change result type";
@@ -176,12 +182,6 @@ ConnectionImpl::ConnectionImpl(
   if (settings_.max_prepared_cache_size == 0) {
     throw InvalidConfig("max_prepared_cache_size is 0");
   }
-#if !LIBPQ_HAS_PIPELINING
-  if (settings_.pipeline_mode == PipelineMode::kEnabled) {
-    LOG_LIMITED_WARNING() << "Pipeline mode is not supported, falling back";
-    settings_.pipeline_mode = PipelineMode::kDisabled;
-  }
-#endif
 }
 
 void ConnectionImpl::AsyncConnect(const Dsn& dsn, engine::Deadline deadline) {
@@ -344,6 +344,24 @@ ResultSet ConnectionImpl::ExecuteCommand(
   return ExecuteCommand(query, params, deadline);
 }
 
+void ConnectionImpl::ExecuteBatch(
+    std::vector<Connection::BatchStatement>& statements,
+    TimeoutDuration statement_timeout, engine::Deadline deadline) {
+  if (IsInTransaction()) {
+    throw LogicError{"A pipelined batch can't be executed in a transaction"};
+  }
+  CheckBusy();
+  SetConnectionStatementTimeout(statement_timeout, deadline);
+  DiscardOldPreparedStatements(deadline);
+  // Preparing a statement must not evict another one of the same chunk
+  const auto chunk_size = settings_.max_prepared_cache_size;
+  for (std::size_t begin = 0; begin < statements.size(); begin += chunk_size) {
+    ExecuteBatchChunk(statements, begin,
+                      std::min(begin + chunk_size, statements.size()),
+                      deadline);
+  }
+}
+
 void ConnectionImpl::Begin(const TransactionOptions& options,
                            SteadyClock::time_point trx_start_time,
                            OptionalCommandControl trx_cmd_ctl) {
@@ -477,6 +495,201 @@ ResultSet ConnectionImpl::PortalExecute(
                     count_execute, span, scope, &prepared_info->description);
 }
 
+template <typename Func>
+auto ConnectionImpl::AccountCopyErrors(Func&& func) {
+  try {
+    return func();
+  } catch (const ConnectionTimeoutError& e) {
+    ++stats_.execute_timeout;
+    ++stats_.error_execute_total;
+    LOG_LIMITED_WARNING() << "COPY network timeout error: " << e;
+    throw;
+  } catch (const std::exception&) {
+    ++stats_.error_execute_total;
+    throw;
+  }
+}
+
+void ConnectionImpl::StartCopy(const Query& query, ExecStatusType status,
+                               OptionalCommandControl statement_cmd_ctl) {
+  CheckBusy();
+  if (IsPipelineActive()) {
+    throw LogicError{"COPY is not supported in pipeline mode"};
+  }
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  SetStatementTimeout(std::move(statement_cmd_ctl));
+  CheckDeadlineReached(deadline);
+  auto span = MakeQuerySpan(query);
+  auto scope = span.CreateScopeTime();
+  ++stats_.execute_total;
+  AccountCopyErrors([&] {
+    try {
+      conn_wrapper_.SendQuery(query.Statement(), scope);
+      conn_wrapper_.WaitCopyStart(status, deadline, scope);
+    } catch (const std::exception&) {
+      span.AddTag(tracing::kErrorFlag, true);
+      throw;
+    }
+  });
+}
+
+void ConnectionImpl::CopyInStart(const Query& query,
+                                 OptionalCommandControl statement_cmd_ctl) {
+  StartCopy(query, PGRES_COPY_IN, std::move(statement_cmd_ctl));
+}
+
+void ConnectionImpl::CopyInPutData(std::string_view data,
+                                   OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  AccountCopyErrors([&] { conn_wrapper_.PutCopyData(data, deadline); });
+}
+
+ResultSet ConnectionImpl::CopyInEnd(const Query& query,
+                                    OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  auto span = MakeQuerySpan(query);
+  auto scope = span.CreateScopeTime();
+  return AccountCopyErrors([&] {
+    try {
+      auto res = conn_wrapper_.PutCopyEnd(deadline, scope);
+      stats_.last_execute_finish = SteadyClock::now();
+      return res;
+    } catch (const std::exception&) {
+      span.AddTag(tracing::kErrorFlag, true);
+      throw;
+    }
+  });
+}
+
+void ConnectionImpl::CopyInAbandon(OptionalCommandControl statement_cmd_ctl) {
+  conn_wrapper_.DiscardInput(MakeStatementDeadline(statement_cmd_ctl));
+}
+
+void ConnectionImpl::CopyOutStart(const Query& query,
+                                  OptionalCommandControl statement_cmd_ctl) {
+  StartCopy(query, PGRES_COPY_OUT, std::move(statement_cmd_ctl));
+}
+
+std::string_view ConnectionImpl::CopyOutGetData(
+    const Query& query, OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  return AccountCopyErrors([&] {
+    const auto data = conn_wrapper_.GetCopyData(deadline);
+    if (data.empty()) {
+      auto span = MakeQuerySpan(query);
+      auto scope = span.CreateScopeTime();
+      try {
+        conn_wrapper_.WaitResult(deadline, scope);
+      } catch (const std::exception&) {
+        span.AddTag(tracing::kErrorFlag, true);
+        throw;
+      }
+      stats_.last_execute_finish = SteadyClock::now();
+    }
+    return data;
+  });
+}
+
+void ConnectionImpl::CopyOutAbandon(OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  // Stop the server from sending the rest of the data
+  auto cancel = conn_wrapper_.Cancel();
+  conn_wrapper_.DiscardInput(deadline);
+  cancel.WaitUntil(deadline);
+}
+
+void ConnectionImpl::StreamStart(const Query& query,
+                                 const QueryParameters& params,
+                                 OptionalCommandControl statement_cmd_ctl) {
+  CheckBusy();
+  if (IsPipelineActive()) {
+    throw LogicError{"Streaming of rows is not supported in pipeline mode"};
+  }
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  SetStatementTimeout(std::move(statement_cmd_ctl));
+
+  const auto& statement = query.Statement();
+  const bool use_prepared = settings_.prepared_statements !=
+                            ConnectionSettings::kNoPreparedStatements;
+  if (use_prepared) {
+    if (settings_.ignore_unused_query_params ==
+        ConnectionSettings::kCheckUnused) {
+      CheckQueryParameters(statement, params);
+    }
+    DiscardOldPreparedStatements(deadline);
+  }
+  CheckDeadlineReached(deadline);
+  auto span = MakeQuerySpan(query);
+  auto scope = span.CreateScopeTime();
+  const TimeoutDuration network_timeout =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline.TimeLeft());
+  ++stats_.execute_total;
+  stream_begin_ = SteadyClock::now();
+  stream_description_.reset();
+  try {
+    if (use_prepared) {
+      const auto& prepared_info =
+          PrepareStatement(statement, params, deadline, span, scope);
+      stream_description_ = prepared_info.description;
+      scope.Reset(scopes::kExec);
+      conn_wrapper_.SendPreparedQuery(prepared_info.statement_name, params,
+                                      scope);
+    } else {
+      conn_wrapper_.SendQuery(statement, params, scope);
+    }
+    conn_wrapper_.SetSingleRowMode();
+  } catch (const std::exception&) {
+    ++stats_.error_execute_total;
+    HandleStatementError(statement, network_timeout, span);
+    throw;
+  }
+}
+
+std::optional<ResultSet> ConnectionImpl::StreamFetchRow(
+    const Query& query, OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  const TimeoutDuration network_timeout =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline.TimeLeft());
+  try {
+    auto row = conn_wrapper_.WaitSingleRow(deadline);
+    if (row) {
+      if (stream_description_) {
+        row->SetBufferCategoriesFrom(*stream_description_);
+      } else {
+        row->FillBufferCategories(db_types_);
+        stream_description_ = *row;
+      }
+      return row;
+    }
+  } catch (const std::exception&) {
+    ++stats_.error_execute_total;
+    stream_description_.reset();
+    auto span = MakeQuerySpan(query);
+    HandleStatementError(query.Statement(), network_timeout, span);
+    throw;
+  }
+
+  const auto now = SteadyClock::now();
+  ++stats_.reply_total;
+  stats_.sum_query_duration += now - stream_begin_;
+  stats_.last_execute_finish = now;
+  stream_description_.reset();
+  return std::nullopt;
+}
+
+void ConnectionImpl::StreamAbandon(OptionalCommandControl statement_cmd_ctl) {
+  const auto deadline = MakeStatementDeadline(statement_cmd_ctl);
+  stream_description_.reset();
+  // The statement is already over if it has failed
+  if (GetConnectionState() != ConnectionState::kTranActive) return;
+  // Stop the server from sending the rest of the rows
+  auto cancel = conn_wrapper_.Cancel();
+  conn_wrapper_.DiscardInput(deadline);
+  cancel.WaitUntil(deadline);
+}
+
 void ConnectionImpl::CancelAndCleanup(TimeoutDuration timeout) {
   auto deadline = testsuite_pg_ctl_.MakeExecuteDeadline(timeout);
 
@@ -534,6 +747,10 @@ void ConnectionImpl::SetParameter(std::string_view name, std::string_view value,
 
 const UserTypes& ConnectionImpl::GetUserTypes() const { return db_types_; }
 
+std::uint64_t ConnectionImpl::GetUserTypesVersion() const {
+  return db_types_version_;
+}
+
 void ConnectionImpl::LoadUserTypes() { LoadUserTypes(MakeCurrentDeadline()); }
 
 TimeoutDuration ConnectionImpl::GetIdleDuration() const {
@@ -579,6 +796,13 @@ engine::Deadline ConnectionImpl::MakeCurrentDeadline() const {
   return testsuite_pg_ctl_.MakeExecuteDeadline(CurrentExecuteTimeout());
 }
 
+engine::Deadline ConnectionImpl::MakeStatementDeadline(
+    const OptionalCommandControl& statement_cmd_ctl) const {
+  return testsuite_pg_ctl_.MakeExecuteDeadline(
+      !!statement_cmd_ctl ? statement_cmd_ctl->execute
+                          : CurrentExecuteTimeout());
+}
+
 void ConnectionImpl::SetTransactionCommandControl(CommandControl cmd_ctl) {
   if (!IsInTransaction()) {
     throw NotInTransaction{
@@ -765,6 +989,114 @@ ResultSet ConnectionImpl::ExecuteCommandNoPrepare(const Query& query,
                     scope, nullptr);
 }
 
+void ConnectionImpl::ExecuteBatchChunk(
+    std::vector<Connection::BatchStatement>& statements, std::size_t begin,
+    std::size_t end, engine::Deadline deadline) {
+  CheckDeadlineReached(deadline);
+  tracing::Span span{scopes::kPipeline};
+  conn_wrapper_.FillSpanTags(span);
+  span.AddTag("pipeline_size", end - begin);
+  auto scope = span.CreateScopeTime();
+  const TimeoutDuration network_timeout =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline.TimeLeft());
+  const bool use_prepared = settings_.prepared_statements !=
+                            ConnectionSettings::kNoPreparedStatements;
+
+  // Only the errors of the connection itself fail the whole batch
+  const auto record_error = [&](Connection::BatchStatement& statement) {
+    try {
+      HandleStatementError(statement.query->Statement(), network_timeout,
+                           span);
+      throw;
+    } catch (const ConnectionError&) {
+      throw;
+    } catch (const ConnectionInterrupted&) {
+      throw;
+    } catch (const std::exception&) {
+      if (!IsConnected()) throw;
+      statement.error = std::current_exception();
+    }
+  };
+
+  // Statements are prepared beforehand, as the pipeline can't wait for the
+  // descriptions of the results
+  std::vector<PreparedStatementInfo> prepared(end - begin);
+  std::vector<std::optional<CountExecute>> counters(end - begin);
+  for (auto i = begin; i < end; ++i) {
+    auto& statement = statements[i];
+    counters[i - begin].emplace(stats_);
+    try {
+      if (settings_.ignore_unused_query_params ==
+          ConnectionSettings::kCheckUnused) {
+        CheckQueryParameters(statement.query->Statement(), statement.params);
+      }
+      if (use_prepared) {
+        prepared[i - begin] = PrepareStatement(
+            statement.query->Statement(), statement.params, deadline, span,
+            scope);
+      }
+    } catch (const std::exception&) {
+      record_error(statement);
+    }
+  }
+
+  const bool enter_pipeline = !IsPipelineActive();
+  try {
+    if (enter_pipeline) conn_wrapper_.EnterPipelineMode();
+    scope.Reset(scopes::kExec);
+    for (auto i = begin; i < end; ++i) {
+      const auto& statement = statements[i];
+      if (statement.error) continue;
+      if (use_prepared) {
+        conn_wrapper_.SendPreparedQuery(prepared[i - begin].statement_name,
+                                        statement.params, scope);
+      } else {
+        conn_wrapper_.SendQuery(statement.query->Statement(), statement.params,
+                                scope);
+      }
+      conn_wrapper_.PipelineSync();
+    }
+    conn_wrapper_.FlushPipeline(deadline);
+
+    for (auto i = begin; i < end; ++i) {
+      auto& statement = statements[i];
+      if (statement.error) continue;
+      try {
+        statement.result =
+            conn_wrapper_.WaitPipelineSyncResult(deadline, scope);
+      } catch (const std::exception&) {
+        record_error(statement);
+      }
+    }
+    if (enter_pipeline) conn_wrapper_.ExitPipelineMode();
+  } catch (const std::exception& e) {
+    LOG_LIMITED_WARNING() << "Pipelined batch failed, closing the connection: "
+                          << e;
+    span.AddTag(tracing::kErrorFlag, true);
+    Close();
+    throw;
+  }
+
+  // User types can be reloaded only after the pipeline is over
+  for (auto i = begin; i < end; ++i) {
+    auto& statement = statements[i];
+    if (!statement.result) continue;
+    try {
+      const auto& description = prepared[i - begin].description;
+      if (!description.IsEmpty()) {
+        statement.result->SetBufferCategoriesFrom(description);
+      } else if (!statement.result->IsEmpty()) {
+        FillBufferCategories(*statement.result);
+      }
+      counters[i - begin]->AccountResult(*statement.result);
+    } catch (const std::exception&) {
+      statement.result.reset();
+      record_error(statement);
+    }
+  }
+}
+
 void ConnectionImpl::SendCommandNoPrepare(const Query& query,
                                           engine::Deadline deadline) {
   static const QueryParameters kNoParams;
@@ -815,6 +1147,7 @@ void ConnectionImpl::LoadUserTypes(engine::Deadline deadline) {
     }
     db_types.AddCompositeFields(std::move(attribs));
     db_types_ = std::move(db_types);
+    db_types_version_ = ++user_types_loads;
   } catch (const Error& e) {
     LOG_LIMITED_ERROR() << "Error loading user datatypes: " << e;
     // TODO Decide about rethrowing
@@ -853,30 +1186,36 @@ ResultSet ConnectionImpl::WaitResult(const std::string& statement,
     }
     counter.AccountResult(res);
     return res;
+  } catch (const std::exception&) {
+    HandleStatementError(statement, network_timeout, span);
+    throw;
+  }
+}
+
+void ConnectionImpl::HandleStatementError(const std::string& statement,
+                                          TimeoutDuration network_timeout,
+                                          tracing::Span& span) {
+  span.AddTag(tracing::kErrorFlag, true);
+  try {
+    throw;
   } catch (const InvalidSqlStatementName& e) {
     LOG_LIMITED_ERROR()
         << "Looks like your pg_bouncer is not in 'session' mode. "
            "Please switch pg_bouncers's pooling mode to 'session'.";
     // reset prepared cache in case they just magically vanished
     is_discard_prepared_pending_ = true;
-    span.AddTag(tracing::kErrorFlag, true);
-    throw;
   } catch (const ConnectionTimeoutError& e) {
     ++stats_.execute_timeout;
     LOG_LIMITED_WARNING() << "Statement `" << statement
                           << "` network timeout error: " << e << ". "
                           << "Network timout was " << network_timeout.count()
                           << "ms";
-    span.AddTag(tracing::kErrorFlag, true);
-    throw;
   } catch (const QueryCancelled& e) {
     ++stats_.execute_timeout;
     LOG_LIMITED_WARNING() << "Statement `" << statement
                           << "` was cancelled: " << e
                           << ". Statement timeout was "
                           << current_statement_timeout_.count() << "ms";
-    span.AddTag(tracing::kErrorFlag, true);
-    throw;
   } catch (const FeatureNotSupported& e) {
     // yes, this is the only way to discern this error
     if (e.GetServerMessage().GetPrimary() == kBadCachedPlanErrorMessage) {
@@ -885,11 +1224,7 @@ ResultSet ConnectionImpl::WaitResult(const std::string& statement,
              "cached plan change";
       is_discard_prepared_pending_ = true;
     }
-    span.AddTag(tracing::kErrorFlag, true);
-    throw;
   } catch (const std::exception&) {
-    span.AddTag(tracing::kErrorFlag, true);
-    throw;
   }
 }
 
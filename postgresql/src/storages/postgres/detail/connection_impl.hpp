@@ -5,6 +5,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <userver/cache/lru_map.hpp>
 #include <userver/engine/deadline.hpp>
@@ -63,6 +64,10 @@ class ConnectionImpl {
                            const detail::QueryParameters& params,
                            OptionalCommandControl statement_cmd_ctl);
 
+  void ExecuteBatch(std::vector<Connection::BatchStatement>& statements,
+                    TimeoutDuration statement_timeout,
+                    engine::Deadline deadline);
+
   void Begin(const TransactionOptions& options,
              SteadyClock::time_point trx_start_time,
              OptionalCommandControl trx_cmd_ctl = {});
@@ -81,6 +86,26 @@ class ConnectionImpl {
                           const std::string& portal_name, std::uint32_t n_rows,
                           OptionalCommandControl statement_cmd_ctl);
 
+  void CopyInStart(const Query& query,
+                   OptionalCommandControl statement_cmd_ctl);
+  void CopyInPutData(std::string_view data,
+                     OptionalCommandControl statement_cmd_ctl);
+  ResultSet CopyInEnd(const Query& query,
+                      OptionalCommandControl statement_cmd_ctl);
+  void CopyInAbandon(OptionalCommandControl statement_cmd_ctl);
+
+  void CopyOutStart(const Query& query,
+                    OptionalCommandControl statement_cmd_ctl);
+  std::string_view CopyOutGetData(const Query& query,
+                                  OptionalCommandControl statement_cmd_ctl);
+  void CopyOutAbandon(OptionalCommandControl statement_cmd_ctl);
+
+  void StreamStart(const Query& query, const detail::QueryParameters& params,
+                   OptionalCommandControl statement_cmd_ctl);
+  std::optional<ResultSet> StreamFetchRow(
+      const Query& query, OptionalCommandControl statement_cmd_ctl);
+  void StreamAbandon(OptionalCommandControl statement_cmd_ctl);
+
   void CancelAndCleanup(TimeoutDuration timeout);
   bool Cleanup(TimeoutDuration timeout);
 
@@ -88,6 +113,7 @@ class ConnectionImpl {
                     Connection::ParameterScope scope);
 
   const UserTypes& GetUserTypes() const;
+  std::uint64_t GetUserTypesVersion() const;
   void LoadUserTypes();
 
   TimeoutDuration GetIdleDuration() const;
@@ -113,6 +139,8 @@ class ConnectionImpl {
   void CheckDeadlineReached(const engine::Deadline& deadline);
   tracing::Span MakeQuerySpan(const Query& query) const;
   engine::Deadline MakeCurrentDeadline() const;
+  engine::Deadline MakeStatementDeadline(
+      const OptionalCommandControl& statement_cmd_ctl) const;
 
   void SetTransactionCommandControl(CommandControl cmd_ctl);
 
@@ -146,6 +174,10 @@ class ConnectionImpl {
                                     const QueryParameters& params,
                                     engine::Deadline deadline);
 
+  void ExecuteBatchChunk(std::vector<Connection::BatchStatement>& statements,
+                         std::size_t begin, std::size_t end,
+                         engine::Deadline deadline);
+
   void SendCommandNoPrepare(const Query& query, engine::Deadline deadline);
 
   void SendCommandNoPrepare(const Query& query, const QueryParameters& params,
@@ -164,6 +196,17 @@ class ConnectionImpl {
                        tracing::Span& span, tracing::ScopeTime& scope,
                        const ResultSet* description_ptr);
 
+  /// Accounts the error of a statement, must be called from a catch block
+  void HandleStatementError(const std::string& statement,
+                            TimeoutDuration network_timeout,
+                            tracing::Span& span);
+
+  void StartCopy(const Query& query, ExecStatusType status,
+                 OptionalCommandControl statement_cmd_ctl);
+
+  template <typename Func>
+  auto AccountCopyErrors(Func&& func);
+
   void Cancel();
 
   const std::string uuid_;
@@ -171,6 +214,7 @@ class ConnectionImpl {
   PGConnectionWrapper conn_wrapper_;
   PreparedStatements prepared_;
   UserTypes db_types_;
+  std::uint64_t db_types_version_{0};
   bool is_in_recovery_ = true;
   bool is_read_only_ = true;
   bool is_discard_prepared_pending_ = false;
@@ -181,6 +225,10 @@ class ConnectionImpl {
   testsuite::PostgresControl testsuite_pg_ctl_;
   OptionalCommandControl transaction_cmd_ctl_;
   TimeoutDuration current_statement_timeout_{};
+  // The rows of a streamed statement get the buffer categories of the first
+  // one, as user types can't be reloaded while the rows are received
+  std::optional<ResultSet> stream_description_;
+  SteadyClock::time_point stream_begin_;
   const error_injection::Settings ei_settings_;
 };
 
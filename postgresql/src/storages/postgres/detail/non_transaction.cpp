@@ -1,7 +1,9 @@
 #include <userver/storages/postgres/detail/non_transaction.hpp>
 
 #include <storages/postgres/detail/connection.hpp>
+#include <storages/postgres/detail/pool.hpp>
 #include <storages/postgres/detail/statement_timer.hpp>
+#include <userver/storages/postgres/exceptions.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -13,8 +15,16 @@ NonTransaction::NonTransaction(ConnectionPtr&& conn,
   conn_->Start(start_time);
 }
 
+NonTransaction::NonTransaction(std::shared_ptr<ConnectionPool> pool,
+                               std::shared_ptr<const UserTypes> user_types)
+    : conn_{nullptr},
+      pool_{std::move(pool)},
+      user_types_{std::move(user_types)} {}
+
 NonTransaction::NonTransaction(NonTransaction&&) noexcept = default;
-NonTransaction::~NonTransaction() { conn_->Finish(); }
+NonTransaction::~NonTransaction() {
+  if (conn_) conn_->Finish();
+}
 
 NonTransaction& NonTransaction::operator=(NonTransaction&&) noexcept = default;
 
@@ -28,13 +38,36 @@ ResultSet NonTransaction::Execute(OptionalCommandControl statement_cmd_ctl,
 ResultSet NonTransaction::DoExecute(const Query& query,
                                     const detail::QueryParameters& params,
                                     OptionalCommandControl statement_cmd_ctl) {
+  if (!conn_) {
+    StatementTimer timer{query, &pool_->GetStatementTimingsStorage()};
+    auto res = pool_->ExecutePipelined(query, params, statement_cmd_ctl);
+    timer.Account();
+    return res;
+  }
   StatementTimer timer{query, conn_};
   auto res = conn_->Execute(query, params, statement_cmd_ctl);
   timer.Account();
   return res;
 }
 
+ResultStream NonTransaction::Stream(OptionalCommandControl statement_cmd_ctl,
+                                    const Query& query,
+                                    const ParameterStore& store) {
+  return DoStream(query, detail::QueryParameters{store.GetInternalData()},
+                  statement_cmd_ctl);
+}
+
+ResultStream NonTransaction::DoStream(
+    const Query& query, const detail::QueryParameters& params,
+    OptionalCommandControl statement_cmd_ctl) {
+  if (!conn_) {
+    throw LogicError{"Rows of a pipelined statement can't be streamed"};
+  }
+  return ResultStream{std::move(conn_), query, params, statement_cmd_ctl};
+}
+
 const UserTypes& NonTransaction::GetConnectionUserTypes() const {
+  if (!conn_) return *user_types_;
   return conn_->GetUserTypes();
 }
 
@@ -9,6 +9,10 @@ auto PQXisBusy(PGconn* conn) { return ::PQisBusy(conn); }
 auto PQXgetResult(PGconn* conn) { return ::PQgetResult(conn); }
 #endif
 
+#if !LIBPQ_HAS_PIPELINING
+#error "libpq of PostgreSQL 14 or newer is required"
+#endif
+
 #include <userver/engine/task/cancel.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/tracing/tags.hpp>
@@ -52,6 +56,8 @@ namespace {
 // TODO move to config
 constexpr bool kVerboseErrors = false;
 
+const char* const kCopyAbandonedMessage = "COPY is abandoned by the client";
+
 const char* MsgForStatus(ConnStatusType status) {
   switch (status) {
     case CONNECTION_OK:
@@ -78,14 +84,10 @@ const char* MsgForStatus(ConnStatusType status) {
       return "PQstatus: Consuming remaining response messages on connection";
     case CONNECTION_GSS_STARTUP:
       return "PQstatus: Negotiating GSSAPI";
-#if PG_VERSION_NUM >= 130000
     case CONNECTION_CHECK_TARGET:
       return "PQstatus: Checking target server properties";
-#endif
-#if PG_VERSION_NUM >= 140000
     case CONNECTION_CHECK_STANDBY:
       return "PQstatus: Checking if server is in standby mode";
-#endif
   }
 
   UINVARIANT(false, "Unhandled ConnStatusType");
@@ -376,16 +378,22 @@ void PGConnectionWrapper::WaitConnectionFinish(Deadline deadline,
 }
 
 void PGConnectionWrapper::EnterPipelineMode() {
-#if LIBPQ_HAS_PIPELINING
   if (!PQenterPipelineMode(conn_)) {
     PGCW_LOG_LIMITED_ERROR()
         << "libpq failed to enter pipeline connection mode";
     throw ConnectionError{"Failed to enter pipeline connection mode"};
   }
   PGCW_LOG_DEBUG() << "Entered pipeline mode";
-#else
-  UINVARIANT(false, "Pipeline mode is not supported");
-#endif
+}
+
+void PGConnectionWrapper::ExitPipelineMode() {
+  if (!PQexitPipelineMode(conn_)) {
+    PGCW_LOG_LIMITED_ERROR()
+        << "libpq failed to exit pipeline connection mode: "
+        << PQerrorMessage(conn_);
+    throw ConnectionError{"Failed to exit pipeline connection mode"};
+  }
+  PGCW_LOG_DEBUG() << "Exited pipeline mode";
 }
 
 bool PGConnectionWrapper::IsSyncingPipeline() const {
@@ -393,11 +401,12 @@ bool PGConnectionWrapper::IsSyncingPipeline() const {
 }
 
 bool PGConnectionWrapper::IsPipelineActive() const {
-#if LIBPQ_HAS_PIPELINING
   return PQpipelineStatus(conn_) != PQ_PIPELINE_OFF;
-#else
-  return false;
-#endif
+}
+
+void PGConnectionWrapper::PipelineSync() {
+  HandleSocketPostClose();
+  CheckError<CommandError>("PQpipelineSync", PQpipelineSync(conn_));
 }
 
 void PGConnectionWrapper::RefreshSocket(const Dsn& dsn) {
@@ -426,13 +435,14 @@ bool PGConnectionWrapper::WaitSocketWriteable(Deadline deadline) {
 }
 
 void PGConnectionWrapper::Flush(Deadline deadline) {
-#if LIBPQ_HAS_PIPELINING
-  if (PQpipelineStatus(conn_) != PQ_PIPELINE_OFF) {
-    HandleSocketPostClose();
-    CheckError<CommandError>("PQpipelineSync", PQpipelineSync(conn_));
+  if (IsPipelineActive()) {
+    PipelineSync();
     is_syncing_pipeline_ = true;
   }
-#endif
+  FlushPipeline(deadline);
+}
+
+void PGConnectionWrapper::FlushPipeline(Deadline deadline) {
   while (const int flush_res = PQflush(conn_)) {
     if (flush_res < 0) {
       HandleSocketPostClose();
@@ -487,8 +497,16 @@ ResultSet PGConnectionWrapper::WaitResult(Deadline deadline,
             << "Query returned several result sets, a result set is discarded";
       }
       auto next_handle = MakeResultHandle(pg_res);
+      switch (PQresultStatus(next_handle.get())) {
+        case PGRES_COPY_IN:
+        case PGRES_COPY_OUT:
+        case PGRES_COPY_BOTH:
+          // libpq returns the COPY result over and over again
+          return MakeResult(std::move(next_handle));
+        default:
+          break;
+      }
       ConsumeInput(deadline);
-#if LIBPQ_HAS_PIPELINING
       if (is_syncing_pipeline_) {
         switch (PQresultStatus(next_handle.get())) {
           case PGRES_PIPELINE_SYNC:
@@ -500,13 +518,209 @@ ResultSet PGConnectionWrapper::WaitResult(Deadline deadline,
             break;
         }
       }
-#endif
       handle = std::move(next_handle);
     }
   } while (is_syncing_pipeline_ && PQstatus(conn_) != CONNECTION_BAD);
   return MakeResult(std::move(handle));
 }
 
+ResultSet PGConnectionWrapper::WaitPipelineSyncResult(
+    Deadline deadline, tracing::ScopeTime& scope) {
+  scope.Reset(scopes::kLibpqWaitResult);
+  auto handle = MakeResultHandle(nullptr);
+  while (true) {
+    ConsumeInput(deadline);
+    auto* pg_res = PQXgetResult(conn_);
+    if (!pg_res) {
+      // The end of results of a statement, the sync point follows
+      if (PQstatus(conn_) == CONNECTION_BAD) {
+        CloseWithError(
+            ConnectionError{"Connection failed while reading a pipeline"});
+      }
+      continue;
+    }
+    auto next_handle = MakeResultHandle(pg_res);
+    const auto status = PQresultStatus(next_handle.get());
+    if (status == PGRES_PIPELINE_SYNC) break;
+    // The statements after a failed one are skipped up to the sync point
+    if (status == PGRES_PIPELINE_ABORTED) continue;
+    handle = std::move(next_handle);
+  }
+  UpdateLastUse();
+  return MakeResult(std::move(handle));
+}
+
+void PGConnectionWrapper::SetSingleRowMode() {
+  if (!PQsetSingleRowMode(conn_)) {
+    PGCW_LOG_LIMITED_ERROR() << "libpq failed to enter single row mode";
+    throw LogicError{"Failed to enter single row mode"};
+  }
+}
+
+std::optional<ResultSet> PGConnectionWrapper::WaitSingleRow(
+    Deadline deadline) {
+  Flush(deadline);
+  ConsumeInput(deadline);
+  auto handle = MakeResultHandle(PQXgetResult(conn_));
+  if (handle && PQresultStatus(handle.get()) == PGRES_SINGLE_TUPLE) {
+    UpdateLastUse();
+    // MakeResult rejects single row results coming from WaitResult
+    return ResultSet{
+        std::make_shared<detail::ResultWrapper>(std::move(handle))};
+  }
+  // Either the completion of the statement or an error, the results are
+  // drained as in WaitResult
+  ConsumeInput(deadline);
+  while (auto* pg_res = PQXgetResult(conn_)) {
+    handle = MakeResultHandle(pg_res);
+    ConsumeInput(deadline);
+  }
+  UpdateLastUse();
+  MakeResult(std::move(handle));
+  return std::nullopt;
+}
+
+void PGConnectionWrapper::WaitCopyStart(ExecStatusType status,
+                                        Deadline deadline,
+                                        tracing::ScopeTime& scope) {
+  scope.Reset(scopes::kLibpqWaitResult);
+  Flush(deadline);
+  ConsumeInput(deadline);
+  // libpq returns the COPY result over and over again while in COPY mode, so
+  // the results can't be drained as in WaitResult
+  auto handle = MakeResultHandle(PQXgetResult(conn_));
+  const auto received =
+      handle ? PQresultStatus(handle.get()) : PGRES_EMPTY_QUERY;
+  if (received == status) {
+    if (PQbinaryTuples(handle.get())) {
+      UpdateLastUse();
+      return;
+    }
+    PGCW_LOG_LIMITED_WARNING()
+        << "COPY statement uses a text format, abandoning it";
+    AbandonCopy(received, deadline);
+    DiscardInput(deadline);
+    throw LogicError{"COPY statement should use (FORMAT binary)"};
+  }
+
+  switch (received) {
+    case PGRES_COPY_IN:
+    case PGRES_COPY_OUT:
+      PGCW_LOG_LIMITED_WARNING() << "COPY statement copies in the opposite "
+                                    "direction, abandoning it";
+      AbandonCopy(received, deadline);
+      DiscardInput(deadline);
+      break;
+    case PGRES_COPY_BOTH:
+      // Closes the connection
+      MakeResult(std::move(handle));
+      break;
+    default:
+      // Either an error or not a COPY statement at all
+      DiscardInput(deadline);
+      MakeResult(std::move(handle));
+      break;
+  }
+  throw LogicError{status == PGRES_COPY_IN
+                       ? "Statement is not a COPY ... FROM STDIN"
+                       : "Statement is not a COPY ... TO STDOUT"};
+}
+
+void PGConnectionWrapper::PutCopyData(std::string_view data,
+                                      Deadline deadline) {
+  while (true) {
+    const int res = PQputCopyData(conn_, data.data(), data.size());
+    if (res > 0) break;
+    if (res < 0) {
+      HandleSocketPostClose();
+      PGCW_LOG_LIMITED_WARNING()
+          << "libpq PQputCopyData error: " << PQerrorMessage(conn_);
+      throw CommandError(std::string{"PQputCopyData execution error: "} +
+                         PQerrorMessage(conn_));
+    }
+    // libpq could not queue the data without blocking
+    Flush(deadline);
+  }
+  // libpq grows its output buffer without a limit, so the data is flushed
+  // here to make the caller wait for the network. The server reports errors
+  // in the data only after PQputCopyEnd.
+  Flush(deadline);
+}
+
+ResultSet PGConnectionWrapper::PutCopyEnd(Deadline deadline,
+                                          tracing::ScopeTime& scope) {
+  while (true) {
+    const int res = PQputCopyEnd(conn_, nullptr);
+    if (res > 0) break;
+    if (res < 0) {
+      HandleSocketPostClose();
+      PGCW_LOG_LIMITED_WARNING()
+          << "libpq PQputCopyEnd error: " << PQerrorMessage(conn_);
+      throw CommandError(std::string{"PQputCopyEnd execution error: "} +
+                         PQerrorMessage(conn_));
+    }
+    Flush(deadline);
+  }
+  UpdateLastUse();
+  return WaitResult(deadline, scope);
+}
+
+std::string_view PGConnectionWrapper::GetCopyData(Deadline deadline) {
+  copy_data_.reset();
+  while (true) {
+    char* buffer = nullptr;
+    const int size = PQgetCopyData(conn_, &buffer, 1);
+    if (size > 0) {
+      copy_data_.reset(buffer);
+      return {buffer, static_cast<std::size_t>(size)};
+    }
+    if (size == -1) {
+      // All the data is received
+      return {};
+    }
+    if (size < -1) {
+      HandleSocketPostClose();
+      PGCW_LOG_LIMITED_WARNING()
+          << "libpq PQgetCopyData error: " << PQerrorMessage(conn_);
+      throw CommandError(std::string{"PQgetCopyData execution error: "} +
+                         PQerrorMessage(conn_));
+    }
+
+    // A whole row is not received yet
+    if (!WaitSocketReadable(deadline)) {
+      if (engine::current_task::ShouldCancel()) {
+        throw ConnectionInterrupted("Task cancelled while reading COPY data");
+      }
+      PGCW_LOG_LIMITED_WARNING()
+          << "Timeout while reading COPY data from PostgreSQL connection "
+             "socket";
+      throw ConnectionTimeoutError("Timed out while reading COPY data");
+    }
+    CheckError<CommandError>("PQconsumeInput", PQconsumeInput(conn_));
+    UpdateLastUse();
+  }
+}
+
+void PGConnectionWrapper::AbandonCopy(ExecStatusType status,
+                                      Deadline deadline) {
+  switch (status) {
+    case PGRES_COPY_IN:
+      CheckError<CommandError>("PQputCopyEnd",
+                               PQputCopyEnd(conn_, kCopyAbandonedMessage) > 0);
+      Flush(deadline);
+      break;
+    case PGRES_COPY_OUT:
+      while (!GetCopyData(deadline).empty()) {
+      }
+      copy_data_.reset();
+      break;
+    case PGRES_COPY_BOTH:
+      CloseWithError(NotImplemented{"COPY BOTH is not supported"});
+    default:
+      break;
+  }
+}
+
 void PGConnectionWrapper::DiscardInput(Deadline deadline) {
   Flush(deadline);
   auto handle = MakeResultHandle(nullptr);
@@ -514,13 +728,12 @@ void PGConnectionWrapper::DiscardInput(Deadline deadline) {
   do {
     while (auto* pg_res = PQXgetResult(conn_)) {
       handle = MakeResultHandle(pg_res);
+      AbandonCopy(PQresultStatus(handle.get()), deadline);
       ConsumeInput(deadline);
-#if LIBPQ_HAS_PIPELINING
       if (is_syncing_pipeline_ &&
           PQresultStatus(handle.get()) == PGRES_PIPELINE_SYNC) {
         is_syncing_pipeline_ = false;
       }
-#endif
     }
   } while (is_syncing_pipeline_);
 }
@@ -555,7 +768,8 @@ ResultSet PGConnectionWrapper::MakeResult(ResultHandle&& handle) {
     case PGRES_COPY_OUT:
     case PGRES_COPY_BOTH:
       PGCW_LOG_LIMITED_ERROR()
-          << "PostgreSQL COPY command invoked which is not implemented"
+          << "PostgreSQL COPY command invoked through Execute, use "
+             "Transaction::CopyIn or Transaction::CopyOut instead"
           << logging::LogExtra::Stacktrace();
       CloseWithError(NotImplemented{"Copy is not implemented"});
     case PGRES_BAD_RESPONSE:
@@ -604,7 +818,6 @@ ResultSet PGConnectionWrapper::MakeResult(ResultHandle&& handle) {
       msg.ThrowException();
       break;
     }
-#if PG_VERSION_NUM >= 140000
     case PGRES_PIPELINE_ABORTED:
       PGCW_LOG_LIMITED_WARNING() << "Command failure in a pipeline";
       CloseWithError(ConnectionError{"Command failure in a pipeline"});
@@ -612,7 +825,6 @@ ResultSet PGConnectionWrapper::MakeResult(ResultHandle&& handle) {
     case PGRES_PIPELINE_SYNC:
       PGCW_LOG_TRACE() << "Successful completion of all commands in a pipeline";
       break;
-#endif
   }
   LOG_DEBUG() << "Result checked";
   return ResultSet{wrapper};
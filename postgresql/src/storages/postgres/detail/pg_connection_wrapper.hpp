@@ -1,6 +1,8 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
+#include <optional>
 #include <string_view>
 
 #include <libpq-fe.h>
@@ -53,10 +55,13 @@ class PGConnectionWrapper {
   ///
   /// Pipeline mode allows applications to send a query without having to read
   /// the result of the previously sent query.
-  ///
-  /// Requires libpq >= 14.
   void EnterPipelineMode();
 
+  /// @brief Causes a connection to exit pipeline mode.
+  ///
+  /// All the results of the pipeline must be read before that.
+  void ExitPipelineMode();
+
   /// @brief Returns true if command send queue is empty.
   ///
   /// Normally command queue is flushed after any Send* call, but in pipeline
@@ -66,6 +71,15 @@ class PGConnectionWrapper {
   /// Check if pipeline mode is currenty enabled
   bool IsPipelineActive() const;
 
+  /// @brief Wrapper for PQpipelineSync
+  ///
+  /// Marks a sync point after the statements sent so far, the results up to
+  /// it should be read with WaitPipelineSyncResult.
+  void PipelineSync();
+
+  /// @brief Send the queued commands without adding a sync point
+  void FlushPipeline(Deadline deadline);
+
   /// @brief Close the connection on a background task processor.
   [[nodiscard]] engine::Task Close();
 
@@ -103,9 +117,47 @@ class PGConnectionWrapper {
   /// Will return result or throw an exception
   ResultSet WaitResult(Deadline deadline, tracing::ScopeTime&);
 
+  /// @brief Wait for the result of a single statement sent in pipeline mode
+  /// and followed by its own PipelineSync.
+  /// Will return result or throw an exception. If the connection is still
+  /// alive after the exception, the error belongs to the statement only.
+  ResultSet WaitPipelineSyncResult(Deadline deadline, tracing::ScopeTime&);
+
+  /// @brief Wrapper for PQsetSingleRowMode
+  /// Must be called right after sending a statement, the rows of its result
+  /// should be read with WaitSingleRow
+  void SetSingleRowMode();
+
+  /// @brief Wait for the next row of a statement in single row mode
+  /// Will return a result set with a single row, std::nullopt when all the
+  /// rows are received, or throw an exception
+  std::optional<ResultSet> WaitSingleRow(Deadline deadline);
+
+  /// @brief Wait for the server to enter COPY mode after a COPY statement
+  /// @param status PGRES_COPY_IN or PGRES_COPY_OUT
+  /// @throws LogicError if the statement does not copy in that direction or
+  /// does not use the binary format
+  void WaitCopyStart(ExecStatusType status, Deadline deadline,
+                     tracing::ScopeTime&);
+
+  /// @brief Wrapper for PQputCopyData
+  /// Waits until the data is sent to the socket, so the caller can't queue
+  /// more data than the network accepts
+  void PutCopyData(std::string_view data, Deadline deadline);
+
+  /// @brief Wrapper for PQputCopyEnd
+  /// Will return the result of the COPY statement or throw an exception
+  ResultSet PutCopyEnd(Deadline deadline, tracing::ScopeTime&);
+
+  /// @brief Wrapper for PQgetCopyData
+  /// Returns the next row of COPY data, the data stays valid until the next
+  /// call. Returns an empty string when all the data is received, the result
+  /// of the COPY statement should be waited for after that.
+  std::string_view GetCopyData(Deadline deadline);
+
   /// Consume input from connection
   void ConsumeInput(Deadline deadline);
-  /// Consume all input discarding all result sets
+  /// Consume all input discarding all result sets, abandons COPY in progress
   void DiscardInput(Deadline deadline);
 
   /// Consume input while the connection is busy.
@@ -143,6 +195,9 @@ class PGConnectionWrapper {
 
   ResultSet MakeResult(ResultHandle&& handle);
 
+  /// Makes the server leave the COPY mode of the status
+  void AbandonCopy(ExecStatusType status, Deadline deadline);
+
   template <typename ExceptionType>
   void CheckError(const std::string& cmd, int pg_dispatch_result);
 
@@ -156,6 +211,7 @@ class PGConnectionWrapper {
   engine::TaskProcessor& bg_task_processor_;
 
   PGconn* conn_{nullptr};
+  std::unique_ptr<char, decltype(&PQfreemem)> copy_data_{nullptr, &PQfreemem};
   engine::io::Socket socket_;
   logging::LogExtra log_extra_;
   SizeGuard size_guard_;
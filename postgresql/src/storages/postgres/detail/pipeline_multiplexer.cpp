@@ -0,0 +1,261 @@
+#include <storages/postgres/detail/pipeline_multiplexer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <string>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/future.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+
+#include <storages/postgres/detail/connection.hpp>
+#include <storages/postgres/detail/pool.hpp>
+#include <userver/storages/postgres/exceptions.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres::detail {
+
+namespace {
+
+/// A copy of the statement parameters, as the task that formatted them may
+/// give up waiting before the statement is sent
+class OwnedParameters {
+ public:
+  explicit OwnedParameters(const QueryParameters& params)
+      : types_(params.ParamTypesBuffer(),
+               params.ParamTypesBuffer() + params.Size()),
+        lengths_(params.ParamLengthsBuffer(),
+                 params.ParamLengthsBuffer() + params.Size()),
+        formats_(params.ParamFormatsBuffer(),
+                 params.ParamFormatsBuffer() + params.Size()),
+        values_(params.Size(), nullptr) {
+    std::vector<std::size_t> offsets(params.Size());
+    for (std::size_t i = 0; i < params.Size(); ++i) {
+      offsets[i] = buffer_.size();
+      if (params.ParamBuffers()[i] && lengths_[i] > 0) {
+        buffer_.append(params.ParamBuffers()[i], lengths_[i]);
+      }
+    }
+    for (std::size_t i = 0; i < params.Size(); ++i) {
+      if (params.ParamBuffers()[i]) {
+        values_[i] = buffer_.data() + offsets[i];
+      }
+    }
+  }
+
+  OwnedParameters(const OwnedParameters&) = delete;
+  OwnedParameters& operator=(const OwnedParameters&) = delete;
+
+  std::size_t Size() const { return values_.size(); }
+  const char* const* ParamBuffers() const { return values_.data(); }
+  const Oid* ParamTypesBuffer() const { return types_.data(); }
+  const int* ParamLengthsBuffer() const { return lengths_.data(); }
+  const int* ParamFormatsBuffer() const { return formats_.data(); }
+
+ private:
+  std::vector<Oid> types_;
+  std::vector<int> lengths_;
+  std::vector<int> formats_;
+  std::string buffer_;
+  std::vector<const char*> values_;
+};
+
+}  // namespace
+
+struct PipelineMultiplexer::Request {
+  Request(const Query& query, const QueryParameters& params,
+          TimeoutDuration statement_timeout, engine::Deadline deadline)
+      : query{query},
+        params{params},
+        statement_timeout{statement_timeout},
+        deadline{deadline} {}
+
+  const Query query;
+  const OwnedParameters params;
+  const TimeoutDuration statement_timeout;
+  const engine::Deadline deadline;
+  engine::Promise<ResultSet> promise;
+  std::atomic<bool> abandoned{false};
+};
+
+class PipelineMultiplexer::EmplaceEnabler {};
+
+PipelineMultiplexer::PipelineMultiplexer(EmplaceEnabler,
+                                         std::weak_ptr<ConnectionPool> pool)
+    : pool_{std::move(pool)} {}
+
+PipelineMultiplexer::~PipelineMultiplexer() {
+  UASSERT_MSG(!running_workers_, "Workers keep the multiplexer alive");
+}
+
+std::shared_ptr<PipelineMultiplexer> PipelineMultiplexer::Create(
+    std::weak_ptr<ConnectionPool> pool, std::size_t workers) {
+  auto multiplexer =
+      std::make_shared<PipelineMultiplexer>(EmplaceEnabler{}, std::move(pool));
+  multiplexer->running_workers_ = workers;
+  for (std::size_t i = 0; i < workers; ++i) {
+    // The workers own the multiplexer until they exit after Stop()
+    engine::CriticalAsyncNoSpan([multiplexer] {
+      multiplexer->Run();
+    }).Detach();
+  }
+  return multiplexer;
+}
+
+void PipelineMultiplexer::Stop() {
+  {
+    std::lock_guard lock{mutex_};
+    stopped_ = true;
+  }
+  request_available_.NotifyAll();
+}
+
+std::shared_ptr<const UserTypes> PipelineMultiplexer::GetUserTypes() const {
+  return user_types_.ReadCopy();
+}
+
+void PipelineMultiplexer::UpdateUserTypes(const Connection& conn) {
+  const auto version = static_cast<std::int64_t>(conn.GetUserTypesVersion());
+  if (version <= user_types_version_.load()) return;
+
+  // Writers are serialized, so the versions only grow
+  auto user_types = user_types_.StartWrite();
+  if (version <= user_types_version_.load()) return;
+  *user_types = std::make_shared<const UserTypes>(conn.GetUserTypes().Clone());
+  user_types.Commit();
+  user_types_version_ = version;
+}
+
+std::optional<ResultSet> PipelineMultiplexer::Execute(
+    const Query& query, const QueryParameters& params,
+    TimeoutDuration statement_timeout, engine::Deadline deadline) {
+  auto request =
+      std::make_shared<Request>(query, params, statement_timeout, deadline);
+  auto future = request->promise.get_future();
+  {
+    std::lock_guard lock{mutex_};
+    if (stopped_) return std::nullopt;
+    queue_.push_back(request);
+  }
+  request_available_.NotifyOne();
+
+  if (future.wait_until(deadline) != engine::FutureStatus::kReady) {
+    request->abandoned = true;
+    if (engine::current_task::ShouldCancel()) {
+      throw ConnectionInterrupted(
+          "Task cancelled while waiting for a pipelined statement");
+    }
+    throw ConnectionTimeoutError(
+        "Timed out while waiting for a pipelined statement");
+  }
+  return future.get();
+}
+
+void PipelineMultiplexer::Run() {
+  for (auto batch = PopBatch(); !batch.empty(); batch = PopBatch()) {
+    RunBatch(batch);
+  }
+  OnWorkerExit();
+}
+
+std::vector<PipelineMultiplexer::RequestPtr> PipelineMultiplexer::PopBatch() {
+  std::unique_lock lock{mutex_};
+  if (!request_available_.Wait(
+          lock, [this] { return stopped_ || !queue_.empty(); })) {
+    // The task is cancelled, the task processor is shutting down
+    return {};
+  }
+  const auto statement_timeout = queue_.front()->statement_timeout;
+  std::vector<RequestPtr> batch;
+  batch.reserve(std::min(queue_.size(), kMaxBatchSize));
+  auto kept = queue_.begin();
+  for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+    if (batch.size() < kMaxBatchSize &&
+        (*it)->statement_timeout == statement_timeout) {
+      batch.push_back(std::move(*it));
+    } else {
+      *kept++ = std::move(*it);
+    }
+  }
+  queue_.erase(kept, queue_.end());
+  return batch;
+}
+
+void PipelineMultiplexer::RunBatch(std::vector<RequestPtr>& batch) {
+  // The tasks that gave up waiting don't need the results anymore
+  batch.erase(std::remove_if(batch.begin(), batch.end(),
+                             [](const RequestPtr& request) {
+                               return request->abandoned.load();
+                             }),
+              batch.end());
+  if (batch.empty()) return;
+
+  auto deadline = batch.front()->deadline;
+  const auto statement_timeout = batch.front()->statement_timeout;
+  std::vector<Connection::BatchStatement> statements;
+  statements.reserve(batch.size());
+  for (const auto& request : batch) {
+    UASSERT(request->statement_timeout == statement_timeout);
+    if (deadline < request->deadline) deadline = request->deadline;
+    statements.push_back(
+        {&request->query, QueryParameters{request->params}, {}, {}});
+  }
+
+  try {
+    const auto pool = pool_.lock();
+    if (!pool) {
+      throw PoolError{"Connection pool is destroyed"};
+    }
+    auto conn = pool->Acquire(deadline);
+    // The connection may have reloaded the types after an unknown one
+    UpdateUserTypes(*conn);
+    conn->Start(SteadyClock::now());
+    try {
+      conn->ExecuteBatch(statements, statement_timeout, deadline);
+    } catch (const std::exception&) {
+      conn->Finish();
+      throw;
+    }
+    conn->Finish();
+  } catch (const std::exception& e) {
+    LOG_LIMITED_WARNING() << "Failed to execute a batch of "
+                          << statements.size() << " pipelined statements: "
+                          << e;
+    const auto error = std::current_exception();
+    for (auto& statement : statements) {
+      if (!statement.result && !statement.error) statement.error = error;
+    }
+  }
+
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    if (statements[i].error) {
+      batch[i]->promise.set_exception(statements[i].error);
+    } else {
+      batch[i]->promise.set_value(std::move(*statements[i].result));
+    }
+  }
+}
+
+void PipelineMultiplexer::OnWorkerExit() {
+  std::deque<RequestPtr> orphans;
+  {
+    std::lock_guard lock{mutex_};
+    UASSERT(running_workers_ > 0);
+    if (--running_workers_ > 0) return;
+    // The last worker is cancelled, nobody would execute the rest
+    stopped_ = true;
+    orphans.swap(queue_);
+  }
+  for (auto& request : orphans) {
+    request->promise.set_exception(std::make_exception_ptr(
+        ConnectionInterrupted{"Pipeline multiplexer is stopped"}));
+  }
+}
+
+}  // namespace storages::postgres::detail
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/rcu/rcu.hpp>
+
+#include <userver/storages/postgres/detail/query_parameters.hpp>
+#include <userver/storages/postgres/detail/time_types.hpp>
+#include <userver/storages/postgres/io/user_types.hpp>
+#include <userver/storages/postgres/query.hpp>
+#include <userver/storages/postgres/result_set.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres::detail {
+
+class Connection;
+class ConnectionPool;
+
+/// @brief Executes single statements of many tasks on a few connections
+///
+/// The statements waiting in the queue are taken by a worker as a batch and
+/// sent over a connection of the pool in pipeline mode, so a batch costs a
+/// single network roundtrip. The statements of a batch share the statement
+/// timeout, so the ones with other timeouts are left for the next batches.
+class PipelineMultiplexer
+    : public std::enable_shared_from_this<PipelineMultiplexer> {
+  class EmplaceEnabler;
+
+ public:
+  /// Maximum number of statements sent in a batch
+  static constexpr std::size_t kMaxBatchSize = 64;
+
+  PipelineMultiplexer(EmplaceEnabler, std::weak_ptr<ConnectionPool> pool);
+  ~PipelineMultiplexer();
+
+  /// Start the workers, each of them uses a connection of the pool at a time
+  static std::shared_ptr<PipelineMultiplexer> Create(
+      std::weak_ptr<ConnectionPool> pool, std::size_t workers);
+
+  /// Stop accepting statements, the workers exit as soon as the statements
+  /// already queued are executed
+  void Stop();
+
+  /// Returns the user types for formatting the statement parameters,
+  /// nullptr if no connection provided them yet
+  std::shared_ptr<const UserTypes> GetUserTypes() const;
+  /// Takes the user types of the connection if they were loaded later than
+  /// the ones the multiplexer has
+  void UpdateUserTypes(const Connection& conn);
+
+  /// Suspends the task until the statement is executed in a batch
+  /// @returns std::nullopt if the multiplexer is stopped and the statement
+  /// should be executed on a connection of its own
+  /// @throws ConnectionTimeoutError if the deadline is reached
+  std::optional<ResultSet> Execute(const Query& query,
+                                   const QueryParameters& params,
+                                   TimeoutDuration statement_timeout,
+                                   engine::Deadline deadline);
+
+ private:
+  struct Request;
+  using RequestPtr = std::shared_ptr<Request>;
+
+  void Run();
+  std::vector<RequestPtr> PopBatch();
+  void RunBatch(std::vector<RequestPtr>& batch);
+  void OnWorkerExit();
+
+  const std::weak_ptr<ConnectionPool> pool_;
+  rcu::Variable<std::shared_ptr<const UserTypes>> user_types_;
+  // Connection::GetUserTypesVersion() of user_types_, -1 if there are none
+  std::atomic<std::int64_t> user_types_version_{-1};
+
+  engine::Mutex mutex_;
+  engine::ConditionVariable request_available_;
+  std::deque<RequestPtr> queue_;
+  std::size_t running_workers_{0};
+  bool stopped_{false};
+};
+
+}  // namespace storages::postgres::detail
+
+USERVER_NAMESPACE_END
@@ -2,12 +2,18 @@
 
 #include <storages/postgres/detail/statement_timings_storage.hpp>
 
+#include <mutex>
+
 #include <userver/engine/async.hpp>
+#include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/sleep.hpp>
 #include <userver/engine/task/cancel.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/storages/postgres/detail/time_types.hpp>
 #include <userver/storages/postgres/exceptions.hpp>
+#include <userver/tracing/tags.hpp>
+
+#include <storages/postgres/detail/tracing_tags.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -54,10 +60,20 @@ class Stopwatch {
   SteadyClock::time_point start_;
 };
 
+std::size_t GetCurrentThreadSlot() noexcept {
+  return USERVER_NAMESPACE::utils::statistics::impl::GetCurrentShardIndex();
+}
+
 }  // namespace
 
 class ConnectionPool::EmplaceEnabler {};
 
+struct ConnectionPool::Waiter {
+  engine::SingleConsumerEvent event;
+  Connection* connection{nullptr};
+  std::list<Waiter*>::iterator position;
+};
+
 ConnectionPool::ConnectionPool(
     EmplaceEnabler, Dsn dsn, clients::dns::Resolver* resolver,
     engine::TaskProcessor& bg_task_processor, const std::string& db_name,
@@ -72,6 +88,8 @@ ConnectionPool::ConnectionPool(
       settings_{settings},
       conn_settings_{conn_settings},
       bg_task_processor_{bg_task_processor},
+      thread_cache_{
+          USERVER_NAMESPACE::utils::statistics::impl::GetShardCount()},
       queue_{settings.max_size},
       size_{std::make_shared<std::atomic<size_t>>(0)},
       connecting_semaphore_{settings.connecting_limit
@@ -86,6 +104,7 @@ ConnectionPool::ConnectionPool(
       sts_{statement_metrics_settings} {}
 
 ConnectionPool::~ConnectionPool() {
+  SetPipelineConnections(0);
   StopMaintainTask();
   Clear();
 }
@@ -145,6 +164,7 @@ void ConnectionPool::Init(InitMode mode) {
     }
   }
   LOG_INFO() << "Pool initialized";
+  SetPipelineConnections(settings->pipeline_connections);
   StartMaintainTask();
 }
 
@@ -293,13 +313,59 @@ Transaction ConnectionPool::Begin(const TransactionOptions& options,
 
 NonTransaction ConnectionPool::Start(OptionalCommandControl cmd_ctl) {
   const auto start_time = detail::SteadyClock::now();
+  const auto multiplexer = multiplexer_.ReadCopy();
+  if (multiplexer) {
+    if (auto user_types = multiplexer->GetUserTypes()) {
+      return NonTransaction{shared_from_this(), std::move(user_types)};
+    }
+  }
   const auto deadline =
       testsuite_pg_ctl_.MakeExecuteDeadline(GetExecuteTimeout(cmd_ctl));
   auto conn = Acquire(deadline);
   UASSERT(conn);
+  if (multiplexer) {
+    // Statements can be multiplexed as soon as their parameters can be
+    // formatted without a connection
+    multiplexer->UpdateUserTypes(*conn);
+  }
   return NonTransaction{std::move(conn), start_time};
 }
 
+NonTransaction ConnectionPool::StartDedicated(OptionalCommandControl cmd_ctl) {
+  const auto start_time = detail::SteadyClock::now();
+  const auto deadline =
+      testsuite_pg_ctl_.MakeExecuteDeadline(GetExecuteTimeout(cmd_ctl));
+  return NonTransaction{Acquire(deadline), start_time};
+}
+
+ResultSet ConnectionPool::ExecutePipelined(const Query& query,
+                                           const QueryParameters& params,
+                                           OptionalCommandControl cmd_ctl) {
+  const auto statement_cmd_ctl =
+      cmd_ctl ? *cmd_ctl : GetDefaultCommandControl();
+  const auto deadline =
+      testsuite_pg_ctl_.MakeExecuteDeadline(statement_cmd_ctl.execute);
+  if (const auto multiplexer = multiplexer_.ReadCopy()) {
+    tracing::Span span{scopes::kQuery};
+    query.FillSpanTags(span);
+    try {
+      auto res = multiplexer->Execute(query, params,
+                                      statement_cmd_ctl.statement, deadline);
+      if (res) return std::move(*res);
+    } catch (const std::exception&) {
+      span.AddTag(tracing::kErrorFlag, true);
+      throw;
+    }
+  }
+
+  // The multiplexer was stopped by a settings update
+  auto conn = Acquire(deadline);
+  conn->Start(detail::SteadyClock::now());
+  auto res = conn->Execute(query, params, std::move(cmd_ctl));
+  conn->Finish();
+  return res;
+}
+
 TimeoutDuration ConnectionPool::GetExecuteTimeout(
     OptionalCommandControl cmd_ctl) const {
   if (cmd_ctl) return cmd_ctl->execute;
@@ -318,7 +384,12 @@ void ConnectionPool::SetSettings(const PoolSettings& settings) {
     connecting_semaphore_.SetCapacity(settings.connecting_limit
                                           ? settings.connecting_limit
                                           : kUnlimitedConnecting);
+  const bool restart_multiplexer =
+      reader->pipeline_connections != settings.pipeline_connections;
   settings_.Assign(settings);
+  if (restart_multiplexer) {
+    SetPipelineConnections(settings.pipeline_connections);
+  }
 }
 
 void ConnectionPool::SetConnectionSettings(const ConnectionSettings& settings) {
@@ -419,17 +490,31 @@ void ConnectionPool::CheckMinPoolSizeUnderflow() {
 }
 
 void ConnectionPool::Push(Connection* connection) {
-  auto conn_settings = conn_settings_.Read();
-  if (connection->GetSettings().version < conn_settings->version) {
-    DropOutdatedConnection(connection);
-  } else if (queue_.push(connection)) {
-    conn_available_.NotifyOne();
-  } else {
+  {
+    auto conn_settings = conn_settings_.Read();
+    if (connection->GetSettings().version < conn_settings->version) {
+      DropOutdatedConnection(connection);
+      return;
+    }
+  }
+
+  // Waiting tasks are served in FIFO order before the connection is cached
+  if (wait_count_ > 0 && HandOver(connection)) return;
+
+  // The connection cached by the thread before is the next one to go idle
+  connection = thread_cache_[GetCurrentThreadSlot()].connection.exchange(
+      connection);
+  if (connection && !queue_.push(connection)) {
     // TODO Reflect this as a statistics error
     LOG_LIMITED_WARNING()
         << "Couldn't push connection back to the pool. Deleting...";
     DeleteConnection(connection);
   }
+
+  // A task might have started waiting after the check above, it checks for
+  // idle connections under the wait mutex
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (wait_count_ > 0) HandOverIdle();
 }
 
 Connection* ConnectionPool::Pop(engine::Deadline deadline) {
@@ -442,15 +527,7 @@ Connection* ConnectionPool::Pop(engine::Deadline deadline) {
     throw PoolError("Deadline reached before trying to get a connection");
   }
   Stopwatch st{stats_.acquire_percentile};
-  Connection* connection = nullptr;
-  auto conn_settings = conn_settings_.Read();
-  while (queue_.pop(connection)) {
-    if (connection->GetSettings().version < conn_settings->version) {
-      DropOutdatedConnection(connection);
-      continue;
-    }
-    return connection;
-  }
+  if (auto* connection = TryPop()) return connection;
 
   auto settings = settings_.Read();
   SizeGuard wg(wait_count_);
@@ -465,14 +542,7 @@ Connection* ConnectionPool::Pop(engine::Deadline deadline) {
               << "ms";
   TryCreateConnectionAsync();
 
-  {
-    std::unique_lock<engine::Mutex> lock{wait_mutex_};
-    // Wait for a connection
-    if (conn_available_.WaitUntil(lock, deadline,
-                                  [&] { return queue_.pop(connection); })) {
-      return connection;
-    }
-  }
+  if (auto* connection = Wait(deadline)) return connection;
 
   if (engine::current_task::ShouldCancel()) {
     throw PoolError("Task was cancelled while waiting for connection");
@@ -482,7 +552,93 @@ Connection* ConnectionPool::Pop(engine::Deadline deadline) {
   throw PoolError("No available connections found", db_name_);
 }
 
+Connection* ConnectionPool::TryPop() {
+  auto conn_settings = conn_settings_.Read();
+  const auto is_usable = [&](Connection* connection) {
+    if (!connection) return false;
+    if (connection->GetSettings().version < conn_settings->version) {
+      DropOutdatedConnection(connection);
+      return false;
+    }
+    return true;
+  };
+
+  // The connection released last on the thread has the warmest caches
+  const auto current_slot = GetCurrentThreadSlot();
+  Connection* connection =
+      thread_cache_[current_slot].connection.exchange(nullptr);
+  if (is_usable(connection)) return connection;
+
+  while (queue_.pop(connection)) {
+    if (is_usable(connection)) return connection;
+  }
+
+  for (std::size_t slot = 0; slot < thread_cache_.size(); ++slot) {
+    auto& cached = thread_cache_[slot].connection;
+    if (slot == current_slot || !cached.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    connection = cached.exchange(nullptr);
+    if (is_usable(connection)) return connection;
+  }
+  return nullptr;
+}
+
+Connection* ConnectionPool::Wait(engine::Deadline deadline) {
+  Waiter waiter;
+  {
+    std::lock_guard lock{wait_mutex_};
+    // A connection released before the waiter is queued is not handed over
+    if (auto* connection = TryPop()) return connection;
+    waiter.position = waiters_.insert(waiters_.end(), &waiter);
+  }
+
+  Stopwatch st{stats_.wait_percentile};
+  [[maybe_unused]] const bool handed_over =
+      waiter.event.WaitForEventUntil(deadline);
+
+  std::lock_guard lock{wait_mutex_};
+  // The connection may be handed over after the wait is over
+  if (!waiter.connection) waiters_.erase(waiter.position);
+  return waiter.connection;
+}
+
+bool ConnectionPool::HandOver(Connection* connection) {
+  std::lock_guard lock{wait_mutex_};
+  if (waiters_.empty()) return false;
+  auto* waiter = waiters_.front();
+  waiters_.pop_front();
+  waiter->connection = connection;
+  // The waiter can't leave before the mutex is unlocked
+  waiter->event.Send();
+  return true;
+}
+
+void ConnectionPool::HandOverIdle() {
+  std::lock_guard lock{wait_mutex_};
+  while (!waiters_.empty()) {
+    auto* connection = TryPop();
+    if (!connection) break;
+    auto* waiter = waiters_.front();
+    waiters_.pop_front();
+    waiter->connection = connection;
+    waiter->event.Send();
+  }
+}
+
+void ConnectionPool::FlushThreadCache() {
+  for (auto& cached : thread_cache_) {
+    auto* connection = cached.connection.exchange(nullptr);
+    if (connection && !queue_.push(connection)) {
+      DeleteConnection(connection);
+    }
+  }
+}
+
 void ConnectionPool::Clear() {
+  for (auto& cached : thread_cache_) {
+    delete cached.connection.exchange(nullptr);
+  }
   Connection* connection = nullptr;
   while (queue_.pop(connection)) {
     delete connection;
@@ -506,18 +662,13 @@ void ConnectionPool::DropOutdatedConnection(Connection* connection) {
 }
 
 Connection* ConnectionPool::AcquireImmediate() {
-  Connection* conn = nullptr;
-  auto conn_settings = conn_settings_.Read();
-  while (queue_.pop(conn)) {
-    if (conn->GetSettings().version < conn_settings->version) {
-      DropOutdatedConnection(conn);
-      continue;
-    }
+  auto* conn = TryPop();
+  if (conn) {
     ++stats_.connection.used;
-    return conn;
+  } else {
+    ++stats_.pool_exhaust_errors;
   }
-  ++stats_.pool_exhaust_errors;
-  return nullptr;
+  return conn;
 }
 
 void ConnectionPool::MaintainConnections() {
@@ -536,6 +687,9 @@ void ConnectionPool::MaintainConnections() {
   auto settings = settings_.Read();
   while (count > 0 && stale_connection) {
     try {
+      // The connections idle for longest are at the head of the shared queue,
+      // the pinged ones go to its tail
+      FlushThreadCache();
       auto deleter = [this](Connection* c) { DeleteConnection(c); };
       std::unique_ptr<Connection, decltype(deleter)> conn(AcquireImmediate(),
                                                           deleter);
@@ -587,6 +741,19 @@ void ConnectionPool::AssignNewSettings(ConnectionSettings settings,
   conn_settings_.Assign(std::move(settings));
 }
 
+void ConnectionPool::SetPipelineConnections(std::size_t count) {
+  std::shared_ptr<PipelineMultiplexer> multiplexer;
+  if (count > 0) {
+    LOG_INFO() << "Multiplexing statements over " << count
+               << " pipelined PostgreSQL connections to "
+               << DsnCutPassword(dsn_);
+    multiplexer = PipelineMultiplexer::Create(weak_from_this(), count);
+  }
+  auto old_multiplexer = multiplexer_.ReadCopy();
+  multiplexer_.Assign(std::move(multiplexer));
+  if (old_multiplexer) old_multiplexer->Stop();
+}
+
 }  // namespace storages::postgres::detail
 
 USERVER_NAMESPACE_END
@@ -1,20 +1,24 @@
 #pragma once
 
 #include <atomic>
+#include <list>
 #include <memory>
 #include <vector>
 
 #include <boost/lockfree/queue.hpp>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
-#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/mutex.hpp>
 #include <userver/engine/semaphore.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/engine/task/task_with_result.hpp>
 #include <userver/error_injection/settings.hpp>
 #include <userver/rcu/rcu.hpp>
 #include <userver/testsuite/postgres_control.hpp>
+#include <userver/utils/fixed_array.hpp>
+#include <userver/utils/impl/interference_size.hpp>
 #include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
 #include <userver/utils/token_bucket.hpp>
 #include <utils/size_guard.hpp>
 
@@ -27,6 +31,7 @@
 
 #include <storages/postgres/detail/connection.hpp>
 #include <storages/postgres/detail/pg_impl_types.hpp>
+#include <storages/postgres/detail/pipeline_multiplexer.hpp>
 #include <storages/postgres/detail/statement_timings_storage.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -67,6 +72,16 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
 
   [[nodiscard]] NonTransaction Start(OptionalCommandControl cmd_ctl = {});
 
+  /// Start a single statement on a connection of its own, the statement is
+  /// never pipelined together with the statements of other tasks
+  [[nodiscard]] NonTransaction StartDedicated(
+      OptionalCommandControl cmd_ctl = {});
+
+  /// Execute a statement together with the statements of other tasks, see
+  /// PoolSettings::pipeline_connections
+  ResultSet ExecutePipelined(const Query& query, const QueryParameters& params,
+                             OptionalCommandControl cmd_ctl);
+
   CommandControl GetDefaultCommandControl() const;
 
   void SetSettings(const PoolSettings& settings);
@@ -95,9 +110,30 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
   void TryCreateConnectionAsync();
   void CheckMinPoolSizeUnderflow();
 
+  struct Waiter;
+
+  /// Idle connection released last by the threads of a shard, see
+  /// utils::statistics::impl::GetCurrentShardIndex
+  struct alignas(USERVER_NAMESPACE::utils::impl::kInterferenceSize)
+      CachedConnection {
+    std::atomic<Connection*> connection{nullptr};
+  };
+
   void Push(Connection* connection);
   Connection* Pop(engine::Deadline);
 
+  /// Takes an idle connection without waiting, the one released last by the
+  /// current thread if possible
+  Connection* TryPop();
+  /// Waits in the FIFO queue of the tasks that found no idle connection
+  Connection* Wait(engine::Deadline);
+  /// Gives the connection to the oldest waiting task
+  bool HandOver(Connection* connection);
+  /// Gives the idle connections to the waiting tasks
+  void HandOverIdle();
+  /// Moves the connections cached by the threads to the shared queue
+  void FlushThreadCache();
+
   void Clear();
 
   void DeleteConnection(Connection* connection);
@@ -114,6 +150,8 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
   void AssignNewSettings(ConnectionSettings settings,
                          const ConnectionSettings& old_settings);
 
+  void SetPipelineConnections(std::size_t count);
+
   using RecentCounter = USERVER_NAMESPACE::utils::statistics::RecentPeriod<
       USERVER_NAMESPACE::utils::statistics::RelaxedCounter<size_t>, size_t>;
 
@@ -125,9 +163,10 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
   rcu::Variable<ConnectionSettings> conn_settings_;
   engine::TaskProcessor& bg_task_processor_;
   USERVER_NAMESPACE::utils::PeriodicTask ping_task_;
-  engine::Mutex wait_mutex_;
-  engine::ConditionVariable conn_available_;
+  USERVER_NAMESPACE::utils::FixedArray<CachedConnection> thread_cache_;
   boost::lockfree::queue<Connection*> queue_;
+  engine::Mutex wait_mutex_;
+  std::list<Waiter*> waiters_;
   SharedCounter size_;
   engine::Semaphore connecting_semaphore_;
   std::atomic<size_t> wait_count_;
@@ -137,6 +176,7 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
   RecentCounter recent_conn_errors_;
   USERVER_NAMESPACE::utils::TokenBucket cancel_limit_;
   detail::StatementTimingsStorage sts_;
+  rcu::Variable<std::shared_ptr<PipelineMultiplexer>> multiplexer_;
 };
 
 }  // namespace storages::postgres::detail
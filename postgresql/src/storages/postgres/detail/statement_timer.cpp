@@ -9,8 +9,12 @@ USERVER_NAMESPACE_BEGIN
 namespace storages::postgres::detail {
 
 StatementTimer::StatementTimer(const Query& query, const ConnectionPtr& conn)
+    : StatementTimer{query, conn.GetStatementTimingsStorage()} {}
+
+StatementTimer::StatementTimer(const Query& query,
+                               const StatementTimingsStorage* sts)
     : query_{query},
-      sts_{conn.GetStatementTimingsStorage()},
+      sts_{sts},
       start_{sts_ != nullptr ? Now() : SteadyClock::time_point{}} {}
 
 void StatementTimer::Account() {
@@ -16,6 +16,7 @@ class StatementTimingsStorage;
 class StatementTimer final {
  public:
   StatementTimer(const Query& query, const ConnectionPtr& conn);
+  StatementTimer(const Query& query, const StatementTimingsStorage* sts);
 
   void Account();
 
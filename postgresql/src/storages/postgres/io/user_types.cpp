@@ -47,6 +47,15 @@ void UserTypes::Reset() {
   composite_types_.clear();
 }
 
+UserTypes UserTypes::Clone() const {
+  UserTypes copy;
+  for (const auto& desc : types_) {
+    copy.AddType(DBTypeDescription{desc});
+  }
+  copy.composite_types_ = composite_types_;
+  return copy;
+}
+
 Oid UserTypes::FindOid(DBTypeName name) const {
   if (auto f = by_name_.find(name); f != by_name_.end()) {
     return f->second->oid;
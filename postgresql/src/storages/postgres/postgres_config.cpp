@@ -91,11 +91,17 @@ PoolSettings ParsePoolSettings(const ConfigType& config) {
       config["max_queue_size"].template As<size_t>(result.max_queue_size);
   result.connecting_limit =
       config["connecting_limit"].template As<size_t>(result.connecting_limit);
+  result.pipeline_connections =
+      config["pipeline_connections"].template As<size_t>(
+          result.pipeline_connections);
 
   if (result.max_size == 0)
     throw InvalidConfig{"max_pool_size must be greater than 0"};
   if (result.max_size < result.min_size)
     throw InvalidConfig{"max_pool_size cannot be less than min_pool_size"};
+  if (result.max_size < result.pipeline_connections)
+    throw InvalidConfig{
+        "max_pool_size cannot be less than pipeline_connections"};
 
   return result;
 }
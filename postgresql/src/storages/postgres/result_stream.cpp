@@ -0,0 +1,88 @@
+#include <userver/storages/postgres/result_stream.hpp>
+
+#include <utility>
+
+#include <storages/postgres/detail/connection.hpp>
+#include <userver/logging/log.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::postgres {
+
+ResultStream::ResultStream(detail::Connection* conn, const Query& query,
+                           const detail::QueryParameters& params,
+                           OptionalCommandControl cmd_ctl)
+    : conn_{conn},
+      owned_conn_{nullptr},
+      query_{query},
+      cmd_ctl_{std::move(cmd_ctl)} {
+  if (!cmd_ctl_) {
+    cmd_ctl_ = conn_->GetQueryCmdCtl(query_.GetName());
+  }
+  conn_->StreamStart(query_, params, cmd_ctl_);
+}
+
+ResultStream::ResultStream(detail::ConnectionPtr&& conn, const Query& query,
+                           const detail::QueryParameters& params,
+                           OptionalCommandControl cmd_ctl)
+    : ResultStream{conn.get(), query, params, std::move(cmd_ctl)} {
+  owned_conn_ = std::move(conn);
+}
+
+ResultStream::ResultStream(ResultStream&& rhs) noexcept
+    : conn_{std::exchange(rhs.conn_, nullptr)},
+      owned_conn_{std::move(rhs.owned_conn_)},
+      query_{std::move(rhs.query_)},
+      cmd_ctl_{std::move(rhs.cmd_ctl_)} {}
+
+ResultStream& ResultStream::operator=(ResultStream&& rhs) noexcept {
+  ResultStream tmp{std::move(rhs)};
+  std::swap(conn_, tmp.conn_);
+  std::swap(owned_conn_, tmp.owned_conn_);
+  std::swap(query_, tmp.query_);
+  std::swap(cmd_ctl_, tmp.cmd_ctl_);
+  return *this;
+}
+
+ResultStream::~ResultStream() {
+  if (conn_) {
+    LOG_DEBUG() << "Result stream is destroyed before reading all the rows, "
+                   "the statement is cancelled";
+    try {
+      conn_->StreamAbandon(cmd_ctl_);
+    } catch (const std::exception& e) {
+      LOG_WARNING() << "Failed to cancel a streamed statement: " << e;
+    }
+  }
+  Finish();
+}
+
+std::optional<ResultSet> ResultStream::NextRow() {
+  if (!conn_) return std::nullopt;
+
+  std::optional<ResultSet> row;
+  try {
+    row = conn_->StreamFetchRow(query_, cmd_ctl_);
+  } catch (const std::exception&) {
+    // The statement is over, don't keep the connection until the destruction
+    conn_ = nullptr;
+    Finish();
+    throw;
+  }
+  if (!row) {
+    conn_ = nullptr;
+    Finish();
+  }
+  return row;
+}
+
+void ResultStream::Finish() {
+  if (!owned_conn_) return;
+  owned_conn_->Finish();
+  // The connection goes back to the pool before the stream is destroyed
+  owned_conn_ = detail::ConnectionPtr{nullptr};
+}
+
+}  // namespace storages::postgres
+
+USERVER_NAMESPACE_END
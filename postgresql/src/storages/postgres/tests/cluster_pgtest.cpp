@@ -1,5 +1,7 @@
 #include <storages/postgres/tests/util_pgtest.hpp>
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <userver/utest/utest.hpp>
@@ -332,4 +334,46 @@ UTEST_F(PostgreCluster, NonTransactionExecuteWithParameterStore) {
   }
 }
 
+UTEST_F(PostgreCluster, StreamRows) {
+  auto cluster = CreateCluster(GetDsnFromEnv(), GetTaskProcessor(), 1);
+
+  UEXPECT_THROW(cluster.Stream({}, "select 1"), pg::LogicError);
+
+  auto stream = cluster.Stream(pg::ClusterHostType::kMaster,
+                               "select generate_series(1, $1)", 1000);
+  EXPECT_EQ(1, stream.Next<int>());
+  EXPECT_EQ(999, stream.AsContainer<std::vector<int>>().size());
+  EXPECT_TRUE(stream.Done());
+
+  // The connection went back to the pool when the stream was done
+  EXPECT_EQ(1, cluster.Execute(pg::ClusterHostType::kMaster, "select 1")
+                   .AsSingleRow<int>());
+
+  {
+    auto abandoned = cluster.Stream(pg::ClusterHostType::kMaster,
+                                    "select generate_series(1, 10000000)");
+    EXPECT_EQ(1, abandoned.Next<int>());
+  }
+  auto res = cluster.Execute(pg::ClusterHostType::kMaster, "select 1");
+  EXPECT_EQ(1, res.AsSingleRow<int>());
+}
+
+UTEST_F(PostgreCluster, StreamError) {
+  auto cluster = CreateCluster(GetDsnFromEnv(), GetTaskProcessor(), 1);
+
+  auto stream = cluster.Stream(
+      pg::ClusterHostType::kMaster,
+      "select 10 / (100 - i) from generate_series(1, 1000) i");
+  const auto read_all = [&] {
+    while (stream.Next<int>()) {
+    }
+  };
+  UEXPECT_THROW(read_all(), pg::DataException);
+  EXPECT_TRUE(stream.Done());
+
+  // The only connection of the pool went back before the stream is destroyed
+  EXPECT_EQ(1, cluster.Execute(pg::ClusterHostType::kMaster, "select 1")
+                   .AsSingleRow<int>());
+}
+
 USERVER_NAMESPACE_END
@@ -0,0 +1,179 @@
+#include <storages/postgres/tests/util_pgtest.hpp>
+
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <userver/storages/postgres/copy.hpp>
+#include <userver/storages/postgres/transaction.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace pg = storages::postgres;
+
+namespace {
+
+const std::string kCreateTable =
+    "create temp table copy_test(id bigint primary key, name text, "
+    "value double precision) on commit drop";
+const std::string kCopyIn = "copy copy_test from stdin (format binary)";
+const std::string kCopyOut =
+    "copy (select * from copy_test order by id) to stdout (format binary)";
+
+struct CopyRow {
+  pg::Bigint id;
+  std::optional<std::string> name;
+  double value;
+};
+
+constexpr std::size_t kRowCount = 100'000;
+
+}  // namespace
+
+UTEST_P(PostgreConnection, CopyRoundtrip) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  std::vector<CopyRow> rows;
+  rows.reserve(kRowCount);
+  for (std::size_t i = 0; i < kRowCount; ++i) {
+    std::optional<std::string> name;
+    if (i % 3) name = "row #" + std::to_string(i);
+    rows.push_back({static_cast<pg::Bigint>(i), name, i * 0.5});
+  }
+  EXPECT_EQ(kRowCount, trx.CopyIn(kCopyIn, rows));
+
+  auto res = trx.Execute("select count(*), count(name) from copy_test");
+  EXPECT_EQ(kRowCount, res.Front()[0].As<pg::Bigint>());
+  EXPECT_EQ(kRowCount - kRowCount / 3 - 1, res.Front()[1].As<pg::Bigint>());
+
+  auto stream = trx.CopyOut(kCopyOut);
+  std::size_t read = 0;
+  for (CopyRow row; stream.ReadRow(row); ++read) {
+    ASSERT_LT(read, kRowCount);
+    EXPECT_EQ(rows[read].id, row.id);
+    EXPECT_EQ(rows[read].name, row.name);
+    EXPECT_EQ(rows[read].value, row.value);
+  }
+  EXPECT_EQ(kRowCount, read);
+  EXPECT_TRUE(stream.Done());
+
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, CopyStreams) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  auto in = trx.CopyIn(kCopyIn);
+  in.Write(pg::Bigint{1}, std::string{"one"}, 1.0);
+  in.WriteRow(std::make_tuple(pg::Bigint{2}, std::optional<std::string>{},
+                              2.0));
+  EXPECT_EQ(2, in.Finish());
+  EXPECT_TRUE(in.IsFinished());
+  UEXPECT_THROW(in.Write(pg::Bigint{3}, std::string{"three"}, 3.0),
+                pg::LogicError);
+
+  auto out = trx.CopyOut(kCopyOut);
+  pg::Bigint id{0};
+  std::string name;
+  double value{0};
+  EXPECT_TRUE(out.Read(id, name, value));
+  EXPECT_EQ(1, id);
+  EXPECT_EQ("one", name);
+  UEXPECT_THROW(out.Read(id, name, value), pg::FieldValueIsNull);
+  EXPECT_FALSE(out.Read(id, name, value));
+  EXPECT_TRUE(out.Done());
+
+  auto empty = trx.CopyOut("copy (select 1 where false) to stdout binary");
+  EXPECT_FALSE(empty.Read(id));
+  EXPECT_TRUE(empty.Done());
+
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, CopyWrongStatement) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  UEXPECT_THROW(trx.CopyIn(kCopyOut), pg::LogicError);
+  UEXPECT_THROW(trx.CopyOut("select 1"), pg::LogicError);
+
+  // Both statements completed, the transaction is intact
+  EXPECT_EQ(1, trx.Execute("select 1").AsSingleRow<int>());
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, CopyWrongDirection) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  // A COPY FROM STDIN can only be aborted, that fails the transaction
+  UEXPECT_THROW(trx.CopyOut(kCopyIn), pg::LogicError);
+  UEXPECT_THROW(trx.Execute("select 1"), pg::InvalidTransactionState);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, CopyTextFormat) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  UEXPECT_THROW(trx.CopyIn("copy copy_test from stdin"), pg::LogicError);
+  UEXPECT_THROW(trx.Execute("select 1"), pg::InvalidTransactionState);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, CopyInServerError) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+
+  auto in = trx.CopyIn(kCopyIn);
+  in.Write(pg::Bigint{1}, std::string{"one"}, 1.0);
+  in.Write(pg::Bigint{1}, std::string{"one again"}, 1.0);
+  UEXPECT_THROW(in.Finish(), pg::UniqueViolation);
+  EXPECT_TRUE(in.IsFinished());
+
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, CopyInAbandon) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  trx.Execute(kCreateTable);
+  {
+    auto in = trx.CopyIn(kCopyIn);
+    in.Write(pg::Bigint{1}, std::string{"one"}, 1.0);
+  }
+  UEXPECT_THROW(trx.Execute("select 1"), pg::InvalidTransactionState);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, CopyOutAbandon) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  {
+    auto out = trx.CopyOut(
+        "copy (select generate_series(1, 10000000)) to stdout binary");
+    int value = 0;
+    EXPECT_TRUE(out.Read(value));
+    EXPECT_EQ(1, value);
+  }
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+USERVER_NAMESPACE_END
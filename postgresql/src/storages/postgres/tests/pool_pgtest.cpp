@@ -5,6 +5,7 @@
 #include <userver/engine/async.hpp>
 #include <userver/engine/mutex.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/engine/task/task_with_result.hpp>
 
 #include <storages/postgres/detail/connection.hpp>
 #include <storages/postgres/detail/pool.hpp>
@@ -109,6 +110,47 @@ UTEST_F(PostgrePool, BlockWaitingOnAvailableConnection) {
   CheckConnection(std::move(conn));
 }
 
+UTEST_F(PostgrePool, ReuseReleasedConnection) {
+  auto pool = pg::detail::ConnectionPool::Create(
+      GetDsnFromEnv(), nullptr, GetTaskProcessor(), "",
+      storages::postgres::InitMode::kSync, {4, 4, 10},
+      kCachePreparedStatements, {}, GetTestCmdCtls(), {}, {});
+
+  auto conn = pool->Acquire(MakeDeadline());
+  const auto* released = conn.get();
+  conn = pg::detail::ConnectionPtr(nullptr);
+
+  conn = pool->Acquire(MakeDeadline());
+  EXPECT_EQ(released, conn.get())
+      << "The connection released last on the thread is reused";
+  CheckConnection(std::move(conn));
+}
+
+UTEST_F(PostgrePool, WaitingTasksServedInOrder) {
+  auto pool = pg::detail::ConnectionPool::Create(
+      GetDsnFromEnv(), nullptr, GetTaskProcessor(), "",
+      storages::postgres::InitMode::kAsync, {1, 1, 10},
+      kCachePreparedStatements, {}, GetTestCmdCtls(), {}, {});
+  auto conn = pool->Acquire(MakeDeadline());
+
+  std::vector<int> order;
+  std::vector<engine::TaskWithResult<void>> tasks;
+  for (int i = 0; i < 3; ++i) {
+    tasks.push_back(engine::AsyncNoSpan(GetTaskProcessor(), [&pool, &order, i] {
+      auto conn = pool->Acquire(MakeDeadline());
+      order.push_back(i);
+    }));
+    while (pool->GetStatistics().connection.waiting <=
+           static_cast<std::uint32_t>(i)) {
+      engine::Yield();
+    }
+  }
+
+  conn = pg::detail::ConnectionPtr(nullptr);
+  for (auto& task : tasks) UEXPECT_NO_THROW(task.Get());
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+}
+
 UTEST_F(PostgrePool, PoolInitialSizeExceedMaxSize) {
   UEXPECT_THROW(pg::detail::ConnectionPool::Create(
                     GetDsnFromEnv(), nullptr, GetTaskProcessor(), "",
@@ -299,4 +341,74 @@ UTEST_F(PostgrePool, DefaultCmdCtl) {
   EXPECT_EQ(kTestCmdCtl, pool->GetDefaultCommandControl());
 }
 
+UTEST_F(PostgrePool, PipelinedStatements) {
+  pg::PoolSettings settings{1, 4, 100};
+  settings.pipeline_connections = 2;
+  auto pool = pg::detail::ConnectionPool::Create(
+      GetDsnFromEnv(), nullptr, GetTaskProcessor(), "",
+      storages::postgres::InitMode::kAsync, settings, kCachePreparedStatements,
+      {}, GetTestCmdCtls(), {}, {});
+
+  // The first statement provides user types for the multiplexed ones
+  EXPECT_EQ(0, pool->Start().Execute("select 0").AsSingleRow<int>());
+
+  std::vector<engine::TaskWithResult<int>> tasks;
+  for (int i = 0; i < 100; ++i) {
+    tasks.push_back(engine::AsyncNoSpan(GetTaskProcessor(), [&pool, i] {
+      return pool->Start().Execute("select $1", i).AsSingleRow<int>();
+    }));
+  }
+  auto failed = engine::AsyncNoSpan(GetTaskProcessor(), [&pool] {
+    return pool->Start().Execute("select 1 / $1", 0);
+  });
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, tasks[i].Get());
+  }
+  // An error affects only the failed statement
+  UEXPECT_THROW(failed.Get(), pg::DataException);
+  EXPECT_EQ(1, pool->Start().Execute("select 1").AsSingleRow<int>());
+
+  settings.pipeline_connections = 1;
+  pool->SetSettings(settings);
+  EXPECT_EQ(2, pool->Start().Execute("select 2").AsSingleRow<int>());
+
+  settings.pipeline_connections = 0;
+  pool->SetSettings(settings);
+  EXPECT_EQ(3, pool->Start().Execute("select 3").AsSingleRow<int>());
+}
+
+UTEST_F(PostgrePool, PipelinedStatementTimeouts) {
+  pg::PoolSettings settings{1, 4, 100};
+  settings.pipeline_connections = 1;
+  auto pool = pg::detail::ConnectionPool::Create(
+      GetDsnFromEnv(), nullptr, GetTaskProcessor(), "",
+      storages::postgres::InitMode::kAsync, settings, kCachePreparedStatements,
+      {}, GetTestCmdCtls(), {}, {});
+  EXPECT_EQ(0, pool->Start().Execute("select 0").AsSingleRow<int>());
+
+  const auto short_cmd_ctl =
+      kTestCmdCtl.WithStatementTimeout(std::chrono::milliseconds{50});
+  const auto long_cmd_ctl =
+      kTestCmdCtl.WithStatementTimeout(std::chrono::milliseconds{750});
+
+  // Statements with different timeouts are queued together, but each of
+  // them runs with its own timeout
+  std::vector<engine::TaskWithResult<void>> short_tasks;
+  std::vector<engine::TaskWithResult<void>> long_tasks;
+  for (int i = 0; i < 4; ++i) {
+    short_tasks.push_back(engine::AsyncNoSpan(GetTaskProcessor(), [&] {
+      pool->Start().Execute(short_cmd_ctl, "select pg_sleep(0.2)");
+    }));
+    long_tasks.push_back(engine::AsyncNoSpan(GetTaskProcessor(), [&] {
+      pool->Start().Execute(long_cmd_ctl, "select pg_sleep(0.1)");
+    }));
+  }
+  for (auto& task : short_tasks) {
+    UEXPECT_THROW(task.Get(), pg::QueryCancelled);
+  }
+  for (auto& task : long_tasks) {
+    UEXPECT_NO_THROW(task.Get());
+  }
+}
+
 USERVER_NAMESPACE_END
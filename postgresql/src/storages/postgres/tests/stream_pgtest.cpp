@@ -0,0 +1,130 @@
+#include <storages/postgres/tests/util_pgtest.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <userver/storages/postgres/result_stream.hpp>
+#include <userver/storages/postgres/transaction.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace pg = storages::postgres;
+
+namespace {
+
+const std::string kSelectSeries =
+    "select i, 'row #' || i::text from generate_series(1, $1) i";
+
+struct StreamRow {
+  int id;
+  std::optional<std::string> name;
+};
+
+constexpr int kRowCount = 100'000;
+
+}  // namespace
+
+UTEST_P(PostgreConnection, StreamRows) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  auto stream = trx.Stream(kSelectSeries, kRowCount);
+  int read = 0;
+  while (auto row = stream.Next<StreamRow>(pg::kRowTag)) {
+    ++read;
+    ASSERT_EQ(read, row->id);
+    EXPECT_EQ("row #" + std::to_string(read), row->name);
+  }
+  EXPECT_EQ(kRowCount, read);
+  EXPECT_TRUE(stream.Done());
+  EXPECT_FALSE(stream.NextRow());
+
+  // The connection is available for the next statement
+  EXPECT_EQ(1, trx.Execute("select 1").AsSingleRow<int>());
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, StreamChunks) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  auto stream = trx.Stream("select generate_series(1, 10)");
+  std::vector<int> values;
+  EXPECT_EQ(4, stream.ReadChunk(values, 4));
+  EXPECT_EQ(4, stream.ReadChunk(values, 4));
+  EXPECT_EQ(2, stream.ReadChunk(values, 4));
+  EXPECT_TRUE(stream.Done());
+  EXPECT_EQ(0, stream.ReadChunk(values, 4));
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}), values);
+
+  auto rest = trx.Stream("select generate_series(1, 3)");
+  EXPECT_EQ(1, rest.Next<int>());
+  EXPECT_EQ((std::vector<int>{2, 3}), rest.AsContainer<std::vector<int>>());
+
+  auto empty = trx.Stream("select 1 where false");
+  EXPECT_FALSE(empty.Next<int>());
+  EXPECT_TRUE(empty.Done());
+
+  auto command = trx.Stream("set local statement_timeout = 0");
+  EXPECT_FALSE(command.NextRow());
+
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, StreamBusyConnection) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  auto stream = trx.Stream("select generate_series(1, 10)");
+  EXPECT_EQ(1, stream.Next<int>());
+  UEXPECT_THROW(trx.Execute("select 1"), pg::ConnectionBusy);
+  EXPECT_EQ(9, stream.AsContainer<std::vector<int>>().size());
+  UEXPECT_NO_THROW(trx.Commit());
+}
+
+UTEST_P(PostgreConnection, StreamServerError) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  // The error happens after some rows are sent
+  auto stream = trx.Stream(
+      "select 10 / (10000 - i) from generate_series(1, 100000) i");
+  std::size_t read = 0;
+  const auto read_all = [&] {
+    while (stream.Next<int>()) ++read;
+  };
+  UEXPECT_THROW(read_all(), pg::DataException);
+  EXPECT_LT(0, read);
+  UEXPECT_THROW(trx.Execute("select 1"), pg::InvalidTransactionState);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, StreamAbandon) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  {
+    auto stream = trx.Stream("select generate_series(1, 10000000)");
+    EXPECT_EQ(1, stream.Next<int>());
+  }
+  UEXPECT_THROW(trx.Execute("select 1"), pg::InvalidTransactionState);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+UTEST_P(PostgreConnection, StreamTimeout) {
+  CheckConnection(GetConn());
+
+  pg::Transaction trx{std::move(GetConn())};
+  auto stream = trx.Stream(
+      kTestCmdCtl.WithStatementTimeout(std::chrono::milliseconds{50}),
+      "select i, pg_sleep(0.01) from generate_series(1, 1000) i");
+  const auto read_all = [&] {
+    while (stream.NextRow()) {
+    }
+  };
+  UEXPECT_THROW(read_all(), pg::QueryCancelled);
+  UEXPECT_NO_THROW(trx.Rollback());
+}
+
+USERVER_NAMESPACE_END
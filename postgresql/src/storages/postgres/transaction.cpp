@@ -53,6 +53,45 @@ Portal Transaction::MakePortal(OptionalCommandControl statement_cmd_ctl,
                     statement_cmd_ctl);
 }
 
+CopyInStream Transaction::CopyIn(OptionalCommandControl statement_cmd_ctl,
+                                 const Query& query) {
+  if (!conn_) {
+    LOG_LIMITED_ERROR() << "CopyIn called after transaction finished"
+                        << logging::LogExtra::Stacktrace();
+    throw NotInTransaction("Transaction handle is not valid");
+  }
+  return CopyInStream{conn_.get(), query, std::move(statement_cmd_ctl)};
+}
+
+CopyOutStream Transaction::CopyOut(OptionalCommandControl statement_cmd_ctl,
+                                   const Query& query) {
+  if (!conn_) {
+    LOG_LIMITED_ERROR() << "CopyOut called after transaction finished"
+                        << logging::LogExtra::Stacktrace();
+    throw NotInTransaction("Transaction handle is not valid");
+  }
+  return CopyOutStream{conn_.get(), query, std::move(statement_cmd_ctl)};
+}
+
+ResultStream Transaction::Stream(OptionalCommandControl statement_cmd_ctl,
+                                 const Query& query,
+                                 const ParameterStore& store) {
+  return DoStream(query, detail::QueryParameters{store.GetInternalData()},
+                  std::move(statement_cmd_ctl));
+}
+
+ResultStream Transaction::DoStream(const Query& query,
+                                   const detail::QueryParameters& params,
+                                   OptionalCommandControl statement_cmd_ctl) {
+  if (!conn_) {
+    LOG_LIMITED_ERROR() << "Stream called after transaction finished"
+                        << logging::LogExtra::Stacktrace();
+    throw NotInTransaction("Transaction handle is not valid");
+  }
+  return ResultStream{conn_.get(), query, params,
+                      std::move(statement_cmd_ctl)};
+}
+
 ResultSet Transaction::DoExecute(const Query& query,
                                  const detail::QueryParameters& params,
                                  OptionalCommandControl statement_cmd_ctl) {
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include <userver/formats/common/type.hpp>
 
@@ -61,6 +63,16 @@ class VersionedValuePtr final {
   size_t Version() const;
   void BumpVersion();
 
+  // Allows member lookups to use lazily built hash indexes, the tree must
+  // never be modified after this call
+  void EnableMemberIndexes();
+  // Same, for the large objects the caller has found while walking the tree
+  void EnableMemberIndexes(std::vector<const impl::Value*>&& large_objects);
+
+  // Returns the member of an object of this tree or nullptr if it is absent
+  const impl::Value* FindMember(const impl::Value& object,
+                                std::string_view key) const;
+
  private:
   struct Data;
 
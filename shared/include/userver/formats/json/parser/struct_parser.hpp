@@ -0,0 +1,412 @@
+#pragma once
+
+/// @file userver/formats/json/parser/struct_parser.hpp
+/// @brief SAX parser and serializer derived from a described aggregate.
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/core.hpp>
+
+#include <userver/formats/json/parser/array_parser.hpp>
+#include <userver/formats/json/parser/bool_parser.hpp>
+#include <userver/formats/json/parser/int_parser.hpp>
+#include <userver/formats/json/parser/map_parser.hpp>
+#include <userver/formats/json/parser/number_parser.hpp>
+#include <userver/formats/json/parser/parser_json.hpp>
+#include <userver/formats/json/parser/string_parser.hpp>
+#include <userver/formats/json/parser/typed_parser.hpp>
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/utils/meta.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace formats::json::parser {
+
+/// @brief Specialize this trait to describe the JSON member names of an
+/// aggregate, in the order of its fields declaration.
+///
+/// The fields themselves are enumerated at compile time with Boost.PFR, so
+/// the aggregate must not have base classes, reference or bit-field members.
+/// `std::optional` fields are not required to be present in the input and are
+/// written as `null` if empty, all the other fields are required.
+///
+/// ~~~~~~~~~~~~~~{.cpp}
+/// struct Point {
+///   std::int64_t x;
+///   std::int64_t y;
+///   std::optional<std::string> label;
+/// };
+///
+/// template <>
+/// struct formats::json::parser::StructFieldNames<Point> {
+///   static constexpr std::string_view kNames[] = {"x", "y", "label"};
+/// };
+///
+/// auto point = formats::json::parser::ParseToType<
+///     Point, formats::json::parser::StructParser<Point>>(input);
+/// ~~~~~~~~~~~~~~
+template <typename T>
+struct StructFieldNames;
+
+template <typename T>
+class StructParser;
+
+namespace impl {
+
+template <typename T, typename = void>
+inline constexpr bool kHasStructFieldNames = false;
+
+template <typename T>
+inline constexpr bool kHasStructFieldNames<
+    T, std::void_t<decltype(StructFieldNames<T>::kNames)>> = true;
+
+template <typename Item>
+class OptionalParser;
+
+template <typename Item>
+class VectorParser;
+
+template <typename Map>
+class DictParser;
+
+// Maps a field type to the parser of the field
+template <typename T, typename = void>
+struct AutoParserImpl {
+  static_assert(!sizeof(T),
+                "There is no SAX parser for the field type, describe the type "
+                "with StructFieldNames or write the parser by hand");
+};
+
+template <>
+struct AutoParserImpl<bool> {
+  using Type = BoolParser;
+};
+
+template <>
+struct AutoParserImpl<std::int32_t> {
+  using Type = Int32Parser;
+};
+
+template <>
+struct AutoParserImpl<std::int64_t> {
+  using Type = Int64Parser;
+};
+
+template <>
+struct AutoParserImpl<float> {
+  using Type = FloatParser;
+};
+
+template <>
+struct AutoParserImpl<double> {
+  using Type = DoubleParser;
+};
+
+template <>
+struct AutoParserImpl<std::string> {
+  using Type = StringParser;
+};
+
+template <>
+struct AutoParserImpl<formats::json::Value> {
+  using Type = JsonValueParser;
+};
+
+template <typename Item>
+struct AutoParserImpl<std::optional<Item>> {
+  using Type = OptionalParser<Item>;
+};
+
+template <typename Item>
+struct AutoParserImpl<std::vector<Item>> {
+  using Type = VectorParser<Item>;
+};
+
+template <typename Value>
+struct AutoParserImpl<std::map<std::string, Value>> {
+  using Type = DictParser<std::map<std::string, Value>>;
+};
+
+template <typename Value>
+struct AutoParserImpl<std::unordered_map<std::string, Value>> {
+  using Type = DictParser<std::unordered_map<std::string, Value>>;
+};
+
+template <typename T>
+struct AutoParserImpl<T, std::enable_if_t<kHasStructFieldNames<T>>> {
+  using Type = StructParser<T>;
+};
+
+template <typename T>
+using AutoParser = typename AutoParserImpl<T>::Type;
+
+// Accepts `null` as an empty optional and anything else as a value of Item
+template <typename Item>
+class OptionalParser final : public TypedParser<std::optional<Item>>,
+                             public Subscriber<Item> {
+ public:
+  OptionalParser() { item_parser_.Subscribe(*this); }
+
+ private:
+  void Null() override { this->SetResult(std::nullopt); }
+  void Bool(bool b) override { PushItemParser().Bool(b); }
+  void Int64(int64_t i) override { PushItemParser().Int64(i); }
+  void Uint64(uint64_t i) override { PushItemParser().Uint64(i); }
+  void Double(double d) override { PushItemParser().Double(d); }
+  void String(std::string_view sw) override { PushItemParser().String(sw); }
+  void StartObject() override { PushItemParser().StartObject(); }
+  void StartArray() override { PushItemParser().StartArray(); }
+
+  void OnSend(Item&& item) override {
+    this->SetResult(std::optional<Item>{std::move(item)});
+  }
+
+  BaseParser& PushItemParser() {
+    item_parser_.Reset();
+    this->parser_state_->PushParser(item_parser_.GetParser());
+    return item_parser_.GetParser();
+  }
+
+  std::string GetPathItem() const override { return {}; }
+
+  std::string Expected() const override { return "value or null"; }
+
+  AutoParser<Item> item_parser_;
+};
+
+// Proxy parser that owns the item parser of an ArrayParser
+template <typename Item>
+class VectorParser final {
+ public:
+  using ResultType = std::vector<Item>;
+
+  VectorParser() : array_parser_(item_parser_) {}
+
+  void Reset() { array_parser_.Reset(); }
+
+  void Subscribe(Subscriber<ResultType>& subscriber) {
+    array_parser_.Subscribe(subscriber);
+  }
+
+  auto& GetParser() { return array_parser_.GetParser(); }
+
+ private:
+  AutoParser<Item> item_parser_;
+  ArrayParser<Item, AutoParser<Item>> array_parser_;
+};
+
+// Proxy parser that owns the value parser of a MapParser
+template <typename Map>
+class DictParser final {
+ public:
+  using ResultType = Map;
+
+  DictParser() : map_parser_(value_parser_) {}
+
+  void Reset() { map_parser_.Reset(); }
+
+  void Subscribe(Subscriber<ResultType>& subscriber) {
+    map_parser_.Subscribe(subscriber);
+  }
+
+  auto& GetParser() { return map_parser_.GetParser(); }
+
+ private:
+  using ValueParser = AutoParser<typename Map::mapped_type>;
+
+  ValueParser value_parser_;
+  MapParser<Map, ValueParser> map_parser_;
+};
+
+// Consumes a value of any type without building it
+class SkipParser final : public BaseParser {
+ public:
+  void Reset() { depth_ = 0; }
+
+ private:
+  void Null() override { MaybePopSelf(); }
+  void Bool(bool) override { MaybePopSelf(); }
+  void Int64(int64_t) override { MaybePopSelf(); }
+  void Uint64(uint64_t) override { MaybePopSelf(); }
+  void Double(double) override { MaybePopSelf(); }
+  void String(std::string_view) override { MaybePopSelf(); }
+  void StartObject() override { ++depth_; }
+  void Key(std::string_view) override {}
+  void EndObject() override {
+    --depth_;
+    MaybePopSelf();
+  }
+  void StartArray() override { ++depth_; }
+  void EndArray() override {
+    --depth_;
+    MaybePopSelf();
+  }
+
+  void MaybePopSelf();
+
+  std::string GetPathItem() const override { return {}; }
+
+  std::string Expected() const override { return "value"; }
+
+  std::size_t depth_{0};
+};
+
+}  // namespace impl
+
+/// @brief SAX parser for an aggregate described with StructFieldNames.
+///
+/// The field parsers are chosen at compile time from the field types: bool,
+/// std::int32_t, std::int64_t, float, double, std::string,
+/// formats::json::Value, std::optional, std::vector, std::map and
+/// std::unordered_map with std::string keys, and other described aggregates.
+/// Members that are not described are skipped without building them.
+template <typename T>
+class StructParser final : public TypedParser<T> {
+  static constexpr std::size_t kFieldsCount = boost::pfr::tuple_size_v<T>;
+  static constexpr std::size_t kNoField = kFieldsCount + 1;
+
+  using Names = StructFieldNames<T>;
+  using Indices = std::make_index_sequence<kFieldsCount>;
+
+  static_assert(std::size(Names::kNames) == kFieldsCount,
+                "StructFieldNames must name every field of the aggregate");
+
+  template <std::size_t I>
+  using Field = boost::pfr::tuple_element_t<I, T>;
+
+ public:
+  StructParser() : StructParser(Indices{}) {}
+
+  void Reset() override {
+    state_ = State::kStart;
+    field_ = kNoField;
+    seen_.reset();
+    result_ = T{};
+  }
+
+ private:
+  template <std::size_t... I>
+  explicit StructParser(std::index_sequence<I...>)
+      : sinks_(boost::pfr::get<I>(result_)...) {
+    (std::get<I>(parsers_).Subscribe(std::get<I>(sinks_)), ...);
+  }
+
+  void StartObject() override {
+    if (state_ != State::kStart) this->Throw("object");
+    state_ = State::kInside;
+  }
+
+  void Key(std::string_view key) override {
+    if (PushFieldParser(key, Indices{})) return;
+
+    field_ = kFieldsCount;
+    unknown_key_ = key;
+    skip_parser_.Reset();
+    this->parser_state_->PushParser(skip_parser_);
+  }
+
+  void EndObject() override {
+    field_ = kNoField;
+    CheckRequiredFields(Indices{});
+    this->SetResult(std::move(result_));
+  }
+
+  std::string Expected() const override { return "object"; }
+
+  std::string GetPathItem() const override {
+    if (field_ < kFieldsCount) return std::string{Names::kNames[field_]};
+    if (field_ == kFieldsCount) return unknown_key_;
+    return {};
+  }
+
+  template <std::size_t... I>
+  bool PushFieldParser(std::string_view key, std::index_sequence<I...>) {
+    return ((key == Names::kNames[I] && (PushFieldParser<I>(), true)) || ...);
+  }
+
+  template <std::size_t I>
+  void PushFieldParser() {
+    field_ = I;
+    if (seen_.test(I)) {
+      throw InternalParseError("Duplicate field '" +
+                               std::string{Names::kNames[I]} + "'");
+    }
+    seen_.set(I);
+
+    auto& parser = std::get<I>(parsers_);
+    parser.Reset();
+    this->parser_state_->PushParser(parser.GetParser());
+  }
+
+  template <std::size_t... I>
+  void CheckRequiredFields(std::index_sequence<I...>) const {
+    (CheckRequiredField<I>(), ...);
+  }
+
+  template <std::size_t I>
+  void CheckRequiredField() const {
+    if constexpr (!meta::kIsOptional<Field<I>>) {
+      if (!seen_.test(I)) {
+        throw InternalParseError("Missing required field '" +
+                                 std::string{Names::kNames[I]} + "'");
+      }
+    }
+  }
+
+  template <typename Sequence>
+  struct FieldsTuple;
+
+  template <std::size_t... I>
+  struct FieldsTuple<std::index_sequence<I...>> {
+    using Parsers = std::tuple<impl::AutoParser<Field<I>>...>;
+    using Sinks = std::tuple<SubscriberSink<Field<I>>...>;
+  };
+
+  enum class State {
+    kStart,
+    kInside,
+  };
+
+  State state_{State::kStart};
+  std::size_t field_{kNoField};
+  std::bitset<kFieldsCount> seen_;
+  T result_{};
+  typename FieldsTuple<Indices>::Parsers parsers_;
+  typename FieldsTuple<Indices>::Sinks sinks_;
+  impl::SkipParser skip_parser_;
+  std::string unknown_key_;
+};
+
+}  // namespace formats::json::parser
+
+namespace formats::json {
+
+/// SAX serialization of an aggregate described with
+/// parser::StructFieldNames, the counterpart of parser::StructParser
+template <typename T>
+std::enable_if_t<parser::impl::kHasStructFieldNames<T>> WriteToStream(
+    const T& value, StringBuilder& sw) {
+  using Names = parser::StructFieldNames<T>;
+
+  StringBuilder::ObjectGuard guard(sw);
+  boost::pfr::for_each_field(value, [&sw](const auto& field, std::size_t i) {
+    sw.Key(Names::kNames[i]);
+    WriteToStream(field, sw);
+  });
+}
+
+}  // namespace formats::json
+
+USERVER_NAMESPACE_END
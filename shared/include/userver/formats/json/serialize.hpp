@@ -23,6 +23,14 @@ namespace formats::json {
 /// Parse JSON from string
 formats::json::Value FromString(std::string_view doc);
 
+/// @brief Parse JSON from string into a single memory arena
+///
+/// Parsing makes a few allocations instead of one per node, and the whole
+/// document is freed at once with the last formats::json::Value referring
+/// to it. Prefer it for large documents that are only read, e.g. request
+/// bodies. formats::json::ValueBuilder always copies such documents.
+formats::json::Value FromStringWithArena(std::string_view doc);
+
 /// Parse JSON from stream
 formats::json::Value FromStream(std::istream& is);
 
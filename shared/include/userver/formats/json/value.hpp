@@ -270,6 +270,7 @@ class Value final {
   friend class impl::StringBuffer;
 
   friend formats::json::Value FromString(std::string_view);
+  friend formats::json::Value FromStringWithArena(std::string_view);
   friend formats::json::Value FromStream(std::istream&);
   friend void Serialize(const formats::json::Value&, std::ostream&);
   friend std::string ToString(const formats::json::Value&);
@@ -370,6 +371,14 @@ inline Value Parse(const Value& value, parse::To<Value>) { return value; }
 /// @endcode
 using formats::common::Items;
 
+/// @brief Sets the member count starting from which the objects of parsed
+/// documents are looked up through a hash index instead of a linear scan.
+///
+/// An index is built on the first lookup in an object and lives as long as
+/// the document. Applies to the documents parsed after the call. Zero
+/// disables the indexes, the default is 32.
+void SetMemberIndexThreshold(std::size_t member_count);
+
 }  // namespace formats::json
 
 USERVER_NAMESPACE_END
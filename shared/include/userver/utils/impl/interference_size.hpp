@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::impl {
+
+// Minimum offset between two objects to avoid false sharing.
+//
+// std::hardware_destructive_interference_size is not used on purpose: it
+// depends on the compiler flags, so it is not ABI-stable across translation
+// units, and it is missing in some of the supported standard libraries.
+inline constexpr std::size_t kInterferenceSize = 64;
+
+}  // namespace utils::impl
+
+USERVER_NAMESPACE_END
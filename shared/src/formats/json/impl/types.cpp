@@ -1,11 +1,93 @@
 #include <formats/json/impl/types_impl.hpp>
 
+#include <cstring>
+#include <vector>
+
+#include <rapidjson/document.h>
+
 #include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace formats::json::impl {
 
+namespace {
+
+// Below this member count a linear scan beats the index lookup
+constexpr std::size_t kDefaultMemberIndexThreshold = 32;
+
+std::atomic<std::size_t> g_member_index_threshold{
+    kDefaultMemberIndexThreshold};
+
+std::vector<const Value*> CollectLargeObjects(const Value& root) {
+  std::vector<const Value*> objects;
+  std::vector<const Value*> stack{&root};
+  while (!stack.empty()) {
+    const auto* value = stack.back();
+    stack.pop_back();
+    if (value->IsObject()) {
+      if (NeedsMemberIndex(value->MemberCount())) objects.push_back(value);
+      for (auto it = value->MemberBegin(); it != value->MemberEnd(); ++it) {
+        stack.push_back(&it->value);
+      }
+    } else if (value->IsArray()) {
+      for (const auto& element : value->GetArray()) stack.push_back(&element);
+    }
+  }
+  return objects;
+}
+
+}  // namespace
+
+bool NeedsMemberIndex(std::size_t member_count) noexcept {
+  const auto threshold =
+      g_member_index_threshold.load(std::memory_order_relaxed);
+  return threshold != 0 && member_count >= threshold;
+}
+
+MemberIndexes::MemberIndexes(const std::vector<const Value*>& objects) {
+  indexes_.reserve(objects.size());
+  for (const auto* object : objects) {
+    UASSERT(object->IsObject());
+    if (indexes_.empty() || object->MemberCount() < min_member_count_) {
+      min_member_count_ = object->MemberCount();
+    }
+    indexes_.try_emplace(object, nullptr);
+  }
+}
+
+MemberIndexes::~MemberIndexes() {
+  for (auto& [_, index] : indexes_) delete index.load();
+}
+
+bool MemberIndexes::IsEmpty() const { return indexes_.empty(); }
+
+const MemberIndexes::Index* MemberIndexes::GetIndex(const Value& object) {
+  UASSERT(object.IsObject());
+  if (object.MemberCount() < min_member_count_) return nullptr;
+
+  const auto slot = indexes_.find(&object);
+  if (slot == indexes_.end()) return nullptr;
+
+  const auto* index = slot->second.load(std::memory_order_acquire);
+  if (index) return index;
+
+  auto new_index = std::make_unique<Index>(object.MemberCount());
+  for (auto it = object.MemberBegin(); it != object.MemberEnd(); ++it) {
+    // keeps the first of duplicate members like rapidjson FindMember does
+    new_index->emplace(
+        std::string_view{it->name.GetString(), it->name.GetStringLength()},
+        &it->value);
+  }
+
+  // concurrent lookups may build the same index, the first one is kept
+  if (slot->second.compare_exchange_strong(index, new_index.get(),
+                                           std::memory_order_acq_rel)) {
+    return new_index.release();
+  }
+  return index;
+}
+
 VersionedValuePtr::Data::Data(Document&& doc)
     : Data(static_cast<Value&&>(doc)) {
   static_assert(
@@ -15,6 +97,28 @@ VersionedValuePtr::Data::Data(Document&& doc)
       "Both Document and Value must use CrtAllocator for the fast move");
 }
 
+VersionedValuePtr::Data::Data(ArenaDocument&& doc,
+                              std::unique_ptr<Arena>&& doc_arena)
+    : arena(std::move(doc_arena)) {
+  using ArenaValue = ArenaDocument::ValueType;
+  static_assert(sizeof(Value) == sizeof(ArenaValue) &&
+                    alignof(Value) == alignof(ArenaValue),
+                "Allocator must not affect the layout of rapidjson values");
+  UASSERT(arena && &doc.GetAllocator() == arena.get());
+
+  // The allocator type only matters for modification and destruction of
+  // the nodes, and neither ever happens to an arena-backed tree
+  auto& root = static_cast<ArenaValue&>(doc);
+  std::memcpy(static_cast<void*>(&native), static_cast<const void*>(&root),
+              sizeof(Value));
+  root.SetNull();
+}
+
+VersionedValuePtr::Data::~Data() {
+  // nodes are released all at once with the arena
+  if (arena) new (&native) Value();
+}
+
 VersionedValuePtr::VersionedValuePtr() noexcept = default;
 
 VersionedValuePtr::VersionedValuePtr(std::shared_ptr<Data>&& data) noexcept
@@ -24,7 +128,10 @@ VersionedValuePtr::~VersionedValuePtr() = default;
 
 VersionedValuePtr::operator bool() const { return !!data_; }
 
-bool VersionedValuePtr::IsUnique() const { return data_.use_count() == 1; }
+// Arena-backed trees are never unique to prevent taking over their nodes
+bool VersionedValuePtr::IsUnique() const {
+  return data_.use_count() == 1 && !data_->arena;
+}
 
 const Value* VersionedValuePtr::Get() const {
   return data_ ? &data_->native : nullptr;
@@ -52,6 +159,43 @@ size_t VersionedValuePtr::Version() const {
 
 void VersionedValuePtr::BumpVersion() { ++data_->version; }
 
+void VersionedValuePtr::EnableMemberIndexes() {
+  UASSERT(data_);
+  EnableMemberIndexes(CollectLargeObjects(data_->native));
+}
+
+void VersionedValuePtr::EnableMemberIndexes(
+    std::vector<const Value*>&& large_objects) {
+  UASSERT(data_);
+  if (large_objects.empty()) return;
+  data_->member_indexes = std::make_unique<MemberIndexes>(large_objects);
+}
+
+const Value* VersionedValuePtr::FindMember(const Value& object,
+                                           std::string_view key) const {
+  UASSERT(object.IsObject());
+  const auto* index =
+      data_ && data_->member_indexes ? data_->member_indexes->GetIndex(object)
+                                     : nullptr;
+  if (index) {
+    const auto it = index->find(key);
+    return it != index->end() ? it->second : nullptr;
+  }
+
+  const auto it =
+      object.FindMember(Value(::rapidjson::StringRef(key.data(), key.size())));
+  return it != object.MemberEnd() ? &it->value : nullptr;
+}
+
 }  // namespace formats::json::impl
 
+namespace formats::json {
+
+void SetMemberIndexThreshold(std::size_t member_count) {
+  impl::g_member_index_threshold.store(member_count,
+                                       std::memory_order_relaxed);
+}
+
+}  // namespace formats::json
+
 USERVER_NAMESPACE_END
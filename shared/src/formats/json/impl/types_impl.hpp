@@ -1,7 +1,13 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
+#include <rapidjson/allocators.h>
 #include <rapidjson/document.h>
 
 #include <userver/formats/json/impl/types.hpp>
@@ -10,6 +16,37 @@ USERVER_NAMESPACE_BEGIN
 
 namespace formats::json::impl {
 
+// Memory arena of the documents parsed with FromStringWithArena
+using Arena = ::rapidjson::MemoryPoolAllocator<::rapidjson::CrtAllocator>;
+using ArenaDocument =
+    ::rapidjson::GenericDocument<UTF8, Arena, ::rapidjson::CrtAllocator>;
+
+// Whether an object with that many members is large enough to be indexed
+bool NeedsMemberIndex(std::size_t member_count) noexcept;
+
+// Hash indexes of the large objects of a read-only tree. The set of indexed
+// objects is fixed on construction, so lookups never take a lock, while each
+// index is only built on the first lookup in its object.
+class MemberIndexes final {
+ public:
+  using Index = std::unordered_map<std::string_view, const Value*>;
+
+  explicit MemberIndexes(const std::vector<const Value*>& objects);
+  ~MemberIndexes();
+
+  MemberIndexes(const MemberIndexes&) = delete;
+  MemberIndexes& operator=(const MemberIndexes&) = delete;
+
+  bool IsEmpty() const;
+
+  // Returns nullptr for the objects that are too small to be indexed
+  const Index* GetIndex(const Value& object);
+
+ private:
+  std::size_t min_member_count_{0};
+  std::unordered_map<const Value*, std::atomic<const Index*>> indexes_;
+};
+
 struct VersionedValuePtr::Data {
   template <typename... Args>
   explicit Data(Args&&... args) : native(std::forward<Args>(args)...) {}
@@ -18,12 +55,24 @@ struct VersionedValuePtr::Data {
   // https://github.com/Tencent/rapidjson/issues/387
   explicit Data(Document&&);
 
+  // takes over the tree allocated in the arena
+  Data(ArenaDocument&&, std::unique_ptr<Arena>&&);
+
+  ~Data();
+
   // native rapidjson value
   Value native;
 
   // version of internal rapidjson structures (member arrays)
   // used in ValueBuilder to avoid UAF, ignored in read-only Value
   std::atomic<size_t> version{0};
+
+  // memory of all the nodes of an arena-backed tree, such a tree is never
+  // modified and its nodes are not freed one by one
+  std::unique_ptr<Arena> arena;
+
+  // set for the trees that are never modified
+  std::unique_ptr<MemberIndexes> member_indexes;
 };
 
 template <typename... Args>
@@ -128,4 +128,35 @@ void json_object_append_nocheck(benchmark::State& state) {
 }
 BENCHMARK(json_object_append_nocheck)->RangeMultiplier(2)->Range(1, 128);
 
+constexpr std::size_t kDefaultMemberIndexThreshold = 32;
+
+formats::json::Value ParseWideObject(size_t count,
+                                     std::size_t member_index_threshold) {
+  const auto text = formats::json::ToString(Build(count).ExtractValue());
+  formats::json::SetMemberIndexThreshold(member_index_threshold);
+  auto json = formats::json::FromString(text);
+  formats::json::SetMemberIndexThreshold(kDefaultMemberIndexThreshold);
+  return json;
+}
+
+void json_object_lookup_indexed(benchmark::State& state) {
+  const auto size = state.range(0);
+  const auto json = ParseWideObject(size, kDefaultMemberIndexThreshold);
+  const auto key = std::to_string(size - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(json[key]);
+  }
+}
+BENCHMARK(json_object_lookup_indexed)->Arg(10)->Arg(100)->Arg(10000);
+
+void json_object_lookup_linear(benchmark::State& state) {
+  const auto size = state.range(0);
+  const auto json = ParseWideObject(size, 0);
+  const auto key = std::to_string(size - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(json[key]);
+  }
+}
+BENCHMARK(json_object_lookup_linear)->Arg(10)->Arg(100)->Arg(10000);
+
 USERVER_NAMESPACE_END
@@ -99,4 +99,33 @@ TEST_F(FormatsJsonSpecificMemberAccess, CheckPrimitiveTypeExceptions) {
   EXPECT_THROW(doc_["key6"].rend(), TypeMismatchException);
 }
 
+TEST(FormatsJson, IndexedMemberAccess) {
+  formats::json::ValueBuilder builder;
+  for (int i = 0; i < 100; ++i) builder[std::to_string(i)] = i;
+  builder["nested"]["small"] = true;
+  const auto text = formats::json::ToString(builder.ExtractValue());
+
+  for (const std::size_t threshold : {0, 1, 32, 1000}) {
+    formats::json::SetMemberIndexThreshold(threshold);
+    for (const auto& doc : {formats::json::FromString(text),
+                            formats::json::FromStringWithArena(text)}) {
+      for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(doc.HasMember(std::to_string(i)));
+        EXPECT_EQ(doc[std::to_string(i)].As<int>(), i);
+      }
+      EXPECT_TRUE(doc["nested"]["small"].As<bool>());
+      EXPECT_FALSE(doc.HasMember("100"));
+      EXPECT_TRUE(doc["100"].IsMissing());
+      EXPECT_FALSE(doc["nested"].HasMember("large"));
+    }
+  }
+  formats::json::SetMemberIndexThreshold(32);
+
+  auto duplicate = text;
+  duplicate.back() = ',';
+  duplicate += R"("0":1})";
+  EXPECT_THROW(formats::json::FromString(duplicate),
+               formats::json::ParseException);
+}
+
 USERVER_NAMESPACE_END
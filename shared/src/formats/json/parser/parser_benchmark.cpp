@@ -5,6 +5,7 @@
 #include <userver/formats/json/parser/parser.hpp>
 #include <userver/formats/json/serialize.hpp>
 #include <userver/formats/parse/common_containers.hpp>
+#include <userver/formats/parse/to.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -46,6 +47,16 @@ void JsonParseArrayDom(benchmark::State& state) {
 }
 BENCHMARK(JsonParseArrayDom)->RangeMultiplier(4)->Range(1, 1024);
 
+void JsonParseArrayDomArena(benchmark::State& state) {
+  const auto input = BuildArray(state.range(0));
+  for (auto _ : state) {
+    auto json = formats::json::FromStringWithArena(input);
+    const auto res = ParseDom(json);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonParseArrayDomArena)->RangeMultiplier(4)->Range(1, 1024);
+
 void JsonParseArraySax(benchmark::State& state) {
   const auto input = BuildArray(state.range(0));
   for (auto _ : state) {
@@ -87,6 +98,15 @@ void JsonParseValueDom(benchmark::State& state) {
 }
 BENCHMARK(JsonParseValueDom)->RangeMultiplier(2)->Range(1, 16);
 
+void JsonParseValueDomArena(benchmark::State& state) {
+  const auto input = BuildObject(state.range(0));
+  for (auto _ : state) {
+    const auto res = formats::json::FromStringWithArena(input);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonParseValueDomArena)->RangeMultiplier(2)->Range(1, 16);
+
 void JsonParseValueSax(benchmark::State& state) {
   const auto input = BuildObject(state.range(0));
   for (auto _ : state) {
@@ -97,4 +117,73 @@ void JsonParseValueSax(benchmark::State& state) {
 }
 BENCHMARK(JsonParseValueSax)->RangeMultiplier(2)->Range(1, 16);
 
+namespace {
+
+struct Record {
+  std::int64_t id;
+  std::string name;
+  double score;
+  bool active;
+  std::vector<std::int64_t> tags;
+};
+
+struct Payload {
+  std::vector<Record> records;
+};
+
+Record Parse(const formats::json::Value& value, formats::parse::To<Record>) {
+  return {value["id"].As<std::int64_t>(), value["name"].As<std::string>(),
+          value["score"].As<double>(), value["active"].As<bool>(),
+          value["tags"].As<std::vector<std::int64_t>>()};
+}
+
+Payload Parse(const formats::json::Value& value, formats::parse::To<Payload>) {
+  return {value["records"].As<std::vector<Record>>()};
+}
+
+std::string BuildPayload(size_t len) {
+  std::string r = R"({"records": [)";
+  for (size_t i = 0; i < len; i++) {
+    if (i > 0) r += ',';
+    r += fmt::format(
+        R"({{"id": {}, "name": "record {}", "score": {}.5, "active": true, )"
+        R"("tags": [1, 2, 3], "comment": "not described"}})",
+        i, i, i);
+  }
+  r += "]}";
+  return r;
+}
+
+}  // namespace
+
+template <>
+struct formats::json::parser::StructFieldNames<Record> {
+  static constexpr std::string_view kNames[] = {"id", "name", "score",
+                                                "active", "tags"};
+};
+
+template <>
+struct formats::json::parser::StructFieldNames<Payload> {
+  static constexpr std::string_view kNames[] = {"records"};
+};
+
+void JsonParseStructDom(benchmark::State& state) {
+  const auto input = BuildPayload(state.range(0));
+  for (auto _ : state) {
+    const auto res = formats::json::FromString(input).As<Payload>();
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonParseStructDom)->RangeMultiplier(4)->Range(1, 1024);
+
+void JsonParseStructSax(benchmark::State& state) {
+  const auto input = BuildPayload(state.range(0));
+  for (auto _ : state) {
+    const auto res = formats::json::parser::ParseToType<
+        Payload, formats::json::parser::StructParser<Payload>>(input);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonParseStructSax)->RangeMultiplier(4)->Range(1, 1024);
+
 USERVER_NAMESPACE_END
@@ -16,6 +16,8 @@ namespace {
 struct JsonValueParser::Impl {
   impl::Document raw_value_{&g_allocator};
   size_t level_{0};
+  // saves walking the parsed tree for the objects to index if there are none
+  bool has_large_objects_{false};
 };
 
 JsonValueParser::JsonValueParser() = default;
@@ -63,6 +65,7 @@ void JsonValueParser::Key(std::string_view key) {
 
 void JsonValueParser::EndObject(size_t members) {
   if (!impl_->raw_value_.EndObject(members)) Throw(Expected());
+  if (impl::NeedsMemberIndex(members)) impl_->has_large_objects_ = true;
 
   impl_->level_--;
   MaybePopSelf();
@@ -87,8 +90,10 @@ void JsonValueParser::MaybePopSelf() {
     auto generator = [](const auto&) { return true; };
     impl_->raw_value_.Populate(generator);
 
-    this->SetResult(
-        Value{impl::VersionedValuePtr::Create(std::move(impl_->raw_value_))});
+    auto root = impl::VersionedValuePtr::Create(std::move(impl_->raw_value_));
+    if (impl_->has_large_objects_) root.EnableMemberIndexes();
+    impl_->has_large_objects_ = false;
+    this->SetResult(Value{std::move(root)});
   }
 }
 
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <map>
+#include <optional>
 #include <unordered_map>
 
 #include <userver/formats/json/parser/parser.hpp>
@@ -369,4 +371,130 @@ TEST(JsonStringParser, BomSymbol) {
   EXPECT_EQ(value_str, value_sax);
 }
 
+namespace {
+
+struct Item {
+  std::string name;
+  std::vector<std::int64_t> values;
+};
+
+struct Document {
+  std::int32_t id;
+  double ratio;
+  bool enabled;
+  std::optional<std::string> comment;
+  Item item;
+  std::vector<Item> items;
+  std::map<std::string, std::int64_t> counters;
+};
+
+}  // namespace
+
+template <>
+struct fjp::StructFieldNames<Item> {
+  static constexpr std::string_view kNames[] = {"name", "values"};
+};
+
+template <>
+struct fjp::StructFieldNames<Document> {
+  static constexpr std::string_view kNames[] = {
+      "id", "ratio", "enabled", "comment", "item", "items", "counters"};
+};
+
+TEST(JsonStringParser, Struct) {
+  std::string input = R"({
+    "id": 42,
+    "unknown": {"nested": [1, {"a": null}], "b": "c"},
+    "ratio": 0.5,
+    "enabled": true,
+    "item": {"name": "first", "values": [1, 2, 3]},
+    "items": [{"name": "second", "values": []}, {"values": [4], "name": ""}],
+    "counters": {"x": 1, "y": 2},
+    "also_unknown": 1
+  })";
+
+  const auto doc = fjp::ParseToType<Document, fjp::StructParser<Document>>(
+      std::string_view{input});
+  EXPECT_EQ(doc.id, 42);
+  EXPECT_EQ(doc.ratio, 0.5);
+  EXPECT_TRUE(doc.enabled);
+  EXPECT_EQ(doc.comment, std::nullopt);
+  EXPECT_EQ(doc.item.name, "first");
+  EXPECT_EQ(doc.item.values, (std::vector<std::int64_t>{1, 2, 3}));
+  ASSERT_EQ(doc.items.size(), 2);
+  EXPECT_EQ(doc.items[0].name, "second");
+  EXPECT_TRUE(doc.items[0].values.empty());
+  EXPECT_EQ(doc.items[1].name, "");
+  EXPECT_EQ(doc.items[1].values, std::vector<std::int64_t>{4});
+  EXPECT_EQ(doc.counters,
+            (std::map<std::string, std::int64_t>{{"x", 1}, {"y", 2}}));
+}
+
+TEST(JsonStringParser, StructOptional) {
+  const auto parse = [](std::string_view comment) {
+    return fjp::ParseToType<Document, fjp::StructParser<Document>>(
+        R"({"id": 1, "ratio": 1, "enabled": false, )" + std::string{comment} +
+        R"("item": {"name": "", "values": []}, "items": [], "counters": {}})");
+  };
+
+  EXPECT_EQ(parse("").comment, std::nullopt);
+  EXPECT_EQ(parse(R"("comment": null,)").comment, std::nullopt);
+  EXPECT_EQ(parse(R"("comment": "text",)").comment, "text");
+  EXPECT_EQ(parse("").ratio, 1.0);
+}
+
+TEST(JsonStringParser, StructErrors) {
+  EXPECT_THROW_TEXT(
+      (fjp::ParseToType<Item, fjp::StructParser<Item>>(R"({"name": "a"})")),
+      fjp::ParseError,
+      "Parse error at pos 12, path '': Missing required field 'values'");
+
+  EXPECT_THROW_TEXT(
+      (fjp::ParseToType<Item, fjp::StructParser<Item>>(
+          R"({"name": "a", "values": [1, "2"]})")),
+      fjp::ParseError,
+      "Parse error at pos 31, path 'values.[1]': integer was expected, but "
+      "string found, the latest token was , \"2\"");
+
+  EXPECT_THROW_TEXT(
+      (fjp::ParseToType<Item, fjp::StructParser<Item>>(
+          R"({"name": "a", "name": "b", "values": []})")),
+      fjp::ParseError,
+      "Parse error at pos 20, path 'name': Duplicate field 'name', the latest "
+      "token was , \"name\"");
+
+  EXPECT_THROW(
+      (fjp::ParseToType<Item, fjp::StructParser<Item>>(R"([])")),
+      fjp::ParseError);
+}
+
+TEST(JsonStringParser, StructRoundtrip) {
+  Document doc{7, 0.25, true, "comment", Item{"item", {1, 2}},
+               {Item{"a", {}}, Item{"b", {3}}}, {{"key", 5}}};
+
+  formats::json::StringBuilder sb;
+  WriteToStream(doc, sb);
+  const auto json = formats::json::FromString(sb.GetString());
+  EXPECT_EQ(json["id"].As<int>(), 7);
+  EXPECT_EQ(json["comment"].As<std::string>(), "comment");
+  EXPECT_EQ(json["items"][1]["values"][0].As<int>(), 3);
+  EXPECT_EQ(json["counters"]["key"].As<int>(), 5);
+
+  const auto parsed = fjp::ParseToType<Document, fjp::StructParser<Document>>(
+      sb.GetString());
+  EXPECT_EQ(parsed.id, doc.id);
+  EXPECT_EQ(parsed.ratio, doc.ratio);
+  EXPECT_EQ(parsed.comment, doc.comment);
+  EXPECT_EQ(parsed.item.values, doc.item.values);
+  ASSERT_EQ(parsed.items.size(), 2);
+  EXPECT_EQ(parsed.items[1].values, doc.items[1].values);
+  EXPECT_EQ(parsed.counters, doc.counters);
+
+  doc.comment.reset();
+  formats::json::StringBuilder sb_null;
+  WriteToStream(doc, sb_null);
+  EXPECT_TRUE(
+      formats::json::FromString(sb_null.GetString())["comment"].IsNull());
+}
+
 USERVER_NAMESPACE_END
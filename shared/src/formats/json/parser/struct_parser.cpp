@@ -0,0 +1,13 @@
+#include <userver/formats/json/parser/struct_parser.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace formats::json::parser::impl {
+
+void SkipParser::MaybePopSelf() {
+  if (depth_ == 0) parser_state_->PopMe(*this);
+}
+
+}  // namespace formats::json::parser::impl
+
+USERVER_NAMESPACE_END
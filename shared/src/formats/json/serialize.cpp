@@ -4,6 +4,8 @@
 #include <array>
 #include <fstream>
 #include <memory>
+#include <unordered_set>
+#include <vector>
 
 #include <fmt/format.h>
 #include <rapidjson/document.h>
@@ -28,11 +30,21 @@ namespace {
 
 ::rapidjson::CrtAllocator g_allocator;
 
+// Larger objects are checked for duplicate keys with a hash set
+constexpr int kMaxLinearKeyUniquenessCheck = 32;
+
+// Arena chunks are sized after the document, as its DOM takes about as much
+// memory as its text, so that a document fits into a few chunks
+constexpr std::size_t kMinArenaChunkSize = 64 * 1024;
+
 std::string_view AsStringView(const impl::Value& jval) {
   return {jval.GetString(), jval.GetStringLength()};
 }
 
-void CheckKeyUniqueness(const impl::Value* root) {
+// Also collects the objects that are large enough to be indexed, so that
+// the tree is walked once
+void CheckKeyUniqueness(const impl::Value* root,
+                        std::vector<const impl::Value*>& large_objects) {
   std::vector<impl::TreeIterFrame> stack;
   const impl::Value* value = root;
 
@@ -43,17 +55,30 @@ void CheckKeyUniqueness(const impl::Value* root) {
   for (;;) {
     stack.back().Advance();
     if (value->IsObject()) {
-      // O(n²) just because our json objects are (hopefully) small
       const int count = value->MemberCount();
       const auto begin = value->MemberBegin();
-      for (int i = 1; i < count; i++) {
-        const std::string_view i_key = AsStringView(begin[i].name);
-        for (int j = 0; j < i; j++) {
-          const std::string_view j_key = AsStringView(begin[j].name);
-          if (i_key == j_key)
-            // TODO: add object path to message in TAXICOMMON-1658
-            throw ParseException("Duplicate key: " + std::string(i_key) +
-                                 " at " + impl::ExtractPath(stack));
+      const auto throw_duplicate = [&stack](std::string_view key) {
+        // TODO: add object path to message in TAXICOMMON-1658
+        throw ParseException("Duplicate key: " + std::string(key) + " at " +
+                             impl::ExtractPath(stack));
+      };
+
+      if (impl::NeedsMemberIndex(count)) large_objects.push_back(value);
+
+      if (count > kMaxLinearKeyUniquenessCheck) {
+        std::unordered_set<std::string_view> keys;
+        keys.reserve(count);
+        for (int i = 0; i < count; i++) {
+          const std::string_view key = AsStringView(begin[i].name);
+          if (!keys.insert(key).second) throw_duplicate(key);
+        }
+      } else {
+        // O(n²) is fine for small objects
+        for (int i = 1; i < count; i++) {
+          const std::string_view i_key = AsStringView(begin[i].name);
+          for (int j = 0; j < i; j++) {
+            if (i_key == AsStringView(begin[j].name)) throw_duplicate(i_key);
+          }
         }
       }
     }
@@ -73,10 +98,36 @@ void CheckKeyUniqueness(const impl::Value* root) {
   }
 }
 
-impl::VersionedValuePtr EnsureValid(impl::Document&& json) {
-  CheckKeyUniqueness(&json);
+impl::VersionedValuePtr EnsureValid(impl::VersionedValuePtr&& root) {
+  std::vector<const impl::Value*> large_objects;
+  CheckKeyUniqueness(root.Get(), large_objects);
+  root.EnableMemberIndexes(std::move(large_objects));
+  return std::move(root);
+}
+
+template <typename Document>
+void ParseInto(Document& json, std::string_view doc) {
+  if (doc.empty()) {
+    throw ParseException("JSON document is empty");
+  }
 
-  return impl::VersionedValuePtr::Create(std::move(json));
+  rapidjson::ParseResult ok =
+      json.template Parse<rapidjson::kParseDefaultFlags |
+                          rapidjson::kParseIterativeFlag |
+                          rapidjson::kParseFullPrecisionFlag>(doc.data(),
+                                                              doc.size());
+  if (!ok) {
+    const auto offset = ok.Offset();
+    const auto line = 1 + std::count(doc.begin(), doc.begin() + offset, '\n');
+    // Some versions of libstdc++ have runtime isues in
+    // string_view::find_last_of("\n", 0, offset) implementation.
+    const auto from_pos = doc.substr(0, offset).find_last_of('\n');
+    const auto column = offset > from_pos ? offset - from_pos : offset + 1;
+
+    throw ParseException(
+        fmt::format("JSON parse error at line {} column {}: {}", line, column,
+                    rapidjson::GetParseError_En(ok.Code())));
+  }
 }
 
 // Like `GenericValue.Accept`, but the order of the keys in objects is sorted
@@ -119,29 +170,19 @@ bool AcceptStable(const impl::Value& origin, Handler& handler) {
 }  // namespace
 
 Value FromString(std::string_view doc) {
-  if (doc.empty()) {
-    throw ParseException("JSON document is empty");
-  }
-
   impl::Document json{&g_allocator};
-  rapidjson::ParseResult ok =
-      json.Parse<rapidjson::kParseDefaultFlags |
-                 rapidjson::kParseIterativeFlag |
-                 rapidjson::kParseFullPrecisionFlag>(doc.data(), doc.size());
-  if (!ok) {
-    const auto offset = ok.Offset();
-    const auto line = 1 + std::count(doc.begin(), doc.begin() + offset, '\n');
-    // Some versions of libstdc++ have runtime isues in
-    // string_view::find_last_of("\n", 0, offset) implementation.
-    const auto from_pos = doc.substr(0, offset).find_last_of('\n');
-    const auto column = offset > from_pos ? offset - from_pos : offset + 1;
+  ParseInto(json, doc);
+  return Value{EnsureValid(impl::VersionedValuePtr::Create(std::move(json)))};
+}
 
-    throw ParseException(
-        fmt::format("JSON parse error at line {} column {}: {}", line, column,
-                    rapidjson::GetParseError_En(ok.Code())));
-  }
+Value FromStringWithArena(std::string_view doc) {
+  auto arena =
+      std::make_unique<impl::Arena>(std::max(kMinArenaChunkSize, doc.size()));
+  impl::ArenaDocument json{arena.get()};
+  ParseInto(json, doc);
 
-  return Value{EnsureValid(std::move(json))};
+  return Value{EnsureValid(
+      impl::VersionedValuePtr::Create(std::move(json), std::move(arena)))};
 }
 
 Value FromStream(std::istream& is) {
@@ -161,7 +202,7 @@ Value FromStream(std::istream& is) {
                                      rapidjson::GetParseError_En(ok.Code())));
   }
 
-  return Value{EnsureValid(std::move(json))};
+  return Value{EnsureValid(impl::VersionedValuePtr::Create(std::move(json)))};
 }
 
 void Serialize(const Value& doc, std::ostream& os) {
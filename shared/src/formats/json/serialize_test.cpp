@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <string_view>
+
 #include <userver/formats/json/exception.hpp>
 #include <userver/formats/json/serialize.hpp>
 
@@ -152,4 +154,43 @@ TEST(JsonToSortedString, NonASCII) {
             formats::json::ToStableString(unescaped));
 }
 
+TEST(FormatsJson, ArenaParse) {
+  constexpr std::string_view kDoc =
+      R"({"a":[1,2.5,"a long string that is not stored inline",null],)"
+      R"("b":{"c":true,"d":-1},"e":""})";
+
+  const auto arena_json = formats::json::FromStringWithArena(kDoc);
+  EXPECT_EQ(arena_json, formats::json::FromString(kDoc));
+  EXPECT_EQ(formats::json::ToString(arena_json), kDoc);
+
+  // members outlive the root Value they were taken from
+  auto member = formats::json::FromStringWithArena(kDoc)["a"];
+  EXPECT_EQ(member[2].As<std::string>(),
+            "a long string that is not stored inline");
+}
+
+TEST(FormatsJson, ArenaParseErrors) {
+  using ParseException = formats::json::Value::ParseException;
+
+  EXPECT_THROW(formats::json::FromStringWithArena(""), ParseException);
+  EXPECT_THROW(formats::json::FromStringWithArena(R"({"a":[1,2,{"b":)"),
+               ParseException);
+  EXPECT_THROW(formats::json::FromStringWithArena(R"({"a":1,"a":2})"),
+               ParseException);
+}
+
+TEST(FormatsJson, ArenaValueBuilderCopies) {
+  auto arena_json =
+      formats::json::FromStringWithArena(R"({"a":[1,2],"b":"text"})");
+
+  formats::json::ValueBuilder builder{std::move(arena_json)};
+  builder["a"].PushBack(3);
+  builder["b"] = "other text";
+  builder["c"] = formats::json::FromStringWithArena(R"({"d":[]})")["d"];
+  builder["c"].PushBack(4);
+
+  EXPECT_EQ(formats::json::ToString(builder.ExtractValue()),
+            R"({"a":[1,2,3],"b":"other text","c":[4]})");
+}
+
 USERVER_NAMESPACE_END
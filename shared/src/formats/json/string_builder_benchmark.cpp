@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include <userver/formats/json/serialize.hpp>
 #include <userver/formats/json/string_builder.hpp>
 #include <userver/formats/json/value_builder.hpp>
 
@@ -33,6 +34,24 @@ void JsonSerialize(benchmark::State& state) {
 }
 BENCHMARK(JsonSerialize)->RangeMultiplier(4)->Range(1, 1024);
 
+void JsonReserialize(benchmark::State& state) {
+  const auto input = ToString(Build(state.range(0)));
+  for (auto _ : state) {
+    const auto res = ToString(FromString(input));
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonReserialize)->RangeMultiplier(4)->Range(1, 1024);
+
+void JsonReserializeArena(benchmark::State& state) {
+  const auto input = ToString(Build(state.range(0)));
+  for (auto _ : state) {
+    const auto res = ToString(FromStringWithArena(input));
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(JsonReserializeArena)->RangeMultiplier(4)->Range(1, 1024);
+
 void Write(int level, StringBuilder& sw) {
   if (level % 2) {
     StringBuilder::ArrayGuard guard(sw);
@@ -85,10 +85,8 @@ Value Value::operator[](std::string_view key) const {
   if (!IsMissing()) {
     CheckObjectOrNull();
     if (IsObject()) {
-      auto it = GetNative().FindMember(
-          impl::Value(::rapidjson::StringRef(key.data(), key.size())));
-      if (it != GetNative().MemberEnd()) {
-        return {root_, &it->value, depth_ + 1};
+      if (const auto* member = root_.FindMember(GetNative(), key)) {
+        return {root_, member, depth_ + 1};
       }
     }
   }
@@ -331,8 +329,7 @@ std::string Value::ConvertTo<std::string>() const {
 bool Value::HasMember(std::string_view key) const {
   if (IsMissing()) return false;
   CheckObjectOrNull();
-  return IsObject() && GetNative().HasMember(impl::Value(
-                           ::rapidjson::StringRef(key.data(), key.size())));
+  return IsObject() && root_.FindMember(GetNative(), key);
 }
 
 std::string Value::GetPath() const {
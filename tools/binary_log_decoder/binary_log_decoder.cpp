@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <logging/binary_format.hpp>
+
+#include <userver/utest/using_namespace_userver.hpp>
+
+namespace {
+
+constexpr std::size_t kChunkSize = 1 << 16;
+
+struct Config {
+  std::vector<std::string> files;
+};
+
+Config ParseConfig(int argc, char** argv) {
+  namespace po = boost::program_options;
+
+  Config config;
+  po::options_description desc(
+      "Converts logs written in the 'binary' format to TSKV, skipping the\n"
+      "truncated or corrupted records.\n"
+      "Reads stdin if no files are given.\n\n"
+      "Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "files", po::value(&config.files), "list of binary log files");
+
+  po::positional_options_description pos_desc;
+  pos_desc.add("files", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos_desc)
+                  .run(),
+              vm);
+    po::notify(vm);
+  } catch (const std::exception& ex) {
+    std::cerr << "Cannot parse command line: " << ex.what() << '\n';
+    exit(1);
+  }
+
+  if (vm.count("help")) {
+    std::cout << desc << '\n';
+    exit(0);
+  }
+
+  return config;
+}
+
+// Returns the number of bytes that do not belong to intact records
+std::size_t Decode(std::istream& input, std::ostream& output) {
+  std::string data;
+  std::string tskv;
+  std::vector<char> chunk(kChunkSize);
+  std::size_t skipped = 0;
+
+  while (input) {
+    input.read(chunk.data(), chunk.size());
+    data.append(chunk.data(), input.gcount());
+
+    std::string_view pending = data;
+    skipped += logging::impl::binary::DecodeRecordsToTskv(
+        pending, tskv, /*is_last_chunk=*/!input);
+    output << tskv;
+    tskv.clear();
+    data.erase(0, data.size() - pending.size());
+  }
+
+  return skipped;
+}
+
+void ReportSkipped(std::string_view source, std::size_t skipped) {
+  if (skipped == 0) return;
+  std::cerr << source << ": skipped " << skipped
+            << " bytes of truncated or corrupted records\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto config = ParseConfig(argc, argv);
+  std::ios_base::sync_with_stdio(false);
+
+  try {
+    if (config.files.empty()) {
+      ReportSkipped("stdin", Decode(std::cin, std::cout));
+      return 0;
+    }
+
+    for (const auto& file : config.files) {
+      std::ifstream input(file, std::ios::binary);
+      if (!input) {
+        std::cerr << "Cannot open '" << file << "'\n";
+        return 1;
+      }
+      ReportSkipped(file, Decode(input, std::cout));
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "Failed to decode: " << ex.what() << '\n';
+    return 1;
+  }
+}